@@ -783,10 +783,13 @@ nm_device_reapply_bridge_port_vlans(NMDevice *device)
     gs_free NMPlatformBridgeVlan *setting_vlans     = NULL;
     gs_free NMPlatformBridgeVlan *plat_vlans        = NULL;
     guint                         num_setting_vlans = 0;
+    gs_free NMPlatformBridgeVlan *vlans_to_add      = NULL;
+    gs_free NMPlatformBridgeVlan *vlans_to_del      = NULL;
     guint                         num_plat_vlans    = 0;
+    guint                         num_vlans_to_add  = 0;
+    guint                         num_vlans_to_del  = 0;
     NMPlatform                   *plat;
     int                           ifindex;
-    gboolean                      do_reapply;
 
     s_bridge_port = nm_device_get_applied_setting(device, NM_TYPE_SETTING_BRIDGE_PORT);
     if (!s_bridge_port)
@@ -820,24 +823,8 @@ nm_device_reapply_bridge_port_vlans(NMDevice *device)
     ifindex = nm_device_get_ifindex(device);
 
     if (!nm_platform_link_get_bridge_vlans(plat, ifindex, &plat_vlans, &num_plat_vlans)) {
+        /* We don't know what is configured, flush everything and start over. */
         _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: can't get current VLANs from platform");
-        do_reapply = TRUE;
-    } else {
-        nmp_utils_bridge_vlan_normalize(setting_vlans, &num_setting_vlans);
-        nmp_utils_bridge_vlan_normalize(plat_vlans, &num_plat_vlans);
-        if (!nmp_utils_bridge_normalized_vlans_equal(setting_vlans,
-                                                     num_setting_vlans,
-                                                     plat_vlans,
-                                                     num_plat_vlans)) {
-            _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: VLANs in platform need reapply");
-            do_reapply = TRUE;
-        } else {
-            _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: VLANs in platform didn't change");
-            do_reapply = FALSE;
-        }
-    }
-
-    if (do_reapply) {
         nm_platform_link_set_bridge_vlans(plat, ifindex, TRUE, NULL, 0);
         if (num_setting_vlans > 0)
             nm_platform_link_set_bridge_vlans(plat,
@@ -845,7 +832,41 @@ nm_device_reapply_bridge_port_vlans(NMDevice *device)
                                               TRUE,
                                               setting_vlans,
                                               num_setting_vlans);
+        return;
     }
+
+    nmp_utils_bridge_vlan_normalize(setting_vlans, &num_setting_vlans);
+    nmp_utils_bridge_vlan_normalize(plat_vlans, &num_plat_vlans);
+    if (nmp_utils_bridge_normalized_vlans_equal(setting_vlans,
+                                                num_setting_vlans,
+                                                plat_vlans,
+                                                num_plat_vlans)) {
+        _LOGD(LOGD_DEVICE, "reapply-bridge-port-vlans: VLANs in platform didn't change");
+        return;
+    }
+
+    /* Only touch the VLANs that changed. Flushing and re-adding all of them
+     * would drop the traffic of the unchanged VLANs for a moment. Add first,
+     * so that a PVID that moves to another VLAN is never missing. */
+    nmp_utils_bridge_vlans_diff(plat_vlans,
+                                num_plat_vlans,
+                                setting_vlans,
+                                num_setting_vlans,
+                                &vlans_to_add,
+                                &num_vlans_to_add,
+                                &vlans_to_del,
+                                &num_vlans_to_del);
+
+    _LOGD(LOGD_DEVICE,
+          "reapply-bridge-port-vlans: VLANs in platform need reapply (%u ranges to add, %u to "
+          "remove)",
+          num_vlans_to_add,
+          num_vlans_to_del);
+
+    if (num_vlans_to_add > 0)
+        nm_platform_link_set_bridge_vlans(plat, ifindex, TRUE, vlans_to_add, num_vlans_to_add);
+    if (num_vlans_to_del > 0)
+        nm_platform_link_del_bridge_vlans(plat, ifindex, TRUE, vlans_to_del, num_vlans_to_del);
 }
 
 static void
@@ -405,3 +405,180 @@ nm_device_resolve_address_finish(GAsyncResult *result, GError **error)
 
     return g_task_propagate_pointer(task, error);
 }
+
+/*****************************************************************************/
+
+struct _NMDeviceHostLookups {
+    GHashTable                *hosts;
+    NMDeviceHostLookupCallback callback;
+    gpointer                   user_data;
+};
+
+typedef struct _NMDeviceHostLookup {
+    /* must be the first field, see nm_pstr_hash(). */
+    char                *host;
+    NMDeviceHostLookups *lookups;
+    GCancellable        *cancellable;
+    CList                waiters_lst_head;
+
+    /* the lookup is done and its waiters get notified. */
+    bool completed : 1;
+} NMDeviceHostLookup;
+
+static void
+_host_lookup_free(NMDeviceHostLookup *lookup)
+{
+    nm_assert(c_list_is_empty(&lookup->waiters_lst_head));
+
+    /* The callback of a cancelled lookup doesn't touch @lookup anymore. */
+    nm_clear_g_cancellable(&lookup->cancellable);
+    g_free(lookup->host);
+    nm_g_slice_free(lookup);
+}
+
+static void
+_host_lookup_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+    NMDeviceHostLookup       *lookup;
+    NMDeviceHostLookups      *lookups;
+    NMDeviceHostLookupWaiter *waiter;
+    gs_free_error GError     *error = NULL;
+    GList                    *list;
+
+    list = g_resolver_lookup_by_name_finish(G_RESOLVER(source_object), res, &error);
+
+    if (nm_utils_error_is_cancelled(error))
+        return;
+
+    lookup  = user_data;
+    lookups = lookup->lookups;
+
+    /* Drop the lookup, so that the callback can start a new one for the same
+     * host. The waiters stay pending until they are notified. Meanwhile, the
+     * callback may also cancel them. */
+    if (!g_hash_table_steal(lookups->hosts, lookup))
+        nm_assert_not_reached();
+    lookup->completed = TRUE;
+
+    while (
+        (waiter = c_list_first_entry(&lookup->waiters_lst_head, NMDeviceHostLookupWaiter, lst))) {
+        c_list_unlink(&waiter->lst);
+        waiter->lookup = NULL;
+        lookups->callback(waiter, list, error, lookups->user_data);
+    }
+
+    _host_lookup_free(lookup);
+    g_list_free_full(list, g_object_unref);
+}
+
+/**
+ * nm_device_host_lookup_start:
+ * @lookups: the lookups
+ * @waiter: the waiter, which must not be pending
+ * @host: the host name
+ *
+ * Returns: %TRUE if a new lookup was started, %FALSE if @waiter
+ *   joined a pending lookup of @host.
+ */
+gboolean
+nm_device_host_lookup_start(NMDeviceHostLookups      *lookups,
+                            NMDeviceHostLookupWaiter *waiter,
+                            const char               *host)
+{
+    gs_unref_object GResolver *resolver = NULL;
+    NMDeviceHostLookup        *lookup;
+
+    nm_assert(lookups);
+    nm_assert(!waiter->lookup);
+    nm_assert(host);
+
+    c_list_unlink(&waiter->lst);
+
+    lookup = g_hash_table_lookup(lookups->hosts, &host);
+    if (lookup) {
+        c_list_link_tail(&lookup->waiters_lst_head, &waiter->lst);
+        waiter->lookup = lookup;
+        return FALSE;
+    }
+
+    lookup  = g_slice_new(NMDeviceHostLookup);
+    *lookup = (NMDeviceHostLookup) {
+        .host             = g_strdup(host),
+        .lookups          = lookups,
+        .cancellable      = g_cancellable_new(),
+        .waiters_lst_head = C_LIST_INIT(lookup->waiters_lst_head),
+    };
+    if (!g_hash_table_add(lookups->hosts, lookup))
+        nm_assert_not_reached();
+
+    c_list_link_tail(&lookup->waiters_lst_head, &waiter->lst);
+    waiter->lookup = lookup;
+
+    resolver = g_resolver_get_default();
+    g_resolver_lookup_by_name_async(resolver, host, lookup->cancellable, _host_lookup_cb, lookup);
+    return TRUE;
+}
+
+/**
+ * nm_device_host_lookup_cancel:
+ * @lookups: the lookups
+ * @waiter: the waiter
+ *
+ * Stops waiting. The lookup is only aborted if no other waiter is left.
+ * It is fine to call this for a waiter that is not pending.
+ *
+ * Returns: %TRUE if @waiter was pending.
+ */
+gboolean
+nm_device_host_lookup_cancel(NMDeviceHostLookups *lookups, NMDeviceHostLookupWaiter *waiter)
+{
+    NMDeviceHostLookup *lookup;
+
+    nm_assert(lookups);
+
+    c_list_unlink(&waiter->lst);
+
+    lookup = g_steal_pointer(&waiter->lookup);
+    if (!lookup)
+        return FALSE;
+
+    nm_assert(lookup->lookups == lookups);
+
+    if (c_list_is_empty(&lookup->waiters_lst_head) && !lookup->completed) {
+        if (!g_hash_table_remove(lookups->hosts, lookup))
+            nm_assert_not_reached();
+    }
+    return TRUE;
+}
+
+NMDeviceHostLookups *
+nm_device_host_lookups_new(NMDeviceHostLookupCallback callback, gpointer user_data)
+{
+    NMDeviceHostLookups *lookups;
+
+    nm_assert(callback);
+
+    lookups  = g_slice_new(NMDeviceHostLookups);
+    *lookups = (NMDeviceHostLookups) {
+        .hosts     = g_hash_table_new_full(nm_pstr_hash,
+                                       nm_pstr_equal,
+                                       (GDestroyNotify) _host_lookup_free,
+                                       NULL),
+        .callback  = callback,
+        .user_data = user_data,
+    };
+    return lookups;
+}
+
+void
+nm_device_host_lookups_free(NMDeviceHostLookups *lookups)
+{
+    if (!lookups)
+        return;
+
+    /* All waiters must have been cancelled. */
+    nm_assert(g_hash_table_size(lookups->hosts) == 0);
+
+    g_hash_table_destroy(lookups->hosts);
+    nm_g_slice_free(lookups);
+}
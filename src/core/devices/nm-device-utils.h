@@ -3,6 +3,8 @@
 #ifndef __DEVICES_NM_DEVICE_UTILS_H__
 #define __DEVICES_NM_DEVICE_UTILS_H__
 
+#include "c-list/src/c-list.h"
+
 /*****************************************************************************/
 
 const char *nm_device_state_to_string(NMDeviceState state);
@@ -92,4 +94,49 @@ void nm_device_resolve_address(int                 addr_family,
 
 char *nm_device_resolve_address_finish(GAsyncResult *result, GError **error);
 
+/*****************************************************************************/
+
+/* Lookups of host names via the default GResolver. Waiters for the same host
+ * share one lookup, which is only cancelled when the last waiter leaves. */
+typedef struct _NMDeviceHostLookups NMDeviceHostLookups;
+
+typedef struct {
+    CList                       lst;
+    struct _NMDeviceHostLookup *lookup;
+} NMDeviceHostLookupWaiter;
+
+/* Called once for every waiter of a completed lookup. The waiter is no longer
+ * pending and may start a new lookup. @addresses is a list of #GInetAddress
+ * and only valid during the call. */
+typedef void (*NMDeviceHostLookupCallback)(NMDeviceHostLookupWaiter *waiter,
+                                           GList                    *addresses,
+                                           GError                   *error,
+                                           gpointer                  user_data);
+
+NMDeviceHostLookups *nm_device_host_lookups_new(NMDeviceHostLookupCallback callback,
+                                                gpointer                   user_data);
+
+void nm_device_host_lookups_free(NMDeviceHostLookups *lookups);
+
+static inline void
+nm_device_host_lookup_waiter_init(NMDeviceHostLookupWaiter *waiter)
+{
+    *waiter = (NMDeviceHostLookupWaiter) {
+        .lst = C_LIST_INIT(waiter->lst),
+    };
+}
+
+static inline gboolean
+nm_device_host_lookup_is_pending(const NMDeviceHostLookupWaiter *waiter)
+{
+    return !!waiter->lookup;
+}
+
+gboolean nm_device_host_lookup_start(NMDeviceHostLookups      *lookups,
+                                     NMDeviceHostLookupWaiter *waiter,
+                                     const char               *host);
+
+gboolean nm_device_host_lookup_cancel(NMDeviceHostLookups      *lookups,
+                                      NMDeviceHostLookupWaiter *waiter);
+
 #endif /* __DEVICES_NM_DEVICE_UTILS_H__ */
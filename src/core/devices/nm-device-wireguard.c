@@ -40,7 +40,8 @@
  *   as well. We may use policy-routing like wg-quick does. See also discussions at
  *   https://www.wireguard.com/netns/#improving-the-classic-solutions */
 
-/* TODO: honor the TTL of DNS to determine when to retry resolving endpoints. */
+/* TODO: honor the TTL of DNS to determine when to retry resolving endpoints.
+ *   GResolver's g_resolver_lookup_by_name() does not provide the TTL. */
 
 /* TODO: when we get multiple IP addresses when resolving a peer endpoint. We currently
  *   just take the first from GAI. We should only accept AAAA/IPv6 if we also have a suitable
@@ -79,7 +80,9 @@ typedef enum {
 } LinkConfigMode;
 
 typedef struct {
-    GCancellable *cancellable;
+    /* pending while we are resolving the endpoint. All peers whose endpoint
+     * has the same host share one lookup. */
+    NMDeviceHostLookupWaiter host_lookup;
 
     NMSockAddrUnion sockaddr;
 
@@ -89,7 +92,7 @@ typedef struct {
      * It may be set to %NEXT_TRY_AT_NSEC_ASAP to indicate to re-resolve as soon as possible.
      *
      * A @sockaddr is either fixed or it has
-     *   - @cancellable set to indicate an ongoing request
+     *   - @host_lookup pending to indicate an ongoing request
      *   - @next_try_at_nsec set to a positive value, indicating when
      *     we ought to retry. */
     gint64 next_try_at_nsec;
@@ -121,6 +124,9 @@ typedef struct {
     CList       lst_peers_head;
     GHashTable *peers;
 
+    /* the pending lookups of the endpoint host names. */
+    NMDeviceHostLookups *host_lookups;
+
     /* counts the numbers of peers that are currently resolving. */
     guint peers_resolving_cnt;
 
@@ -522,7 +528,7 @@ _peers_resolving_cnt(NMDeviceWireGuardPrivate *priv)
         guint     cnt = 0;
 
         c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers) {
-            if (peer_data->ep_resolv.cancellable)
+            if (nm_device_host_lookup_is_pending(&peer_data->ep_resolv.host_lookup))
                 cnt++;
         }
         nm_assert(cnt == priv->peers_resolving_cnt);
@@ -553,6 +559,16 @@ _peers_resolving_cnt_decrement(NMDeviceWireGuard *self)
     }
 }
 
+static void
+_peers_resolve_cancel(NMDeviceWireGuard *self, PeerData *peer_data)
+{
+    NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
+
+    /* Only aborts the lookup, if no other peer is waiting for it. */
+    if (nm_device_host_lookup_cancel(priv->host_lookups, &peer_data->ep_resolv.host_lookup))
+        _peers_resolving_cnt_decrement(self);
+}
+
 static void
 _peers_remove(NMDeviceWireGuard *self, PeerData *peer_data)
 {
@@ -566,8 +582,7 @@ _peers_remove(NMDeviceWireGuard *self, PeerData *peer_data)
 
     c_list_unlink_stale(&peer_data->lst_peers);
     nm_wireguard_peer_unref(peer_data->peer);
-    if (nm_clear_g_cancellable(&peer_data->ep_resolv.cancellable))
-        _peers_resolving_cnt_decrement(self);
+    _peers_resolve_cancel(self, peer_data);
     g_slice_free(PeerData, peer_data);
 
     if (c_list_is_empty(&priv->lst_peers_head)) {
@@ -598,6 +613,7 @@ _peers_add(NMDeviceWireGuard *self, NMWireGuardPeer *peer)
             },
     };
 
+    nm_device_host_lookup_waiter_init(&peer_data->ep_resolv.host_lookup);
     c_list_link_tail(&priv->lst_peers_head, &peer_data->lst_peers);
     if (!g_hash_table_add(priv->peers, peer_data))
         nm_assert_not_reached();
@@ -623,7 +639,7 @@ _peers_resolve_retry_timeout(gpointer user_data)
         if (peer_data->ep_resolv.next_try_at_nsec <= 0)
             continue;
 
-        if (peer_data->ep_resolv.cancellable) {
+        if (nm_device_host_lookup_is_pending(&peer_data->ep_resolv.host_lookup)) {
             /* we are currently resolving a name. We don't need the global
              * watchdog to guard this peer. No need to adjust @next for
              * this one, when the currently ongoing resolving completes, we
@@ -725,34 +741,18 @@ _peers_retry_in_msec(PeerData *peer_data, gboolean after_failure)
 }
 
 static void
-_peers_resolve_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+_peers_resolve_handle_result(NMDeviceWireGuard *self,
+                             PeerData          *peer_data,
+                             GList             *list,
+                             GError            *resolv_error)
 {
-    NMDeviceWireGuard        *self;
-    NMDeviceWireGuardPrivate *priv;
-    PeerData                 *peer_data;
-    gs_free_error GError     *resolv_error = NULL;
-    GList                    *list;
+    NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
     gboolean                  changed;
     NMSockAddrUnion           sockaddr;
     gint64                    retry_in_msec;
     char                      s_sockaddr[100];
     char                      s_retry[100];
 
-    list = g_resolver_lookup_by_name_finish(G_RESOLVER(source_object), res, &resolv_error);
-
-    if (nm_utils_error_is_cancelled(resolv_error))
-        return;
-
-    peer_data = user_data;
-    self      = peer_data->self;
-    priv      = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
-
-    if (nm_clear_g_object(&peer_data->ep_resolv.cancellable))
-        _peers_resolving_cnt_decrement(self);
-
-    nm_assert((!resolv_error) != (!list));
-    nm_assert(_peers_resolving_cnt(priv) == priv->peers_resolving_cnt);
-
 #define _retry_in_msec_to_string(retry_in_msec, s_retry)                               \
     ({                                                                                 \
         gint64 _retry_in_msec = (retry_in_msec);                                       \
@@ -824,8 +824,6 @@ _peers_resolve_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
                 break;
             }
         }
-
-        g_list_free_full(list, g_object_unref);
     }
 
     if (sockaddr.sa.sa_family == AF_UNSPEC) {
@@ -874,18 +872,27 @@ _peers_resolve_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
 }
 
 static void
-_peers_resolve_start(NMDeviceWireGuard *self, PeerData *peer_data)
+_peers_resolve_cb(NMDeviceHostLookupWaiter *waiter,
+                  GList                    *addresses,
+                  GError                   *error,
+                  gpointer                  user_data)
 {
-    NMDeviceWireGuardPrivate  *priv     = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
-    gs_unref_object GResolver *resolver = NULL;
-    const char                *host;
+    NMDeviceWireGuard *self      = user_data;
+    PeerData          *peer_data = c_list_entry(waiter, PeerData, ep_resolv.host_lookup);
 
-    resolver = g_resolver_get_default();
+    nm_assert((!error) != (!addresses));
 
-    nm_assert(!peer_data->ep_resolv.cancellable);
+    _peers_resolving_cnt_decrement(self);
+    _peers_resolve_handle_result(self, peer_data, addresses, error);
+}
 
-    peer_data->ep_resolv.cancellable = g_cancellable_new();
-    priv->peers_resolving_cnt++;
+static void
+_peers_resolve_start(NMDeviceWireGuard *self, PeerData *peer_data)
+{
+    NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
+    const char               *host;
+
+    nm_assert(!nm_device_host_lookup_is_pending(&peer_data->ep_resolv.host_lookup));
 
     /* set a special next-try timestamp. It is positive, and indicates
      * that we are in the process of trying.
@@ -896,17 +903,21 @@ _peers_resolve_start(NMDeviceWireGuard *self, PeerData *peer_data)
 
     host = nm_sock_addr_endpoint_get_host(_nm_wireguard_peer_get_endpoint(peer_data->peer));
 
-    g_resolver_lookup_by_name_async(resolver,
-                                    host,
-                                    peer_data->ep_resolv.cancellable,
-                                    _peers_resolve_cb,
-                                    peer_data);
+    if (nm_device_host_lookup_start(priv->host_lookups, &peer_data->ep_resolv.host_lookup, host)) {
+        _LOGT(LOGD_DEVICE,
+              "wireguard-peer[%s]: resolving name \"%s\" for endpoint \"%s\"...",
+              nm_wireguard_peer_get_public_key(peer_data->peer),
+              host,
+              nm_wireguard_peer_get_endpoint(peer_data->peer));
+    } else {
+        _LOGT(LOGD_DEVICE,
+              "wireguard-peer[%s]: wait for lookup of name \"%s\" for endpoint \"%s\"...",
+              nm_wireguard_peer_get_public_key(peer_data->peer),
+              host,
+              nm_wireguard_peer_get_endpoint(peer_data->peer));
+    }
 
-    _LOGT(LOGD_DEVICE,
-          "wireguard-peer[%s]: resolving name \"%s\" for endpoint \"%s\"...",
-          nm_wireguard_peer_get_public_key(peer_data->peer),
-          host,
-          nm_wireguard_peer_get_endpoint(peer_data->peer));
+    priv->peers_resolving_cnt++;
 
     nm_assert(_peers_resolving_cnt(priv) == priv->peers_resolving_cnt);
 }
@@ -918,7 +929,7 @@ _peers_resolve_reresolve_all(NMDeviceWireGuard *self)
     PeerData                 *peer_data;
 
     c_list_for_each_entry (peer_data, &priv->lst_peers_head, lst_peers) {
-        if (peer_data->ep_resolv.cancellable) {
+        if (nm_device_host_lookup_is_pending(&peer_data->ep_resolv.host_lookup)) {
             /* remember to retry when the currently ongoing request completes. */
             peer_data->ep_resolv.next_try_at_nsec = NEXT_TRY_AT_NSEC_ASAP;
         } else if (peer_data->ep_resolv.next_try_at_nsec <= 0) {
@@ -983,15 +994,11 @@ _peers_update(NMDeviceWireGuard *self,
     if (nm_sock_addr_union_cmp(&peer_data->ep_resolv.sockaddr, &sockaddr) != 0)
         changed = TRUE;
 
-    if (nm_clear_g_cancellable(&peer_data->ep_resolv.cancellable))
-        _peers_resolving_cnt_decrement(self);
+    _peers_resolve_cancel(self, peer_data);
 
-    peer_data->ep_resolv = (PeerEndpointResolveData) {
-        .sockaddr          = sockaddr,
-        .resolv_fail_count = 0,
-        .cancellable       = NULL,
-        .next_try_at_nsec  = 0,
-    };
+    peer_data->ep_resolv.sockaddr          = sockaddr;
+    peer_data->ep_resolv.resolv_fail_count = 0;
+    peer_data->ep_resolv.next_try_at_nsec  = 0;
 
     if (!endpoint) {
         _LOGT(LOGD_DEVICE,
@@ -2061,7 +2068,8 @@ nm_device_wireguard_init(NMDeviceWireGuard *self)
     NMDeviceWireGuardPrivate *priv = NM_DEVICE_WIREGUARD_GET_PRIVATE(self);
 
     c_list_init(&priv->lst_peers_head);
-    priv->peers = g_hash_table_new(_peer_data_hash, _peer_data_equal);
+    priv->peers        = g_hash_table_new(_peer_data_hash, _peer_data_equal);
+    priv->host_lookups = nm_device_host_lookups_new(_peers_resolve_cb, self);
 }
 
 static void
@@ -2088,6 +2096,7 @@ finalize(GObject *object)
     }
 
     g_hash_table_destroy(priv->peers);
+    nm_device_host_lookups_free(priv->host_lookups);
 
     G_OBJECT_CLASS(nm_device_wireguard_parent_class)->finalize(object);
 }
@@ -50,6 +50,7 @@
 #include "dhcp/nm-dhcp-utils.h"
 #include "nm-act-request.h"
 #include "nm-pacrunner-manager.h"
+#include "nm-ping.h"
 #include "dnsmasq/nm-dnsmasq-manager.h"
 #include "nm-ip-config.h"
 #include "nm-dhcp-config.h"
@@ -549,7 +550,6 @@ typedef struct _NMDevicePrivate {
     bool               queued_act_request_is_waiting_for_carrier : 1;
     NMDBusTrackObjPath act_request;
 
-    GSource             *activation_idle_source;
     ActivationHandleFunc activation_func;
 
     guint recheck_assume_id;
@@ -850,7 +850,6 @@ static const char *_activation_func_to_string(ActivationHandleFunc func);
 static void
 _set_state_full(NMDevice *self, NMDeviceState state, NMDeviceStateReason reason, gboolean quitting);
 static void queued_state_clear(NMDevice *device);
-static void ip_check_ping_watch_cb(GPid pid, int status, gpointer user_data);
 static void nm_device_start_ip_check(NMDevice *self);
 static void realize_start_setup(NMDevice             *self,
                                 const NMPlatformLink *plink,
@@ -7325,9 +7324,8 @@ nm_device_update_dynamic_ip_setup(NMDevice *self, const char *reason)
     if (priv->ipdhcp_data_6.state != NM_DEVICE_IP_STATE_NONE)
         _dev_ipdhcpx_restart(self, AF_INET6, FALSE);
 
-    if (priv->ipac6_data.ndisc) {
-        /* FIXME: todo */
-    }
+    if (priv->ipac6_data.ndisc)
+        nm_ndisc_solicit(priv->ipac6_data.ndisc);
     if (priv->ipshared_data_4.v4.dnsmasq_manager) {
         /* FIXME: todo */
     }
@@ -10208,12 +10206,26 @@ nm_device_auth_request(NMDevice                      *self,
 
 /*****************************************************************************/
 
+/* The scheduled activation stages of all devices are queued in one list and
+ * run as a batch from a single idle source, instead of one idle source (and
+ * main loop iteration) per device. A batch stops after a time budget, so that
+ * activating many devices at once doesn't starve the main loop. */
+#define ACTIVATION_BATCH_BUDGET_MSEC 50
+
+static void activation_batch_cb(CList *lst, gpointer user_data);
+
+static NMUtilsIdleBatch _activation_batch = NM_UTILS_IDLE_BATCH_INIT(_activation_batch,
+                                                                     activation_batch_cb,
+                                                                     NULL,
+                                                                     ACTIVATION_BATCH_BUDGET_MSEC);
+
 static void
 activation_source_clear(NMDevice *self)
 {
     NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE(self);
 
-    if (nm_clear_g_source_inst(&priv->activation_idle_source)) {
+    if (c_list_is_linked(&self->activation_lst)) {
+        c_list_unlink(&self->activation_lst);
         _LOGD(LOGD_DEVICE,
               "activation-stage: clear %s",
               _activation_func_to_string(priv->activation_func));
@@ -10221,31 +10233,23 @@ activation_source_clear(NMDevice *self)
     }
 }
 
-static gboolean
-activation_source_handle_cb(gpointer user_data)
+static void
+activation_batch_cb(CList *lst, gpointer user_data)
 {
-    NMDevice            *self = user_data;
-    NMDevicePrivate     *priv;
+    NMDevice            *self = c_list_entry(lst, NMDevice, activation_lst);
+    NMDevicePrivate     *priv = NM_DEVICE_GET_PRIVATE(self);
     ActivationHandleFunc activation_func;
 
-    g_return_val_if_fail(NM_IS_DEVICE(self), G_SOURCE_REMOVE);
-
-    priv = NM_DEVICE_GET_PRIVATE(self);
-
-    g_return_val_if_fail(priv->activation_idle_source, G_SOURCE_REMOVE);
-
     nm_assert(priv->activation_func);
 
     activation_func       = priv->activation_func;
     priv->activation_func = NULL;
 
-    nm_clear_g_source_inst(&priv->activation_idle_source);
-
-    _LOGD(LOGD_DEVICE, "activation-stage: invoke %s", _activation_func_to_string(activation_func));
+    _LOGD(LOGD_DEVICE,
+          "activation-stage: invoke %s",
+          _activation_func_to_string(activation_func));
 
     activation_func(self);
-
-    return G_SOURCE_CONTINUE;
 }
 
 static void
@@ -10253,7 +10257,7 @@ activation_source_schedule(NMDevice *self, ActivationHandleFunc func)
 {
     NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE(self);
 
-    if (priv->activation_idle_source && priv->activation_func == func) {
+    if (c_list_is_linked(&self->activation_lst) && priv->activation_func == func) {
         /* Scheduling the same stage multiple times is fine. */
         _LOGT(LOGD_DEVICE,
               "activation-stage: already scheduled %s",
@@ -10261,18 +10265,18 @@ activation_source_schedule(NMDevice *self, ActivationHandleFunc func)
         return;
     }
 
-    if (priv->activation_idle_source) {
+    if (c_list_is_linked(&self->activation_lst)) {
         _LOGD(LOGD_DEVICE,
               "activation-stage: schedule %s (which replaces %s)",
               _activation_func_to_string(func),
               _activation_func_to_string(priv->activation_func));
-        nm_clear_g_source_inst(&priv->activation_idle_source);
+        c_list_unlink(&self->activation_lst);
     } else {
         _LOGD(LOGD_DEVICE, "activation-stage: schedule %s", _activation_func_to_string(func));
     }
 
-    priv->activation_idle_source = nm_g_idle_add_source(activation_source_handle_cb, self);
-    priv->activation_func        = func;
+    nm_utils_idle_batch_link(&_activation_batch, &self->activation_lst);
+    priv->activation_func = func;
 }
 
 static void
@@ -10280,7 +10284,7 @@ activation_source_invoke_sync(NMDevice *self, ActivationHandleFunc func)
 {
     NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE(self);
 
-    if (!priv->activation_idle_source) {
+    if (!c_list_is_linked(&self->activation_lst)) {
         _LOGD(LOGD_DEVICE,
               "activation-stage: synchronously invoke %s",
               _activation_func_to_string(func));
@@ -10295,7 +10299,7 @@ activation_source_invoke_sync(NMDevice *self, ActivationHandleFunc func)
               _activation_func_to_string(priv->activation_func));
     }
 
-    nm_clear_g_source_inst(&priv->activation_idle_source);
+    c_list_unlink(&self->activation_lst);
     priv->activation_func = NULL;
 
     func(self);
@@ -15272,7 +15276,7 @@ nm_device_is_activating(NMDevice *self)
      * handler is actually run.  If there's an activation handler scheduled
      * we're activating anyway.
      */
-    return !!priv->activation_idle_source;
+    return c_list_is_linked(&self->activation_lst);
 }
 
 NMDhcpConfig *
@@ -15381,31 +15385,27 @@ _dispatcher_complete_proceed_state(NMDispatcherCallId *call_id, gpointer user_da
 /*****************************************************************************/
 
 typedef struct {
-    NMLogDomain log_domain;
-    NMDevice   *device;
-    gboolean    ping_addresses_require_all;
-    GSource    *watch;
-    GPid        pid;
-    char       *binary;
-    char       *address;
-    guint       deadline;
+    NMLogDomain  log_domain;
+    NMDevice    *device;
+    gboolean     ping_addresses_require_all;
+    NMPingProbe *probe;
+    char        *address;
+    int          addr_family;
 } PingOperation;
 
 static PingOperation *
 ping_operation_new(NMDevice   *self,
                    NMLogDomain log_domain,
+                   int         addr_family,
                    const char *address,
-                   const char *ping_binary,
-                   guint       ping_timeout,
                    gboolean    ip_ping_addresses_require_all)
 {
     PingOperation *ping_op = g_new0(PingOperation, 1);
 
     ping_op->device                     = self;
     ping_op->log_domain                 = log_domain;
+    ping_op->addr_family                = addr_family;
     ping_op->address                    = g_strdup(address);
-    ping_op->binary                     = g_strdup(ping_binary);
-    ping_op->deadline                   = ping_timeout + 10;
     ping_op->ping_addresses_require_all = ip_ping_addresses_require_all;
 
     return ping_op;
@@ -15435,149 +15435,51 @@ ip_check_pre_up(NMDevice *self)
 static void
 cleanup_ping_operation(PingOperation *ping_op)
 {
-    if (ping_op->watch) {
-        nm_clear_g_source_inst(&ping_op->watch);
-    }
-
-    if (ping_op->pid) {
-        nm_utils_kill_child_async(ping_op->pid,
-                                  SIGTERM,
-                                  ping_op->log_domain,
-                                  "ping",
-                                  1000,
-                                  NULL,
-                                  NULL);
-        ping_op->pid = 0;
-    }
-
-    nm_clear_g_free(&ping_op->binary);
+    nm_ping_probe_cancel(g_steal_pointer(&ping_op->probe));
     nm_clear_g_free(&ping_op->address);
 
     g_free(ping_op);
 }
 
-static gboolean
-spawn_ping_for_operation(NMDevice *self, PingOperation *ping_op)
-{
-    gs_free char         *str_timeout = NULL;
-    gs_free char         *tmp_str     = NULL;
-    const char           *args[]      = {ping_op->binary,
-                                         "-I",
-                                         nm_device_get_ip_iface(self),
-                                         "-c",
-                                         "1",
-                                         "-w",
-                                         NULL,
-                                         ping_op->address,
-                                         NULL};
-    gs_free_error GError *error       = NULL;
-    gboolean              ret;
-
-    args[6] = str_timeout = g_strdup_printf("%u", ping_op->deadline);
-
-    tmp_str = g_strjoinv(" ", (char **) args);
-    _LOGD(ping_op->log_domain, "ping: running '%s'", tmp_str);
-
-    ret = g_spawn_async("/",
-                        (char **) args,
-                        NULL,
-                        G_SPAWN_DO_NOT_REAP_CHILD,
-                        NULL,
-                        NULL,
-                        &ping_op->pid,
-                        &error);
-
-    if (ret) {
-        ping_op->watch = nm_g_child_watch_add_source(ping_op->pid, ip_check_ping_watch_cb, ping_op);
-    } else {
-        _LOGD(ping_op->log_domain, "ping: could not spawn %s: %s", ping_op->binary, error->message);
-    }
-
-    return ret;
-}
-
-static gboolean
-respawn_ping_cb(gpointer user_data)
-{
-    PingOperation   *ping_op = (PingOperation *) user_data;
-    NMDevice        *self    = ping_op->device;
-    NMDevicePrivate *priv    = NM_DEVICE_GET_PRIVATE(self);
-
-    nm_clear_g_source_inst(&ping_op->watch);
-
-    if (!spawn_ping_for_operation(self, ping_op)) {
-        priv->ping_operations = g_list_remove(priv->ping_operations, ping_op);
-        cleanup_ping_operation(ping_op);
-
-        if (g_list_length(priv->ping_operations) == 0) {
-            ip_check_pre_up(self);
-        }
-    }
-
-    return FALSE;
-}
-
 static void
-ip_check_ping_watch_cb(GPid pid, int status, gpointer user_data)
+ip_check_ping_probe_cb(NMPingProbe *probe, gpointer user_data)
 {
-    PingOperation   *ping_op = (PingOperation *) user_data;
+    PingOperation   *ping_op = user_data;
     NMDevice        *self    = ping_op->device;
     NMDevicePrivate *priv    = NM_DEVICE_GET_PRIVATE(self);
-    gboolean         success = FALSE;
 
-    if (!ping_op->watch)
-        return;
+    nm_assert(ping_op->probe == probe);
 
-    nm_clear_g_source_inst(&ping_op->watch);
-    ping_op->pid = 0;
+    /* The probe is freed after the callback returns. */
+    ping_op->probe = NULL;
 
-    if (WIFEXITED(status)) {
-        if (WEXITSTATUS(status) == 0) {
-            _LOGD(ping_op->log_domain, "ping: ping succeeded on %s", ping_op->address);
-            success = TRUE;
-        } else {
+    _LOGD(ping_op->log_domain, "ping: ping succeeded on %s", ping_op->address);
+
+    if (ping_op->ping_addresses_require_all) {
+        priv->ping_operations = g_list_remove(priv->ping_operations, ping_op);
+        if (g_list_length(priv->ping_operations) == 0) {
             _LOGD(ping_op->log_domain,
-                  "ping: ping failed with error code %d on %s",
-                  WEXITSTATUS(status),
-                  ping_op->address);
+                  "ping: ip-ping-addresses requires all, all ping checks on ip-ping-addresses "
+                  "succeeded");
+            if (priv->ping_timeout)
+                nm_clear_g_source_inst(&priv->ping_timeout);
+            ip_check_pre_up(self);
         }
+        cleanup_ping_operation(ping_op);
     } else {
+        nm_assert(priv->ping_operations);
+
         _LOGD(ping_op->log_domain,
-              "ping: stopped unexpectedly with status %d on %s",
-              status,
-              ping_op->address);
-    }
-
-    if (success) {
-        if (ping_op->ping_addresses_require_all) {
-            priv->ping_operations = g_list_remove(priv->ping_operations, ping_op);
-            if (g_list_length(priv->ping_operations) == 0) {
-                _LOGD(ping_op->log_domain,
-                      "ping: ip-ping-addresses requires all, all ping checks on ip-ping-addresses "
-                      "succeeded");
-                if (priv->ping_timeout)
-                    nm_clear_g_source_inst(&priv->ping_timeout);
-                ip_check_pre_up(self);
-            }
-            cleanup_ping_operation(ping_op);
-        } else {
-            nm_assert(priv->ping_operations);
+              "ping: ip-ping-addresses requires any, one ping check on ip-ping-addresses "
+              "succeeded");
 
-            g_list_free_full(priv->ping_operations, (GDestroyNotify) cleanup_ping_operation);
-            priv->ping_operations = NULL;
+        g_list_free_full(priv->ping_operations, (GDestroyNotify) cleanup_ping_operation);
+        priv->ping_operations = NULL;
 
-            if (priv->ping_timeout)
-                nm_clear_g_source_inst(&priv->ping_timeout);
+        if (priv->ping_timeout)
+            nm_clear_g_source_inst(&priv->ping_timeout);
 
-            _LOGD(ping_op->log_domain,
-                  "ping: ip-ping-addresses requires any, one ping check on ip-ping-addresses "
-                  "succeeded");
-            ip_check_pre_up(self);
-        }
-    } else {
-        /* If ping exited with an error it may have returned early,
-         * wait 1 second and restart it */
-        ping_op->watch = nm_g_timeout_add_seconds_source(1, respawn_ping_cb, ping_op);
+        ip_check_pre_up(self);
     }
 }
 
@@ -15604,13 +15506,34 @@ ip_check_ping_timeout_cb(gpointer user_data)
 static gboolean
 start_ping(NMDevice *self, PingOperation *ping_op)
 {
-    NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE(self);
+    NMDevicePrivate      *priv    = NM_DEVICE_GET_PRIVATE(self);
+    gs_free_error GError *error   = NULL;
+    int                   ifindex = nm_device_get_ip_ifindex(self);
+    NMIPAddr              addr;
+
+    if (!nm_inet_parse_bin(ping_op->addr_family, ping_op->address, NULL, &addr))
+        nm_assert_not_reached();
 
-    if (spawn_ping_for_operation(self, ping_op)) {
+    if (ifindex <= 0) {
+        _LOGD(ping_op->log_domain, "ping: could not ping %s: no interface", ping_op->address);
+        cleanup_ping_operation(ping_op);
+        return FALSE;
+    }
+
+    _LOGD(ping_op->log_domain, "ping: start pinging %s", ping_op->address);
+
+    ping_op->probe = nm_ping_probe_start(ping_op->addr_family,
+                                         &addr,
+                                         ifindex,
+                                         ip_check_ping_probe_cb,
+                                         ping_op,
+                                         &error);
+    if (ping_op->probe) {
         priv->ping_operations = g_list_append(priv->ping_operations, ping_op);
         return TRUE;
     }
 
+    _LOGD(ping_op->log_domain, "ping: could not ping %s: %s", ping_op->address, error->message);
     cleanup_ping_operation(ping_op);
     return FALSE;
 }
@@ -15623,9 +15546,9 @@ nm_device_start_ip_check(NMDevice *self)
     NMSettingConnection *s_con;
     guint                gw_ping_timeout = 0;
     guint                ip_ping_timeout = 0;
-    const char          *ping_binary     = NULL;
     char                 buf[NM_INET_ADDRSTRLEN];
-    NMLogDomain          log_domain = LOGD_IP4;
+    NMLogDomain          log_domain  = LOGD_IP4;
+    int                  addr_family = AF_INET;
     gboolean             ip_ping_addresses_require_all;
     gboolean             ping_started = FALSE;
 
@@ -15660,15 +15583,15 @@ nm_device_start_ip_check(NMDevice *self)
             gw = nm_l3_config_data_get_best_default_route(l3cd, AF_INET);
             if (gw) {
                 nm_inet4_ntop(NMP_OBJECT_CAST_IP4_ROUTE(gw)->gateway, buf);
-                ping_binary = nm_utils_find_helper("ping", "/usr/bin/ping", NULL);
                 log_domain  = LOGD_IP4;
+                addr_family = AF_INET;
             }
         } else if (priv->ip_data_6.state == NM_DEVICE_IP_STATE_READY) {
             gw = nm_l3_config_data_get_best_default_route(l3cd, AF_INET6);
             if (gw) {
                 nm_inet6_ntop(&NMP_OBJECT_CAST_IP6_ROUTE(gw)->gateway, buf);
-                ping_binary = nm_utils_find_helper("ping6", "/usr/bin/ping6", NULL);
                 log_domain  = LOGD_IP6;
+                addr_family = AF_INET6;
             }
         }
     }
@@ -15676,9 +15599,8 @@ nm_device_start_ip_check(NMDevice *self)
     if (buf[0]) {
         PingOperation *ping_op = ping_operation_new(self,
                                                     log_domain,
+                                                    addr_family,
                                                     buf,
-                                                    ping_binary,
-                                                    gw_ping_timeout,
                                                     ip_ping_addresses_require_all);
 
         if (start_ping(self, ping_op))
@@ -15703,21 +15625,20 @@ nm_device_start_ip_check(NMDevice *self)
 
                 if (priv->ip_data_4.state == NM_DEVICE_IP_STATE_READY
                     && inet_pton(AF_INET, (const char *) s, &ipv4_addr)) {
-                    ping_binary = nm_utils_find_helper("ping", "/usr/bin/ping", NULL);
                     log_domain  = LOGD_IP4;
+                    addr_family = AF_INET;
                 } else if (priv->ip_data_6.state == NM_DEVICE_IP_STATE_READY
                            && inet_pton(AF_INET6, (const char *) s, &ipv6_addr)) {
-                    ping_binary = nm_utils_find_helper("ping6", "/usr/bin/ping6", NULL);
                     log_domain  = LOGD_IP6;
+                    addr_family = AF_INET6;
                 } else
                     continue;
 
                 if (s[0]) {
                     PingOperation *ping_op = ping_operation_new(self,
                                                                 log_domain,
+                                                                addr_family,
                                                                 s,
-                                                                ping_binary,
-                                                                ip_ping_timeout,
                                                                 ip_ping_addresses_require_all);
 
                     if (start_ping(self, ping_op))
@@ -19604,6 +19525,7 @@ nm_device_init(NMDevice *self)
     c_list_init(&self->devices_lst);
     c_list_init(&self->devcon_dev_lst_head);
     c_list_init(&self->policy_auto_activate_lst);
+    c_list_init(&self->activation_lst);
     c_list_init(&priv->ports);
 
     priv->ipdhcp_data_6.v6.mode = NM_NDISC_DHCP_LEVEL_NONE;
@@ -19732,6 +19654,8 @@ dispose(GObject *object)
     nm_assert(c_list_is_empty(&self->policy_auto_activate_lst));
     nm_assert(!self->policy_auto_activate_idle_source);
 
+    activation_source_clear(self);
+
     while ((con_handle = c_list_first_entry(&priv->concheck_lst_head,
                                             NMDeviceConnectivityHandle,
                                             concheck_lst))) {
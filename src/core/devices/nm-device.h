@@ -147,6 +147,8 @@ struct _NMDevice {
 
     CList    policy_auto_activate_lst;
     GSource *policy_auto_activate_idle_source;
+
+    CList activation_lst;
 };
 
 /* The flags have an relaxing meaning, that means, specifying more flags, can make
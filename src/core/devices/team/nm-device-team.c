@@ -12,7 +12,6 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
-#include <teamdctl.h>
 #include <stdlib.h>
 
 #include "libnm-glib-aux/nm-jansson.h"
@@ -24,6 +23,7 @@
 #include "libnm-core-intern/nm-core-internal.h"
 #include "nm-dbus-manager.h"
 #include "libnm-std-aux/nm-dbus-compat.h"
+#include "nm-teamd-ctl.h"
 
 #define _NMLOG_DEVICE_TYPE NMDeviceTeam
 #include "devices/nm-device-logging.h"
@@ -33,7 +33,8 @@
 NM_GOBJECT_PROPERTIES_DEFINE(NMDeviceTeam, PROP_CONFIG, );
 
 typedef struct {
-    struct teamdctl   *tdc;
+    NMTeamdCtl        *tdc;
+    char              *tdc_config;
     char              *config;
     GPid               teamd_pid;
     guint              teamd_process_watch;
@@ -41,9 +42,12 @@ typedef struct {
     guint              teamd_read_timeout;
     guint              teamd_dbus_watch;
     bool               kill_in_progress : 1;
+    bool               tdc_config_pending : 1;
+    bool               stage1_wait_tdc_config : 1;
     GFileMonitor      *usock_monitor;
     NMDeviceStageState stage1_state : 3;
     GHashTable        *port_configs;
+    GHashTable        *port_configs_actual;
 } NMDeviceTeamPrivate;
 
 struct _NMDeviceTeam {
@@ -62,53 +66,38 @@ G_DEFINE_TYPE(NMDeviceTeam, nm_device_team, NM_TYPE_DEVICE)
 
 /*****************************************************************************/
 
-static gboolean teamd_start(NMDeviceTeam *self);
+typedef enum {
+    READ_CONFIG_MODE_NONE,
+    READ_CONFIG_MODE_RECHECK_ASSUME,
+    READ_CONFIG_MODE_FAIL_ON_ERROR,
+    READ_CONFIG_MODE_STAGE1,
+} ReadConfigMode;
 
-/*****************************************************************************/
+typedef struct {
+    NMDeviceTeam  *self;
+    ReadConfigMode mode;
+} ReadConfigData;
 
-static struct teamdctl *
-_tdc_connect_new(NMDeviceTeam *self, const char *iface, GError **error)
-{
-    NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
-    struct teamdctl     *tdc;
-    const char          *cli_type;
-    int                  r;
-
-    tdc = teamdctl_alloc();
-    if (!tdc) {
-        nm_utils_error_set(error, NM_UTILS_ERROR_UNKNOWN, "failure to allocate teamdctl structure");
-        g_return_val_if_reached(NULL);
-    }
+typedef struct {
+    NMDeviceTeam *self;
+    NMDevice     *port;
+    char         *port_iface;
+} PortCallData;
 
-    if (priv->teamd_dbus_watch)
-        cli_type = "dbus";
-    else if (priv->usock_monitor)
-        cli_type = "usock";
-    else
-        cli_type = NULL;
+typedef struct {
+    NMDevice                  *device;
+    NMDevice                  *port;
+    GCancellable              *cancellable;
+    NMDeviceAttachPortCallback callback;
+    gpointer                   callback_user_data;
+} AttachPortData;
 
-again:
-    r = teamdctl_connect(tdc, iface, NULL, cli_type);
-    if (r != 0) {
-        _LOGD(LOGD_TEAM,
-              "failure to connect to teamdctl%s%s, err=%d",
-              NM_PRINT_FMT_QUOTED2(cli_type, " with cli_type=", cli_type, ""),
-              r);
-        if (cli_type) {
-            /* How odd. Let's retry with any CLI type. */
-            cli_type = NULL;
-            goto again;
-        }
-        teamdctl_free(tdc);
-        nm_utils_error_set(error,
-                           NM_UTILS_ERROR_UNKNOWN,
-                           "failure to connect to teamd (err=%d)",
-                           r);
-        return NULL;
-    }
+/*****************************************************************************/
 
-    return tdc;
-}
+static gboolean teamd_start(NMDeviceTeam *self);
+static void     teamd_cleanup(NMDeviceTeam *self, gboolean free_tdc);
+
+/*****************************************************************************/
 
 static NMDeviceCapabilities
 get_generic_capabilities(NMDevice *device)
@@ -137,24 +126,86 @@ complete_connection(NMDevice            *device,
     return TRUE;
 }
 
-static gboolean
+static PortCallData *
+_port_call_data_new(NMDeviceTeam *self, NMDevice *port, const char *port_iface)
+{
+    PortCallData *data;
+
+    data  = g_slice_new(PortCallData);
+    *data = (PortCallData) {
+        .self       = self,
+        .port       = nm_g_object_ref(port),
+        .port_iface = g_strdup(port_iface),
+    };
+    return data;
+}
+
+static void
+_port_call_data_free(PortCallData *data)
+{
+    nm_g_object_unref(data->port);
+    g_free(data->port_iface);
+    nm_g_slice_free(data);
+}
+
+static void
+_update_port_config_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    PortCallData *data = user_data;
+    NMDeviceTeam *self = data->self;
+
+    if (error && !nm_utils_error_is_cancelled(error)) {
+        _LOGE(LOGD_TEAM,
+              "failed to update config for port %s: %s",
+              data->port_iface,
+              error->message);
+    }
+
+    _port_call_data_free(data);
+}
+
+static void
 _update_port_config(NMDeviceTeam *self, const char *port_iface, const char *sanitized_config)
 {
     NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
-    int                  err;
 
     _LOGT(LOGD_TEAM, "setting port config: %s", sanitized_config);
-    err = teamdctl_port_config_update_raw(priv->tdc, port_iface, sanitized_config);
-    if (err != 0) {
-        _LOGE(LOGD_TEAM, "failed to update config for port %s (err=%d)", port_iface, err);
-        return FALSE;
-    }
+    nm_teamd_ctl_call(priv->tdc,
+                      NM_TEAMD_CTL_METHOD_PORT_CONFIG_UPDATE,
+                      NM_MAKE_STRV(port_iface, sanitized_config),
+                      _update_port_config_cb,
+                      _port_call_data_new(self, NULL, port_iface));
+}
 
-    return TRUE;
+static void
+_tdc_config_dump_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    NMDeviceTeam        *self = user_data;
+    NMDeviceTeamPrivate *priv;
+
+    if (nm_utils_error_is_cancelled(error))
+        return;
+
+    priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
+
+    if (error)
+        _LOGD(LOGD_TEAM, "failed to get teamd config: %s", error->message);
+
+    priv->tdc_config_pending = FALSE;
+    nm_strdup_reset(&priv->tdc_config, reply);
+
+    if (priv->stage1_wait_tdc_config) {
+        priv->stage1_wait_tdc_config = FALSE;
+        if (nm_device_get_state(NM_DEVICE(self)) == NM_DEVICE_STATE_PREPARE)
+            nm_device_activate_schedule_stage1_device_prepare(NM_DEVICE(self), FALSE);
+    }
 }
 
+static void teamd_read_config(NMDeviceTeam *self, ReadConfigMode mode);
+
+/* @mode is how to read the configuration if a new connection is made. */
 static gboolean
-ensure_teamd_connection(NMDevice *device, GError **error)
+ensure_teamd_connection(NMDevice *device, ReadConfigMode mode, GError **error)
 {
     NMDeviceTeam        *self = NM_DEVICE_TEAM(device);
     NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
@@ -165,10 +216,17 @@ ensure_teamd_connection(NMDevice *device, GError **error)
     if (priv->tdc)
         return TRUE;
 
-    priv->tdc = _tdc_connect_new(self, nm_device_get_iface(device), error);
+    priv->tdc = nm_teamd_ctl_new(nm_device_get_iface(device), error);
     if (!priv->tdc)
         return FALSE;
 
+    /* Like libteamdctl did on connect, remember the configuration that teamd
+     * was started with. act_stage1_prepare() compares it with the profile. */
+    priv->tdc_config_pending = TRUE;
+    nm_teamd_ctl_call(priv->tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _tdc_config_dump_cb, self);
+
+    teamd_read_config(self, mode);
+
     g_hash_table_iter_init(&iter, priv->port_configs);
     while (g_hash_table_iter_next(&iter, (gpointer *) &port_iface, (gpointer *) &port_config))
         _update_port_config(self, port_iface, port_config);
@@ -182,30 +240,96 @@ _get_config(NMDeviceTeam *self)
     return nm_str_not_empty(NM_DEVICE_TEAM_GET_PRIVATE(self)->config);
 }
 
-static gboolean
-teamd_read_config(NMDeviceTeam *self)
+static void
+_set_config(NMDeviceTeam *self, const char *config)
 {
-    NMDeviceTeamPrivate *priv   = NM_DEVICE_TEAM_GET_PRIVATE(self);
-    const char          *config = NULL;
-    int                  err;
+    NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
 
-    if (priv->tdc) {
-        err = teamdctl_config_actual_get_raw_direct(priv->tdc, (char **) &config);
-        if (err)
-            return FALSE;
-        if (!config) {
-            /* set "" to distinguish an empty result from no config at all. */
-            config = "";
+    if (nm_strdup_reset(&priv->config, config))
+        _notify(self, PROP_CONFIG);
+}
+
+static void
+teamd_read_config_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    ReadConfigData *data   = user_data;
+    NMDeviceTeam   *self   = data->self;
+    ReadConfigMode  mode   = data->mode;
+    NMDevice       *device = NM_DEVICE(self);
+    NMDeviceState   state;
+
+    nm_g_slice_free(data);
+
+    if (nm_utils_error_is_cancelled(error))
+        return;
+
+    state = nm_device_get_state(device);
+
+    if (error) {
+        if (mode != READ_CONFIG_MODE_FAIL_ON_ERROR && mode != READ_CONFIG_MODE_STAGE1) {
+            _LOGD(LOGD_TEAM, "failed to read teamd configuration: %s", error->message);
+            return;
         }
+
+        _LOGW(LOGD_TEAM, "failed to read teamd configuration: %s", error->message);
+
+        if (mode == READ_CONFIG_MODE_STAGE1) {
+            if (state != NM_DEVICE_STATE_PREPARE
+                || NM_DEVICE_TEAM_GET_PRIVATE(self)->stage1_state != NM_DEVICE_STAGE_STATE_PENDING)
+                return;
+            teamd_cleanup(self, TRUE);
+        } else if (state < NM_DEVICE_STATE_PREPARE || state > NM_DEVICE_STATE_ACTIVATED)
+            return;
+
+        nm_device_state_changed(device,
+                                NM_DEVICE_STATE_FAILED,
+                                NM_DEVICE_STATE_REASON_TEAMD_CONTROL_FAILED);
+        return;
     }
 
-    if (!nm_streq0(config, priv->config)) {
-        g_free(priv->config);
-        priv->config = g_strdup(config);
-        _notify(self, PROP_CONFIG);
+    /* A successful reply is never NULL, "" distinguishes an empty result
+     * from no config at all. */
+    _set_config(self, reply);
+
+    switch (mode) {
+    case READ_CONFIG_MODE_RECHECK_ASSUME:
+        /* The generated connection now has the team config. */
+        nm_device_queue_recheck_assume(device);
+        break;
+    case READ_CONFIG_MODE_STAGE1:
+        if (state != NM_DEVICE_STATE_PREPARE
+            || NM_DEVICE_TEAM_GET_PRIVATE(self)->stage1_state != NM_DEVICE_STAGE_STATE_PENDING)
+            break;
+        NM_DEVICE_TEAM_GET_PRIVATE(self)->stage1_state = NM_DEVICE_STAGE_STATE_COMPLETED;
+        nm_device_activate_schedule_stage1_device_prepare(device, FALSE);
+        break;
+    default:
+        break;
     }
+}
 
-    return TRUE;
+static void
+teamd_read_config(NMDeviceTeam *self, ReadConfigMode mode)
+{
+    NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
+    ReadConfigData      *data;
+
+    if (!priv->tdc) {
+        nm_assert(mode != READ_CONFIG_MODE_STAGE1);
+        _set_config(self, NULL);
+        return;
+    }
+
+    data  = g_slice_new(ReadConfigData);
+    *data = (ReadConfigData) {
+        .self = self,
+        .mode = mode,
+    };
+    nm_teamd_ctl_call(priv->tdc,
+                      NM_TEAMD_CTL_METHOD_CONFIG_DUMP_ACTUAL,
+                      NULL,
+                      teamd_read_config_cb,
+                      data);
 }
 
 static gboolean
@@ -215,7 +339,7 @@ teamd_read_timeout_cb(gpointer user_data)
     NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
 
     priv->teamd_read_timeout = 0;
-    teamd_read_config(self);
+    teamd_read_config(self, READ_CONFIG_MODE_NONE);
     return G_SOURCE_REMOVE;
 }
 
@@ -226,9 +350,10 @@ update_connection(NMDevice *device, NMConnection *connection)
     NMSettingTeam       *s_team = _nm_connection_ensure_setting(connection, NM_TYPE_SETTING_TEAM);
     NMDeviceTeamPrivate *priv   = NM_DEVICE_TEAM_GET_PRIVATE(self);
 
-    /* Read the configuration only if not already set */
+    /* Read the configuration only if not already set. The reply arrives
+     * asynchronously and triggers another assume check. */
     if (!priv->config && priv->tdc) {
-        teamd_read_config(self);
+        teamd_read_config(self, READ_CONFIG_MODE_RECHECK_ASSUME);
     }
 
     g_object_set(G_OBJECT(s_team), NM_SETTING_TEAM_CONFIG, _get_config(self), NULL);
@@ -236,6 +361,38 @@ update_connection(NMDevice *device, NMConnection *connection)
 
 /*****************************************************************************/
 
+static void
+_port_config_dump_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    PortCallData        *data = user_data;
+    NMDeviceTeam        *self = data->self;
+    NMDeviceTeamPrivate *priv;
+
+    if (nm_utils_error_is_cancelled(error))
+        goto out;
+
+    priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
+
+    if (error) {
+        _LOGD(LOGD_TEAM,
+              "failed to get configuration of port %s from teamd: %s",
+              data->port_iface,
+              error->message);
+        goto out;
+    }
+
+    if (nm_streq0(g_hash_table_lookup(priv->port_configs_actual, data->port_iface), reply))
+        goto out;
+
+    g_hash_table_insert(priv->port_configs_actual, g_strdup(data->port_iface), g_strdup(reply));
+
+    /* controller_update_port_connection() can now provide the port config. */
+    nm_device_queue_recheck_assume(data->port);
+
+out:
+    _port_call_data_free(data);
+}
+
 static gboolean
 controller_update_port_connection(NMDevice     *device,
                                   NMDevice     *port,
@@ -243,18 +400,15 @@ controller_update_port_connection(NMDevice     *device,
                                   GError      **error)
 {
     NMDeviceTeam         *self = NM_DEVICE_TEAM(device);
+    NMDeviceTeamPrivate  *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
     NMSettingTeamPort    *s_port;
-    char                 *port_config   = NULL;
-    gs_free_error GError *connect_error = NULL;
-    int                   err           = 0;
-    struct teamdctl      *tdc;
-    const char           *team_port_config   = NULL;
+    gs_free_error GError *connect_error      = NULL;
+    const char           *port_config        = NULL;
     const char           *iface              = nm_device_get_iface(device);
     const char           *iface_port         = nm_device_get_iface(port);
     NMConnection         *applied_connection = nm_device_get_applied_connection(device);
 
-    tdc = _tdc_connect_new(self, iface, &connect_error);
-    if (!tdc) {
+    if (!ensure_teamd_connection(device, READ_CONFIG_MODE_RECHECK_ASSUME, &connect_error)) {
         g_set_error(
             error,
             NM_DEVICE_ERROR,
@@ -267,27 +421,29 @@ controller_update_port_connection(NMDevice     *device,
         return FALSE;
     }
 
-    err         = teamdctl_port_config_get_raw_direct(tdc, iface_port, (char **) &team_port_config);
-    port_config = g_strdup(team_port_config);
-    teamdctl_disconnect(tdc);
-    teamdctl_free(tdc);
-    if (err) {
+    /* Always refresh the cached port configuration. If it changed, the reply
+     * triggers another assume check for the port. */
+    nm_teamd_ctl_call(priv->tdc,
+                      NM_TEAMD_CTL_METHOD_PORT_CONFIG_DUMP,
+                      NM_MAKE_STRV(iface_port),
+                      _port_config_dump_cb,
+                      _port_call_data_new(self, port, iface_port));
+
+    port_config = g_hash_table_lookup(priv->port_configs_actual, iface_port);
+    if (!port_config) {
         g_set_error(error,
                     NM_DEVICE_ERROR,
                     NM_DEVICE_ERROR_FAILED,
-                    "update port connection for port '%s' failed to get configuration from teamd "
-                    "controller %s (err=%d)",
+                    "update port connection for port '%s' is waiting for the configuration "
+                    "from teamd controller %s",
                     iface_port,
-                    iface,
-                    err);
-        g_free(port_config);
+                    iface);
         return FALSE;
     }
 
     s_port = _nm_connection_ensure_setting(connection, NM_TYPE_SETTING_TEAM_PORT);
 
     g_object_set(G_OBJECT(s_port), NM_SETTING_TEAM_PORT_CONFIG, port_config, NULL);
-    g_free(port_config);
 
     g_object_set(nm_connection_get_setting_connection(connection),
                  NM_SETTING_CONNECTION_CONTROLLER,
@@ -343,9 +499,11 @@ teamd_cleanup(NMDeviceTeam *self, gboolean free_tdc)
     }
 
     if (priv->tdc && free_tdc) {
-        teamdctl_disconnect(priv->tdc);
-        teamdctl_free(priv->tdc);
-        priv->tdc = NULL;
+        nm_clear_pointer(&priv->tdc, nm_teamd_ctl_free);
+        nm_clear_g_free(&priv->tdc_config);
+        priv->tdc_config_pending = FALSE;
+        if (priv->port_configs_actual)
+            g_hash_table_remove_all(priv->port_configs_actual);
     }
 }
 
@@ -372,12 +530,7 @@ teamd_timeout_cb(gpointer user_data)
         /* Read again the configuration after the timeout since it might
          * have changed.
          */
-        if (!teamd_read_config(self)) {
-            _LOGW(LOGD_TEAM, "failed to read teamd configuration");
-            nm_device_state_changed(device,
-                                    NM_DEVICE_STATE_FAILED,
-                                    NM_DEVICE_STATE_REASON_TEAMD_CONTROL_FAILED);
-        }
+        teamd_read_config(self, READ_CONFIG_MODE_FAIL_ON_ERROR);
     }
 
     return G_SOURCE_REMOVE;
@@ -389,6 +542,8 @@ teamd_ready(NMDeviceTeam *self)
     NMDeviceTeamPrivate *priv   = NM_DEVICE_TEAM_GET_PRIVATE(self);
     NMDevice            *device = NM_DEVICE(self);
     gboolean             success;
+    gboolean             stage1;
+    gboolean             had_tdc;
     GError              *error = NULL;
 
     if (priv->kill_in_progress) {
@@ -399,23 +554,26 @@ teamd_ready(NMDeviceTeam *self)
 
     nm_device_queue_recheck_assume(device);
 
+    stage1 = nm_device_get_state(device) == NM_DEVICE_STATE_PREPARE
+             && priv->stage1_state == NM_DEVICE_STAGE_STATE_PENDING;
+
     /* Grab a teamd control handle even if we aren't going to use it
      * immediately.  But if we are, and grabbing it failed, fail the
      * device activation.
      */
-    success = ensure_teamd_connection(device, &error);
+    had_tdc = !!priv->tdc;
+    success = ensure_teamd_connection(device,
+                                      stage1 ? READ_CONFIG_MODE_STAGE1
+                                             : READ_CONFIG_MODE_RECHECK_ASSUME,
+                                      &error);
     if (!success) {
         _LOGW(LOGD_TEAM, "could not connect to teamd: %s", error->message);
         g_clear_error(&error);
     }
 
-    if (nm_device_get_state(device) != NM_DEVICE_STATE_PREPARE
-        || priv->stage1_state != NM_DEVICE_STAGE_STATE_PENDING)
+    if (!stage1)
         return;
 
-    if (success)
-        success = teamd_read_config(self);
-
     if (!success) {
         teamd_cleanup(self, TRUE);
         nm_device_state_changed(device,
@@ -424,8 +582,10 @@ teamd_ready(NMDeviceTeam *self)
         return;
     }
 
-    priv->stage1_state = NM_DEVICE_STAGE_STATE_COMPLETED;
-    nm_device_activate_schedule_stage1_device_prepare(device, FALSE);
+    /* Stage1 completes once the configuration is read. A new connection
+     * already requested it. */
+    if (had_tdc)
+        teamd_read_config(self, READ_CONFIG_MODE_STAGE1);
 }
 
 static void
@@ -591,12 +751,20 @@ teamd_env(void)
     return env;
 }
 
+static void
+teamd_kill_watch_cb(GPid pid, int status, gpointer user_data)
+{
+    teamd_kill_cb(pid, WIFEXITED(status) && WEXITSTATUS(status) == 0, status, user_data);
+}
+
 static gboolean
 teamd_kill(NMDeviceTeam *self, const char *teamd_binary, GError **error)
 {
+    NMDeviceTeamPrivate         *priv    = NM_DEVICE_TEAM_GET_PRIVATE(self);
     gs_unref_ptrarray GPtrArray *argv    = NULL;
     gs_free char                *tmp_str = NULL;
     gs_free const char         **envp    = NULL;
+    GPid                         pid;
 
     if (!teamd_binary) {
         teamd_binary = nm_utils_find_helper("teamd", NULL, error);
@@ -616,16 +784,21 @@ teamd_kill(NMDeviceTeam *self, const char *teamd_binary, GError **error)
     envp = teamd_env();
 
     _LOGD(LOGD_TEAM, "running: %s", (tmp_str = g_strjoinv(" ", (char **) argv->pdata)));
-    return g_spawn_sync("/",
-                        (char **) argv->pdata,
-                        (char **) envp,
-                        0,
-                        teamd_child_setup,
-                        NULL,
-                        NULL,
-                        NULL,
-                        NULL,
-                        error);
+    if (!g_spawn_async("/",
+                       (char **) argv->pdata,
+                       (char **) envp,
+                       G_SPAWN_DO_NOT_REAP_CHILD,
+                       teamd_child_setup,
+                       NULL,
+                       &pid,
+                       error))
+        return FALSE;
+
+    /* Don't wait for "teamd -k". Like when killing our own teamd, a new
+     * instance is only started from teamd_kill_cb(). */
+    priv->kill_in_progress = TRUE;
+    g_child_watch_add(pid, teamd_kill_watch_cb, g_object_ref(self));
+    return TRUE;
 }
 
 static gboolean
@@ -766,7 +939,7 @@ act_stage1_prepare(NMDevice *device, NMDeviceStateReason *out_failure_reason)
         return NM_ACT_STAGE_RETURN_SUCCESS;
 
     if (nm_device_managed_type_is_external_or_assume(device)) {
-        if (ensure_teamd_connection(device, &error))
+        if (ensure_teamd_connection(device, READ_CONFIG_MODE_RECHECK_ASSUME, &error))
             return NM_ACT_STAGE_RETURN_SUCCESS;
         _LOGD(LOGD_TEAM, "could not connect to teamd: %s", error->message);
         g_clear_error(&error);
@@ -782,6 +955,13 @@ act_stage1_prepare(NMDevice *device, NMDeviceStateReason *out_failure_reason)
     if (priv->stage1_state == NM_DEVICE_STAGE_STATE_COMPLETED)
         return NM_ACT_STAGE_RETURN_SUCCESS;
 
+    if (priv->tdc && priv->tdc_config_pending) {
+        /* _tdc_config_dump_cb() schedules stage1 again. */
+        _LOGT(LOGD_TEAM, "waiting for teamd config");
+        priv->stage1_wait_tdc_config = TRUE;
+        return NM_ACT_STAGE_RETURN_POSTPONE;
+    }
+
     priv->stage1_state = NM_DEVICE_STAGE_STATE_PENDING;
 
     if (priv->tdc) {
@@ -790,14 +970,14 @@ act_stage1_prepare(NMDevice *device, NMDeviceStateReason *out_failure_reason)
          * kill it so we can respawn it with the right config.  If we don't
          * have a PID, then we must fail.
          */
-        cfg = teamdctl_config_get_raw(priv->tdc);
+        cfg = priv->tdc_config;
         if (cfg && nm_streq0(cfg, nm_setting_team_get_config(s_team))) {
             _LOGD(LOGD_TEAM, "using existing matching teamd config");
             return NM_ACT_STAGE_RETURN_SUCCESS;
         }
 
         if (!priv->teamd_pid) {
-            _LOGD(LOGD_TEAM, "existing teamd config mismatch; killing existing via teamdctl");
+            _LOGD(LOGD_TEAM, "existing teamd config mismatch; killing existing via teamd -k");
             if (!teamd_kill(self, NULL, &error)) {
                 _LOGW(LOGD_TEAM,
                       "existing teamd config mismatch; failed to kill existing teamd: %s",
@@ -829,7 +1009,8 @@ deactivate(NMDevice *device)
     NMDeviceTeam        *self = NM_DEVICE_TEAM(device);
     NMDeviceTeamPrivate *priv = NM_DEVICE_TEAM_GET_PRIVATE(self);
 
-    priv->stage1_state = NM_DEVICE_STAGE_STATE_INIT;
+    priv->stage1_state           = NM_DEVICE_STAGE_STATE_INIT;
+    priv->stage1_wait_tdc_config = FALSE;
 
     if (nm_device_managed_type_is_external(device))
         return;
@@ -843,6 +1024,67 @@ deactivate(NMDevice *device)
     teamd_cleanup(self, TRUE);
 }
 
+static gboolean
+_attach_port_link(NMDeviceTeam *self, NMDevice *port)
+{
+    NMDevice            *device     = NM_DEVICE(self);
+    NMDeviceTeamPrivate *priv       = NM_DEVICE_TEAM_GET_PRIVATE(self);
+    const char          *port_iface = nm_device_get_ip_iface(port);
+    gboolean             success;
+
+    success = nm_platform_link_attach_port(nm_device_get_platform(device),
+                                           nm_device_get_ip_ifindex(device),
+                                           nm_device_get_ip_ifindex(port));
+    nm_device_bring_up(port);
+
+    if (!success)
+        return FALSE;
+
+    nm_clear_g_source(&priv->teamd_read_timeout);
+    priv->teamd_read_timeout = g_timeout_add_seconds(5, teamd_read_timeout_cb, self);
+
+    _LOGI(LOGD_TEAM, "attached team port %s", port_iface);
+    return TRUE;
+}
+
+static void
+_attach_port_config_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    AttachPortData       *data = user_data;
+    NMDeviceTeam         *self = NM_DEVICE_TEAM(data->device);
+    gs_free_error GError *local = NULL;
+
+    if (g_cancellable_set_error_if_cancelled(data->cancellable, &local))
+        error = local;
+    else if (error) {
+        _LOGE(LOGD_TEAM,
+              "failed to update config for port %s: %s",
+              nm_device_get_ip_iface(data->port),
+              error->message);
+        if (nm_utils_error_is_cancelled(error)) {
+            /* The teamd connection was closed, but the attachment was not
+             * cancelled. That is a failure. */
+            local = g_error_new_literal(NM_DEVICE_ERROR,
+                                        NM_DEVICE_ERROR_FAILED,
+                                        "connection to teamd closed");
+            error = local;
+        }
+    } else if (!_attach_port_link(self, data->port)) {
+        local = g_error_new(NM_DEVICE_ERROR,
+                            NM_DEVICE_ERROR_FAILED,
+                            "failed to attach team port %s",
+                            nm_device_get_ip_iface(data->port));
+        error = local;
+    }
+
+    data->callback(data->device, error, data->callback_user_data);
+
+    g_object_unref(data->device);
+    g_object_unref(data->port);
+    g_object_unref(data->cancellable);
+    nm_g_slice_free(data);
+}
+
 static NMTernary
 attach_port(NMDevice                  *device,
             NMDevice                  *port,
@@ -854,7 +1096,6 @@ attach_port(NMDevice                  *device,
 {
     NMDeviceTeam        *self       = NM_DEVICE_TEAM(device);
     NMDeviceTeamPrivate *priv       = NM_DEVICE_TEAM_GET_PRIVATE(self);
-    gboolean             success    = TRUE;
     const char          *port_iface = nm_device_get_ip_iface(port);
     NMSettingTeamPort   *s_team_port;
 
@@ -871,31 +1112,40 @@ attach_port(NMDevice                  *device,
             g_strdelimit(sanitized_config, "\r\n", ' ');
 
             g_hash_table_insert(priv->port_configs, g_strdup(port_iface), sanitized_config);
+            g_hash_table_remove(priv->port_configs_actual, port_iface);
 
             if (!priv->tdc) {
                 _LOGW(LOGD_TEAM,
                       "attached team port %s config not changed, not connected to teamd",
                       port_iface);
             } else {
-                if (!_update_port_config(self, port_iface, sanitized_config))
-                    return FALSE;
+                AttachPortData *data;
+
+                /* teamd must know the port config before the port gets
+                 * attached. Attach once it acknowledged the update. */
+                data  = g_slice_new(AttachPortData);
+                *data = (AttachPortData) {
+                    .device             = g_object_ref(device),
+                    .port               = g_object_ref(port),
+                    .cancellable        = g_object_ref(cancellable),
+                    .callback           = callback,
+                    .callback_user_data = user_data,
+                };
+
+                _LOGT(LOGD_TEAM, "setting port config: %s", sanitized_config);
+                nm_teamd_ctl_call(priv->tdc,
+                                  NM_TEAMD_CTL_METHOD_PORT_CONFIG_UPDATE,
+                                  NM_MAKE_STRV(port_iface, sanitized_config),
+                                  _attach_port_config_cb,
+                                  data);
+                return NM_TERNARY_DEFAULT;
             }
         }
-        success = nm_platform_link_attach_port(nm_device_get_platform(device),
-                                               nm_device_get_ip_ifindex(device),
-                                               nm_device_get_ip_ifindex(port));
-        nm_device_bring_up(port);
 
-        if (!success)
-            return FALSE;
-
-        nm_clear_g_source(&priv->teamd_read_timeout);
-        priv->teamd_read_timeout = g_timeout_add_seconds(5, teamd_read_timeout_cb, self);
-
-        _LOGI(LOGD_TEAM, "attached team port %s", port_iface);
-    } else
-        _LOGI(LOGD_TEAM, "team port %s was attached", port_iface);
+        return _attach_port_link(self, port);
+    }
 
+    _LOGI(LOGD_TEAM, "team port %s was attached", port_iface);
     return TRUE;
 }
 
@@ -955,6 +1205,7 @@ detach_port(NMDevice                  *device,
         _update_port_config(self, port_iface, "{}");
         g_hash_table_remove(priv->port_configs, port_iface);
     }
+    g_hash_table_remove(priv->port_configs_actual, port_iface);
 
     return TRUE;
 }
@@ -1020,7 +1271,8 @@ constructed(GObject *object)
 
     G_OBJECT_CLASS(nm_device_team_parent_class)->constructed(object);
 
-    priv->port_configs = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, g_free);
+    priv->port_configs        = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, g_free);
+    priv->port_configs_actual = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, g_free);
 
     if (nm_dbus_manager_get_dbus_connection(nm_dbus_manager_get())) {
         /* Register D-Bus name watcher */
@@ -1082,6 +1334,7 @@ dispose(GObject *object)
     teamd_cleanup(self, TRUE);
     nm_clear_g_free(&priv->config);
     nm_clear_pointer(&priv->port_configs, g_hash_table_destroy);
+    nm_clear_pointer(&priv->port_configs_actual, g_hash_table_destroy);
 
     G_OBJECT_CLASS(nm_device_team_parent_class)->dispose(object);
 }
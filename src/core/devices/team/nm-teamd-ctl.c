@@ -0,0 +1,508 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include "nm-teamd-ctl.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "c-list/src/c-list.h"
+#include "libnm-glib-aux/nm-io-utils.h"
+
+/*****************************************************************************/
+
+/* The unix socket that teamd creates with --usock-enable. This is what
+ * libteamdctl's "usock" CLI type talks to. */
+#define TEAMD_USOCK_PATH_FMT "/run/teamd/%s.sock"
+
+#define TEAMD_USOCK_REQUEST_PREFIX    "REQUEST"
+#define TEAMD_USOCK_REPLY_SUCC_PREFIX "REPLY_SUCCESS"
+#define TEAMD_USOCK_REPLY_ERR_PREFIX  "REPLY_ERROR"
+
+/* teamd answers requests right away. A teamd that doesn't reply within this
+ * time is considered wedged and the connection is dropped. The next call
+ * connects again. */
+#define TEAMD_CTL_TIMEOUT_MSEC 5000
+
+/*****************************************************************************/
+
+typedef struct {
+    CList              calls_lst;
+    NMTeamdCtlCallback callback;
+    gpointer           user_data;
+    char              *method;
+    char              *msg;
+} TeamdCtlCall;
+
+struct _NMTeamdCtl {
+    CList    calls_lst_head;
+    GSource *io_source;
+    GSource *timeout_source;
+    GSource *idle_source;
+    char    *iface;
+
+    /* The reason why the connection was lost. The queued calls fail with this
+     * error on idle. Calls queued afterwards connect again. */
+    GError *error;
+
+    int fd;
+    int ref_count;
+
+    /* Whether the request of the first call was sent and we wait for the reply.
+     * teamd replies in order, but we only keep one request in flight so that
+     * a timeout can be attributed to a call. */
+    bool in_flight : 1;
+
+    /* Set by nm_teamd_ctl_free(). Nothing is sent anymore. */
+    bool disposed : 1;
+};
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN      LOGD_TEAM
+#define _NMLOG(level, ...) __NMLOG_DEFAULT(level, _NMLOG_DOMAIN, "teamd-ctl", __VA_ARGS__)
+
+/*****************************************************************************/
+
+static void _send_next(NMTeamdCtl *tdc);
+
+/*****************************************************************************/
+
+static void
+_teamd_ctl_unref(NMTeamdCtl *tdc)
+{
+    nm_assert(tdc);
+    nm_assert(tdc->ref_count > 0);
+
+    if (--tdc->ref_count > 0)
+        return;
+
+    nm_assert(c_list_is_empty(&tdc->calls_lst_head));
+    nm_assert(tdc->fd < 0);
+    nm_assert(!tdc->io_source);
+
+    g_clear_error(&tdc->error);
+    g_free(tdc->iface);
+    g_free(tdc);
+}
+
+static void
+_call_complete(NMTeamdCtl *tdc, TeamdCtlCall *call, const char *reply, GError *error)
+{
+    c_list_unlink(&call->calls_lst);
+    if (call->callback)
+        call->callback(tdc, reply, error, call->user_data);
+    g_free(call->method);
+    g_free(call->msg);
+    g_free(call);
+}
+
+static void
+_fail_calls(NMTeamdCtl *tdc, CList *calls_lst_head, GError *error)
+{
+    gs_free_error GError *error_cancelled = NULL;
+    TeamdCtlCall         *call;
+
+    tdc->ref_count++;
+    while ((call = c_list_first_entry(calls_lst_head, TeamdCtlCall, calls_lst))) {
+        if (tdc->disposed && !error_cancelled) {
+            /* A callback freed @tdc. The remaining calls are cancelled. */
+            nm_utils_error_set_cancelled(&error_cancelled, FALSE, NULL);
+            error = error_cancelled;
+        }
+        _call_complete(tdc, call, NULL, error);
+    }
+    _teamd_ctl_unref(tdc);
+}
+
+static gboolean
+_idle_cb(gpointer user_data)
+{
+    NMTeamdCtl           *tdc            = user_data;
+    CList                 calls_lst_head = C_LIST_INIT(calls_lst_head);
+    gs_free_error GError *error          = NULL;
+
+    nm_clear_g_source_inst(&tdc->idle_source);
+
+    /* Only the calls queued so far fail. If a callback queues a new call,
+     * that one connects again. */
+    error = g_steal_pointer(&tdc->error);
+    c_list_splice(&calls_lst_head, &tdc->calls_lst_head);
+    _fail_calls(tdc, &calls_lst_head, error);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+_disconnect(NMTeamdCtl *tdc, GError *error)
+{
+    nm_assert(error);
+
+    if (tdc->error) {
+        g_error_free(error);
+        return;
+    }
+
+    if (tdc->fd >= 0)
+        _LOGD("%s: connection to teamd lost: %s", tdc->iface, error->message);
+
+    tdc->in_flight = FALSE;
+    nm_clear_g_source_inst(&tdc->io_source);
+    nm_clear_g_source_inst(&tdc->timeout_source);
+    nm_clear_fd(&tdc->fd);
+
+    if (c_list_is_empty(&tdc->calls_lst_head)) {
+        g_error_free(error);
+        return;
+    }
+
+    /* Don't fail the calls synchronously, the caller might not expect the
+     * callback while still in nm_teamd_ctl_call(). */
+    tdc->error = error;
+    if (!tdc->idle_source)
+        tdc->idle_source = nm_g_idle_add_source(_idle_cb, tdc);
+}
+
+static void
+_handle_reply(NMTeamdCtl *tdc, char *msg)
+{
+    gs_free_error GError *error = NULL;
+    TeamdCtlCall         *call;
+    const char           *reply = NULL;
+    char                 *s;
+
+    call = c_list_first_entry(&tdc->calls_lst_head, TeamdCtlCall, calls_lst);
+    if (!call || !tdc->in_flight) {
+        _disconnect(tdc,
+                    g_error_new(NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN, "unexpected reply"));
+        return;
+    }
+
+    tdc->in_flight = FALSE;
+    nm_clear_g_source_inst(&tdc->timeout_source);
+
+    s = strchr(msg, '\n');
+    if (s)
+        *(s++) = '\0';
+
+    if (nm_streq(msg, TEAMD_USOCK_REPLY_SUCC_PREFIX)) {
+        reply = s ?: "";
+    } else if (nm_streq(msg, TEAMD_USOCK_REPLY_ERR_PREFIX)) {
+        const char *err_name = s ?: "";
+        const char *err_msg  = "";
+
+        s = strchr(err_name, '\n');
+        if (s) {
+            *(s++) = '\0';
+            err_msg = s;
+            g_strchomp(s);
+        }
+        error = g_error_new(NM_UTILS_ERROR,
+                            NM_UTILS_ERROR_UNKNOWN,
+                            "%s failed: %s%s%s",
+                            call->method,
+                            err_name,
+                            err_msg[0] ? ": " : "",
+                            err_msg);
+    } else {
+        _disconnect(tdc,
+                    g_error_new(NM_UTILS_ERROR,
+                                NM_UTILS_ERROR_UNKNOWN,
+                                "invalid reply to %s",
+                                call->method));
+        return;
+    }
+
+    _LOGT("%s: %s %s", tdc->iface, call->method, error ? "failed" : "succeeded");
+    _call_complete(tdc, call, reply, error);
+}
+
+static gboolean
+_io_cb(int fd, GIOCondition condition, gpointer user_data)
+{
+    NMTeamdCtl   *tdc = user_data;
+    gs_free char *msg = NULL;
+    gssize        len;
+    gssize        n;
+    int           errsv;
+
+    len = nm_fd_next_datagram_size(fd);
+    if (len == -EAGAIN || len == -EINTR)
+        return G_SOURCE_CONTINUE;
+    if (len <= 0) {
+        if (len == 0)
+            _disconnect(tdc,
+                        g_error_new(NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN, "teamd closed socket"));
+        else
+            _disconnect(tdc,
+                        g_error_new(NM_UTILS_ERROR,
+                                    NM_UTILS_ERROR_UNKNOWN,
+                                    "failure to receive: %s",
+                                    nm_strerror_native((int) -len)));
+        return G_SOURCE_CONTINUE;
+    }
+
+    msg = g_malloc(len + 1);
+    n   = recv(fd, msg, len, MSG_DONTWAIT);
+    if (n < 0) {
+        errsv = errno;
+        if (NM_IN_SET(errsv, EAGAIN, EWOULDBLOCK, EINTR))
+            return G_SOURCE_CONTINUE;
+        _disconnect(tdc,
+                    g_error_new(NM_UTILS_ERROR,
+                                NM_UTILS_ERROR_UNKNOWN,
+                                "failure to receive: %s",
+                                nm_strerror_native(errsv)));
+        return G_SOURCE_CONTINUE;
+    }
+    msg[n] = '\0';
+
+    tdc->ref_count++;
+    _handle_reply(tdc, msg);
+    _send_next(tdc);
+    _teamd_ctl_unref(tdc);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_timeout_cb(gpointer user_data)
+{
+    NMTeamdCtl *tdc = user_data;
+
+    nm_clear_g_source_inst(&tdc->timeout_source);
+    _disconnect(tdc,
+                g_error_new(NM_UTILS_ERROR,
+                            NM_UTILS_ERROR_UNKNOWN,
+                            "timeout waiting for teamd to reply"));
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+_send_next(NMTeamdCtl *tdc)
+{
+    TeamdCtlCall *call;
+    int           errsv;
+
+    if (tdc->in_flight || tdc->error || tdc->fd < 0 || tdc->disposed)
+        return;
+
+    call = c_list_first_entry(&tdc->calls_lst_head, TeamdCtlCall, calls_lst);
+    if (!call)
+        return;
+
+    /* With only one request in flight, the socket buffer is always empty.
+     * If it still doesn't accept the request, teamd is gone or wedged. */
+    if (send(tdc->fd, call->msg, strlen(call->msg), MSG_NOSIGNAL | MSG_DONTWAIT) < 0) {
+        errsv = errno;
+        _disconnect(tdc,
+                    g_error_new(NM_UTILS_ERROR,
+                                NM_UTILS_ERROR_UNKNOWN,
+                                "failure to send %s: %s",
+                                call->method,
+                                nm_strerror_native(errsv)));
+        return;
+    }
+
+    tdc->in_flight      = TRUE;
+    tdc->timeout_source = nm_g_timeout_add_source(TEAMD_CTL_TIMEOUT_MSEC, _timeout_cb, tdc);
+}
+
+static void
+_set_fd(NMTeamdCtl *tdc, int fd)
+{
+    nm_assert(tdc->fd < 0);
+    nm_assert(fd >= 0);
+
+    tdc->fd        = fd;
+    tdc->io_source = nm_g_unix_fd_add_source(fd, G_IO_IN | G_IO_ERR | G_IO_HUP, _io_cb, tdc);
+}
+
+static gboolean
+_connect(NMTeamdCtl *tdc, GError **error)
+{
+    struct sockaddr_un sockaddr;
+    gs_free char      *path = NULL;
+    int                addr_len;
+    int                fd;
+    int                errsv;
+
+    nm_assert(tdc->fd < 0);
+
+    path     = g_strdup_printf(TEAMD_USOCK_PATH_FMT, tdc->iface);
+    addr_len = nm_io_sockaddr_un_set(&sockaddr, NM_OPTION_BOOL_FALSE, path);
+    if (addr_len < 0) {
+        nm_utils_error_set_errno(error, addr_len, "invalid socket path: %s");
+        return FALSE;
+    }
+
+    fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        errsv = errno;
+        nm_utils_error_set_errno(error, errsv, "failure to create socket: %s");
+        return FALSE;
+    }
+
+    if (connect(fd, (struct sockaddr *) &sockaddr, addr_len) < 0) {
+        errsv = errno;
+        nm_close(fd);
+        nm_utils_error_set_errno(error, errsv, "failure to connect to teamd: %s");
+        return FALSE;
+    }
+
+    _set_fd(tdc, fd);
+
+    _LOGD("%s: connected to %s", tdc->iface, path);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_teamd_ctl_call:
+ * @tdc: the teamd control connection
+ * @method: the name of the method to invoke
+ * @args: (nullable): %NULL terminated list of arguments. The arguments must
+ *   not contain newlines.
+ * @callback: (nullable): invoked with the reply
+ * @user_data: user data for @callback
+ *
+ * Queues a method call on teamd. Calls are sent one after another and
+ * @callback is always invoked asynchronously. If the connection to teamd
+ * was lost, it is established again.
+ */
+void
+nm_teamd_ctl_call(NMTeamdCtl        *tdc,
+                  const char        *method,
+                  const char *const *args,
+                  NMTeamdCtlCallback callback,
+                  gpointer           user_data)
+{
+    nm_auto_free_gstring GString *str = NULL;
+    TeamdCtlCall                 *call;
+
+    g_return_if_fail(tdc);
+    g_return_if_fail(method);
+    g_return_if_fail(!tdc->disposed);
+
+    str = g_string_new(TEAMD_USOCK_REQUEST_PREFIX "\n");
+    g_string_append(str, method);
+    g_string_append_c(str, '\n');
+    for (; args && *args; args++) {
+        nm_assert(!strchr(*args, '\n'));
+        g_string_append(str, *args);
+        g_string_append_c(str, '\n');
+    }
+
+    call  = g_new(TeamdCtlCall, 1);
+    *call = (TeamdCtlCall) {
+        .callback  = callback,
+        .user_data = user_data,
+        .method    = g_strdup(method),
+        .msg       = g_string_free(g_steal_pointer(&str), FALSE),
+    };
+    c_list_link_tail(&tdc->calls_lst_head, &call->calls_lst);
+
+    _LOGT("%s: queue %s", tdc->iface, method);
+
+    if (tdc->error) {
+        /* The failure of the previous connection is not yet reported. */
+        return;
+    }
+
+    if (tdc->fd < 0) {
+        GError *error = NULL;
+
+        if (!_connect(tdc, &error)) {
+            _LOGD("%s: reconnecting to teamd failed: %s", tdc->iface, error->message);
+            _disconnect(tdc, error);
+            return;
+        }
+    }
+
+    _send_next(tdc);
+}
+
+static NMTeamdCtl *
+_teamd_ctl_new(const char *iface)
+{
+    NMTeamdCtl *tdc;
+
+    tdc  = g_new(NMTeamdCtl, 1);
+    *tdc = (NMTeamdCtl) {
+        .iface     = g_strdup(iface),
+        .fd        = -1,
+        .ref_count = 1,
+    };
+    c_list_init(&tdc->calls_lst_head);
+    return tdc;
+}
+
+/**
+ * nm_teamd_ctl_new:
+ * @iface: the name of the team interface
+ * @error: the failure reason
+ *
+ * Connects to the control socket of the teamd instance for @iface. Connecting
+ * to a local unix socket does not block.
+ *
+ * Returns: the new connection, or %NULL if teamd isn't listening.
+ */
+NMTeamdCtl *
+nm_teamd_ctl_new(const char *iface, GError **error)
+{
+    NMTeamdCtl *tdc;
+
+    g_return_val_if_fail(iface, NULL);
+    g_return_val_if_fail(!error || !*error, NULL);
+
+    tdc = _teamd_ctl_new(iface);
+    if (!_connect(tdc, error)) {
+        _teamd_ctl_unref(tdc);
+        return NULL;
+    }
+
+    return tdc;
+}
+
+NMTeamdCtl *
+_nm_teamd_ctl_new_for_fd(const char *iface, int fd)
+{
+    NMTeamdCtl *tdc;
+
+    g_return_val_if_fail(iface, NULL);
+    g_return_val_if_fail(fd >= 0, NULL);
+
+    tdc = _teamd_ctl_new(iface);
+    _set_fd(tdc, fd);
+    return tdc;
+}
+
+/**
+ * nm_teamd_ctl_free:
+ * @tdc: the teamd control connection
+ *
+ * Closes the connection. Pending calls are cancelled and their callbacks
+ * invoked synchronously.
+ */
+void
+nm_teamd_ctl_free(NMTeamdCtl *tdc)
+{
+    gs_free_error GError *error = NULL;
+
+    if (!tdc)
+        return;
+
+    nm_clear_g_source_inst(&tdc->idle_source);
+    nm_clear_g_source_inst(&tdc->io_source);
+    nm_clear_g_source_inst(&tdc->timeout_source);
+    nm_clear_fd(&tdc->fd);
+    g_clear_error(&tdc->error);
+
+    /* We might be called from within a callback. Make sure that nothing is
+     * sent anymore. */
+    tdc->disposed = TRUE;
+
+    nm_utils_error_set_cancelled(&error, FALSE, NULL);
+    _fail_calls(tdc, &tdc->calls_lst_head, error);
+    _teamd_ctl_unref(tdc);
+}
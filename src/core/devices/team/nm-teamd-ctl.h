@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#ifndef __NM_TEAMD_CTL_H__
+#define __NM_TEAMD_CTL_H__
+
+/* Methods of teamd's control interface, see teamd_ctl_methods in teamd. */
+#define NM_TEAMD_CTL_METHOD_CONFIG_DUMP        "ConfigDump"
+#define NM_TEAMD_CTL_METHOD_CONFIG_DUMP_ACTUAL "ConfigDumpActual"
+#define NM_TEAMD_CTL_METHOD_PORT_CONFIG_UPDATE "PortConfigUpdate"
+#define NM_TEAMD_CTL_METHOD_PORT_CONFIG_DUMP   "PortConfigDump"
+
+typedef struct _NMTeamdCtl NMTeamdCtl;
+
+/* On success, @reply is the reply of teamd and @error is %NULL. Otherwise
+ * @error is set. When the call is aborted by nm_teamd_ctl_free(), @error is
+ * a cancelled error and the callback must not touch @tdc. */
+typedef void (*NMTeamdCtlCallback)(NMTeamdCtl *tdc,
+                                   const char *reply,
+                                   GError     *error,
+                                   gpointer    user_data);
+
+NMTeamdCtl *nm_teamd_ctl_new(const char *iface, GError **error);
+
+/* For tests. Takes ownership of @fd, a connected SOCK_SEQPACKET socket, instead
+ * of connecting to teamd. A lost connection is still re-established via the
+ * socket path of @iface. */
+NMTeamdCtl *_nm_teamd_ctl_new_for_fd(const char *iface, int fd);
+
+void nm_teamd_ctl_free(NMTeamdCtl *tdc);
+
+void nm_teamd_ctl_call(NMTeamdCtl        *tdc,
+                       const char        *method,
+                       const char *const *args,
+                       NMTeamdCtlCallback callback,
+                       gpointer           user_data);
+
+#endif /* __NM_TEAMD_CTL_H__ */
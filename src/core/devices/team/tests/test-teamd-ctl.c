@@ -0,0 +1,268 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include <sys/socket.h>
+
+#include "nm-teamd-ctl.h"
+
+#include "nm-test-utils-core.h"
+
+/* No teamd listens for this interface, so reconnecting fails. */
+#define TEST_IFACE "nm-test-team0"
+
+/*****************************************************************************/
+
+typedef struct {
+    char   *reply;
+    GError *error;
+    bool    done : 1;
+} CallResult;
+
+static void
+_call_cb(NMTeamdCtl *tdc, const char *reply, GError *error, gpointer user_data)
+{
+    CallResult *result = user_data;
+
+    g_assert(!result->done);
+    g_assert((!!reply) != (!!error));
+
+    result->done  = TRUE;
+    result->reply = g_strdup(reply);
+    result->error = error ? g_error_copy(error) : NULL;
+}
+
+static void
+_call_result_clear(CallResult *result)
+{
+    nm_clear_g_free(&result->reply);
+    g_clear_error(&result->error);
+    result->done = FALSE;
+}
+
+static NMTeamdCtl *
+_tdc_new(int *out_peer_fd)
+{
+    int fds[2];
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0, fds) < 0)
+        g_assert_not_reached();
+
+    *out_peer_fd = fds[1];
+    return _nm_teamd_ctl_new_for_fd(TEST_IFACE, fds[0]);
+}
+
+/* NMTeamdCtl sends the requests synchronously, either when the call is queued
+ * or when handling the previous reply. */
+static char *
+_peer_recv(int peer_fd)
+{
+    char   buf[1024];
+    gssize n;
+
+    n = recv(peer_fd, buf, sizeof(buf) - 1, MSG_DONTWAIT);
+    g_assert_cmpint(n, >, 0);
+    buf[n] = '\0';
+    return g_strdup(buf);
+}
+
+static void
+_peer_send(int peer_fd, const char *msg)
+{
+    g_assert_cmpint(send(peer_fd, msg, strlen(msg), MSG_NOSIGNAL), ==, strlen(msg));
+}
+
+static void
+_peer_assert_nothing_sent(int peer_fd)
+{
+    char buf[16];
+
+    g_assert_cmpint(recv(peer_fd, buf, sizeof(buf), MSG_DONTWAIT), ==, -1);
+    g_assert_cmpint(errno, ==, EAGAIN);
+}
+
+/*****************************************************************************/
+
+static void
+test_request_reply(void)
+{
+    nm_auto_close int peer_fd = -1;
+    NMTeamdCtl       *tdc;
+    CallResult        result1 = {};
+    CallResult        result2 = {};
+    gs_free char     *msg     = NULL;
+
+    tdc = _tdc_new(&peer_fd);
+
+    nm_teamd_ctl_call(tdc,
+                      NM_TEAMD_CTL_METHOD_PORT_CONFIG_UPDATE,
+                      NM_MAKE_STRV("eth0", "{\"prio\": 10}"),
+                      _call_cb,
+                      &result1);
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP_ACTUAL, NULL, _call_cb, &result2);
+
+    /* The callback is never invoked synchronously. */
+    g_assert(!result1.done);
+
+    msg = _peer_recv(peer_fd);
+    g_assert_cmpstr(msg, ==, "REQUEST\nPortConfigUpdate\neth0\n{\"prio\": 10}\n");
+    nm_clear_g_free(&msg);
+
+    /* Only one request is in flight. */
+    _peer_assert_nothing_sent(peer_fd);
+
+    _peer_send(peer_fd, "REPLY_SUCCESS\n");
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result1.done);
+    g_assert_no_error(result1.error);
+    g_assert_cmpstr(result1.reply, ==, "");
+    g_assert(!result2.done);
+
+    msg = _peer_recv(peer_fd);
+    g_assert_cmpstr(msg, ==, "REQUEST\nConfigDumpActual\n");
+    nm_clear_g_free(&msg);
+
+    _peer_send(peer_fd, "REPLY_SUCCESS\n{\"device\": \"team0\"}\n");
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result2.done);
+    g_assert_no_error(result2.error);
+    g_assert_cmpstr(result2.reply, ==, "{\"device\": \"team0\"}\n");
+
+    nm_teamd_ctl_free(tdc);
+    _call_result_clear(&result1);
+    _call_result_clear(&result2);
+}
+
+static void
+test_reply_error(void)
+{
+    nm_auto_close int peer_fd = -1;
+    NMTeamdCtl       *tdc;
+    CallResult        result1 = {};
+    CallResult        result2 = {};
+    gs_free char     *msg     = NULL;
+
+    tdc = _tdc_new(&peer_fd);
+
+    nm_teamd_ctl_call(tdc,
+                      NM_TEAMD_CTL_METHOD_PORT_CONFIG_DUMP,
+                      NM_MAKE_STRV("eth1"),
+                      _call_cb,
+                      &result1);
+    msg = _peer_recv(peer_fd);
+    g_assert_cmpstr(msg, ==, "REQUEST\nPortConfigDump\neth1\n");
+    nm_clear_g_free(&msg);
+
+    _peer_send(peer_fd, "REPLY_ERROR\nNoSuchDev\nNo such port device.\n");
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result1.done);
+    g_assert_error(result1.error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN);
+    g_assert_cmpstr(result1.error->message,
+                    ==,
+                    "PortConfigDump failed: NoSuchDev: No such port device.");
+
+    /* An error reply doesn't affect the connection. */
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _call_cb, &result2);
+    msg = _peer_recv(peer_fd);
+    g_assert_cmpstr(msg, ==, "REQUEST\nConfigDump\n");
+    _peer_send(peer_fd, "REPLY_SUCCESS\n{}\n");
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result2.done);
+    g_assert_no_error(result2.error);
+    g_assert_cmpstr(result2.reply, ==, "{}\n");
+
+    nm_teamd_ctl_free(tdc);
+    _call_result_clear(&result1);
+    _call_result_clear(&result2);
+}
+
+static void
+test_invalid_reply(void)
+{
+    nm_auto_close int peer_fd = -1;
+    NMTeamdCtl       *tdc;
+    CallResult        result1 = {};
+    CallResult        result2 = {};
+    gs_free char     *msg     = NULL;
+
+    tdc = _tdc_new(&peer_fd);
+
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _call_cb, &result1);
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP_ACTUAL, NULL, _call_cb, &result2);
+    msg = _peer_recv(peer_fd);
+    g_assert_cmpstr(msg, ==, "REQUEST\nConfigDump\n");
+
+    /* A garbled reply drops the connection and fails all queued calls. */
+    _peer_send(peer_fd, "GARBAGE\n");
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result1.done && result2.done);
+    g_assert_error(result1.error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN);
+    g_assert_cmpstr(result1.error->message, ==, "invalid reply to ConfigDump");
+    g_assert_error(result2.error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN);
+
+    nm_teamd_ctl_free(tdc);
+    _call_result_clear(&result1);
+    _call_result_clear(&result2);
+}
+
+static void
+test_reconnect(void)
+{
+    nm_auto_close int peer_fd = -1;
+    NMTeamdCtl       *tdc;
+    CallResult        result = {};
+
+    tdc = _tdc_new(&peer_fd);
+
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _call_cb, &result);
+    nm_clear_fd(&peer_fd);
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result.done);
+    g_assert_error(result.error, NM_UTILS_ERROR, NM_UTILS_ERROR_UNKNOWN);
+    _call_result_clear(&result);
+
+    /* The next call connects again. As no teamd listens, that fails (but still
+     * asynchronously). */
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _call_cb, &result);
+    g_assert(!result.done);
+    nmtst_main_context_iterate_until_assert(NULL, 1000, result.done);
+    g_assert(result.error);
+    g_assert(strstr(result.error->message, "failure to connect to teamd"));
+
+    nm_teamd_ctl_free(tdc);
+    _call_result_clear(&result);
+}
+
+static void
+test_free_cancels(void)
+{
+    nm_auto_close int peer_fd = -1;
+    NMTeamdCtl       *tdc;
+    CallResult        result1 = {};
+    CallResult        result2 = {};
+
+    tdc = _tdc_new(&peer_fd);
+
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP, NULL, _call_cb, &result1);
+    nm_teamd_ctl_call(tdc, NM_TEAMD_CTL_METHOD_CONFIG_DUMP_ACTUAL, NULL, _call_cb, &result2);
+
+    nm_teamd_ctl_free(tdc);
+    g_assert(result1.done && result2.done);
+    g_assert(nm_utils_error_is_cancelled(result1.error));
+    g_assert(nm_utils_error_is_cancelled(result2.error));
+
+    _call_result_clear(&result1);
+    _call_result_clear(&result2);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE();
+
+int
+main(int argc, char **argv)
+{
+    nmtst_init_assert_logging(&argc, &argv, "INFO", "DEFAULT");
+
+    g_test_add_func("/teamd-ctl/request-reply", test_request_reply);
+    g_test_add_func("/teamd-ctl/reply-error", test_reply_error);
+    g_test_add_func("/teamd-ctl/invalid-reply", test_invalid_reply);
+    g_test_add_func("/teamd-ctl/reconnect", test_reconnect);
+    g_test_add_func("/teamd-ctl/free-cancels", test_free_cancels);
+
+    return g_test_run();
+}
@@ -0,0 +1,189 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include "devices/nm-device-utils.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+/* A resolver whose lookups only complete when the test says so. */
+
+typedef struct {
+    GResolver  parent;
+    GPtrArray *tasks;
+    guint      n_lookups;
+} TestResolver;
+
+typedef struct {
+    GResolverClass parent;
+} TestResolverClass;
+
+GType test_resolver_get_type(void);
+
+G_DEFINE_TYPE(TestResolver, test_resolver, G_TYPE_RESOLVER)
+
+static void
+_resolver_lookup_by_name_async(GResolver          *resolver,
+                               const char         *hostname,
+                               GCancellable       *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer            user_data)
+{
+    TestResolver *self = (TestResolver *) resolver;
+    GTask        *task;
+
+    task = g_task_new(resolver, cancellable, callback, user_data);
+    g_task_set_task_data(task, g_strdup(hostname), g_free);
+    g_ptr_array_add(self->tasks, task);
+    self->n_lookups++;
+}
+
+static GList *
+_resolver_lookup_by_name_finish(GResolver *resolver, GAsyncResult *result, GError **error)
+{
+    return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+static void
+test_resolver_init(TestResolver *self)
+{
+    self->tasks = g_ptr_array_new_with_free_func(g_object_unref);
+}
+
+static void
+_resolver_finalize(GObject *object)
+{
+    TestResolver *self = (TestResolver *) object;
+
+    g_ptr_array_unref(self->tasks);
+
+    G_OBJECT_CLASS(test_resolver_parent_class)->finalize(object);
+}
+
+static void
+test_resolver_class_init(TestResolverClass *klass)
+{
+    GObjectClass   *object_class   = G_OBJECT_CLASS(klass);
+    GResolverClass *resolver_class = G_RESOLVER_CLASS(klass);
+
+    object_class->finalize                = _resolver_finalize;
+    resolver_class->lookup_by_name_async  = _resolver_lookup_by_name_async;
+    resolver_class->lookup_by_name_finish = _resolver_lookup_by_name_finish;
+}
+
+static void
+_resolver_complete(TestResolver *self, const char *hostname, const char *address)
+{
+    gs_unref_object GTask *task = NULL;
+    guint                  i;
+
+    for (i = 0; i < self->tasks->len; i++) {
+        if (nm_streq(g_task_get_task_data(self->tasks->pdata[i]), hostname))
+            break;
+    }
+    g_assert_cmpint(i, <, self->tasks->len);
+    task = g_object_ref(self->tasks->pdata[i]);
+    g_ptr_array_remove_index(self->tasks, i);
+
+    g_task_return_pointer(task,
+                          g_list_append(NULL, g_inet_address_new_from_string(address)),
+                          (GDestroyNotify) g_resolver_free_addresses);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    NMDeviceHostLookupWaiter waiter;
+    char                    *address;
+    guint                    n_results;
+} Peer;
+
+static void
+_lookup_cb(NMDeviceHostLookupWaiter *waiter, GList *addresses, GError *error, gpointer user_data)
+{
+    Peer *peer = c_list_entry(waiter, Peer, waiter);
+
+    g_assert_no_error(error);
+    g_assert(addresses);
+    g_assert(!nm_device_host_lookup_is_pending(waiter));
+
+    peer->n_results++;
+    nm_clear_g_free(&peer->address);
+    peer->address = g_inet_address_to_string(addresses->data);
+}
+
+static void
+test_shared_lookup(void)
+{
+    gs_unref_object TestResolver *resolver = g_object_new(test_resolver_get_type(), NULL);
+    NMDeviceHostLookups          *lookups;
+    Peer                          peers[4];
+    guint                         i;
+
+    g_resolver_set_default(G_RESOLVER(resolver));
+
+    lookups = nm_device_host_lookups_new(_lookup_cb, NULL);
+
+    for (i = 0; i < G_N_ELEMENTS(peers); i++) {
+        peers[i] = (Peer) {};
+        nm_device_host_lookup_waiter_init(&peers[i].waiter);
+    }
+
+    /* Three peers have their endpoint on the same host. They share one lookup. */
+    g_assert(nm_device_host_lookup_start(lookups, &peers[0].waiter, "vpn.example.com"));
+    g_assert(!nm_device_host_lookup_start(lookups, &peers[1].waiter, "vpn.example.com"));
+    g_assert(!nm_device_host_lookup_start(lookups, &peers[2].waiter, "vpn.example.com"));
+    g_assert(nm_device_host_lookup_start(lookups, &peers[3].waiter, "other.example.com"));
+    g_assert_cmpint(resolver->n_lookups, ==, 2);
+
+    /* Removing the peer that started the lookup doesn't abort it for the others. */
+    g_assert(nm_device_host_lookup_cancel(lookups, &peers[0].waiter));
+    g_assert(!nm_device_host_lookup_cancel(lookups, &peers[0].waiter));
+    g_assert(nm_device_host_lookup_is_pending(&peers[1].waiter));
+
+    _resolver_complete(resolver, "vpn.example.com", "192.0.2.1");
+    nmtst_main_context_iterate_until_assert(NULL,
+                                            1000,
+                                            peers[1].n_results == 1 && peers[2].n_results == 1);
+    g_assert_cmpstr(peers[1].address, ==, "192.0.2.1");
+    g_assert_cmpstr(peers[2].address, ==, "192.0.2.1");
+    g_assert_cmpint(peers[0].n_results, ==, 0);
+    g_assert_cmpint(peers[3].n_results, ==, 0);
+    g_assert(nm_device_host_lookup_is_pending(&peers[3].waiter));
+
+    /* After completion, a peer starts a new lookup. */
+    g_assert(nm_device_host_lookup_start(lookups, &peers[1].waiter, "vpn.example.com"));
+    g_assert_cmpint(resolver->n_lookups, ==, 3);
+
+    /* When the last waiter leaves, the lookup is aborted. A late result
+     * is ignored. */
+    g_assert(nm_device_host_lookup_cancel(lookups, &peers[1].waiter));
+    g_assert(nm_device_host_lookup_cancel(lookups, &peers[3].waiter));
+    _resolver_complete(resolver, "vpn.example.com", "192.0.2.2");
+    _resolver_complete(resolver, "other.example.com", "192.0.2.3");
+    nmtst_main_context_iterate_until(NULL, 100, FALSE);
+    g_assert_cmpint(peers[1].n_results, ==, 1);
+    g_assert_cmpstr(peers[1].address, ==, "192.0.2.1");
+    g_assert_cmpint(peers[3].n_results, ==, 0);
+
+    nm_device_host_lookups_free(lookups);
+
+    for (i = 0; i < G_N_ELEMENTS(peers); i++)
+        nm_clear_g_free(&peers[i].address);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE();
+
+int
+main(int argc, char **argv)
+{
+    nmtst_init_assert_logging(&argc, &argv, "INFO", "DEFAULT");
+
+    g_test_add_func("/device/host-lookup/shared", test_shared_lookup);
+
+    return g_test_run();
+}
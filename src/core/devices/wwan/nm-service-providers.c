@@ -10,6 +10,15 @@
 
 #include "nm-service-providers.h"
 
+#include <sys/stat.h>
+
+#include "libnm-glib-aux/nm-time-utils.h"
+
+/* The provider database is parsed once into an index of the first internet
+ * APN for each MCC/MNC, and the index is reused until the file changes on
+ * disk. Modems that get (re)activated repeatedly thus don't pay for streaming
+ * and parsing the whole XML file on every lookup. */
+
 typedef enum {
     PARSER_TOPLEVEL = 0,
     PARSER_COUNTRY,
@@ -17,31 +26,109 @@ typedef enum {
     PARSER_METHOD_GSM,
     PARSER_METHOD_GSM_APN,
     PARSER_METHOD_CDMA,
-    PARSER_DONE,
     PARSER_ERROR
 } ParseContextState;
 
 typedef struct {
+    char   *apn;
+    char   *username;
+    char   *password;
+    char   *gateway;
+    char   *auth_method;
+    GSList *dns;
+} ApnEntry;
+
+typedef struct {
+    CList                            lookups_lst;
     char                            *mccmnc;
     NMServiceProvidersGsmApnCallback callback;
     gpointer                         user_data;
     GCancellable                    *cancellable;
-    GMarkupParseContext             *ctx;
-    char                             buffer[4096];
+} Lookup;
+
+typedef struct {
+    char *path;
+
+    /* Maps the MCC/MNC string to the ApnEntry. Only valid while @index_valid. */
+    GHashTable *by_mccmnc;
+
+    CList    lookups_lst_head;
+    GSource *dispatch_source;
+
+    struct {
+        dev_t  dev;
+        ino_t  ino;
+        off_t  size;
+        gint64 mtime_nsec;
+    } stamp;
+
+    bool index_valid : 1;
+    bool loading : 1;
+} Database;
+
+typedef struct {
+    Database            *db;
+    GHashTable          *by_mccmnc;
+    GMarkupParseContext *ctx;
+    char                 buffer[4096];
 
     char             *text_buffer;
     ParseContextState state;
 
-    gboolean mccmnc_matched;
-    gboolean found_internet_apn;
-    char    *apn;
-    char    *username;
-    char    *password;
-    char    *gateway;
-    char    *auth_method;
-    GSList  *dns;
+    GPtrArray *network_ids;
+    gboolean   found_internet_apn;
+    char      *apn;
+    char      *username;
+    char      *password;
+    char      *gateway;
+    char      *auth_method;
+    GSList    *dns;
 } ParseContext;
 
+static GHashTable *databases;
+
+/*****************************************************************************/
+
+static void
+apn_entry_free(gpointer data)
+{
+    ApnEntry *entry = data;
+
+    g_free(entry->apn);
+    g_free(entry->username);
+    g_free(entry->password);
+    g_free(entry->gateway);
+    g_free(entry->auth_method);
+    g_slist_free_full(entry->dns, g_free);
+    nm_g_slice_free(entry);
+}
+
+static void
+parser_add_apn_entry(ParseContext *parse_context)
+{
+    guint i;
+
+    for (i = 0; i < parse_context->network_ids->len; i++) {
+        const char *mccmnc = parse_context->network_ids->pdata[i];
+        ApnEntry   *entry;
+
+        /* Like a sequential scan of the file, the first internet APN wins. */
+        if (g_hash_table_contains(parse_context->by_mccmnc, mccmnc))
+            continue;
+
+        entry  = g_slice_new(ApnEntry);
+        *entry = (ApnEntry){
+            .apn         = g_strdup(parse_context->apn),
+            .username    = g_strdup(parse_context->username),
+            .password    = g_strdup(parse_context->password),
+            .gateway     = g_strdup(parse_context->gateway),
+            .auth_method = g_strdup(parse_context->auth_method),
+            .dns         = g_slist_copy_deep(parse_context->dns, (GCopyFunc) g_strdup, NULL),
+        };
+        g_hash_table_insert(parse_context->by_mccmnc, g_strdup(mccmnc), entry);
+    }
+}
+
 /*****************************************************************************/
 
 static void
@@ -86,7 +173,7 @@ parser_provider_start(ParseContext *parse_context,
                       const char  **attribute_names,
                       const char  **attribute_values)
 {
-    parse_context->mccmnc_matched = FALSE;
+    g_ptr_array_set_size(parse_context->network_ids, 0);
     if (strcmp(name, "gsm") == 0)
         parse_context->state = PARSER_METHOD_GSM;
     else if (strcmp(name, "cdma") == 0)
@@ -110,11 +197,7 @@ parser_gsm_start(ParseContext *parse_context,
             else if (strcmp(attribute_names[i], "mnc") == 0)
                 mnc = attribute_values[i];
             if (mcc && strlen(mcc) && mnc && strlen(mnc)) {
-                char *mccmnc = g_strdup_printf("%s%s", mcc, mnc);
-
-                if (strcmp(mccmnc, parse_context->mccmnc) == 0)
-                    parse_context->mccmnc_matched = TRUE;
-                g_free(mccmnc);
+                g_ptr_array_add(parse_context->network_ids, g_strdup_printf("%s%s", mcc, mnc));
                 break;
             }
         }
@@ -197,8 +280,6 @@ parser_start_element(GMarkupParseContext *context,
         break;
     case PARSER_ERROR:
         break;
-    case PARSER_DONE:
-        break;
     }
 }
 
@@ -247,10 +328,9 @@ parser_gsm_apn_end(ParseContext *parse_context, const char *name)
     } else if (strcmp(name, "apn") == 0) {
         nm_clear_g_free(&parse_context->text_buffer);
 
-        if (parse_context->mccmnc_matched && parse_context->found_internet_apn)
-            parse_context->state = PARSER_DONE;
-        else
-            parse_context->state = PARSER_METHOD_GSM;
+        if (parse_context->found_internet_apn)
+            parser_add_apn_entry(parse_context);
+        parse_context->state = PARSER_METHOD_GSM;
     }
 }
 
@@ -291,8 +371,6 @@ parser_end_element(GMarkupParseContext *context,
         break;
     case PARSER_ERROR:
         break;
-    case PARSER_DONE:
-        break;
     }
 }
 
@@ -320,28 +398,100 @@ static const GMarkupParser parser = {
 /*****************************************************************************/
 
 static void
-finish_parse_context(ParseContext *parse_context, GError *error)
+lookup_complete(Lookup *lookup, GHashTable *by_mccmnc, GError *error)
 {
-    if (parse_context->callback) {
+    gs_free_error GError *local = NULL;
+    const ApnEntry       *entry = NULL;
+
+    c_list_unlink_stale(&lookup->lookups_lst);
+
+    if (!error && g_cancellable_set_error_if_cancelled(lookup->cancellable, &local))
+        error = local;
+
+    if (!error) {
+        entry = g_hash_table_lookup(by_mccmnc, lookup->mccmnc);
+        if (!entry) {
+            g_set_error(&local,
+                        NM_UTILS_ERROR,
+                        NM_UTILS_ERROR_UNKNOWN,
+                        "Operator ID '%s' not found in service provider database",
+                        lookup->mccmnc);
+            error = local;
+        }
+    }
+
+    if (lookup->callback) {
         if (error) {
-            parse_context
-                ->callback(NULL, NULL, NULL, NULL, NULL, NULL, error, parse_context->user_data);
+            lookup->callback(NULL, NULL, NULL, NULL, NULL, NULL, error, lookup->user_data);
         } else {
-            parse_context->callback(parse_context->apn,
-                                    parse_context->username,
-                                    parse_context->password,
-                                    parse_context->gateway,
-                                    parse_context->auth_method,
-                                    parse_context->dns,
-                                    error,
-                                    parse_context->user_data);
+            lookup->callback(entry->apn,
+                             entry->username,
+                             entry->password,
+                             entry->gateway,
+                             entry->auth_method,
+                             entry->dns,
+                             NULL,
+                             lookup->user_data);
         }
     }
 
-    g_free(parse_context->mccmnc);
+    nm_g_object_unref(lookup->cancellable);
+    g_free(lookup->mccmnc);
+    nm_g_slice_free(lookup);
+}
+
+static void
+database_dispatch(Database *db, GError *error)
+{
+    gs_unref_hashtable GHashTable *by_mccmnc        = nm_g_hash_table_ref(db->by_mccmnc);
+    CList                          lookups_lst_head = C_LIST_INIT(lookups_lst_head);
+    Lookup                        *lookup;
+
+    nm_clear_g_source_inst(&db->dispatch_source);
+
+    /* Callbacks may start new lookups. Those are queued on the database
+     * and handled by the next dispatch. */
+    c_list_splice(&lookups_lst_head, &db->lookups_lst_head);
+
+    while ((lookup = c_list_first_entry(&lookups_lst_head, Lookup, lookups_lst)))
+        lookup_complete(lookup, by_mccmnc, error);
+}
+
+static gboolean
+database_dispatch_cb(gpointer user_data)
+{
+    Database *db = user_data;
+
+    if (db->loading) {
+        /* The database changed meanwhile. The load completes the lookups. */
+        nm_clear_g_source_inst(&db->dispatch_source);
+        return G_SOURCE_CONTINUE;
+    }
+
+    database_dispatch(db, NULL);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+finish_parse_context(ParseContext *parse_context, GError *error)
+{
+    Database *db = parse_context->db;
+
+    db->loading = FALSE;
+    nm_clear_pointer(&db->by_mccmnc, g_hash_table_unref);
+    if (!error) {
+        db->by_mccmnc   = g_steal_pointer(&parse_context->by_mccmnc);
+        db->index_valid = TRUE;
+    } else {
+        /* Errors are not cached. The next lookup tries again. */
+        db->index_valid = FALSE;
+    }
+
     g_markup_parse_context_free(parse_context->ctx);
+    nm_clear_pointer(&parse_context->by_mccmnc, g_hash_table_unref);
 
     g_free(parse_context->text_buffer);
+    g_ptr_array_unref(parse_context->network_ids);
     g_free(parse_context->apn);
     g_free(parse_context->username);
     g_free(parse_context->password);
@@ -349,7 +499,9 @@ finish_parse_context(ParseContext *parse_context, GError *error)
     g_free(parse_context->auth_method);
     g_slist_free_full(parse_context->dns, g_free);
 
-    g_slice_free(ParseContext, parse_context);
+    nm_g_slice_free(parse_context);
+
+    database_dispatch(db, error);
 }
 
 static void read_next_chunk(GInputStream *stream, ParseContext *parse_context);
@@ -371,13 +523,7 @@ stream_read_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
     }
 
     if (len == 0) {
-        g_set_error(&error,
-                    NM_UTILS_ERROR,
-                    NM_UTILS_ERROR_UNKNOWN,
-                    "Operator ID '%s' not found in service provider database",
-                    parse_context->mccmnc);
-        finish_parse_context(parse_context, error);
-        g_clear_error(&error);
+        finish_parse_context(parse_context, NULL);
         return;
     }
 
@@ -388,11 +534,6 @@ stream_read_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
         return;
     }
 
-    if (parse_context->state == PARSER_DONE) {
-        finish_parse_context(parse_context, NULL);
-        return;
-    }
-
     read_next_chunk(stream, parse_context);
 }
 
@@ -403,7 +544,7 @@ read_next_chunk(GInputStream *stream, ParseContext *parse_context)
                               parse_context->buffer,
                               sizeof(parse_context->buffer),
                               G_PRIORITY_DEFAULT,
-                              parse_context->cancellable,
+                              NULL,
                               stream_read_cb,
                               parse_context);
 }
@@ -430,6 +571,75 @@ file_read_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
 
 /*****************************************************************************/
 
+static gboolean
+database_check_stamp(Database *db)
+{
+    struct stat st;
+    gboolean    unchanged;
+
+    if (stat(db->path, &st) != 0) {
+        db->stamp.ino = 0;
+        return FALSE;
+    }
+
+    unchanged = db->stamp.ino != 0 && db->stamp.dev == st.st_dev && db->stamp.ino == st.st_ino
+                && db->stamp.size == st.st_size
+                && db->stamp.mtime_nsec == nm_utils_timespec_to_nsec(&st.st_mtim);
+
+    db->stamp.dev        = st.st_dev;
+    db->stamp.ino        = st.st_ino;
+    db->stamp.size       = st.st_size;
+    db->stamp.mtime_nsec = nm_utils_timespec_to_nsec(&st.st_mtim);
+    return unchanged;
+}
+
+static void
+database_load(Database *db)
+{
+    gs_unref_object GFile *file = NULL;
+    ParseContext          *parse_context;
+
+    nm_assert(!db->loading);
+
+    db->loading     = TRUE;
+    db->index_valid = FALSE;
+
+    parse_context  = g_slice_new(ParseContext);
+    *parse_context = (ParseContext){
+        .db          = db,
+        .by_mccmnc   = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, apn_entry_free),
+        .network_ids = g_ptr_array_new_with_free_func(g_free),
+    };
+    parse_context->ctx = g_markup_parse_context_new(&parser, 0, parse_context, NULL);
+
+    /* The load is shared by all pending lookups, so it is not cancellable.
+     * Cancelled lookups are completed when the load finishes. */
+    file = g_file_new_for_path(db->path);
+    g_file_read_async(file, G_PRIORITY_DEFAULT, NULL, file_read_cb, parse_context);
+}
+
+static Database *
+database_get(const char *path)
+{
+    Database *db;
+
+    if (!databases)
+        databases = g_hash_table_new(nm_str_hash, g_str_equal);
+
+    db = g_hash_table_lookup(databases, path);
+    if (!db) {
+        db  = g_slice_new(Database);
+        *db = (Database){
+            .path             = g_strdup(path),
+            .lookups_lst_head = C_LIST_INIT(db->lookups_lst_head),
+        };
+        g_hash_table_insert(databases, db->path, db);
+    }
+    return db;
+}
+
+/*****************************************************************************/
+
 void
 nm_service_providers_find_gsm_apn(const char                      *service_providers,
                                   const char                      *mccmnc,
@@ -437,19 +647,32 @@ nm_service_providers_find_gsm_apn(const char                      *service_provi
                                   NMServiceProvidersGsmApnCallback callback,
                                   gpointer                         user_data)
 {
-    GFile        *file;
-    ParseContext *parse_context;
-
-    parse_context              = g_slice_new0(ParseContext);
-    parse_context->mccmnc      = g_strdup(mccmnc);
-    parse_context->cancellable = cancellable;
-    parse_context->callback    = callback;
-    parse_context->user_data   = user_data;
-    parse_context->ctx         = g_markup_parse_context_new(&parser, 0, parse_context, NULL);
-
-    file = g_file_new_for_path(service_providers);
+    Database *db;
+    Lookup   *lookup;
+
+    db = database_get(service_providers);
+
+    lookup  = g_slice_new(Lookup);
+    *lookup = (Lookup){
+        .mccmnc      = g_strdup(mccmnc),
+        .callback    = callback,
+        .user_data   = user_data,
+        .cancellable = nm_g_object_ref(cancellable),
+    };
+    c_list_link_tail(&db->lookups_lst_head, &lookup->lookups_lst);
+
+    if (db->loading) {
+        /* The lookup gets completed once the load finishes. */
+        return;
+    }
 
-    g_file_read_async(file, G_PRIORITY_DEFAULT, cancellable, file_read_cb, parse_context);
+    if (!database_check_stamp(db) || !db->index_valid) {
+        database_load(db);
+        return;
+    }
 
-    g_object_unref(file);
+    /* The index is up to date. Still complete the lookup asynchronously,
+     * like the callers expect. */
+    if (!db->dispatch_source)
+        db->dispatch_source = nm_g_idle_add_source(database_dispatch_cb, db);
 }
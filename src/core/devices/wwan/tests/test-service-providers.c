@@ -115,6 +115,158 @@ test_nonexistent(void)
 
 /*****************************************************************************/
 
+typedef struct {
+    GMainLoop  *loop;
+    const char *expected_apn;
+    guint       pending;
+} ManyData;
+
+static void
+test_many_cb(const char   *apn,
+             const char   *username,
+             const char   *password,
+             const char   *gateway,
+             const char   *auth_method,
+             const GSList *dns,
+             GError       *error,
+             gpointer      user_data)
+{
+    ManyData *data = user_data;
+
+    if (data->expected_apn) {
+        g_assert_no_error(error);
+        g_assert_cmpstr(apn, ==, data->expected_apn);
+    }
+    g_assert_cmpint(data->pending, >, 0);
+    if (--data->pending == 0)
+        g_main_loop_quit(data->loop);
+}
+
+static void
+_run_many(const char *service_providers, const char *mccmnc, const char *expected_apn, guint n)
+{
+    ManyData data = {
+        .loop         = g_main_loop_new(NULL, FALSE),
+        .expected_apn = expected_apn,
+        .pending      = n,
+    };
+    guint i;
+
+    for (i = 0; i < n; i++)
+        nm_service_providers_find_gsm_apn(service_providers, mccmnc, NULL, test_many_cb, &data);
+    g_main_loop_run(data.loop);
+    g_assert_cmpint(data.pending, ==, 0);
+    g_main_loop_unref(data.loop);
+}
+
+static void
+test_many(void)
+{
+    const char *path = NM_BUILD_SRCDIR "/src/core/devices/wwan/tests/test-service-providers.xml";
+    gint64      start;
+    guint       i;
+
+    /* Concurrent lookups share one load of the database. */
+    _run_many(path, "13337", "gprs.example.com", 1000);
+
+    /* Later lookups are served from the index. */
+    start = nm_utils_get_monotonic_timestamp_nsec();
+    for (i = 0; i < 1000; i++) {
+        if (i % 2)
+            _run_many(path, "13337", "gprs.example.com", 1);
+        else
+            _run_many(path, "666999", "access.example.com", 1);
+    }
+    g_test_message("1000 lookups took %" G_GINT64_FORMAT " usec",
+                   (nm_utils_get_monotonic_timestamp_nsec() - start) / 1000);
+}
+
+static void
+test_system_database(void)
+{
+    gint64 start;
+    guint  i;
+
+    if (!g_file_test(MOBILE_BROADBAND_PROVIDER_INFO_DATABASE, G_FILE_TEST_EXISTS)) {
+        g_test_skip("mobile broadband provider database not installed");
+        return;
+    }
+
+    /* Benchmark against the full upstream database. Only the first lookup
+     * parses the file. */
+    start = nm_utils_get_monotonic_timestamp_nsec();
+    for (i = 0; i < 1000; i++)
+        _run_many(MOBILE_BROADBAND_PROVIDER_INFO_DATABASE, "26201", NULL, 1);
+    g_test_message("1000 lookups in %s took %" G_GINT64_FORMAT " usec",
+                   MOBILE_BROADBAND_PROVIDER_INFO_DATABASE,
+                   (nm_utils_get_monotonic_timestamp_nsec() - start) / 1000);
+}
+
+static void
+test_reload_cb(const char   *apn,
+               const char   *username,
+               const char   *password,
+               const char   *gateway,
+               const char   *auth_method,
+               const GSList *dns,
+               GError       *error,
+               gpointer      user_data)
+{
+    char **out_apn = user_data;
+
+    g_assert_no_error(error);
+    *out_apn = g_strdup(apn);
+}
+
+static char *
+_lookup_sync(const char *service_providers, const char *mccmnc)
+{
+    char *apn = NULL;
+
+    nm_service_providers_find_gsm_apn(service_providers, mccmnc, NULL, test_reload_cb, &apn);
+    nmtst_main_context_iterate_until_assert(NULL, 5000, apn);
+    return apn;
+}
+
+static void
+test_reload(void)
+{
+    gs_free char *path =
+        g_build_filename(g_get_tmp_dir(), "nm-test-service-providers-XXXXXX.xml", NULL);
+    gs_free char *apn1 = NULL;
+    gs_free char *apn2 = NULL;
+    gs_free char *apn3 = NULL;
+    int           fd;
+
+#define _XML(apn)                                                               \
+    "<?xml version=\"1.0\" encoding='utf-8'?>"                                   \
+    "<serviceproviders format=\"2.0\"><country code=\"xx\"><provider><gsm>"      \
+    "<network-id mcc=\"001\" mnc=\"01\"/><apn value=\"" apn "\">"                 \
+    "<usage type=\"internet\"/></apn></gsm></provider></country></serviceproviders>"
+
+    fd = g_mkstemp(path);
+    g_assert_cmpint(fd, >=, 0);
+    nm_close(fd);
+
+    g_assert(g_file_set_contents(path, _XML("first.example.com"), -1, NULL));
+    apn1 = _lookup_sync(path, "00101");
+    g_assert_cmpstr(apn1, ==, "first.example.com");
+
+    /* Rewriting the file (which replaces the inode) invalidates the index. */
+    g_assert(g_file_set_contents(path, _XML("second.example.com"), -1, NULL));
+    apn2 = _lookup_sync(path, "00101");
+    g_assert_cmpstr(apn2, ==, "second.example.com");
+
+    apn3 = _lookup_sync(path, "00101");
+    g_assert_cmpstr(apn3, ==, "second.example.com");
+
+#undef _XML
+
+    unlink(path);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -125,6 +277,9 @@ main(int argc, char **argv)
     g_test_add_func("/service-providers/positive", test_positive);
     g_test_add_func("/service-providers/negative", test_negative);
     g_test_add_func("/service-providers/nonexistent", test_nonexistent);
+    g_test_add_func("/service-providers/many", test_many);
+    g_test_add_func("/service-providers/system-database", test_system_database);
+    g_test_add_func("/service-providers/reload", test_reload);
 
     return g_test_run();
 }
@@ -0,0 +1,405 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include "nm-dhcp-lease-store.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "libnm-glib-aux/nm-io-utils.h"
+#include "libnm-glib-aux/nm-str-buf.h"
+
+/*****************************************************************************/
+
+/* The store is an append-only journal. Every record is one line "KEY\tDATA\n",
+ * with both parts escaped by g_strescape(). A later record replaces an earlier
+ * one with the same key, a record with empty DATA deletes the key.
+ *
+ * Changed entries are collected and appended together after a short delay.
+ * That way, many clients that renew at the same time cause one write. When
+ * the journal grows much larger than its live records, it gets rewritten. */
+
+#define FLUSH_DELAY_MSEC 1000
+
+/* Rewrite the journal, when it grows larger than twice the live records
+ * (plus some slack). */
+#define COMPACT_SLACK_BYTES 4096
+
+#define MAX_JOURNAL_BYTES (16u * 1024u * 1024u)
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN LOGD_DHCP
+#define _NMLOG(level, ...) __NMLOG_DEFAULT(level, _NMLOG_DOMAIN, "dhcp-lease-store", __VA_ARGS__)
+
+/*****************************************************************************/
+
+typedef struct {
+    char *key;
+    char *data;
+
+    CList dirty_lst;
+
+    /* The length of the record in a compacted journal. */
+    gsize record_len;
+} Entry;
+
+struct _NMDhcpLeaseStore {
+    char       *filename;
+    GHashTable *entries;
+    CList       dirty_lst_head;
+    GSource    *flush_source;
+
+    /* The size of the journal file, and the size it would have after compaction. */
+    gsize journal_len;
+    gsize live_len;
+
+    guint n_writes;
+
+    /* The journal doesn't end with a complete record. Appending to it
+     * would corrupt the next record. */
+    bool needs_rewrite : 1;
+};
+
+/*****************************************************************************/
+
+static void
+_entry_free(Entry *entry)
+{
+    c_list_unlink_stale(&entry->dirty_lst);
+    g_free(entry->key);
+    g_free(entry->data);
+    nm_g_slice_free(entry);
+}
+
+static void
+_record_append(NMStrBuf *sbuf, const char *key, const char *data)
+{
+    gs_free char *key_escaped  = g_strescape(key, NULL);
+    gs_free char *data_escaped = g_strescape(data ?: "", NULL);
+
+    nm_str_buf_append(sbuf, key_escaped);
+    nm_str_buf_append_c(sbuf, '\t');
+    nm_str_buf_append(sbuf, data_escaped);
+    nm_str_buf_append_c(sbuf, '\n');
+}
+
+static gsize
+_record_len(const char *key, const char *data)
+{
+    nm_auto_str_buf NMStrBuf sbuf = NM_STR_BUF_INIT(NM_UTILS_GET_NEXT_REALLOC_SIZE_104, FALSE);
+
+    _record_append(&sbuf, key, data);
+    return sbuf.len;
+}
+
+/* Updates the entry in memory. Returns FALSE if nothing changed. */
+static gboolean
+_entry_update(NMDhcpLeaseStore *self, const char *key, const char *data, Entry **out_entry)
+{
+    Entry *entry;
+
+    if (data && !data[0])
+        data = NULL;
+
+    entry = g_hash_table_lookup(self->entries, &key);
+
+    NM_SET_OUT(out_entry, entry);
+
+    if (!entry) {
+        if (!data)
+            return FALSE;
+
+        entry  = g_slice_new(Entry);
+        *entry = (Entry){
+            .key        = g_strdup(key),
+            .data       = g_strdup(data),
+            .dirty_lst  = C_LIST_INIT(entry->dirty_lst),
+            .record_len = _record_len(key, data),
+        };
+        g_hash_table_add(self->entries, entry);
+        self->live_len += entry->record_len;
+        NM_SET_OUT(out_entry, entry);
+        return TRUE;
+    }
+
+    if (nm_streq0(entry->data, data))
+        return FALSE;
+
+    self->live_len -= entry->record_len;
+    nm_strdup_reset(&entry->data, data);
+    entry->record_len = entry->data ? _record_len(key, data) : 0;
+    self->live_len += entry->record_len;
+    return TRUE;
+}
+
+static void
+_journal_load(NMDhcpLeaseStore *self)
+{
+    gs_free char         *contents = NULL;
+    gsize                 len;
+    gs_free_error GError *error = NULL;
+    GHashTableIter        iter;
+    Entry                *entry;
+    char                 *line;
+    char                 *line_end;
+
+    if (!nm_utils_file_get_contents(-1,
+                                    self->filename,
+                                    MAX_JOURNAL_BYTES,
+                                    NM_UTILS_FILE_GET_CONTENTS_FLAG_NONE,
+                                    &contents,
+                                    &len,
+                                    NULL,
+                                    &error)) {
+        if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+            _LOGW("failure to read %s: %s", self->filename, error->message);
+        return;
+    }
+
+    self->journal_len = len;
+
+    for (line = contents; (line_end = strchr(line, '\n')); line = &line_end[1]) {
+        gs_free char *key  = NULL;
+        gs_free char *data = NULL;
+        char         *sep;
+
+        *line_end = '\0';
+        sep       = strchr(line, '\t');
+        if (!sep || sep == line)
+            continue;
+        *sep = '\0';
+
+        key  = g_strcompress(line);
+        data = g_strcompress(&sep[1]);
+        _entry_update(self, key, data, NULL);
+    }
+
+    /* A partial last line is ignored. It would be the remainder of
+     * an interrupted write. */
+    if (line[0])
+        self->needs_rewrite = TRUE;
+
+    g_hash_table_iter_init(&iter, self->entries);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &entry, NULL)) {
+        if (!entry->data)
+            g_hash_table_iter_remove(&iter);
+    }
+}
+
+/*****************************************************************************/
+
+static gboolean
+_journal_compact(NMDhcpLeaseStore *self)
+{
+    nm_auto_str_buf NMStrBuf sbuf = NM_STR_BUF_INIT(NM_UTILS_GET_NEXT_REALLOC_SIZE_1000, FALSE);
+    gs_free_error GError    *error = NULL;
+    GHashTableIter           iter;
+    Entry                   *entry;
+
+    g_hash_table_iter_init(&iter, self->entries);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &entry, NULL)) {
+        c_list_unlink(&entry->dirty_lst);
+        if (!entry->data) {
+            g_hash_table_iter_remove(&iter);
+            continue;
+        }
+        _record_append(&sbuf, entry->key, entry->data);
+    }
+
+    nm_assert(sbuf.len == self->live_len);
+
+    self->n_writes++;
+    if (!nm_utils_file_set_contents(self->filename,
+                                    nm_str_buf_get_str_unsafe(&sbuf),
+                                    sbuf.len,
+                                    0600,
+                                    NULL,
+                                    NULL,
+                                    NULL,
+                                    &error)) {
+        _LOGW("failure to write %s: %s", self->filename, error->message);
+        self->needs_rewrite = TRUE;
+        return FALSE;
+    }
+
+    self->journal_len   = sbuf.len;
+    self->needs_rewrite = FALSE;
+    _LOGT("compacted %s to %zu bytes", self->filename, sbuf.len);
+    return TRUE;
+}
+
+static gboolean
+_journal_append(NMDhcpLeaseStore *self)
+{
+    nm_auto_str_buf NMStrBuf sbuf = NM_STR_BUF_INIT(NM_UTILS_GET_NEXT_REALLOC_SIZE_1000, FALSE);
+    nm_auto_close int        fd   = -1;
+    Entry                   *entry;
+    Entry                   *entry_safe;
+    const char              *buf;
+    gsize                    n;
+
+    c_list_for_each_entry_safe (entry, entry_safe, &self->dirty_lst_head, dirty_lst) {
+        c_list_unlink(&entry->dirty_lst);
+        _record_append(&sbuf, entry->key, entry->data);
+        if (!entry->data)
+            g_hash_table_remove(self->entries, entry);
+    }
+
+    if (sbuf.len == 0)
+        return TRUE;
+
+    self->n_writes++;
+
+    fd = open(self->filename, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        _LOGW("failure to open %s: %s", self->filename, nm_strerror_native(errno));
+        self->needs_rewrite = TRUE;
+        return FALSE;
+    }
+
+    buf = nm_str_buf_get_str_unsafe(&sbuf);
+    n   = sbuf.len;
+    while (n > 0) {
+        gssize r;
+
+        r = write(fd, buf, n);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            _LOGW("failure to write %s: %s", self->filename, nm_strerror_native(errno));
+            /* We don't know how much got written. */
+            self->needs_rewrite = TRUE;
+            return FALSE;
+        }
+        buf = &buf[r];
+        n -= r;
+    }
+
+    self->journal_len += sbuf.len;
+    return TRUE;
+}
+
+static gboolean
+_flush_cb(gpointer user_data)
+{
+    nm_dhcp_lease_store_flush(user_data);
+    return G_SOURCE_CONTINUE;
+}
+
+/**
+ * nm_dhcp_lease_store_flush:
+ * @self: the lease store
+ *
+ * Writes all pending changes now. Otherwise, that happens shortly after
+ * the changes.
+ */
+void
+nm_dhcp_lease_store_flush(NMDhcpLeaseStore *self)
+{
+    nm_clear_g_source_inst(&self->flush_source);
+
+    if (c_list_is_empty(&self->dirty_lst_head))
+        return;
+
+    if (self->needs_rewrite || self->journal_len >= 2u * self->live_len + COMPACT_SLACK_BYTES)
+        _journal_compact(self);
+    else
+        _journal_append(self);
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_dhcp_lease_store_get:
+ * @self: the lease store
+ * @key: the key of the lease
+ *
+ * Returns: the data last set for @key or %NULL.
+ */
+const char *
+nm_dhcp_lease_store_get(NMDhcpLeaseStore *self, const char *key)
+{
+    Entry *entry;
+
+    g_return_val_if_fail(self, NULL);
+    g_return_val_if_fail(key, NULL);
+
+    entry = g_hash_table_lookup(self->entries, &key);
+    return entry ? entry->data : NULL;
+}
+
+/**
+ * nm_dhcp_lease_store_set:
+ * @self: the lease store
+ * @key: the key of the lease
+ * @data: (nullable): the data to store. %NULL deletes the entry.
+ *
+ * Stores @data for @key. Writing to disk happens later, and only if
+ * @data differs from what is stored already.
+ *
+ * Returns: %TRUE if the data changed and will be written.
+ */
+gboolean
+nm_dhcp_lease_store_set(NMDhcpLeaseStore *self, const char *key, const char *data)
+{
+    Entry *entry;
+
+    g_return_val_if_fail(self, FALSE);
+    g_return_val_if_fail(key && key[0], FALSE);
+
+    if (!_entry_update(self, key, data, &entry))
+        return FALSE;
+
+    if (c_list_is_empty(&entry->dirty_lst))
+        c_list_link_tail(&self->dirty_lst_head, &entry->dirty_lst);
+
+    if (!self->flush_source)
+        self->flush_source = nm_g_timeout_add_source(FLUSH_DELAY_MSEC, _flush_cb, self);
+
+    return TRUE;
+}
+
+guint
+nm_dhcp_lease_store_get_n_writes(NMDhcpLeaseStore *self)
+{
+    return self->n_writes;
+}
+
+/*****************************************************************************/
+
+NMDhcpLeaseStore *
+nm_dhcp_lease_store_new(const char *filename)
+{
+    NMDhcpLeaseStore *self;
+
+    g_return_val_if_fail(filename, NULL);
+
+    self  = g_slice_new(NMDhcpLeaseStore);
+    *self = (NMDhcpLeaseStore){
+        .filename       = g_strdup(filename),
+        .entries        = g_hash_table_new_full(nm_pstr_hash,
+                                         nm_pstr_equal,
+                                         (GDestroyNotify) _entry_free,
+                                         NULL),
+        .dirty_lst_head = C_LIST_INIT(self->dirty_lst_head),
+    };
+
+    _journal_load(self);
+    return self;
+}
+
+void
+nm_dhcp_lease_store_free(NMDhcpLeaseStore *self)
+{
+    if (!self)
+        return;
+
+    nm_dhcp_lease_store_flush(self);
+
+    nm_clear_g_source_inst(&self->flush_source);
+    nm_clear_pointer(&self->entries, g_hash_table_destroy);
+    g_free(self->filename);
+    nm_g_slice_free(self);
+}
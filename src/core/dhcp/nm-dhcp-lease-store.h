@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef __NM_DHCP_LEASE_STORE_H__
+#define __NM_DHCP_LEASE_STORE_H__
+
+typedef struct _NMDhcpLeaseStore NMDhcpLeaseStore;
+
+NMDhcpLeaseStore *nm_dhcp_lease_store_new(const char *filename);
+
+void nm_dhcp_lease_store_free(NMDhcpLeaseStore *self);
+
+NM_AUTO_DEFINE_FCN0(NMDhcpLeaseStore *, _nm_auto_free_dhcp_lease_store, nm_dhcp_lease_store_free);
+#define nm_auto_free_dhcp_lease_store nm_auto(_nm_auto_free_dhcp_lease_store)
+
+const char *nm_dhcp_lease_store_get(NMDhcpLeaseStore *self, const char *key);
+
+gboolean nm_dhcp_lease_store_set(NMDhcpLeaseStore *self, const char *key, const char *data);
+
+void nm_dhcp_lease_store_flush(NMDhcpLeaseStore *self);
+
+guint nm_dhcp_lease_store_get_n_writes(NMDhcpLeaseStore *self);
+
+#endif /* __NM_DHCP_LEASE_STORE_H__ */
@@ -25,9 +25,12 @@
 #include "nm-config.h"
 #include "nm-core-utils.h"
 #include "nm-dhcp-client-logging.h"
+#include "nm-dhcp-lease-store.h"
 #include "nm-dhcp-options.h"
 #include "nm-dhcp-utils.h"
 #include "nm-l3-config-data.h"
+#include "nm-l3cfg.h"
+#include "nm-netns.h"
 #include "nm-utils.h"
 
 #include "libnm-systemd-shared/nm-sd-utils-shared.h"
@@ -62,6 +65,9 @@ typedef struct {
 
     GSource *event_source;
     char    *lease_file;
+
+    /* The content of @lease_file, as we last wrote or read it. */
+    char *lease_file_contents;
 } NMDhcpNettoolsPrivate;
 
 struct _NMDhcpNettools {
@@ -890,26 +896,86 @@ lease_to_ip4_config(NMDhcpNettools *self, NDhcp4ClientLease *lease, GError **err
 
 /*****************************************************************************/
 
+static NMDhcpLeaseStore *
+lease_store_get(NMDhcpNettools *self)
+{
+    const NMDhcpClientConfig *client_config = nm_dhcp_client_get_config(NM_DHCP_CLIENT(self));
+
+    return nm_netns_get_dhcp_lease_store(nm_l3cfg_get_netns(client_config->l3cfg));
+}
+
+static const char *
+lease_store_key(const char *lease_file)
+{
+    const char *s = strrchr(lease_file, '/');
+
+    return s ? &s[1] : lease_file;
+}
+
 static void
-lease_save(NMDhcpNettools *self, NDhcp4ClientLease *lease, const char *lease_file)
+lease_save(NMDhcpNettools *self, NDhcp4ClientLease *lease, const NML3ConfigData *lease_l3cd)
 {
+    NMDhcpNettoolsPrivate   *priv = NM_DHCP_NETTOOLS_GET_PRIVATE(self);
     struct in_addr           a_address;
     nm_auto_str_buf NMStrBuf sbuf = NM_STR_BUF_INIT(NM_UTILS_GET_NEXT_REALLOC_SIZE_104, FALSE);
     char                     addr_str[NM_INET_ADDRSTRLEN];
     gs_free_error GError    *error = NULL;
+    gs_free const char     **keys  = NULL;
+    GHashTable              *options;
+    const char              *expiry_name;
+    guint                    n_keys;
+    guint                    i;
 
     nm_assert(lease);
-    nm_assert(lease_file);
+    nm_assert(lease_l3cd);
+    nm_assert(priv->lease_file);
 
     n_dhcp4_client_lease_get_yiaddr(lease, &a_address);
     if (a_address.s_addr == INADDR_ANY)
         return;
 
+    nm_inet4_ntop(a_address.s_addr, addr_str);
+
+    /* The lease store of the netns gets all options of the lease, except the
+     * expiry time. That changes with every renewal, while the rest usually
+     * doesn't. The store doesn't write unchanged data. */
+    nm_str_buf_append_printf(&sbuf, "ADDRESS=%s\n", addr_str);
+    options     = nm_dhcp_lease_get_options(nm_l3_config_data_get_dhcp_lease(lease_l3cd, AF_INET));
+    expiry_name = nm_dhcp_option_request_string(AF_INET, NM_DHCP_OPTION_DHCP4_NM_EXPIRY);
+    keys        = nm_strdict_get_keys(options, TRUE, &n_keys);
+    for (i = 0; i < n_keys; i++) {
+        if (nm_streq(keys[i], expiry_name))
+            continue;
+        nm_str_buf_append_printf(&sbuf,
+                                 "%s=%s\n",
+                                 keys[i],
+                                 (const char *) g_hash_table_lookup(options, keys[i]));
+    }
+    nm_dhcp_lease_store_set(lease_store_get(self),
+                            lease_store_key(priv->lease_file),
+                            nm_str_buf_get_str(&sbuf));
+
+    /* The lease file only has the address, which we request again after a
+     * reboot. Only write it when the address changes. */
+    nm_str_buf_reset(&sbuf);
     nm_str_buf_append(&sbuf, "# This is private data. Do not parse.\n");
-    nm_str_buf_append_printf(&sbuf, "ADDRESS=%s\n", nm_inet4_ntop(a_address.s_addr, addr_str));
+    nm_str_buf_append_printf(&sbuf, "ADDRESS=%s\n", addr_str);
+
+    if (nm_streq0(priv->lease_file_contents, nm_str_buf_get_str(&sbuf))) {
+        _LOGT("lease file %s is unchanged", priv->lease_file);
+        return;
+    }
 
-    if (!g_file_set_contents(lease_file, nm_str_buf_get_str_unsafe(&sbuf), sbuf.len, &error))
-        _LOGW("error saving lease to %s: %s", lease_file, error->message);
+    if (!g_file_set_contents(priv->lease_file,
+                             nm_str_buf_get_str_unsafe(&sbuf),
+                             sbuf.len,
+                             &error)) {
+        _LOGW("error saving lease to %s: %s", priv->lease_file, error->message);
+        nm_clear_g_free(&priv->lease_file_contents);
+        return;
+    }
+
+    nm_strdup_reset(&priv->lease_file_contents, nm_str_buf_get_str(&sbuf));
 }
 
 static void
@@ -941,7 +1007,7 @@ bound4_handle(NMDhcpNettools *self, guint event, NDhcp4ClientLease *lease)
         priv->granted.lease      = n_dhcp4_client_lease_ref(lease);
         priv->granted.lease_l3cd = nm_l3_config_data_ref(l3cd);
     } else
-        lease_save(self, lease, priv->lease_file);
+        lease_save(self, lease, l3cd);
 
     _nm_dhcp_client_notify(NM_DHCP_CLIENT(self),
                            event == N_DHCP4_CLIENT_EVENT_GRANTED
@@ -1294,7 +1360,7 @@ _accept(NMDhcpClient *client, const NML3ConfigData *l3cd, GError **error)
 
     r = n_dhcp4_client_lease_accept(priv->granted.lease);
     if (!r)
-        lease_save(self, priv->granted.lease, priv->lease_file);
+        lease_save(self, priv->granted.lease, priv->granted.lease_l3cd);
 
     dhcp4_event_pop_all_events_on_idle(self);
 
@@ -1367,8 +1433,9 @@ ip4_start(NMDhcpClient *client, GError **error)
     NMDhcpNettoolsPrivate    *priv                = NM_DHCP_NETTOOLS_GET_PRIVATE(self);
     gs_unref_bytes GBytes    *effective_client_id = NULL;
     const NMDhcpClientConfig *client_config;
-    gs_free char             *lease_file = NULL;
-    struct in_addr            last_addr  = {0};
+    gs_free char             *lease_file          = NULL;
+    gs_free char             *lease_file_contents = NULL;
+    struct in_addr            last_addr           = {0};
     int                       r, i;
 
     client_config = nm_dhcp_client_get_config(client);
@@ -1400,18 +1467,26 @@ ip4_start(NMDhcpClient *client, GError **error)
     if (client_config->v4.last_address)
         inet_pton(AF_INET, client_config->v4.last_address, &last_addr);
     else {
-        gs_free char *contents = NULL;
-        gs_free char *s_addr   = NULL;
+        gs_free char *s_addr = NULL;
+        const char   *stored;
 
         nm_utils_file_get_contents(-1,
                                    lease_file,
                                    64 * 1024,
                                    NM_UTILS_FILE_GET_CONTENTS_FLAG_NONE,
-                                   &contents,
+                                   &lease_file_contents,
                                    NULL,
                                    NULL,
                                    NULL);
-        nm_parse_env_file(contents, "ADDRESS", &s_addr);
+
+        /* Prefer the lease store. It is from this boot, while the lease file
+         * might be older. */
+        stored = nm_dhcp_lease_store_get(lease_store_get(self), lease_store_key(lease_file));
+        if (NM_STR_HAS_PREFIX(stored, "ADDRESS=")) {
+            stored = &stored[NM_STRLEN("ADDRESS=")];
+            s_addr = g_strndup(stored, strcspn(stored, "\n"));
+        } else
+            nm_parse_env_file(lease_file_contents, "ADDRESS", &s_addr);
         if (s_addr)
             nm_inet_parse_bin(AF_INET, s_addr, NULL, &last_addr);
     }
@@ -1521,6 +1596,8 @@ ip4_start(NMDhcpClient *client, GError **error)
 
     g_free(priv->lease_file);
     priv->lease_file = g_steal_pointer(&lease_file);
+    g_free(priv->lease_file_contents);
+    priv->lease_file_contents = g_steal_pointer(&lease_file_contents);
 
     r = n_dhcp4_client_probe(priv->client, &priv->probe, config);
     if (r) {
@@ -1568,6 +1645,7 @@ dispose(GObject *object)
     NMDhcpNettoolsPrivate *priv = NM_DHCP_NETTOOLS_GET_PRIVATE(object);
 
     nm_clear_g_free(&priv->lease_file);
+    nm_clear_g_free(&priv->lease_file_contents);
     nm_clear_g_source_inst(&priv->event_source);
     nm_clear_g_source_inst(&priv->pop_all_events_on_idle_source);
     nm_clear_pointer(&priv->granted.lease, n_dhcp4_client_lease_unref);
@@ -0,0 +1,227 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include <sys/stat.h>
+
+#include "libnm-glib-aux/nm-io-utils.h"
+
+#include "dhcp/nm-dhcp-lease-store.h"
+
+#include "nm-test-utils-core.h"
+
+#define N_CLIENTS 1000
+
+/*****************************************************************************/
+
+typedef struct {
+    char *tmpdir;
+    char *filename;
+} TestFixture;
+
+static void
+_fixture_init(TestFixture *f)
+{
+    gs_free_error GError *error = NULL;
+
+    f->tmpdir = g_dir_make_tmp("nm-test-dhcp-lease-store-XXXXXX", &error);
+    g_assert_no_error(error);
+    f->filename = g_build_filename(f->tmpdir, "dhcp-leases", NULL);
+}
+
+static void
+_fixture_clear(TestFixture *f)
+{
+    unlink(f->filename);
+    g_assert_cmpint(rmdir(f->tmpdir), ==, 0);
+    nm_clear_g_free(&f->filename);
+    nm_clear_g_free(&f->tmpdir);
+}
+
+static gsize
+_file_size(const char *filename)
+{
+    struct stat st;
+
+    g_assert_cmpint(stat(filename, &st), ==, 0);
+    return st.st_size;
+}
+
+static char *
+_lease_key(guint i)
+{
+    return g_strdup_printf("internal-%08x-eth%u.lease", i, i);
+}
+
+static char *
+_lease_data(guint i, guint generation)
+{
+    return g_strdup_printf("ADDRESS=10.%u.%u.%u\n"
+                           "domain_name=example.com\n"
+                           "routers=10.%u.%u.1\n"
+                           "generation=%u\n",
+                           (i >> 8) & 0xFF,
+                           i & 0xFF,
+                           10 + (generation % 200),
+                           (i >> 8) & 0xFF,
+                           i & 0xFF,
+                           generation);
+}
+
+/*****************************************************************************/
+
+static void
+test_renewals(void)
+{
+    TestFixture       f     = {};
+    NMDhcpLeaseStore *store = NULL;
+    gsize             size_before;
+    guint             round;
+    guint             i;
+
+    _fixture_init(&f);
+
+    store = nm_dhcp_lease_store_new(f.filename);
+
+    /* All clients get their first lease at about the same time. That is
+     * a single write. */
+    for (i = 0; i < N_CLIENTS; i++) {
+        gs_free char *key  = _lease_key(i);
+        gs_free char *data = _lease_data(i, 0);
+
+        g_assert(nm_dhcp_lease_store_set(store, key, data));
+    }
+    g_assert_cmpint(nm_dhcp_lease_store_get_n_writes(store), ==, 0);
+    nmtst_main_context_iterate_until_assert(NULL,
+                                            5000,
+                                            nm_dhcp_lease_store_get_n_writes(store) == 1);
+
+    /* Renewals with the same lease write nothing. */
+    for (round = 0; round < 10; round++) {
+        for (i = 0; i < N_CLIENTS; i++) {
+            gs_free char *key  = _lease_key(i);
+            gs_free char *data = _lease_data(i, 0);
+
+            g_assert(!nm_dhcp_lease_store_set(store, key, data));
+        }
+        nm_dhcp_lease_store_flush(store);
+    }
+    g_assert_cmpint(nm_dhcp_lease_store_get_n_writes(store), ==, 1);
+
+    /* A few clients that get a different lease cause one more write, which
+     * only appends their records. */
+    size_before = _file_size(f.filename);
+    for (i = 0; i < 5; i++) {
+        gs_free char *key  = _lease_key(i * 100);
+        gs_free char *data = _lease_data(i * 100, 1);
+
+        g_assert(nm_dhcp_lease_store_set(store, key, data));
+    }
+    nm_dhcp_lease_store_flush(store);
+    g_assert_cmpint(nm_dhcp_lease_store_get_n_writes(store), ==, 2);
+    g_assert_cmpint(_file_size(f.filename), >, size_before);
+    g_assert_cmpint(_file_size(f.filename), <, size_before + 5 * 200);
+
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    /* The journal has the latest lease of every client. */
+    store = nm_dhcp_lease_store_new(f.filename);
+    for (i = 0; i < N_CLIENTS; i++) {
+        gs_free char *key  = _lease_key(i);
+        gs_free char *data = _lease_data(i, (i % 100 == 0 && i < 500) ? 1 : 0);
+
+        g_assert_cmpstr(nm_dhcp_lease_store_get(store, key), ==, data);
+    }
+
+    /* Setting no data deletes the lease. */
+    g_assert(nm_dhcp_lease_store_set(store, "internal-00000000-eth0.lease", NULL));
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    store = nm_dhcp_lease_store_new(f.filename);
+    g_assert(!nm_dhcp_lease_store_get(store, "internal-00000000-eth0.lease"));
+    g_assert_cmpint(nm_dhcp_lease_store_get_n_writes(store), ==, 0);
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    _fixture_clear(&f);
+}
+
+static void
+test_compact(void)
+{
+    TestFixture       f     = {};
+    NMDhcpLeaseStore *store = NULL;
+    gs_free char     *data  = NULL;
+    gsize             size_max;
+    guint             generation;
+
+    _fixture_init(&f);
+
+    store = nm_dhcp_lease_store_new(f.filename);
+
+    /* A client whose lease always changes makes the journal grow. It gets
+     * rewritten before it is much larger than the one record. */
+    size_max = 0;
+    for (generation = 0; generation < 500; generation++) {
+        nm_clear_g_free(&data);
+        data = _lease_data(7, generation);
+        g_assert(nm_dhcp_lease_store_set(store, "lease-with\ttab\nand-newline", data));
+        nm_dhcp_lease_store_flush(store);
+        size_max = NM_MAX(size_max, _file_size(f.filename));
+    }
+    g_assert_cmpint(nm_dhcp_lease_store_get_n_writes(store), ==, 500);
+    g_assert_cmpint(size_max, <, 3 * 4096);
+
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    store = nm_dhcp_lease_store_new(f.filename);
+    g_assert_cmpstr(nm_dhcp_lease_store_get(store, "lease-with\ttab\nand-newline"), ==, data);
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    _fixture_clear(&f);
+}
+
+static void
+test_truncated(void)
+{
+    TestFixture           f     = {};
+    NMDhcpLeaseStore     *store = NULL;
+    gs_free_error GError *error = NULL;
+
+    _fixture_init(&f);
+
+    /* A record without newline is from an interrupted write. It is ignored,
+     * like garbage lines. */
+    nm_utils_file_set_contents(f.filename,
+                               "key1\tdata1\nkey2\tdata2\ngarbage\nkey1\tdata1-new",
+                               -1,
+                               0600,
+                               NULL,
+                               NULL,
+                               NULL,
+                               &error);
+    g_assert_no_error(error);
+
+    store = nm_dhcp_lease_store_new(f.filename);
+    g_assert_cmpstr(nm_dhcp_lease_store_get(store, "key1"), ==, "data1");
+    g_assert_cmpstr(nm_dhcp_lease_store_get(store, "key2"), ==, "data2");
+    g_assert(!nm_dhcp_lease_store_get(store, "garbage"));
+    nm_clear_pointer(&store, nm_dhcp_lease_store_free);
+
+    _fixture_clear(&f);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE();
+
+int
+main(int argc, char **argv)
+{
+    nmtst_init_assert_logging(&argc, &argv, "INFO", "DEFAULT");
+
+    g_test_add_func("/dhcp/lease-store/renewals", test_renewals);
+    g_test_add_func("/dhcp/lease-store/compact", test_compact);
+    g_test_add_func("/dhcp/lease-store/truncated", test_truncated);
+
+    return g_test_run();
+}
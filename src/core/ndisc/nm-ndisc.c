@@ -104,6 +104,18 @@ NM_UTILS_LOOKUP_STR_DEFINE(nm_ndisc_dhcp_level_to_string,
 
 /*****************************************************************************/
 
+static guint32
+_route_expires_from_expiry(gint64 now_msec, gint64 expiry_msec)
+{
+    if (expiry_msec == NM_NDISC_EXPIRY_INFINITY)
+        return 0;
+
+    /* Let kernel expire the route. The expiry is the absolute time in seconds,
+     * see NMPlatformIP6Route.expires. */
+    expiry_msec = NM_MAX(expiry_msec, now_msec + 1000);
+    return NM_MIN((expiry_msec + 999) / 1000, (gint64) G_MAXUINT32);
+}
+
 NML3ConfigData *
 nm_ndisc_data_to_l3cd(NMDedupMultiIndex        *multi_idx,
                       int                       ifindex,
@@ -163,6 +175,7 @@ nm_ndisc_data_to_l3cd(NMDedupMultiIndex        *multi_idx,
             /* Non-on_link routes get a small penalty */
             .metric  = ndisc_route->duplicate && !ndisc_route->on_link ? 5 : 0,
             .rt_pref = ndisc_route->preference,
+            .expires = _route_expires_from_expiry(now_msec, ndisc_route->expiry_msec),
         };
         nm_assert((NMIcmpv6RouterPref) r.rt_pref == ndisc_route->preference);
 
@@ -199,6 +212,7 @@ nm_ndisc_data_to_l3cd(NMDedupMultiIndex        *multi_idx,
             r.metric  = metric_offset;
             r.gateway = rdata->gateways[i].address;
             r.rt_pref = rdata->gateways[i].preference;
+            r.expires = _route_expires_from_expiry(now_msec, rdata->gateways[i].expiry_msec);
             nm_assert((NMIcmpv6RouterPref) r.rt_pref == rdata->gateways[i].preference);
             nm_l3_config_data_add_route_6(l3cd, &r);
         }
@@ -1245,6 +1259,29 @@ nm_ndisc_start(NMNDisc *ndisc)
     announce_router_initial(ndisc);
 }
 
+/**
+ * nm_ndisc_solicit:
+ * @ndisc: the #NMNDisc instance
+ *
+ * Restart soliciting routers right away, for example because the
+ * link might have moved to a different network while we were asleep.
+ * Does nothing for router mode.
+ */
+void
+nm_ndisc_solicit(NMNDisc *ndisc)
+{
+    NMNDiscPrivate *priv;
+
+    g_return_if_fail(NM_IS_NDISC(ndisc));
+
+    priv = NM_NDISC_GET_PRIVATE(ndisc);
+
+    if (priv->config.node_type != NM_NDISC_NODE_TYPE_HOST)
+        return;
+
+    solicit_timer_start(ndisc);
+}
+
 void
 nm_ndisc_stop(NMNDisc *ndisc)
 {
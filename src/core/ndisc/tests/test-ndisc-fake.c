@@ -8,6 +8,7 @@
 #include <syslog.h>
 
 #include "ndisc/nm-ndisc.h"
+#include "ndisc/nm-ndisc-private.h"
 #include "ndisc/nm-fake-ndisc.h"
 
 #include "platform/nm-fake-platform.h"
@@ -656,6 +657,80 @@ test_dns_solicit_loop(void)
 
 /*****************************************************************************/
 
+static void
+_test_solicit_on_wake_changed(NMNDisc              *ndisc,
+                              const NMNDiscData    *rdata,
+                              guint                 changed_i,
+                              const NML3ConfigData *l3cd,
+                              TestData             *data)
+{
+    data->counter++;
+}
+
+static void
+_test_solicit_on_wake_rs_sent(NMFakeNDisc *ndisc, TestData *data)
+{
+    data->rs_counter++;
+}
+
+static void
+test_solicit_on_wake(void)
+{
+    gs_unref_object NMFakeNDisc *ndisc    = ndisc_new();
+    const gint64                 now_msec = nm_utils_get_monotonic_timestamp_msec();
+    TestData                     data     = {
+                                .timestamp_msec_1 = now_msec,
+    };
+    const NMNDiscData *rdata;
+    guint              id;
+
+    /* A device that keeps its configuration across suspend only solicits
+     * routers again on wake up (nm_device_update_dynamic_ip_setup()). Until
+     * an RA says otherwise, the configuration from before stays. */
+
+    id = nm_fake_ndisc_add_ra(ndisc, 1, NM_NDISC_DHCP_LEVEL_NONE, 4, 1500);
+    g_assert(id);
+    nm_fake_ndisc_add_gateway(ndisc, id, "fe80::1", now_msec + 60000, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+    nm_fake_ndisc_add_prefix(ndisc,
+                             id,
+                             "2001:db8:a:a::",
+                             64,
+                             "fe80::1",
+                             now_msec + 60000,
+                             now_msec + 60000,
+                             10);
+
+    g_signal_connect(ndisc,
+                     NM_NDISC_CONFIG_RECEIVED,
+                     G_CALLBACK(_test_solicit_on_wake_changed),
+                     &data);
+    g_signal_connect(ndisc,
+                     NM_FAKE_NDISC_RS_SENT,
+                     G_CALLBACK(_test_solicit_on_wake_rs_sent),
+                     &data);
+
+    nm_ndisc_start(NM_NDISC(ndisc));
+    nmtst_main_context_iterate_until_assert(NULL, 5000, data.counter == 1);
+    g_assert(nm_fake_ndisc_done(ndisc));
+    g_assert_cmpint(data.rs_counter, ==, 1);
+
+    /* After an RA, the next solicitation is due only after several seconds. */
+    nm_ndisc_solicit(NM_NDISC(ndisc));
+    nmtst_main_context_iterate_until_assert(NULL, 1000, data.rs_counter == 2);
+
+    g_assert_cmpint(data.counter, ==, 1);
+    rdata = &NM_NDISC(ndisc)->rdata->public;
+    g_assert_cmpint(rdata->gateways_n, ==, 1);
+    match_gateway(rdata, 0, "fe80::1", now_msec + 60000, NM_ICMPV6_ROUTER_PREF_MEDIUM);
+    g_assert_cmpint(rdata->addresses_n, ==, 1);
+    match_address(rdata, 0, "2001:db8:a:a::1", now_msec + 60000, now_msec + 60000);
+    g_assert_cmpint(rdata->routes_n, ==, 1);
+
+    nm_ndisc_stop(NM_NDISC(ndisc));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -676,6 +751,7 @@ main(int argc, char **argv)
     g_test_add_func("/ndisc/preference-order", test_preference_order);
     g_test_add_func("/ndisc/preference-changed", test_preference_changed);
     g_test_add_func("/ndisc/dns-solicit-loop", test_dns_solicit_loop);
+    g_test_add_func("/ndisc/solicit-on-wake", test_solicit_on_wake);
 
     return g_test_run();
 }
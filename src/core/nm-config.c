@@ -859,7 +859,9 @@ static const ConfigGroup config_groups[] = {
                              NM_CONFIG_KEYFILE_KEY_MAIN_NO_AUTO_DEFAULT,
                              NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS,
                              NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER,
-                             NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED, ),
+                             NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED,
+                             NM_CONFIG_KEYFILE_KEY_MAIN_VPN_ROUTE_AGGREGATION,
+                             NM_CONFIG_KEYFILE_KEY_MAIN_VPN_STANDBY_SERVICES, ),
     },
     {
         .group = NM_CONFIG_KEYFILE_GROUP_LOGGING,
@@ -896,6 +898,7 @@ static const ConfigGroup config_groups[] = {
                              NM_CONFIG_KEYFILE_KEY_DEVICE_MANAGED,
                              NM_CONFIG_KEYFILE_KEY_DEVICE_SRIOV_NUM_VFS,
                              NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION,
+                             NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION_ON_SLEEP,
                              NM_CONFIG_KEYFILE_KEY_DEVICE_ALLOWED_CONNECTIONS,
                              NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_BACKEND,
                              NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_RAND_MAC_ADDRESS,
@@ -5654,6 +5654,68 @@ nm_rate_limit_check(NMRateLimit *rate_limit, gint32 window_sec, gint32 burst)
     return FALSE;
 }
 
+/*****************************************************************************/
+
+static gboolean
+_idle_batch_cb(gpointer user_data)
+{
+    NMUtilsIdleBatch *batch = user_data;
+    CList             batch_lst_head;
+    CList            *lst;
+    gint64            deadline;
+
+    nm_clear_g_source_inst(&batch->source);
+
+    /* Only handle the elements that are queued now. Elements that get
+     * queued while we run are part of the next batch. */
+    c_list_init(&batch_lst_head);
+    c_list_splice(&batch_lst_head, &batch->lst_head);
+
+    deadline = nm_utils_get_monotonic_timestamp_msec() + batch->budget_msec;
+
+    while ((lst = c_list_first(&batch_lst_head))) {
+        if (nm_utils_get_monotonic_timestamp_msec() > deadline) {
+            /* Out of time. Give the main loop a chance and continue with the
+             * rest later, before the elements that were queued meanwhile.
+             * Those already scheduled a new source. */
+            c_list_splice(&batch_lst_head, &batch->lst_head);
+            c_list_splice(&batch->lst_head, &batch_lst_head);
+            if (!batch->source)
+                batch->source = nm_g_idle_add_source(_idle_batch_cb, batch);
+            break;
+        }
+
+        c_list_unlink(lst);
+        batch->func(lst, batch->user_data);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * nm_utils_idle_batch_link:
+ * @batch: the #NMUtilsIdleBatch
+ * @lst: the unlinked list element to queue
+ *
+ * Queue @lst in @batch. All queued elements are passed to the batch
+ * function from one idle source, until the batch's time budget is used up.
+ * The element is unlinked before calling the function. Callers may
+ * unlink queued elements at any time to dequeue them.
+ */
+void
+nm_utils_idle_batch_link(NMUtilsIdleBatch *batch, CList *lst)
+{
+    nm_assert(batch);
+    nm_assert(batch->func);
+    nm_assert(!c_list_is_linked(lst));
+
+    c_list_link_tail(&batch->lst_head, lst);
+    if (!batch->source)
+        batch->source = nm_g_idle_add_source(_idle_batch_cb, batch);
+}
+
+/*****************************************************************************/
+
 const char *
 nm_utils_get_connection_first_permissions_user(NMConnection *connection)
 {
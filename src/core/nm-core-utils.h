@@ -11,6 +11,7 @@
 #include <arpa/inet.h>
 #include <sys/types.h>
 
+#include "c-list/src/c-list.h"
 #include "nm-connection.h"
 
 #include "libnm-glib-aux/nm-time-utils.h"
@@ -507,6 +508,28 @@ gboolean nm_rate_limit_check(NMRateLimit *rate_limit, gint32 window_sec, gint32
 
 /*****************************************************************************/
 
+typedef void (*NMUtilsIdleBatchFunc)(CList *lst, gpointer user_data);
+
+typedef struct {
+    CList                lst_head;
+    GSource             *source;
+    NMUtilsIdleBatchFunc func;
+    gpointer             user_data;
+    guint                budget_msec;
+} NMUtilsIdleBatch;
+
+#define NM_UTILS_IDLE_BATCH_INIT(name, _func, _user_data, _budget_msec) \
+    {                                                                   \
+        .lst_head    = C_LIST_INIT((name).lst_head),                    \
+        .func        = (_func),                                         \
+        .user_data   = (_user_data),                                    \
+        .budget_msec = (_budget_msec),                                  \
+    }
+
+void nm_utils_idle_batch_link(NMUtilsIdleBatch *batch, CList *lst);
+
+/*****************************************************************************/
+
 const char *nm_utils_get_connection_first_permissions_user(NMConnection *connection);
 
 /*****************************************************************************/
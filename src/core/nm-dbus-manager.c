@@ -8,9 +8,11 @@
 
 #include "nm-dbus-manager.h"
 
+#include <poll.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <gio/gunixfdlist.h>
 
 #include "c-list/src/c-list.h"
 #include "libnm-glib-aux/nm-c-list.h"
@@ -31,16 +33,52 @@
 /*****************************************************************************/
 
 typedef struct {
-    CList  caller_info_lst;
-    gulong uid;
-    gulong pid;
-    gint64 uid_checked_at;
-    gint64 pid_checked_at;
-    bool   uid_valid : 1;
-    bool   pid_valid : 1;
-    char   sender[0];
+    CList         caller_info_lst;
+    CList         pending_calls_lst_head;
+    GCancellable *fetch_cancellable;
+    gulong        uid;
+    gulong        pid;
+    gint64        checked_at;
+    int           pidfd;
+    guint         name_owner_changed_id;
+    bool          uid_valid : 1;
+    bool          pid_valid : 1;
+
+    /* Whether the credentials were fetched while we were subscribed to
+     * NameOwnerChanged for the sender. In that case, the entry stays valid
+     * until the name goes away. */
+    bool tracked : 1;
+    char sender[0];
 } CallerInfo;
 
+typedef struct {
+    NMDBusManager *self;
+    CList          watches_lst_head;
+    GCancellable  *confirm_cancellable;
+    guint          name_owner_changed_id;
+
+    /* Set while the watches are notified that the name is gone. */
+    bool vanished : 1;
+    char name[0];
+} NameWatchData;
+
+struct _NMDBusManagerNameWatch {
+    CList                          watches_lst;
+    NameWatchData                 *data;
+    NMDBusManagerNameWatchCallback callback;
+    gpointer                       user_data;
+};
+
+/* An incoming call that waits in the queue of its sender. Either for the
+ * sender's credentials, or for earlier calls that wait for them. @obj is
+ * %NULL for calls to the object manager. */
+typedef struct {
+    CList                              pending_calls_lst;
+    NMDBusObject                      *obj;
+    const NMDBusInterfaceInfoExtended *interface_info;
+    GDBusMethodInvocation             *invocation;
+} PendingCall;
+
 typedef struct {
     GVariant *value;
 } PropertyCacheData;
@@ -78,7 +116,14 @@ typedef struct {
 
     GDBusConnection *main_dbus_connection;
 
-    CList caller_info_lst_head;
+    /* The caller-infos are indexed by sender in @caller_infos, and
+     * @caller_info_lst_head is sorted by least recent use. */
+    GHashTable *caller_infos;
+    CList       caller_info_lst_head;
+    guint       caller_infos_n_tracked;
+
+    /* The name watches, indexed by unique name. */
+    GHashTable *name_watches;
 
     guint objmgr_registration_id;
     bool  started : 1;
@@ -111,6 +156,23 @@ static const GDBusInterfaceInfo interface_info_objmgr;
 static const GDBusSignalInfo    signal_info_objmgr_interfaces_added;
 static const GDBusSignalInfo    signal_info_objmgr_interfaces_removed;
 static GVariantBuilder *_obj_collect_properties_all(NMDBusObject *obj, GVariantBuilder *builder);
+static GVariantBuilder *_obj_collect_properties_per_interface(NMDBusObject     *obj,
+                                                              RegistrationData *reg_data,
+                                                              GVariantBuilder  *builder);
+static void             _obj_method_call_handle(NMDBusManager         *self,
+                                                RegistrationData      *reg_data,
+                                                GDBusMethodInvocation *invocation);
+static void _objmgr_method_call_handle(NMDBusManager *self, GDBusMethodInvocation *invocation);
+
+/*****************************************************************************/
+
+static const NMDBusInterfaceInfoExtended *
+_reg_data_get_interface_info(RegistrationData *reg_data)
+{
+    nm_assert(reg_data);
+
+    return reg_data->klass->interface_infos[reg_data->info_idx];
+}
 
 /*****************************************************************************/
 
@@ -445,144 +507,521 @@ private_server_get_connection_by_owner(PrivateServer *s, const char *owner)
 
 /*****************************************************************************/
 
+#define CALLER_INFO_MAX_AGE (NM_UTILS_NSEC_PER_SEC * 1)
+#define CALLER_INFO_MAX_NUM 1000
+
+/* Each tracked caller-info has a NameOwnerChanged match rule on the bus, and
+ * the bus limits the number of match rules per connection. Callers beyond
+ * that are not tracked, their credentials expire after CALLER_INFO_MAX_AGE. */
+#define CALLER_INFO_MAX_TRACKED 128
+
+static void
+_pending_call_free(PendingCall *pending_call)
+{
+    c_list_unlink_stale(&pending_call->pending_calls_lst);
+    nm_g_object_unref(pending_call->obj);
+    g_object_unref(pending_call->invocation);
+    nm_g_slice_free(pending_call);
+}
+
+static void
+_pending_call_dispatch(NMDBusManager *self, PendingCall *pending_call)
+{
+    RegistrationData *reg_data;
+
+    c_list_unlink(&pending_call->pending_calls_lst);
+
+    if (!pending_call->obj) {
+        _objmgr_method_call_handle(self, g_object_ref(pending_call->invocation));
+        goto out;
+    }
+
+    /* The object might have been unexported in the meantime. */
+    c_list_for_each_entry (reg_data,
+                           &pending_call->obj->internal.registration_lst_head,
+                           registration_lst) {
+        if (_reg_data_get_interface_info(reg_data) == pending_call->interface_info) {
+            _obj_method_call_handle(self, reg_data, g_object_ref(pending_call->invocation));
+            goto out;
+        }
+    }
+
+    g_dbus_method_invocation_return_error(
+        g_object_ref(pending_call->invocation),
+        G_DBUS_ERROR,
+        G_DBUS_ERROR_UNKNOWN_OBJECT,
+        "Object does not exist at path '%s'",
+        g_dbus_method_invocation_get_object_path(pending_call->invocation));
+
+out:
+    _pending_call_free(pending_call);
+}
+
 static void
-_caller_info_free(CallerInfo *caller_info)
+_caller_info_free(NMDBusManager *self, CallerInfo *caller_info, const char *error_message)
 {
+    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+    PendingCall          *pending_call;
+
+    nm_assert(g_hash_table_lookup(priv->caller_infos, caller_info->sender) == caller_info);
+    nm_assert(error_message || c_list_is_empty(&caller_info->pending_calls_lst_head));
+
+    g_hash_table_remove(priv->caller_infos, caller_info->sender);
     c_list_unlink_stale(&caller_info->caller_info_lst);
+    if (caller_info->name_owner_changed_id != 0) {
+        nm_clear_g_dbus_connection_signal(priv->main_dbus_connection,
+                                          &caller_info->name_owner_changed_id);
+        priv->caller_infos_n_tracked--;
+    }
+    g_cancellable_cancel(caller_info->fetch_cancellable);
+    g_clear_object(&caller_info->fetch_cancellable);
+    while ((pending_call = c_list_first_entry(&caller_info->pending_calls_lst_head,
+                                              PendingCall,
+                                              pending_calls_lst))) {
+        g_dbus_method_invocation_return_error_literal(g_object_ref(pending_call->invocation),
+                                                      G_DBUS_ERROR,
+                                                      G_DBUS_ERROR_FAILED,
+                                                      error_message);
+        _pending_call_free(pending_call);
+    }
+    nm_clear_fd(&caller_info->pidfd);
     g_free(caller_info);
 }
 
-static gboolean
-_bus_get_unix_pid(NMDBusManager *self, const char *sender, gulong *out_pid)
+static void
+_caller_info_set_credentials(CallerInfo  *caller_info,
+                             GVariant    *ret,
+                             GUnixFDList *fd_list,
+                             gboolean     tracked)
 {
-    NMDBusManagerPrivate      *priv     = NM_DBUS_MANAGER_GET_PRIVATE(self);
-    guint32                    unix_pid = G_MAXUINT32;
-    gs_unref_variant GVariant *ret      = NULL;
+    gs_unref_variant GVariant *dict = NULL;
+    guint32                    u32;
+    gint32                     fd_idx;
+
+    caller_info->checked_at = nm_utils_get_monotonic_timestamp_nsec();
+    caller_info->tracked    = tracked && ret;
+    caller_info->uid_valid  = FALSE;
+    caller_info->pid_valid  = FALSE;
+    caller_info->uid        = G_MAXULONG;
+    caller_info->pid        = G_MAXULONG;
+    nm_clear_fd(&caller_info->pidfd);
 
-    if (!priv->main_dbus_connection)
-        return FALSE;
+    if (!ret)
+        return;
+
+    g_variant_get(ret, "(@a{sv})", &dict);
+
+    if (g_variant_lookup(dict, "UnixUserID", "u", &u32)) {
+        caller_info->uid       = u32;
+        caller_info->uid_valid = TRUE;
+    }
+    if (g_variant_lookup(dict, "ProcessID", "u", &u32)) {
+        caller_info->pid       = u32;
+        caller_info->pid_valid = TRUE;
+    }
+    if (fd_list && g_variant_lookup(dict, "ProcessFD", "h", &fd_idx))
+        caller_info->pidfd = g_unix_fd_list_get(fd_list, fd_idx, NULL);
+}
+
+static void
+_caller_info_fetch_sync(NMDBusManager *self, CallerInfo *caller_info)
+{
+    NMDBusManagerPrivate        *priv    = NM_DBUS_MANAGER_GET_PRIVATE(self);
+    gs_unref_variant GVariant   *ret     = NULL;
+    gs_unref_object GUnixFDList *fd_list = NULL;
+
+    /* Usually, the credentials are already fetched asynchronously before
+     * the method call gets dispatched. This is only the fallback for callers
+     * that didn't go through dbus_vtable_method_call(). */
+    if (priv->main_dbus_connection) {
+        ret = g_dbus_connection_call_with_unix_fd_list_sync(priv->main_dbus_connection,
+                                                            DBUS_SERVICE_DBUS,
+                                                            DBUS_PATH_DBUS,
+                                                            DBUS_INTERFACE_DBUS,
+                                                            "GetConnectionCredentials",
+                                                            g_variant_new("(s)", caller_info->sender),
+                                                            G_VARIANT_TYPE("(a{sv})"),
+                                                            G_DBUS_CALL_FLAGS_NONE,
+                                                            2000,
+                                                            NULL,
+                                                            &fd_list,
+                                                            NULL,
+                                                            NULL);
+    }
+
+    _caller_info_set_credentials(caller_info,
+                                 ret,
+                                 fd_list,
+                                 caller_info->name_owner_changed_id != 0);
+}
+
+static void
+_caller_info_fetch_cb(GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    gs_unref_variant GVariant   *ret     = NULL;
+    gs_unref_object GUnixFDList *fd_list = NULL;
+    gs_free_error GError        *error   = NULL;
+    CList                        pending_calls_lst_head;
+    NMDBusManager               *self;
+    CallerInfo                  *caller_info;
+    PendingCall                 *pending_call;
+
+    ret = g_dbus_connection_call_with_unix_fd_list_finish(G_DBUS_CONNECTION(source),
+                                                          &fd_list,
+                                                          result,
+                                                          &error);
+    if (nm_utils_error_is_cancelled(error))
+        return;
+
+    caller_info = user_data;
+    self        = nm_dbus_manager_get();
+
+    g_clear_object(&caller_info->fetch_cancellable);
 
-    ret = g_dbus_connection_call_sync(priv->main_dbus_connection,
-                                      DBUS_SERVICE_DBUS,
-                                      DBUS_PATH_DBUS,
-                                      DBUS_INTERFACE_DBUS,
-                                      "GetConnectionUnixProcessID",
-                                      g_variant_new("(s)", sender),
-                                      G_VARIANT_TYPE("(u)"),
-                                      G_DBUS_CALL_FLAGS_NONE,
-                                      2000,
-                                      NULL,
-                                      NULL);
     if (!ret)
+        _LOGD("failed to get credentials for dbus sender '%s': %s",
+              caller_info->sender,
+              error->message);
+
+    _caller_info_set_credentials(caller_info,
+                                 ret,
+                                 fd_list,
+                                 caller_info->name_owner_changed_id != 0);
+
+    /* The method handlers find the credentials in the cache now. Take the
+     * calls off the caller-info first, the handlers might evict it. */
+    c_list_init(&pending_calls_lst_head);
+    c_list_splice(&pending_calls_lst_head, &caller_info->pending_calls_lst_head);
+    while ((pending_call =
+                c_list_first_entry(&pending_calls_lst_head, PendingCall, pending_calls_lst)))
+        _pending_call_dispatch(self, pending_call);
+}
+
+static void
+_caller_info_fetch_async(NMDBusManager *self, CallerInfo *caller_info)
+{
+    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+
+    if (caller_info->fetch_cancellable)
+        return;
+
+    caller_info->fetch_cancellable = g_cancellable_new();
+
+    /* GetConnectionCredentials gives us UID, PID and (if the bus supports it)
+     * a pidfd in one round trip. */
+    g_dbus_connection_call_with_unix_fd_list(priv->main_dbus_connection,
+                                             DBUS_SERVICE_DBUS,
+                                             DBUS_PATH_DBUS,
+                                             DBUS_INTERFACE_DBUS,
+                                             "GetConnectionCredentials",
+                                             g_variant_new("(s)", caller_info->sender),
+                                             G_VARIANT_TYPE("(a{sv})"),
+                                             G_DBUS_CALL_FLAGS_NONE,
+                                             2000,
+                                             NULL,
+                                             caller_info->fetch_cancellable,
+                                             _caller_info_fetch_cb,
+                                             caller_info);
+}
+
+static gboolean
+_caller_info_is_fresh(const CallerInfo *caller_info, gint64 *p_now_ns)
+{
+    if (caller_info->checked_at == 0)
         return FALSE;
 
-    g_variant_get(ret, "(u)", &unix_pid);
+    if (caller_info->pidfd >= 0) {
+        struct pollfd pfd = {
+            .fd     = caller_info->pidfd,
+            .events = POLLIN,
+        };
 
-    *out_pid = (gulong) unix_pid;
-    return TRUE;
+        /* A pidfd becomes readable when the process exits. */
+        if (poll(&pfd, 1, 0) != 0)
+            return FALSE;
+    }
+
+    if (caller_info->tracked)
+        return TRUE;
+
+    return (nm_utils_get_monotonic_timestamp_nsec_cached(p_now_ns) - caller_info->checked_at)
+           <= CALLER_INFO_MAX_AGE;
 }
 
 static gboolean
-_bus_get_unix_user(NMDBusManager *self, const char *sender, gulong *out_user)
+_name_owner_changed_is_vanished(GVariant *parameters)
 {
-    NMDBusManagerPrivate      *priv     = NM_DBUS_MANAGER_GET_PRIVATE(self);
-    guint32                    unix_uid = G_MAXUINT32;
-    gs_unref_variant GVariant *ret      = NULL;
+    const char *new_owner;
 
-    if (!priv->main_dbus_connection)
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(sss)")))
         return FALSE;
 
-    ret = g_dbus_connection_call_sync(priv->main_dbus_connection,
-                                      DBUS_SERVICE_DBUS,
-                                      DBUS_PATH_DBUS,
-                                      DBUS_INTERFACE_DBUS,
-                                      "GetConnectionUnixUser",
-                                      g_variant_new("(s)", sender),
-                                      G_VARIANT_TYPE("(u)"),
-                                      G_DBUS_CALL_FLAGS_NONE,
-                                      2000,
-                                      NULL,
-                                      NULL);
-    if (!ret)
-        return FALSE;
+    g_variant_get(parameters, "(&s&s&s)", NULL, NULL, &new_owner);
+    return new_owner[0] == '\0';
+}
 
-    g_variant_get(ret, "(u)", &unix_uid);
+static void
+_caller_info_name_owner_changed_cb(GDBusConnection *connection,
+                                   const char      *sender_name,
+                                   const char      *object_path,
+                                   const char      *interface_name,
+                                   const char      *signal_name,
+                                   GVariant        *parameters,
+                                   gpointer         user_data)
+{
+    CallerInfo *caller_info = user_data;
 
-    *out_user = (gulong) unix_uid;
-    return TRUE;
+    if (!_name_owner_changed_is_vanished(parameters))
+        return;
+
+    /* Calls that still wait for the credentials can no longer be answered.
+     * Fail them, instead of dispatching them without credentials. */
+    _caller_info_free(nm_dbus_manager_get(), caller_info, "The caller disconnected");
 }
 
-static const CallerInfo *
-_get_caller_info_ensure(NMDBusManager *self,
-                        const char    *sender,
-                        gboolean       ensure_uid,
-                        gboolean       ensure_pid)
+static CallerInfo *
+_caller_info_lookup(NMDBusManager *self, const char *sender)
 {
     NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
     CallerInfo           *caller_info;
     CallerInfo           *ci;
-    gint64                now_ns;
-    gsize                 num;
+    CallerInfo           *ci_safe;
+    gsize                 l;
 
-#define CALLER_INFO_MAX_AGE (NM_UTILS_NSEC_PER_SEC * 1)
+    caller_info = g_hash_table_lookup(priv->caller_infos, sender);
+    if (caller_info) {
+        nm_c_list_move_front(&priv->caller_info_lst_head, &caller_info->caller_info_lst);
+        return caller_info;
+    }
 
-    /* Linear search the cache for the sender.
-     *
-     * The number of cached caller-infos is limited. Hence, it's O(1) and
-     * the list is reasonably short.
-     * Also, the entire caching assumes that we repeatedly ask for the
-     * same sender. That means, we expect to find the right caller info
-     * at the front of the list. */
-    num         = 1;
-    caller_info = NULL;
-    c_list_for_each_entry (ci, &priv->caller_info_lst_head, caller_info_lst) {
-        if (nm_streq(sender, ci->sender)) {
-            caller_info = ci;
-            break;
+    l            = strlen(sender) + 1;
+    caller_info  = g_malloc(sizeof(CallerInfo) + l);
+    *caller_info = (CallerInfo) {
+        .pending_calls_lst_head = C_LIST_INIT(caller_info->pending_calls_lst_head),
+        .pidfd                  = -1,
+    };
+    memcpy(caller_info->sender, sender, l);
+    c_list_link_front(&priv->caller_info_lst_head, &caller_info->caller_info_lst);
+    g_hash_table_insert(priv->caller_infos, caller_info->sender, caller_info);
+
+    if (priv->main_dbus_connection && priv->caller_infos_n_tracked < CALLER_INFO_MAX_TRACKED) {
+        /* Subscribe before fetching the credentials. Then either the fetch
+         * fails, or we get notified when the name goes away. */
+        caller_info->name_owner_changed_id =
+            nm_dbus_connection_signal_subscribe_name_owner_changed(
+                priv->main_dbus_connection,
+                caller_info->sender,
+                _caller_info_name_owner_changed_cb,
+                caller_info,
+                NULL);
+        priv->caller_infos_n_tracked++;
+    }
+
+    if (g_hash_table_size(priv->caller_infos) > CALLER_INFO_MAX_NUM) {
+        /* Evict the least recently used entries, but never those which
+         * still have method calls waiting for them. */
+        c_list_for_each_entry_safe_reverse (ci,
+                                            ci_safe,
+                                            &priv->caller_info_lst_head,
+                                            caller_info_lst) {
+            if (g_hash_table_size(priv->caller_infos) <= CALLER_INFO_MAX_NUM)
+                break;
+            if (ci == caller_info || ci->fetch_cancellable)
+                continue;
+            _caller_info_free(self, ci, NULL);
         }
-        num++;
     }
 
-    if (caller_info)
-        nm_c_list_move_front(&priv->caller_info_lst_head, &caller_info->caller_info_lst);
-    else {
-        gsize l = strlen(sender) + 1;
+    return caller_info;
+}
 
-        caller_info  = g_malloc(sizeof(CallerInfo) + l);
-        *caller_info = (CallerInfo) {
-            .uid_checked_at = -CALLER_INFO_MAX_AGE,
-            .pid_checked_at = -CALLER_INFO_MAX_AGE,
-        };
-        memcpy(caller_info->sender, sender, l);
-        c_list_link_front(&priv->caller_info_lst_head, &caller_info->caller_info_lst);
+static const CallerInfo *
+_get_caller_info_ensure(NMDBusManager *self, const char *sender)
+{
+    CallerInfo *caller_info;
 
-        /* only cache the last few entries. */
-        while (TRUE) {
-            nm_assert(num > 0 && num == c_list_length(&priv->caller_info_lst_head));
-            if (num-- <= 5)
-                break;
-            _caller_info_free(
-                c_list_last_entry(&priv->caller_info_lst_head, CallerInfo, caller_info_lst));
-        }
+    caller_info = _caller_info_lookup(self, sender);
+    if (!_caller_info_is_fresh(caller_info, NULL))
+        _caller_info_fetch_sync(self, caller_info);
+    return caller_info;
+}
+
+static void
+_name_watch_data_free(NameWatchData *data)
+{
+    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(data->self);
+
+    nm_assert(c_list_is_empty(&data->watches_lst_head));
+
+    if (!data->vanished) {
+        if (!g_hash_table_remove(priv->name_watches, data->name))
+            nm_assert_not_reached();
     }
+    nm_clear_g_dbus_connection_signal(priv->main_dbus_connection, &data->name_owner_changed_id);
+    nm_clear_g_cancellable(&data->confirm_cancellable);
+    g_free(data);
+}
 
-    now_ns = nm_utils_get_monotonic_timestamp_nsec();
+static void
+_name_watch_data_vanished(NameWatchData *data)
+{
+    NMDBusManagerPrivate   *priv = NM_DBUS_MANAGER_GET_PRIVATE(data->self);
+    NMDBusManagerNameWatch *watch;
+
+    nm_assert(!data->vanished);
 
-    if (ensure_uid && (now_ns - caller_info->uid_checked_at) > CALLER_INFO_MAX_AGE) {
-        caller_info->uid_checked_at = now_ns;
-        if (!(caller_info->uid_valid = _bus_get_unix_user(self, sender, &caller_info->uid)))
-            caller_info->uid = G_MAXULONG;
+    _LOGT("name-watch[%s]: name vanished", data->name);
+
+    if (!g_hash_table_remove(priv->name_watches, data->name))
+        nm_assert_not_reached();
+    data->vanished = TRUE;
+
+    /* The callbacks may free any of the watches, also the ones that were
+     * not yet notified. */
+    while ((watch = c_list_first_entry(&data->watches_lst_head,
+                                       NMDBusManagerNameWatch,
+                                       watches_lst))) {
+        c_list_unlink(&watch->watches_lst);
+        watch->data = NULL;
+        watch->callback(watch, watch->user_data);
     }
 
-    if (ensure_pid && (now_ns - caller_info->pid_checked_at) > CALLER_INFO_MAX_AGE) {
-        caller_info->pid_checked_at = now_ns;
-        if (!(caller_info->pid_valid = _bus_get_unix_pid(self, sender, &caller_info->pid)))
-            caller_info->pid = G_MAXULONG;
+    _name_watch_data_free(data);
+}
+
+static void
+_name_watch_name_owner_changed_cb(GDBusConnection *connection,
+                                  const char      *sender_name,
+                                  const char      *object_path,
+                                  const char      *interface_name,
+                                  const char      *signal_name,
+                                  GVariant        *parameters,
+                                  gpointer         user_data)
+{
+    if (_name_owner_changed_is_vanished(parameters))
+        _name_watch_data_vanished(user_data);
+}
+
+static void
+_name_watch_get_name_owner_cb(const char *name_owner, GError *error, gpointer user_data)
+{
+    NameWatchData *data;
+
+    if (!name_owner && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        return;
+
+    data = user_data;
+
+    g_clear_object(&data->confirm_cancellable);
+
+    if (name_owner && nm_streq(name_owner, data->name)) {
+        /* all good, the name is confirmed. */
+        return;
     }
 
-    return caller_info;
+    _name_watch_data_vanished(data);
+}
+
+/**
+ * nm_dbus_manager_name_watch_new:
+ * @self: the #NMDBusManager
+ * @connection: the #GDBusConnection on which @name is. This must be the main
+ *   D-Bus connection.
+ * @name: the unique bus name to watch
+ * @callback: invoked once, when @name disappears from the bus
+ * @user_data: user data for @callback
+ *
+ * All watches for the same name share one lookup and one NameOwnerChanged
+ * subscription, which only matches that name. So having many watches for one
+ * client is cheap, for the daemon and for the bus.
+ *
+ * When the callback is invoked, the watch is no longer active but must still
+ * be freed with nm_dbus_manager_name_watch_free().
+ *
+ * Returns: (transfer full): the new watch.
+ */
+NMDBusManagerNameWatch *
+nm_dbus_manager_name_watch_new(NMDBusManager                 *self,
+                               GDBusConnection               *connection,
+                               const char                    *name,
+                               NMDBusManagerNameWatchCallback callback,
+                               gpointer                       user_data)
+{
+    NMDBusManagerPrivate   *priv;
+    NMDBusManagerNameWatch *watch;
+    NameWatchData          *data;
+
+    g_return_val_if_fail(NM_IS_DBUS_MANAGER(self), NULL);
+    g_return_val_if_fail(name && name[0] == ':', NULL);
+    g_return_val_if_fail(callback, NULL);
+
+    priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+
+    g_return_val_if_fail(connection && connection == priv->main_dbus_connection, NULL);
+
+    data = g_hash_table_lookup(priv->name_watches, name);
+    if (!data) {
+        gsize l = strlen(name) + 1;
+
+        data  = g_malloc(sizeof(NameWatchData) + l);
+        *data = (NameWatchData) {
+            .self                = self,
+            .watches_lst_head    = C_LIST_INIT(data->watches_lst_head),
+            .confirm_cancellable = g_cancellable_new(),
+        };
+        memcpy(data->name, name, l);
+        g_hash_table_insert(priv->name_watches, data->name, data);
+
+        _LOGT("name-watch[%s]: start watching", data->name);
+
+        data->name_owner_changed_id = nm_dbus_connection_signal_subscribe_name_owner_changed(
+            priv->main_dbus_connection,
+            data->name,
+            _name_watch_name_owner_changed_cb,
+            data,
+            NULL);
+
+        /* We only learn about names that go away. Check once that the
+         * name is still there. */
+        nm_dbus_connection_call_get_name_owner(priv->main_dbus_connection,
+                                               data->name,
+                                               -1,
+                                               data->confirm_cancellable,
+                                               _name_watch_get_name_owner_cb,
+                                               data);
+    }
+
+    watch  = g_new(NMDBusManagerNameWatch, 1);
+    *watch = (NMDBusManagerNameWatch) {
+        .data      = data,
+        .callback  = callback,
+        .user_data = user_data,
+    };
+    c_list_link_tail(&data->watches_lst_head, &watch->watches_lst);
+    return watch;
+}
+
+void
+nm_dbus_manager_name_watch_free(NMDBusManagerNameWatch *watch)
+{
+    NameWatchData *data;
+
+    if (!watch)
+        return;
+
+    data = watch->data;
+    if (data) {
+        c_list_unlink(&watch->watches_lst);
+        if (c_list_is_empty(&data->watches_lst_head) && !data->vanished) {
+            _LOGT("name-watch[%s]: stop watching", data->name);
+            _name_watch_data_free(data);
+        }
+    }
+    g_free(watch);
 }
 
+/*****************************************************************************/
+
 static gboolean
 _get_caller_info(NMDBusManager         *self,
                  GDBusMethodInvocation *context,
@@ -641,7 +1080,7 @@ _get_caller_info(NMDBusManager         *self,
         return FALSE;
     }
 
-    caller_info = _get_caller_info_ensure(self, sender, !!out_uid, !!out_pid);
+    caller_info = _get_caller_info_ensure(self, sender);
 
     NM_SET_OUT(out_sender, caller_info->sender);
     NM_SET_OUT(out_uid, caller_info->uid);
@@ -741,7 +1180,7 @@ nm_dbus_manager_get_unix_user(NMDBusManager *self, const char *sender, gulong *o
     }
 
     /* Otherwise, a bus connection */
-    caller_info = _get_caller_info_ensure(self, sender, TRUE, FALSE);
+    caller_info = _get_caller_info_ensure(self, sender);
     *out_uid    = caller_info->uid;
     if (!caller_info->uid_valid) {
         _LOGW("failed to get unix user for dbus sender '%s'", sender);
@@ -752,81 +1191,167 @@ nm_dbus_manager_get_unix_user(NMDBusManager *self, const char *sender, gulong *o
 
 /*****************************************************************************/
 
-static const NMDBusInterfaceInfoExtended *
-_reg_data_get_interface_info(RegistrationData *reg_data)
+/* Queues the incoming call of @sender, if it must wait for the sender's
+ * credentials, or for earlier calls that wait for them. Calls that don't
+ * need credentials must still not overtake those.
+ *
+ * Returns: %TRUE if the call was queued. It gets dispatched once the
+ *   credentials are known. */
+static gboolean
+_caller_info_queue_call(NMDBusManager                     *self,
+                        GDBusConnection                   *connection,
+                        const char                        *sender,
+                        GDBusMethodInvocation             *invocation,
+                        NMDBusObject                      *obj,
+                        const NMDBusInterfaceInfoExtended *interface_info,
+                        gboolean                           need_credentials)
 {
-    nm_assert(reg_data);
+    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+    CallerInfo           *caller_info;
+    PendingCall          *pending_call;
 
-    return reg_data->klass->interface_infos[reg_data->info_idx];
+    if (!sender || connection != priv->main_dbus_connection)
+        return FALSE;
+
+    if (need_credentials) {
+        caller_info = _caller_info_lookup(self, sender);
+        if (c_list_is_empty(&caller_info->pending_calls_lst_head)
+            && _caller_info_is_fresh(caller_info, NULL))
+            return FALSE;
+    } else {
+        caller_info = g_hash_table_lookup(priv->caller_infos, sender);
+        if (!caller_info || c_list_is_empty(&caller_info->pending_calls_lst_head))
+            return FALSE;
+    }
+
+    /* Don't block the main loop on the bus daemon. The fetch is already
+     * in progress, if there are queued calls. */
+    pending_call  = g_slice_new(PendingCall);
+    *pending_call = (PendingCall) {
+        .obj            = obj ? g_object_ref(obj) : NULL,
+        .interface_info = interface_info,
+        .invocation     = invocation,
+    };
+    c_list_link_tail(&caller_info->pending_calls_lst_head, &pending_call->pending_calls_lst);
+    _caller_info_fetch_async(self, caller_info);
+    return TRUE;
 }
 
-/*****************************************************************************/
+static GVariant *
+_obj_get_property(RegistrationData *reg_data, guint property_idx, gboolean refetch)
+{
+    const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info(reg_data);
+    const NMDBusPropertyInfoExtended  *property_info;
+    GVariant                          *value;
+
+    property_info =
+        (const NMDBusPropertyInfoExtended *) (interface_info->parent.properties[property_idx]);
+
+    if (refetch)
+        nm_clear_g_variant(&reg_data->property_cache[property_idx].value);
+    else {
+        value = reg_data->property_cache[property_idx].value;
+        if (value)
+            goto out;
+    }
+
+    value = nm_dbus_utils_get_property(G_OBJECT(reg_data->obj),
+                                       property_info->parent.signature,
+                                       property_info->property_name);
+    reg_data->property_cache[property_idx].value = value;
+out:
+    return g_variant_ref(value);
+}
 
 static void
-dbus_vtable_method_call(GDBusConnection       *connection,
-                        const char            *sender,
-                        const char            *object_path,
-                        const char            *interface_name,
-                        const char            *method_name,
-                        GVariant              *parameters,
-                        GDBusMethodInvocation *invocation,
-                        gpointer               user_data)
+_obj_method_call_handle(NMDBusManager         *self,
+                        RegistrationData      *reg_data,
+                        GDBusMethodInvocation *invocation)
 {
-    NMDBusManager                     *self;
-    NMDBusManagerPrivate              *priv;
-    RegistrationData                  *reg_data       = user_data;
+    NMDBusManagerPrivate              *priv           = NM_DBUS_MANAGER_GET_PRIVATE(self);
     NMDBusObject                      *obj            = reg_data->obj;
     const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info(reg_data);
     const NMDBusMethodInfoExtended    *method_info    = NULL;
-    gboolean                           on_same_interface;
-
-    on_same_interface = nm_streq(interface_info->parent.name, interface_name);
+    GDBusConnection                   *connection;
+    const char                        *sender;
+    const char                        *interface_name;
+    const char                        *method_name;
+    GVariant                          *parameters;
+
+    connection     = g_dbus_method_invocation_get_connection(invocation);
+    sender         = g_dbus_method_invocation_get_sender(invocation);
+    interface_name = g_dbus_method_invocation_get_interface_name(invocation);
+    method_name    = g_dbus_method_invocation_get_method_name(invocation);
+    parameters     = g_dbus_method_invocation_get_parameters(invocation);
+
+    if (nm_streq(interface_name, DBUS_INTERFACE_PROPERTIES)) {
+        if (nm_streq(method_name, "Set")) {
+            const NMDBusPropertyInfoExtended *property_info = NULL;
+            const char                       *property_interface;
+            const char                       *property_name;
+            gs_unref_variant GVariant        *value = NULL;
+
+            g_variant_get(parameters, "(&s&sv)", &property_interface, &property_name, &value);
+
+            nm_assert(nm_streq(property_interface, interface_info->parent.name));
+
+            property_info =
+                (const NMDBusPropertyInfoExtended *) nm_dbus_utils_interface_info_lookup_property(
+                    &interface_info->parent,
+                    property_name,
+                    NULL);
+            if (!property_info
+                || !NM_FLAGS_HAS(property_info->parent.flags,
+                                 G_DBUS_PROPERTY_INFO_FLAGS_WRITABLE))
+                g_return_if_reached();
+
+            if (!priv->set_property_handler) {
+                g_dbus_method_invocation_return_error(invocation,
+                                                      G_DBUS_ERROR,
+                                                      G_DBUS_ERROR_AUTH_FAILED,
+                                                      "Cannot authenticate setting property %s",
+                                                      property_name);
+                return;
+            }
 
-    /* handle property setter first... */
-    if (!on_same_interface && nm_streq(interface_name, DBUS_INTERFACE_PROPERTIES)
-        && nm_streq(method_name, "Set")) {
-        const NMDBusPropertyInfoExtended *property_info = NULL;
-        const char                       *property_interface;
-        const char                       *property_name;
-        gs_unref_variant GVariant        *value = NULL;
+            priv->set_property_handler(obj,
+                                       interface_info,
+                                       property_info,
+                                       connection,
+                                       sender,
+                                       invocation,
+                                       value,
+                                       priv->set_property_handler_data);
+            return;
+        }
 
-        self = nm_dbus_object_get_manager(obj);
-        priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+        if (nm_streq(method_name, "Get")) {
+            gs_unref_variant GVariant *value = NULL;
+            const char                *property_name;
+            guint                      property_idx;
 
-        g_variant_get(parameters, "(&s&sv)", &property_interface, &property_name, &value);
+            g_variant_get(parameters, "(&s&s)", NULL, &property_name);
 
-        nm_assert(nm_streq(property_interface, interface_info->parent.name));
+            if (!nm_dbus_utils_interface_info_lookup_property(&interface_info->parent,
+                                                              property_name,
+                                                              &property_idx))
+                g_return_if_reached();
 
-        property_info =
-            (const NMDBusPropertyInfoExtended *) nm_dbus_utils_interface_info_lookup_property(
-                &interface_info->parent,
-                property_name,
-                NULL);
-        if (!property_info
-            || !NM_FLAGS_HAS(property_info->parent.flags, G_DBUS_PROPERTY_INFO_FLAGS_WRITABLE))
-            g_return_if_reached();
-
-        if (!priv->set_property_handler) {
-            g_dbus_method_invocation_return_error(invocation,
-                                                  G_DBUS_ERROR,
-                                                  G_DBUS_ERROR_AUTH_FAILED,
-                                                  "Cannot authenticate setting property %s",
-                                                  property_name);
+            value = _obj_get_property(reg_data, property_idx, FALSE);
+            g_dbus_method_invocation_return_value(invocation, g_variant_new("(v)", value));
             return;
         }
 
-        priv->set_property_handler(obj,
-                                   interface_info,
-                                   property_info,
-                                   connection,
-                                   sender,
-                                   invocation,
-                                   value,
-                                   priv->set_property_handler_data);
-        return;
-    }
+        if (nm_streq(method_name, "GetAll")) {
+            GVariantBuilder builder;
 
-    if (on_same_interface) {
+            g_dbus_method_invocation_return_value(
+                invocation,
+                g_variant_new("(a{sv})",
+                              _obj_collect_properties_per_interface(obj, reg_data, &builder)));
+            return;
+        }
+    } else if (nm_streq(interface_info->parent.name, interface_name)) {
         method_info = (const NMDBusMethodInfoExtended *) nm_dbus_utils_interface_info_lookup_method(
             &interface_info->parent,
             method_name);
@@ -840,8 +1365,6 @@ dbus_vtable_method_call(GDBusConnection       *connection,
         return;
     }
 
-    self = nm_dbus_object_get_manager(obj);
-    priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
     if (priv->shutting_down && !method_info->allow_during_shutdown) {
         g_dbus_method_invocation_return_error_literal(invocation,
                                                       G_DBUS_ERROR,
@@ -850,7 +1373,7 @@ dbus_vtable_method_call(GDBusConnection       *connection,
         return;
     }
 
-    method_info->handle(reg_data->obj,
+    method_info->handle(obj,
                         interface_info,
                         method_info,
                         connection,
@@ -859,59 +1382,44 @@ dbus_vtable_method_call(GDBusConnection       *connection,
                         parameters);
 }
 
-static GVariant *
-_obj_get_property(RegistrationData *reg_data, guint property_idx, gboolean refetch)
+static void
+dbus_vtable_method_call(GDBusConnection       *connection,
+                        const char            *sender,
+                        const char            *object_path,
+                        const char            *interface_name,
+                        const char            *method_name,
+                        GVariant              *parameters,
+                        GDBusMethodInvocation *invocation,
+                        gpointer               user_data)
 {
-    const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info(reg_data);
-    const NMDBusPropertyInfoExtended  *property_info;
-    GVariant                          *value;
-
-    property_info =
-        (const NMDBusPropertyInfoExtended *) (interface_info->parent.properties[property_idx]);
-
-    if (refetch)
-        nm_clear_g_variant(&reg_data->property_cache[property_idx].value);
-    else {
-        value = reg_data->property_cache[property_idx].value;
-        if (value)
-            goto out;
-    }
-
-    value = nm_dbus_utils_get_property(G_OBJECT(reg_data->obj),
-                                       property_info->parent.signature,
-                                       property_info->property_name);
-    reg_data->property_cache[property_idx].value = value;
-out:
-    return g_variant_ref(value);
-}
-
-static GVariant *
-dbus_vtable_get_property(GDBusConnection *connection,
-                         const char      *sender,
-                         const char      *object_path,
-                         const char      *interface_name,
-                         const char      *property_name,
-                         GError         **error,
-                         gpointer         user_data)
-{
-    RegistrationData                  *reg_data       = user_data;
-    const NMDBusInterfaceInfoExtended *interface_info = _reg_data_get_interface_info(reg_data);
-    guint                              property_idx;
-
-    if (!nm_dbus_utils_interface_info_lookup_property(&interface_info->parent,
-                                                      property_name,
-                                                      &property_idx))
-        g_return_val_if_reached(NULL);
+    RegistrationData *reg_data = user_data;
+    NMDBusManager    *self     = nm_dbus_object_get_manager(reg_data->obj);
+    gboolean          need_credentials;
+
+    /* All calls of a sender go through the same queue, so they are handled
+     * in order. Only reading properties doesn't need the credentials. */
+    need_credentials = !nm_streq(interface_name, DBUS_INTERFACE_PROPERTIES)
+                       || !NM_IN_STRSET(method_name, "Get", "GetAll");
+
+    if (_caller_info_queue_call(self,
+                                connection,
+                                sender,
+                                invocation,
+                                reg_data->obj,
+                                _reg_data_get_interface_info(reg_data),
+                                need_credentials))
+        return;
 
-    return _obj_get_property(reg_data, property_idx, FALSE);
+    _obj_method_call_handle(self, reg_data, invocation);
 }
 
 static const GDBusInterfaceVTable dbus_vtable = {
-    .method_call  = dbus_vtable_method_call,
-    .get_property = dbus_vtable_get_property,
+    .method_call = dbus_vtable_method_call,
 
-    /* set_property is handled via method_call as well. We need to authenticate
-     * which requires an asynchronous handler. */
+    /* Get, GetAll and Set are handled via method_call as well. Setting needs
+     * authentication, which is asynchronous. And none of them may overtake
+     * earlier method calls that wait for the caller's credentials. */
+    .get_property = NULL,
     .set_property = NULL,
 };
 
@@ -1301,22 +1809,14 @@ _obj_collect_properties_all(NMDBusObject *obj, GVariantBuilder *builder)
 }
 
 static void
-dbus_vtable_objmgr_method_call(GDBusConnection       *connection,
-                               const char            *sender,
-                               const char            *object_path,
-                               const char            *interface_name,
-                               const char            *method_name,
-                               GVariant              *parameters,
-                               GDBusMethodInvocation *invocation,
-                               gpointer               user_data)
+_objmgr_method_call_handle(NMDBusManager *self, GDBusMethodInvocation *invocation)
 {
-    NMDBusManager        *self = user_data;
-    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+    NMDBusManagerPrivate *priv           = NM_DBUS_MANAGER_GET_PRIVATE(self);
+    const char           *interface_name = g_dbus_method_invocation_get_interface_name(invocation);
+    const char           *method_name    = g_dbus_method_invocation_get_method_name(invocation);
     GVariantBuilder       array_builder;
     NMDBusObject         *obj;
 
-    nm_assert(nm_streq0(object_path, OBJECT_MANAGER_SERVER_BASE_PATH));
-
     if (!nm_streq(method_name, "GetManagedObjects")
         || !nm_streq(interface_name, interface_info_objmgr.name)) {
         g_dbus_method_invocation_return_error(
@@ -1346,6 +1846,27 @@ dbus_vtable_objmgr_method_call(GDBusConnection       *connection,
                                           g_variant_new("(a{oa{sa{sv}}})", &array_builder));
 }
 
+static void
+dbus_vtable_objmgr_method_call(GDBusConnection       *connection,
+                               const char            *sender,
+                               const char            *object_path,
+                               const char            *interface_name,
+                               const char            *method_name,
+                               GVariant              *parameters,
+                               GDBusMethodInvocation *invocation,
+                               gpointer               user_data)
+{
+    NMDBusManager *self = user_data;
+
+    nm_assert(nm_streq0(object_path, OBJECT_MANAGER_SERVER_BASE_PATH));
+
+    /* Don't let GetManagedObjects() overtake earlier calls of the sender. */
+    if (_caller_info_queue_call(self, connection, sender, invocation, NULL, NULL, FALSE))
+        return;
+
+    _objmgr_method_call_handle(self, invocation);
+}
+
 static const GDBusInterfaceVTable dbus_vtable_objmgr = {.method_call =
                                                             dbus_vtable_objmgr_method_call};
 
@@ -1542,6 +2063,9 @@ nm_dbus_manager_init(NMDBusManager *self)
         g_hash_table_new((GHashFunc) _objects_by_path_hash, (GEqualFunc) _objects_by_path_equal);
 
     c_list_init(&priv->caller_info_lst_head);
+    priv->caller_infos = g_hash_table_new(nm_str_hash, g_str_equal);
+
+    priv->name_watches = g_hash_table_new(nm_str_hash, g_str_equal);
 }
 
 static void
@@ -1551,6 +2075,8 @@ dispose(GObject *object)
     NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
     PrivateServer        *s, *s_safe;
     CallerInfo           *caller_info;
+    NameWatchData        *name_watch_data;
+    GHashTableIter        iter;
 
     /* All exported NMDBusObject instances keep the manager alive, so we don't
      * expect any remaining objects. */
@@ -1567,13 +2093,42 @@ dispose(GObject *object)
                                             nm_steal_int(&priv->objmgr_registration_id));
     }
 
+    while ((caller_info =
+                c_list_first_entry(&priv->caller_info_lst_head, CallerInfo, caller_info_lst)))
+        _caller_info_free(self, caller_info, "NetworkManager is exiting");
+
+    /* The remaining watches are owned by their users. Detach them, they
+     * are never notified anymore. */
+    g_hash_table_iter_init(&iter, priv->name_watches);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &name_watch_data)) {
+        NMDBusManagerNameWatch *watch;
+
+        g_hash_table_iter_remove(&iter);
+        name_watch_data->vanished = TRUE;
+        while ((watch = c_list_first_entry(&name_watch_data->watches_lst_head,
+                                           NMDBusManagerNameWatch,
+                                           watches_lst))) {
+            c_list_unlink(&watch->watches_lst);
+            watch->data = NULL;
+        }
+        _name_watch_data_free(name_watch_data);
+    }
+
     g_clear_object(&priv->main_dbus_connection);
 
     G_OBJECT_CLASS(nm_dbus_manager_parent_class)->dispose(object);
+}
 
-    while ((caller_info =
-                c_list_first_entry(&priv->caller_info_lst_head, CallerInfo, caller_info_lst)))
-        _caller_info_free(caller_info);
+static void
+finalize(GObject *object)
+{
+    NMDBusManager        *self = NM_DBUS_MANAGER(object);
+    NMDBusManagerPrivate *priv = NM_DBUS_MANAGER_GET_PRIVATE(self);
+
+    g_hash_table_destroy(priv->caller_infos);
+    g_hash_table_destroy(priv->name_watches);
+
+    G_OBJECT_CLASS(nm_dbus_manager_parent_class)->finalize(object);
 }
 
 static void
@@ -1581,7 +2136,8 @@ nm_dbus_manager_class_init(NMDBusManagerClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS(klass);
 
-    object_class->dispose = dispose;
+    object_class->dispose  = dispose;
+    object_class->finalize = finalize;
 
     signals[PRIVATE_CONNECTION_NEW] = g_signal_new(NM_DBUS_MANAGER_PRIVATE_CONNECTION_NEW,
                                                    G_OBJECT_CLASS_TYPE(object_class),
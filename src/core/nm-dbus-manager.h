@@ -91,6 +91,18 @@ gboolean nm_dbus_manager_get_caller_info_from_message(NMDBusManager   *self,
 void
 nm_dbus_manager_private_server_register(NMDBusManager *self, const char *path, const char *tag);
 
+typedef struct _NMDBusManagerNameWatch NMDBusManagerNameWatch;
+
+typedef void (*NMDBusManagerNameWatchCallback)(NMDBusManagerNameWatch *watch, gpointer user_data);
+
+NMDBusManagerNameWatch *nm_dbus_manager_name_watch_new(NMDBusManager                 *self,
+                                                       GDBusConnection               *connection,
+                                                       const char                    *name,
+                                                       NMDBusManagerNameWatchCallback callback,
+                                                       gpointer                       user_data);
+
+void nm_dbus_manager_name_watch_free(NMDBusManagerNameWatch *watch);
+
 NMAuthSubject *nm_dbus_manager_new_auth_subject_from_context(GDBusMethodInvocation *context);
 
 NMAuthSubject *nm_dbus_manager_new_auth_subject_from_message(GDBusConnection *connection,
@@ -8,7 +8,7 @@
 #include "nm-keep-alive.h"
 
 #include "settings/nm-settings-connection.h"
-#include "libnm-glib-aux/nm-dbus-aux.h"
+#include "nm-dbus-manager.h"
 
 /*****************************************************************************/
 
@@ -17,18 +17,13 @@ NM_GOBJECT_PROPERTIES_DEFINE(NMKeepAlive, PROP_ALIVE, );
 typedef struct {
     GObject *owner;
 
-    NMSettingsConnection *connection;
-    GDBusConnection      *dbus_connection;
-    char                 *dbus_client;
-
-    GCancellable *dbus_client_confirm_cancellable;
-    guint         subscription_id;
+    NMSettingsConnection   *connection;
+    NMDBusManagerNameWatch *dbus_client_watch;
 
     bool armed : 1;
     bool disarmed : 1;
 
     bool alive : 1;
-    bool dbus_client_confirmed : 1;
     bool dbus_client_watching : 1;
     bool connection_was_visible : 1;
 } NMKeepAlivePrivate;
@@ -191,51 +186,14 @@ nm_keep_alive_set_settings_connection_watch_visible(NMKeepAlive          *self,
 
 /*****************************************************************************/
 
-static void
-get_name_owner_cb(const char *name_owner, GError *error, gpointer user_data)
-{
-    NMKeepAlive        *self;
-    NMKeepAlivePrivate *priv;
-
-    if (!name_owner && g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-        return;
-
-    self = user_data;
-    priv = NM_KEEP_ALIVE_GET_PRIVATE(self);
-
-    if (name_owner && nm_streq(name_owner, priv->dbus_client)) {
-        /* all good, the name is confirmed. */
-        return;
-    }
-
-    _LOGD("DBus client for keep alive is not on the bus");
-    cleanup_dbus_watch(self);
-    _notify_alive(self);
-}
-
 static gboolean
 _is_alive_dbus_client(NMKeepAlive *self)
 {
     NMKeepAlivePrivate *priv = NM_KEEP_ALIVE_GET_PRIVATE(self);
 
-    if (!priv->dbus_client)
-        return FALSE;
-
-    if (!priv->dbus_client_confirmed) {
-        /* it's unconfirmed that the D-Bus client is really alive.
-         * It looks like it is, but as we are claiming that to be
-         * the case, issue an async GetNameOwner call to make sure. */
-        priv->dbus_client_confirmed           = TRUE;
-        priv->dbus_client_confirm_cancellable = g_cancellable_new();
-
-        nm_dbus_connection_call_get_name_owner(priv->dbus_connection,
-                                               priv->dbus_client,
-                                               -1,
-                                               priv->dbus_client_confirm_cancellable,
-                                               get_name_owner_cb,
-                                               self);
-    }
-    return TRUE;
+    /* The watch confirms on its own that the D-Bus client is really on the
+     * bus. Until it tells us otherwise, the client is alive. */
+    return !!priv->dbus_client_watch;
 }
 
 static void
@@ -243,37 +201,18 @@ cleanup_dbus_watch(NMKeepAlive *self)
 {
     NMKeepAlivePrivate *priv = NM_KEEP_ALIVE_GET_PRIVATE(self);
 
-    if (!priv->dbus_client)
+    if (!priv->dbus_client_watch)
         return;
 
     _LOGD("Cleanup DBus client watch");
 
-    nm_clear_g_cancellable(&priv->dbus_client_confirm_cancellable);
-    nm_clear_g_free(&priv->dbus_client);
-    if (priv->dbus_connection) {
-        g_dbus_connection_signal_unsubscribe(priv->dbus_connection,
-                                             nm_steal_int(&priv->subscription_id));
-        g_clear_object(&priv->dbus_connection);
-    }
+    nm_clear_pointer(&priv->dbus_client_watch, nm_dbus_manager_name_watch_free);
 }
 
 static void
-name_owner_changed_cb(GDBusConnection *connection,
-                      const char      *sender_name,
-                      const char      *object_path,
-                      const char      *interface_name,
-                      const char      *signal_name,
-                      GVariant        *parameters,
-                      gpointer         user_data)
+dbus_client_vanished_cb(NMDBusManagerNameWatch *watch, gpointer user_data)
 {
     NMKeepAlive *self = NM_KEEP_ALIVE(user_data);
-    const char  *old_owner;
-    const char  *new_owner;
-
-    g_variant_get(parameters, "(&s&s&s)", NULL, &old_owner, &new_owner);
-
-    if (!nm_streq0(new_owner, ""))
-        return;
 
     _LOGD("DBus client for keep alive disappeared from bus");
     cleanup_dbus_watch(self);
@@ -295,16 +234,12 @@ nm_keep_alive_set_dbus_client_watch(NMKeepAlive     *self,
     if (client_address) {
         _LOGD("Registering dbus client watch for keep alive");
 
-        priv->dbus_client           = g_strdup(client_address);
-        priv->dbus_client_watching  = TRUE;
-        priv->dbus_client_confirmed = FALSE;
-        priv->dbus_connection       = g_object_ref(connection);
-        priv->subscription_id =
-            nm_dbus_connection_signal_subscribe_name_owner_changed(priv->dbus_connection,
-                                                                   priv->dbus_client,
-                                                                   name_owner_changed_cb,
-                                                                   self,
-                                                                   NULL);
+        priv->dbus_client_watching = TRUE;
+        priv->dbus_client_watch    = nm_dbus_manager_name_watch_new(nm_dbus_manager_get(),
+                                                                    connection,
+                                                                    client_address,
+                                                                    dbus_client_vanished_cb,
+                                                                    self);
     } else
         priv->dbus_client_watching = FALSE;
 
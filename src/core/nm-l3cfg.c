@@ -1233,6 +1233,18 @@ _obj_states_sync_filter(NML3Cfg *self, const NMPObject *obj, NML3CfgCommitType c
         return TRUE;
     }
 
+    if (obj_type == NMP_OBJECT_TYPE_IP6_ROUTE && !obj_state->os_plobj
+        && obj_state->os_was_in_platform && NMP_OBJECT_CAST_IP6_ROUTE(obj)->expires != 0
+        && NMP_OBJECT_CAST_IP6_ROUTE(obj)->expires
+               <= (guint32) nm_utils_get_monotonic_timestamp_sec()) {
+        /* The route was configured with RTA_EXPIRES and kernel removed it
+         * because its lifetime is over. The source (NDisc) drops it from
+         * its configuration shortly, don't add it back until then. */
+        _LOGT("obj-state: skip expired: %s",
+              _obj_state_data_to_string(obj_state, sbuf, sizeof(sbuf)));
+        return FALSE;
+    }
+
     /* One goal would be that we don't forcefully re-add routes which were
      * externally removed (e.g. by the user via `ip route del`).
      *
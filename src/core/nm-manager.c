@@ -205,7 +205,12 @@ typedef struct {
 
     GHashTable *devcon_data_dict;
 
-    CList link_cb_lst;
+    /* Links that were added or removed in platform. They are handled together
+     * on an idle handler, so that a burst of new links (like when creating
+     * many SR-IOV VFs and their representors) is processed as one batch. */
+    GArray     *link_cb_ifindexes;
+    GHashTable *link_cb_ifindexes_idx;
+    GSource    *link_cb_idle_source;
 
     NMCheckpointManager *checkpoint_mgr;
 
@@ -410,6 +415,8 @@ static void
 settings_startup_complete_changed(NMSettings *settings, GParamSpec *pspec, NMManager *self);
 
 static void retry_connections_for_parent_device(NMManager *self, NMDevice *device);
+static void
+retry_connections_for_parent_devices(NMManager *self, NMDevice *const *devices, guint n_devices);
 
 static void
 active_connection_state_changed(NMActiveConnection *active, GParamSpec *pspec, NMManager *self);
@@ -2715,14 +2722,20 @@ system_create_virtual_device(NMManager *self, NMConnection *connection, GError *
 }
 
 static void
-retry_connections_for_parent_device(NMManager *self, NMDevice *device)
+retry_connections_for_parent_devices(NMManager *self, NMDevice *const *devices, guint n_devices)
 {
     NMManagerPrivate            *priv = NM_MANAGER_GET_PRIVATE(self);
     NMSettingsConnection *const *connections;
     guint                        i;
+    guint                        j;
 
-    g_return_if_fail(device);
+    if (n_devices == 0)
+        return;
 
+    /* Looking up the parent of a connection is expensive, as it may check
+     * the compatibility of the parent connection with all devices. When
+     * many devices appear at once, do it only once per connection for all
+     * of them. */
     connections = nm_settings_get_connections_sorted_by_autoconnect_priority(priv->settings, NULL);
     for (i = 0; connections[i]; i++) {
         NMSettingsConnection *sett_conn  = connections[i];
@@ -2732,17 +2745,33 @@ retry_connections_for_parent_device(NMManager *self, NMDevice *device)
         NMDevice             *parent;
 
         parent = find_parent_device_for_connection(self, connection, NULL, NULL);
-        if (parent == device) {
-            /* Only try to activate devices that don't already exist */
-            ifname = nm_manager_get_connection_iface(self, connection, &parent, NULL, &error);
-            if (ifname) {
-                if (!nm_platform_link_get_by_ifname(NM_PLATFORM_GET, ifname))
-                    connection_changed(self, sett_conn);
-            }
+        if (!parent)
+            continue;
+
+        for (j = 0; j < n_devices; j++) {
+            if (devices[j] == parent)
+                break;
+        }
+        if (j == n_devices)
+            continue;
+
+        /* Only try to activate devices that don't already exist */
+        ifname = nm_manager_get_connection_iface(self, connection, &parent, NULL, &error);
+        if (ifname) {
+            if (!nm_platform_link_get_by_ifname(NM_PLATFORM_GET, ifname))
+                connection_changed(self, sett_conn);
         }
     }
 }
 
+static void
+retry_connections_for_parent_device(NMManager *self, NMDevice *device)
+{
+    g_return_if_fail(device);
+
+    retry_connections_for_parent_devices(self, &device, 1);
+}
+
 static void
 connection_changed(NMManager *self, NMSettingsConnection *sett_conn)
 {
@@ -3052,18 +3081,6 @@ _rfkill_update(NMManager *self, NMRfkillType rtype)
 
 /*****************************************************************************/
 
-#define KERN_RFKILL_OP_CHANGE_ALL 3
-#define KERN_RFKILL_TYPE_WLAN     1
-#define KERN_RFKILL_TYPE_WWAN     5
-
-struct rfkill_event {
-    uint32_t idx;
-    uint8_t  type;
-    uint8_t  op;
-    uint8_t  soft;
-    uint8_t  hard;
-} _nm_packed;
-
 static void
 _rfkill_update_system(NMManager *self, NMRfkillType rtype, gboolean enabled)
 {
@@ -4156,7 +4173,8 @@ platform_link_added(NMManager                     *self,
                     int                            ifindex,
                     const NMPlatformLink          *plink,
                     gboolean                       guess_assume,
-                    const NMConfigDeviceStateData *dev_state)
+                    const NMConfigDeviceStateData *dev_state,
+                    GPtrArray                     *added_devices)
 {
     NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE(self);
     NMDeviceFactory  *factory;
@@ -4298,7 +4316,10 @@ add:
                                     &error)) {
             add_device(self, device, NULL);
             _device_realize_finish(self, device, plink);
-            retry_connections_for_parent_device(self, device);
+
+            /* The caller will retry the connections for which the new devices
+             * are parents, once for all devices that got added. */
+            g_ptr_array_add(added_devices, g_object_ref(device));
         } else {
             _LOGW(LOGD_DEVICE, "%s: failed to realize device: %s", plink->name, error->message);
         }
@@ -4306,13 +4327,6 @@ add:
     }
 }
 
-typedef struct {
-    CList      lst;
-    NMManager *self;
-    int        ifindex;
-    guint      idle_id;
-} PlatformLinkCbData;
-
 static gboolean
 _check_remove_dev_on_link_deleted(NMManager *self, NMDevice *device)
 {
@@ -4352,22 +4366,17 @@ _check_remove_dev_on_link_deleted(NMManager *self, NMDevice *device)
     return TRUE;
 }
 
-static gboolean
-_platform_link_cb_idle(PlatformLinkCbData *data)
+static void
+_platform_link_changed(NMManager *self, int ifindex, GPtrArray *added_devices)
 {
-    int                   ifindex = data->ifindex;
-    NMManager            *self    = data->self;
-    NMManagerPrivate     *priv    = NM_MANAGER_GET_PRIVATE(self);
+    NMManagerPrivate     *priv = NM_MANAGER_GET_PRIVATE(self);
     const NMPlatformLink *plink;
 
-    c_list_unlink_stale(&data->lst);
-    g_slice_free(PlatformLinkCbData, data);
-
     plink = nm_platform_link_get(priv->platform, ifindex);
     if (plink) {
         const NMPObject *plink_keep_alive = nmp_object_ref(NMP_OBJECT_UP_CAST(plink));
 
-        platform_link_added(self, ifindex, plink, FALSE, NULL);
+        platform_link_added(self, ifindex, plink, FALSE, NULL, added_devices);
         nmp_object_unref(plink_keep_alive);
     } else {
         NMDevice *device;
@@ -4393,6 +4402,29 @@ _platform_link_cb_idle(PlatformLinkCbData *data)
             }
         }
     }
+}
+
+static gboolean
+_platform_link_cb_idle(gpointer user_data)
+{
+    NMManager                   *self          = user_data;
+    NMManagerPrivate            *priv          = NM_MANAGER_GET_PRIVATE(self);
+    gs_unref_array GArray       *ifindexes     = NULL;
+    gs_unref_ptrarray GPtrArray *added_devices = NULL;
+    guint                        i;
+
+    nm_clear_g_source_inst(&priv->link_cb_idle_source);
+    nm_clear_pointer(&priv->link_cb_ifindexes_idx, g_hash_table_unref);
+    ifindexes = g_steal_pointer(&priv->link_cb_ifindexes);
+
+    added_devices = g_ptr_array_new_with_free_func(g_object_unref);
+
+    for (i = 0; i < ifindexes->len; i++)
+        _platform_link_changed(self, nm_g_array_index(ifindexes, int, i), added_devices);
+
+    retry_connections_for_parent_devices(self,
+                                         (NMDevice *const *) added_devices->pdata,
+                                         added_devices->len);
 
     return G_SOURCE_REMOVE;
 }
@@ -4408,7 +4440,6 @@ platform_link_cb(NMPlatform     *platform,
     NMManager                       *self;
     NMManagerPrivate                *priv;
     const NMPlatformSignalChangeType change_type = change_type_i;
-    PlatformLinkCbData              *data;
 
     switch (change_type) {
     case NM_PLATFORM_SIGNAL_ADDED:
@@ -4416,11 +4447,19 @@ platform_link_cb(NMPlatform     *platform,
         self = NM_MANAGER(user_data);
         priv = NM_MANAGER_GET_PRIVATE(self);
 
-        data          = g_slice_new(PlatformLinkCbData);
-        data->self    = self;
-        data->ifindex = ifindex;
-        c_list_link_tail(&priv->link_cb_lst, &data->lst);
-        data->idle_id = g_idle_add((GSourceFunc) _platform_link_cb_idle, data);
+        if (!priv->link_cb_ifindexes) {
+            priv->link_cb_ifindexes     = g_array_new(FALSE, FALSE, sizeof(int));
+            priv->link_cb_ifindexes_idx = g_hash_table_new(nm_direct_hash, NULL);
+        }
+
+        /* The idle handler looks up the current state of the link, so it's
+         * enough to queue each ifindex once. */
+        if (!g_hash_table_add(priv->link_cb_ifindexes_idx, GINT_TO_POINTER(ifindex)))
+            break;
+        g_array_append_val(priv->link_cb_ifindexes, ifindex);
+
+        if (!priv->link_cb_idle_source)
+            priv->link_cb_idle_source = nm_g_idle_add_source(_platform_link_cb_idle, self);
         break;
     default:
         break;
@@ -4430,8 +4469,9 @@ platform_link_cb(NMPlatform     *platform,
 static void
 platform_query_devices(NMManager *self)
 {
-    NMManagerPrivate            *priv  = NM_MANAGER_GET_PRIVATE(self);
-    gs_unref_ptrarray GPtrArray *links = NULL;
+    NMManagerPrivate            *priv          = NM_MANAGER_GET_PRIVATE(self);
+    gs_unref_ptrarray GPtrArray *links         = NULL;
+    gs_unref_ptrarray GPtrArray *added_devices = NULL;
     int                          i;
     gboolean                     guess_assume;
     gs_free char                *order = NULL;
@@ -4441,6 +4481,8 @@ platform_query_devices(NMManager *self)
     if (!links)
         return;
 
+    added_devices = g_ptr_array_new_with_free_func(g_object_unref);
+
     for (i = 0; i < links->len; i++) {
         const NMPlatformLink          *elem = NMP_OBJECT_CAST_LINK(links->pdata[i]);
         const NMPlatformLink          *link;
@@ -4464,8 +4506,13 @@ platform_query_devices(NMManager *self)
                             link->ifindex,
                             link,
                             guess_assume && (!dev_state || !dev_state->connection_uuid),
-                            dev_state);
+                            dev_state,
+                            added_devices);
     }
+
+    retry_connections_for_parent_devices(self,
+                                         (NMDevice *const *) added_devices->pdata,
+                                         added_devices->len);
 }
 
 static void
@@ -7321,6 +7368,26 @@ device_sleep_cb(NMDevice *device, GParamSpec *pspec, NMManager *self)
     }
 }
 
+static gboolean
+device_keeps_configuration_on_sleep(NMDevice *device)
+{
+    /* Wired links usually stay on the same network across a suspend, so
+     * if configured, leave them alone and only revalidate the dynamic
+     * configuration on wake up. Software devices are never taken down on
+     * suspend anyway. */
+    if (nm_device_is_software(device))
+        return FALSE;
+    if (nm_device_get_device_type(device) != NM_DEVICE_TYPE_ETHERNET)
+        return FALSE;
+
+    return nm_config_data_get_device_config_boolean_by_device(
+        NM_CONFIG_GET_DATA,
+        NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION_ON_SLEEP,
+        device,
+        FALSE,
+        FALSE);
+}
+
 static void
 _handle_device_takedown(NMManager *self,
                         NMDevice  *device,
@@ -7378,6 +7445,12 @@ do_sleep_wake(NMManager *self, gboolean sleeping_changed)
                 if (suspending)
                     continue;
             }
+            if (suspending && device_keeps_configuration_on_sleep(device)) {
+                _LOGD(LOGD_SUSPEND,
+                      "sleep: device %s keeps its configuration, skipping",
+                      nm_device_get_ip_iface(device));
+                continue;
+            }
             /* Wake-on-LAN devices will be taken down post-suspend rather than pre- */
             if (suspending && device_is_wake_on_lan(priv->platform, device)) {
                 _LOGD(LOGD_SUSPEND,
@@ -7399,6 +7472,9 @@ do_sleep_wake(NMManager *self, gboolean sleeping_changed)
             c_list_for_each_entry (device, &priv->devices_lst_head, devices_lst) {
                 if (nm_device_is_software(device))
                     continue;
+                if (!nm_device_get_unmanaged_flags(device, NM_UNMANAGED_MANAGER_DISABLED)
+                    && device_keeps_configuration_on_sleep(device))
+                    continue;
 
                 /* Belatedly take down Wake-on-LAN devices; ideally we wouldn't have to do this
                  * but for now it's the only way to make sure we re-check their connectivity.
@@ -7432,9 +7508,10 @@ do_sleep_wake(NMManager *self, gboolean sleeping_changed)
             NMDeviceStateReason reason;
             guint               i;
 
-            if (nm_device_is_software(device)
+            if ((nm_device_is_software(device) || device_keeps_configuration_on_sleep(device))
                 && !nm_device_get_unmanaged_flags(device, NM_UNMANAGED_MANAGER_DISABLED)) {
-                /* DHCP leases of software devices could have gone stale
+                /* DHCP leases of software devices (and of devices that kept
+                 * their configuration across sleep) could have gone stale
                  * so we need to renew them. */
                 nm_device_update_dynamic_ip_setup(device,
                                                   waking_from_suspend ? "wake up"
@@ -9010,7 +9087,6 @@ nm_manager_init(NMManager *self)
     GFile            *file;
 
     c_list_init(&priv->auth_lst_head);
-    c_list_init(&priv->link_cb_lst);
     c_list_init(&priv->devices_lst_head);
     c_list_init(&priv->active_connections_lst_head);
     c_list_init(&priv->async_op_lst_head);
@@ -9260,13 +9336,9 @@ dispose(GObject *object)
     nm_assert(c_list_is_empty(&priv->async_op_lst_head));
 
     g_signal_handlers_disconnect_by_func(priv->platform, G_CALLBACK(platform_link_cb), self);
-    while ((iter = c_list_first(&priv->link_cb_lst))) {
-        PlatformLinkCbData *data = c_list_entry(iter, PlatformLinkCbData, lst);
-
-        g_source_remove(data->idle_id);
-        c_list_unlink_stale(&data->lst);
-        g_slice_free(PlatformLinkCbData, data);
-    }
+    nm_clear_g_source_inst(&priv->link_cb_idle_source);
+    nm_clear_pointer(&priv->link_cb_ifindexes, g_array_unref);
+    nm_clear_pointer(&priv->link_cb_ifindexes_idx, g_hash_table_unref);
 
     while ((iter = c_list_first(&priv->auth_lst_head)))
         nm_auth_chain_destroy(nm_auth_chain_parent_lst_entry(iter));
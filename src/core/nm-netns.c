@@ -15,6 +15,7 @@
 #include "NetworkManagerUtils.h"
 #include "libnm-core-intern/nm-core-internal.h"
 #include "nm-l3cfg.h"
+#include "dhcp/nm-dhcp-lease-store.h"
 #include "libnm-platform/nm-platform.h"
 #include "libnm-platform/nmp-netns.h"
 #include "libnm-platform/nmp-global-tracker.h"
@@ -67,6 +68,7 @@ typedef struct {
     NMPlatform       *platform;
     NMPNetns         *platform_netns;
     NMPGlobalTracker *global_tracker;
+    NMDhcpLeaseStore *dhcp_lease_store;
     GHashTable       *l3cfgs;
     GHashTable       *ip_reservation[_NM_NETNS_IP_RESERVATION_TYPE_NUM];
     GHashTable       *ecmp_track_by_obj;
@@ -317,6 +319,18 @@ nm_netns_get_global_tracker(NMNetns *self)
     return NM_NETNS_GET_PRIVATE(self)->global_tracker;
 }
 
+/* The DHCP clients of all devices in the namespace share one lease store.
+ * It is only created when the first client needs it. */
+NMDhcpLeaseStore *
+nm_netns_get_dhcp_lease_store(NMNetns *self)
+{
+    NMNetnsPrivate *priv = NM_NETNS_GET_PRIVATE(self);
+
+    if (!priv->dhcp_lease_store)
+        priv->dhcp_lease_store = nm_dhcp_lease_store_new(NMRUNDIR "/dhcp-leases");
+    return priv->dhcp_lease_store;
+}
+
 NMDedupMultiIndex *
 nm_netns_get_multi_idx(NMNetns *self)
 {
@@ -1629,6 +1643,8 @@ dispose(GObject *object)
 
     nm_clear_pointer(&priv->global_tracker, nmp_global_tracker_unref);
 
+    nm_clear_pointer(&priv->dhcp_lease_store, nm_dhcp_lease_store_free);
+
     G_OBJECT_CLASS(nm_netns_parent_class)->dispose(object);
 }
 
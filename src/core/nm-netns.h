@@ -31,6 +31,8 @@ NMPNetns           *nm_netns_get_platform_netns(NMNetns *self);
 
 struct _NMPGlobalTracker *nm_netns_get_global_tracker(NMNetns *self);
 
+struct _NMDhcpLeaseStore *nm_netns_get_dhcp_lease_store(NMNetns *self);
+
 struct _NMDedupMultiIndex *nm_netns_get_multi_idx(NMNetns *self);
 
 #define NM_NETNS_GET (nm_netns_get())
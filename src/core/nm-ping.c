@@ -0,0 +1,463 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include "nm-ping.h"
+
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
+#include <netinet/ip_icmp.h>
+
+#include "c-list/src/c-list.h"
+#include "libnm-glib-aux/nm-random-utils.h"
+
+/*****************************************************************************/
+
+/* Like `ping -c 1 -w $deadline` did before, an echo request is sent every
+ * second until the first reply arrives. The overall timeout is up to the
+ * caller. */
+#define PING_INTERVAL_MSEC 1000
+
+/* All probes of one address family share one ICMP socket and one timer.
+ * The socket only exists while there are probes. */
+typedef struct {
+    CList    probes_lst_head;
+    GSource *io_source;
+    GSource *timer_source;
+    int      addr_family;
+    int      fd;
+    int      ref_count;
+    guint16  ident;
+    guint16  seq;
+
+    /* Whether this is a SOCK_RAW socket. With SOCK_DGRAM, the kernel picks
+     * the echo identifier and only passes us the replies to our requests. */
+    bool is_raw : 1;
+} PingSocket;
+
+struct _NMPingProbe {
+    CList               probes_lst;
+    PingSocket         *ping_socket;
+    NMPingProbeCallback callback;
+    gpointer            user_data;
+    NMIPAddr            addr;
+    int                 ifindex;
+};
+
+static PingSocket *_ping_sockets[2];
+
+/*****************************************************************************/
+
+#define _NMLOG_DOMAIN      LOGD_IP
+#define _NMLOG(level, ...) __NMLOG_DEFAULT(level, _NMLOG_DOMAIN, "ping", __VA_ARGS__)
+
+/*****************************************************************************/
+
+static guint16
+_icmp4_checksum(gconstpointer data, gsize len)
+{
+    const guint8 *p   = data;
+    guint32       sum = 0;
+
+    for (; len > 1; len -= 2, p += 2)
+        sum += ((guint32) p[0] << 8) | p[1];
+    if (len > 0)
+        sum += ((guint32) p[0]) << 8;
+    while (sum >> 16)
+        sum = (sum & 0xFFFFu) + (sum >> 16);
+
+    return htons(~sum & 0xFFFFu);
+}
+
+static void
+_probe_send(NMPingProbe *probe)
+{
+    PingSocket *ps      = probe->ping_socket;
+    const int   IS_IPv4 = NM_IS_IPv4(ps->addr_family);
+    char        sbuf[NM_INET_ADDRSTRLEN];
+    union {
+        struct sockaddr_in  sin;
+        struct sockaddr_in6 sin6;
+    } sa;
+    int     ifindex_be = htonl(probe->ifindex);
+    ssize_t n;
+    int     errsv;
+
+    /* Like SO_BINDTODEVICE, but per request. That way, one socket serves
+     * the probes of all interfaces. */
+    if (setsockopt(ps->fd,
+                   IS_IPv4 ? IPPROTO_IP : IPPROTO_IPV6,
+                   IS_IPv4 ? IP_UNICAST_IF : IPV6_UNICAST_IF,
+                   &ifindex_be,
+                   sizeof(ifindex_be))
+        < 0) {
+        errsv = errno;
+        _LOGD("failed to select interface %d for %s: %s",
+              probe->ifindex,
+              nm_inet_ntop(ps->addr_family, &probe->addr, sbuf),
+              nm_strerror_native(errsv));
+        return;
+    }
+
+    ps->seq++;
+
+    if (IS_IPv4) {
+        struct icmphdr hdr = {
+            .type             = ICMP_ECHO,
+            .un.echo.id       = htons(ps->ident),
+            .un.echo.sequence = htons(ps->seq),
+        };
+
+        hdr.checksum = _icmp4_checksum(&hdr, sizeof(hdr));
+
+        sa.sin = (struct sockaddr_in) {
+            .sin_family = AF_INET,
+            .sin_addr   = probe->addr.addr4_struct,
+        };
+        n = sendto(ps->fd,
+                   &hdr,
+                   sizeof(hdr),
+                   MSG_DONTWAIT,
+                   (struct sockaddr *) &sa,
+                   sizeof(sa.sin));
+    } else {
+        struct icmp6_hdr hdr = {
+            .icmp6_type = ICMP6_ECHO_REQUEST,
+        };
+
+        /* The kernel fills in the ICMPv6 checksum. */
+        hdr.icmp6_id  = htons(ps->ident);
+        hdr.icmp6_seq = htons(ps->seq);
+
+        sa.sin6 = (struct sockaddr_in6) {
+            .sin6_family = AF_INET6,
+            .sin6_addr   = probe->addr.addr6,
+            .sin6_scope_id =
+                IN6_IS_ADDR_LINKLOCAL(&probe->addr.addr6) ? (guint32) probe->ifindex : 0u,
+        };
+        n = sendto(ps->fd,
+                   &hdr,
+                   sizeof(hdr),
+                   MSG_DONTWAIT,
+                   (struct sockaddr *) &sa,
+                   sizeof(sa.sin6));
+    }
+
+    if (n < 0) {
+        /* Errors like ENETUNREACH are expected while the interface is still
+         * being configured. We retry with the next tick. */
+        errsv = errno;
+        _LOGT("failed to send echo request to %s on interface %d: %s",
+              nm_inet_ntop(ps->addr_family, &probe->addr, sbuf),
+              probe->ifindex,
+              nm_strerror_native(errsv));
+        return;
+    }
+
+    _LOGT("sent echo request #%u to %s on interface %d",
+          (guint) ps->seq,
+          nm_inet_ntop(ps->addr_family, &probe->addr, sbuf),
+          probe->ifindex);
+}
+
+/*****************************************************************************/
+
+static void
+_ping_socket_unref(PingSocket *ps)
+{
+    nm_assert(ps);
+    nm_assert(ps->ref_count > 0);
+
+    if (--ps->ref_count > 0)
+        return;
+
+    nm_assert(c_list_is_empty(&ps->probes_lst_head));
+    nm_assert(_ping_sockets[NM_IS_IPv4(ps->addr_family)] == ps);
+
+    _ping_sockets[NM_IS_IPv4(ps->addr_family)] = NULL;
+    nm_clear_g_source_inst(&ps->io_source);
+    nm_clear_g_source_inst(&ps->timer_source);
+    nm_close(ps->fd);
+    g_free(ps);
+}
+
+static void
+_ping_socket_dispatch_reply(PingSocket *ps, const NMIPAddr *addr, int ifindex)
+{
+    NMPingProbe *probe;
+
+again:
+    c_list_for_each_entry (probe, &ps->probes_lst_head, probes_lst) {
+        if (ifindex > 0 && ifindex != probe->ifindex)
+            continue;
+        if (!nm_ip_addr_equal(ps->addr_family, addr, &probe->addr))
+            continue;
+
+        c_list_unlink(&probe->probes_lst);
+        probe->callback(probe, probe->user_data);
+        _ping_socket_unref(probe->ping_socket);
+        g_free(probe);
+
+        /* The callback may have cancelled other probes. Start over. */
+        goto again;
+    }
+}
+
+static gboolean
+_ping_socket_receive_one(PingSocket *ps)
+{
+    const int IS_IPv4 = NM_IS_IPv4(ps->addr_family);
+    guint8    buf[512];
+    union {
+        struct sockaddr_in  sin;
+        struct sockaddr_in6 sin6;
+    } sa;
+    union {
+        char v4[CMSG_SPACE(sizeof(struct in_pktinfo))];
+        char v6[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+    } cbuf;
+    struct iovec iov = {
+        .iov_base = buf,
+        .iov_len  = sizeof(buf),
+    };
+    struct msghdr msg = {
+        .msg_name       = &sa,
+        .msg_namelen    = sizeof(sa),
+        .msg_iov        = &iov,
+        .msg_iovlen     = 1,
+        .msg_control    = &cbuf,
+        .msg_controllen = sizeof(cbuf),
+    };
+    struct cmsghdr *cmsg;
+    const guint8   *icmp;
+    gsize           icmp_len;
+    NMIPAddr        addr    = NM_IP_ADDR_INIT;
+    int             ifindex = 0;
+    ssize_t         n;
+    int             errsv;
+
+    n = recvmsg(ps->fd, &msg, MSG_DONTWAIT);
+    if (n < 0) {
+        errsv = errno;
+        if (!NM_IN_SET(errsv, EAGAIN, EWOULDBLOCK, EINTR))
+            _LOGD("failed to receive: %s", nm_strerror_native(errsv));
+        return FALSE;
+    }
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (IS_IPv4 && cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO)
+            ifindex = ((const struct in_pktinfo *) CMSG_DATA(cmsg))->ipi_ifindex;
+        else if (!IS_IPv4 && cmsg->cmsg_level == IPPROTO_IPV6
+                 && cmsg->cmsg_type == IPV6_PKTINFO)
+            ifindex = ((const struct in6_pktinfo *) CMSG_DATA(cmsg))->ipi6_ifindex;
+    }
+
+    icmp     = buf;
+    icmp_len = n;
+
+    if (IS_IPv4) {
+        if (ps->is_raw) {
+            gsize ihl;
+
+            /* Raw IPv4 sockets also pass the IP header. */
+            if (icmp_len < 1)
+                return TRUE;
+            ihl = (icmp[0] & 0x0Fu) * 4u;
+            if (icmp_len < ihl)
+                return TRUE;
+            icmp += ihl;
+            icmp_len -= ihl;
+        }
+        if (icmp_len < sizeof(struct icmphdr))
+            return TRUE;
+        if (((const struct icmphdr *) icmp)->type != ICMP_ECHOREPLY)
+            return TRUE;
+        if (ps->is_raw && ntohs(((const struct icmphdr *) icmp)->un.echo.id) != ps->ident)
+            return TRUE;
+        addr.addr4 = sa.sin.sin_addr.s_addr;
+    } else {
+        if (icmp_len < sizeof(struct icmp6_hdr))
+            return TRUE;
+        if (((const struct icmp6_hdr *) icmp)->icmp6_type != ICMP6_ECHO_REPLY)
+            return TRUE;
+        if (ps->is_raw && ntohs(((const struct icmp6_hdr *) icmp)->icmp6_id) != ps->ident)
+            return TRUE;
+        addr.addr6 = sa.sin6.sin6_addr;
+    }
+
+    _ping_socket_dispatch_reply(ps, &addr, ifindex);
+    return TRUE;
+}
+
+static gboolean
+_ping_socket_io_cb(int fd, GIOCondition condition, gpointer user_data)
+{
+    PingSocket *ps = user_data;
+    guint       i;
+
+    ps->ref_count++;
+
+    /* Don't starve the main loop if there is a flood of packets. */
+    for (i = 0; i < 50; i++) {
+        if (ps->ref_count == 1) {
+            /* All probes are gone. */
+            break;
+        }
+        if (!_ping_socket_receive_one(ps))
+            break;
+    }
+
+    _ping_socket_unref(ps);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+_ping_socket_timer_cb(gpointer user_data)
+{
+    PingSocket  *ps = user_data;
+    NMPingProbe *probe;
+
+    c_list_for_each_entry (probe, &ps->probes_lst_head, probes_lst)
+        _probe_send(probe);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static PingSocket *
+_ping_socket_get(int addr_family, GError **error)
+{
+    const int   IS_IPv4 = NM_IS_IPv4(addr_family);
+    const int   proto   = IS_IPv4 ? IPPROTO_ICMP : IPPROTO_ICMPV6;
+    PingSocket *ps;
+    gboolean    is_raw = FALSE;
+    int         one    = 1;
+    int         fd;
+    int         errsv;
+
+    ps = _ping_sockets[IS_IPv4];
+    if (ps) {
+        ps->ref_count++;
+        return ps;
+    }
+
+    fd = socket(addr_family, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, proto);
+    if (fd < 0 && NM_IN_SET(errno, EACCES, EPERM)) {
+        /* ICMP datagram sockets are only permitted for the groups in
+         * net.ipv4.ping_group_range. Fall back to a raw socket. */
+        fd     = socket(addr_family, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, proto);
+        is_raw = TRUE;
+    }
+    if (fd < 0) {
+        errsv = errno;
+        nm_utils_error_set_errno(error, errsv, "failed to create ICMP socket: %s");
+        return NULL;
+    }
+
+    if (setsockopt(fd,
+                   IS_IPv4 ? IPPROTO_IP : IPPROTO_IPV6,
+                   IS_IPv4 ? IP_PKTINFO : IPV6_RECVPKTINFO,
+                   &one,
+                   sizeof(one))
+        < 0) {
+        errsv = errno;
+        _LOGD("failed to enable packet info on ICMP socket: %s", nm_strerror_native(errsv));
+    }
+
+    if (is_raw && !IS_IPv4) {
+        struct icmp6_filter filter;
+
+        ICMP6_FILTER_SETBLOCKALL(&filter);
+        ICMP6_FILTER_SETPASS(ICMP6_ECHO_REPLY, &filter);
+        if (setsockopt(fd, IPPROTO_ICMPV6, ICMP6_FILTER, &filter, sizeof(filter)) < 0) {
+            errsv = errno;
+            _LOGD("failed to set ICMPv6 filter: %s", nm_strerror_native(errsv));
+        }
+    }
+
+    ps  = g_new(PingSocket, 1);
+    *ps = (PingSocket) {
+        .addr_family = addr_family,
+        .fd          = fd,
+        .ref_count   = 1,
+        .ident       = (guint16) nm_random_u32(),
+        .is_raw      = is_raw,
+    };
+    c_list_init(&ps->probes_lst_head);
+    ps->io_source    = nm_g_unix_fd_add_source(fd, G_IO_IN, _ping_socket_io_cb, ps);
+    ps->timer_source = nm_g_timeout_add_source(PING_INTERVAL_MSEC, _ping_socket_timer_cb, ps);
+
+    _LOGD("created %s ICMP%s socket", is_raw ? "raw" : "datagram", IS_IPv4 ? "" : "v6");
+
+    _ping_sockets[IS_IPv4] = ps;
+    return ps;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_ping_probe_start:
+ * @addr_family: the address family of @addr
+ * @addr: the address to ping
+ * @ifindex: the interface on which to send the echo requests
+ * @callback: invoked when the first echo reply arrives
+ * @user_data: user data for @callback
+ * @error: the failure reason
+ *
+ * Sends an ICMP echo request to @addr every second until a reply arrives.
+ * This never times out, cancel the probe with nm_ping_probe_cancel().
+ *
+ * Returns: the new probe or %NULL if the ICMP socket can't be created.
+ */
+NMPingProbe *
+nm_ping_probe_start(int                 addr_family,
+                    gconstpointer       addr,
+                    int                 ifindex,
+                    NMPingProbeCallback callback,
+                    gpointer            user_data,
+                    GError            **error)
+{
+    NMPingProbe *probe;
+    PingSocket  *ps;
+
+    g_return_val_if_fail(NM_IN_SET(addr_family, AF_INET, AF_INET6), NULL);
+    g_return_val_if_fail(addr, NULL);
+    g_return_val_if_fail(ifindex > 0, NULL);
+    g_return_val_if_fail(callback, NULL);
+    g_return_val_if_fail(!error || !*error, NULL);
+
+    ps = _ping_socket_get(addr_family, error);
+    if (!ps)
+        return NULL;
+
+    probe  = g_new(NMPingProbe, 1);
+    *probe = (NMPingProbe) {
+        .ping_socket = ps,
+        .callback    = callback,
+        .user_data   = user_data,
+        .ifindex     = ifindex,
+    };
+    nm_ip_addr_set(addr_family, &probe->addr, addr);
+    c_list_link_tail(&ps->probes_lst_head, &probe->probes_lst);
+
+    _probe_send(probe);
+    return probe;
+}
+
+void
+nm_ping_probe_cancel(NMPingProbe *probe)
+{
+    if (!probe)
+        return;
+
+    c_list_unlink(&probe->probes_lst);
+    _ping_socket_unref(probe->ping_socket);
+    g_free(probe);
+}
+
+int
+_nm_ping_probe_get_fd(NMPingProbe *probe)
+{
+    g_return_val_if_fail(probe, -1);
+
+    return probe->ping_socket->fd;
+}
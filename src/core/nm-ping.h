@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef __NM_PING_H__
+#define __NM_PING_H__
+
+typedef struct _NMPingProbe NMPingProbe;
+
+/* Invoked once, when the first echo reply for the probe arrives. After the
+ * callback returns, @probe is freed and must no longer be cancelled. */
+typedef void (*NMPingProbeCallback)(NMPingProbe *probe, gpointer user_data);
+
+NMPingProbe *nm_ping_probe_start(int                 addr_family,
+                                 gconstpointer       addr,
+                                 int                 ifindex,
+                                 NMPingProbeCallback callback,
+                                 gpointer            user_data,
+                                 GError            **error);
+
+void nm_ping_probe_cancel(NMPingProbe *probe);
+
+/* For tests. The ICMP socket that the probe uses. */
+int _nm_ping_probe_get_fd(NMPingProbe *probe);
+
+#endif /* __NM_PING_H__ */
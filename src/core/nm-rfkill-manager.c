@@ -7,6 +7,7 @@
 
 #include "nm-rfkill-manager.h"
 
+#include <fcntl.h>
 #include <libudev.h>
 
 #include "c-list/src/c-list.h"
@@ -24,6 +25,12 @@ static guint signals[LAST_SIGNAL] = {0};
 typedef struct {
     NMUdevClient *udev_client;
 
+    /* If /dev/rfkill is available, we track the killswitches from its
+     * events and only use udev to look up details about new killswitches.
+     * Otherwise, we rely on udev uevents. */
+    GSource *rfkill_event_source;
+    int      rfkill_fd;
+
     /* Authoritative rfkill state (RFKILL_* enum) */
     NMRfkillState rfkill_states[NM_RFKILL_TYPE_MAX];
 
@@ -47,14 +54,15 @@ G_DEFINE_TYPE(NMRfkillManager, nm_rfkill_manager, G_TYPE_OBJECT)
 /*****************************************************************************/
 
 typedef struct {
-    CList        killswitch_lst;
-    char        *name;
-    char        *path;
-    char        *driver;
-    guint64      seqnum;
-    NMRfkillType rtype;
-    int          state;
-    bool         platform : 1;
+    CList         killswitch_lst;
+    char         *name;
+    char         *path;
+    char         *driver;
+    guint64       seqnum;
+    NMRfkillType  rtype;
+    NMRfkillState state;
+    guint32       idx;
+    bool          platform : 1;
 } Killswitch;
 
 NMRfkillState
@@ -111,21 +119,23 @@ nm_rfkill_state_to_string(NMRfkillState state)
 }
 
 static Killswitch *
-killswitch_new(struct udev_device *device, NMRfkillType rtype)
+killswitch_new(const char *name, struct udev_device *device, NMRfkillType rtype)
 {
     Killswitch         *ks;
-    struct udev_device *parent      = NULL;
-    struct udev_device *grandparent = NULL;
-    const char         *driver;
-    const char         *subsys;
+    struct udev_device *parent        = NULL;
+    struct udev_device *grandparent   = NULL;
+    const char         *driver        = NULL;
+    const char         *subsys        = NULL;
     const char         *parent_subsys = NULL;
     gboolean            platform;
 
-    driver = udev_device_get_property_value(device, "DRIVER");
-    subsys = udev_device_get_subsystem(device);
+    if (device) {
+        driver = udev_device_get_property_value(device, "DRIVER");
+        subsys = udev_device_get_subsystem(device);
 
-    /* Check parent for various attributes */
-    parent = udev_device_get_parent(device);
+        /* Check parent for various attributes */
+        parent = udev_device_get_parent(device);
+    }
     if (parent) {
         parent_subsys = udev_device_get_subsystem(parent);
         if (!driver)
@@ -147,10 +157,11 @@ killswitch_new(struct udev_device *device, NMRfkillType rtype)
 
     ks  = g_slice_new(Killswitch);
     *ks = (Killswitch) {
-        .name     = g_strdup(udev_device_get_sysname(device)),
-        .seqnum   = udev_device_get_seqnum(device),
-        .path     = g_strdup(udev_device_get_syspath(device)),
+        .name     = g_strdup(name),
+        .seqnum   = device ? udev_device_get_seqnum(device) : 0,
+        .path     = device ? g_strdup(udev_device_get_syspath(device)) : NULL,
         .rtype    = rtype,
+        .state    = NM_RFKILL_STATE_UNAVAILABLE,
         .driver   = g_strdup(driver),
         .platform = platform,
     };
@@ -185,6 +196,29 @@ sysfs_state_to_nm_state(int sysfs_state)
     return NM_RFKILL_STATE_UNBLOCKED;
 }
 
+static NMRfkillState
+kernel_event_to_nm_state(const struct rfkill_event *event)
+{
+    if (event->hard)
+        return NM_RFKILL_STATE_HARD_BLOCKED;
+    if (event->soft)
+        return NM_RFKILL_STATE_SOFT_BLOCKED;
+    return NM_RFKILL_STATE_UNBLOCKED;
+}
+
+static void
+killswitch_set_state(Killswitch *ks, NMRfkillState state)
+{
+    nm_log_dbg(LOGD_RFKILL,
+               "%s rfkill%s switch %s state now %s",
+               nm_rfkill_type_to_string(ks->rtype),
+               ks->platform ? " platform" : "",
+               ks->name,
+               nm_rfkill_state_to_string(state));
+
+    ks->state = state;
+}
+
 static void
 recheck_killswitches(NMRfkillManager *self)
 {
@@ -202,43 +236,16 @@ recheck_killswitches(NMRfkillManager *self)
         platform_checked[i] = FALSE;
     }
 
-    /* Poll the states of all killswitches */
+    /* Combine the (already known) states of all killswitches */
     c_list_for_each_entry (ks, &priv->killswitch_lst_head, killswitch_lst) {
-        struct udev_device *device;
-        NMRfkillState       dev_state;
-        int                 sysfs_state;
-
-        device = udev_device_new_from_subsystem_sysname(nm_udev_client_get_udev(priv->udev_client),
-                                                        "rfkill",
-                                                        ks->name);
-        if (!device)
-            continue;
-        sysfs_state =
-            _nm_utils_ascii_str_to_int64(udev_device_get_property_value(device, "RFKILL_STATE"),
-                                         10,
-                                         G_MININT,
-                                         G_MAXINT,
-                                         -1);
-        dev_state = sysfs_state_to_nm_state(sysfs_state);
-
-        nm_log_dbg(LOGD_RFKILL,
-                   "%s rfkill%s switch %s state now %d/%s",
-                   nm_rfkill_type_to_string(ks->rtype),
-                   ks->platform ? " platform" : "",
-                   ks->name,
-                   sysfs_state,
-                   nm_rfkill_state_to_string(dev_state));
-
         if (ks->platform == FALSE) {
-            if (dev_state > poll_states[ks->rtype])
-                poll_states[ks->rtype] = dev_state;
+            if (ks->state > poll_states[ks->rtype])
+                poll_states[ks->rtype] = ks->state;
         } else {
             platform_checked[ks->rtype] = TRUE;
-            if (dev_state > platform_states[ks->rtype])
-                platform_states[ks->rtype] = dev_state;
+            if (ks->state > platform_states[ks->rtype])
+                platform_states[ks->rtype] = ks->state;
         }
-
-        udev_device_unref(device);
     }
 
     /* Log and emit change signal for final rfkill states */
@@ -267,6 +274,40 @@ recheck_killswitches(NMRfkillManager *self)
     }
 }
 
+static void
+poll_killswitches(NMRfkillManager *self)
+{
+    NMRfkillManagerPrivate *priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+    Killswitch             *ks;
+
+    /* Without /dev/rfkill, we don't know which killswitch changed. Re-read
+     * the states of all of them from sysfs. */
+    c_list_for_each_entry (ks, &priv->killswitch_lst_head, killswitch_lst) {
+        struct udev_device *device = NULL;
+        int                 sysfs_state;
+
+        if (priv->udev_client) {
+            device =
+                udev_device_new_from_subsystem_sysname(nm_udev_client_get_udev(priv->udev_client),
+                                                       "rfkill",
+                                                       ks->name);
+        }
+        if (!device) {
+            ks->state = NM_RFKILL_STATE_UNAVAILABLE;
+            continue;
+        }
+        sysfs_state =
+            _nm_utils_ascii_str_to_int64(udev_device_get_property_value(device, "RFKILL_STATE"),
+                                         10,
+                                         G_MININT,
+                                         G_MAXINT,
+                                         -1);
+        killswitch_set_state(ks, sysfs_state_to_nm_state(sysfs_state));
+
+        udev_device_unref(device);
+    }
+}
+
 static Killswitch *
 killswitch_find_by_name(NMRfkillManager *self, const char *name)
 {
@@ -282,6 +323,19 @@ killswitch_find_by_name(NMRfkillManager *self, const char *name)
     return NULL;
 }
 
+static Killswitch *
+killswitch_find_by_idx(NMRfkillManager *self, guint32 idx)
+{
+    NMRfkillManagerPrivate *priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+    Killswitch             *ks;
+
+    c_list_for_each_entry (ks, &priv->killswitch_lst_head, killswitch_lst) {
+        if (ks->idx == idx)
+            return ks;
+    }
+    return NULL;
+}
+
 static NMRfkillType
 rfkill_type_to_enum(const char *str)
 {
@@ -295,6 +349,30 @@ rfkill_type_to_enum(const char *str)
     return NM_RFKILL_TYPE_UNKNOWN;
 }
 
+static NMRfkillType
+kernel_rfkill_type_to_enum(guint8 type)
+{
+    switch (type) {
+    case KERN_RFKILL_TYPE_WLAN:
+        return NM_RFKILL_TYPE_WLAN;
+    case KERN_RFKILL_TYPE_WWAN:
+        return NM_RFKILL_TYPE_WWAN;
+    }
+    return NM_RFKILL_TYPE_UNKNOWN;
+}
+
+static void
+killswitch_log_found(Killswitch *ks)
+{
+    nm_log_info(LOGD_RFKILL,
+                "%s: found %s radio killswitch (at %s) (%sdriver %s)",
+                ks->name,
+                nm_rfkill_type_to_string(ks->rtype),
+                ks->path ?: "<unknown>",
+                ks->platform ? "platform " : "",
+                ks->driver ?: "<unknown>");
+}
+
 static void
 add_one_killswitch(NMRfkillManager *self, struct udev_device *device)
 {
@@ -306,16 +384,10 @@ add_one_killswitch(NMRfkillManager *self, struct udev_device *device)
     if (rtype == NM_RFKILL_TYPE_UNKNOWN)
         return;
 
-    ks = killswitch_new(device, rtype);
+    ks = killswitch_new(udev_device_get_sysname(device), device, rtype);
     c_list_link_front(&priv->killswitch_lst_head, &ks->killswitch_lst);
 
-    nm_log_info(LOGD_RFKILL,
-                "%s: found %s radio killswitch (at %s) (%sdriver %s)",
-                ks->name,
-                nm_rfkill_type_to_string(rtype),
-                ks->path,
-                ks->platform ? "platform " : "",
-                ks->driver ?: "<unknown>");
+    killswitch_log_found(ks);
 }
 
 static void
@@ -379,25 +451,30 @@ handle_uevent(NMUdevClient *client, struct udev_device *device, gpointer user_da
     else if (nm_streq(action, "remove"))
         rfkill_remove(self, device);
 
+    poll_killswitches(self);
     recheck_killswitches(self);
 }
 
-/*****************************************************************************/
-
+/* Tracks the killswitches via udev uevents, when /dev/rfkill is not available
+ * or stopped working. The caller must recheck the killswitches afterwards. */
 static void
-nm_rfkill_manager_init(NMRfkillManager *self)
+udev_tracking_start(NMRfkillManager *self)
 {
     NMRfkillManagerPrivate *priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
     struct udev_enumerate  *enumerate;
     struct udev_list_entry *iter;
-    guint                   i;
 
-    c_list_init(&priv->killswitch_lst_head);
-
-    for (i = 0; i < NM_RFKILL_TYPE_MAX; i++)
-        priv->rfkill_states[i] = NM_RFKILL_STATE_UNAVAILABLE;
+    nm_assert(priv->rfkill_fd < 0);
 
+    /* A udev client that was only used for looking up devices has no
+     * uevent callback. Replace it. */
+    priv->udev_client = nm_udev_client_destroy(priv->udev_client);
     priv->udev_client = nm_udev_client_new(NM_MAKE_STRV("rfkill"), handle_uevent, self);
+    if (!priv->udev_client) {
+        nm_log_warn(LOGD_RFKILL, "cannot track killswitches via udev");
+        poll_killswitches(self);
+        return;
+    }
 
     enumerate = nm_udev_client_enumerate_new(priv->udev_client);
     udev_enumerate_scan_devices(enumerate);
@@ -410,18 +487,202 @@ nm_rfkill_manager_init(NMRfkillManager *self)
         if (!udevice)
             continue;
 
-        add_one_killswitch(self, udevice);
+        rfkill_add(self, udevice);
         udev_device_unref(udevice);
     }
     udev_enumerate_unref(enumerate);
 
+    poll_killswitches(self);
+}
+
+/*****************************************************************************/
+
+static gboolean
+handle_kernel_event(NMRfkillManager *self, const struct rfkill_event *event)
+{
+    NMRfkillManagerPrivate *priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+    Killswitch             *ks;
+    NMRfkillState           state;
+
+    ks = killswitch_find_by_idx(self, event->idx);
+
+    switch (event->op) {
+    case KERN_RFKILL_OP_ADD:
+    case KERN_RFKILL_OP_CHANGE:
+        if (!ks) {
+            struct udev_device *device = NULL;
+            NMRfkillType        rtype;
+            char                name[30];
+
+            rtype = kernel_rfkill_type_to_enum(event->type);
+            if (rtype == NM_RFKILL_TYPE_UNKNOWN)
+                return FALSE;
+
+            /* We only need udev for the details about the device, like the driver
+             * and whether this is a platform switch. */
+            nm_sprintf_buf(name, "rfkill%u", (guint) event->idx);
+            if (priv->udev_client) {
+                device = udev_device_new_from_subsystem_sysname(
+                    nm_udev_client_get_udev(priv->udev_client),
+                    "rfkill",
+                    name);
+            }
+            ks      = killswitch_new(name, device, rtype);
+            ks->idx = event->idx;
+            c_list_link_front(&priv->killswitch_lst_head, &ks->killswitch_lst);
+            killswitch_log_found(ks);
+            if (device)
+                udev_device_unref(device);
+        }
+
+        state = kernel_event_to_nm_state(event);
+        if (ks->state == state)
+            return FALSE;
+        killswitch_set_state(ks, state);
+        return TRUE;
+
+    case KERN_RFKILL_OP_DEL:
+        if (!ks)
+            return FALSE;
+        nm_log_info(LOGD_RFKILL, "radio killswitch %s disappeared", ks->name);
+        killswitch_destroy(ks);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static gboolean
+read_kernel_events(NMRfkillManager *self)
+{
+    NMRfkillManagerPrivate *priv    = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+    gboolean                changed = FALSE;
+    gboolean                failed  = FALSE;
+
+    for (;;) {
+        struct rfkill_event event;
+        ssize_t             n;
+        int                 errsv;
+
+        /* Newer kernels have a larger struct rfkill_event_ext. For reads, they
+         * truncate each event to the size we ask for, which is one event per
+         * read() call. */
+        n = read(priv->rfkill_fd, &event, sizeof(event));
+        if (n < 0) {
+            errsv = errno;
+            if (errsv == EINTR)
+                continue;
+            if (errsv != EAGAIN) {
+                nm_log_warn(LOGD_RFKILL,
+                            "failed to read from /dev/rfkill: %s",
+                            nm_strerror_native(errsv));
+                failed = TRUE;
+            }
+            break;
+        }
+        if (n == 0) {
+            nm_log_warn(LOGD_RFKILL, "unexpected end of file on /dev/rfkill");
+            failed = TRUE;
+            break;
+        }
+        if (n < (ssize_t) sizeof(event))
+            continue;
+
+        nm_log_trace(LOGD_RFKILL,
+                     "rfkill event: op %u, idx %u, type %u, soft %u, hard %u",
+                     (guint) event.op,
+                     (guint) event.idx,
+                     (guint) event.type,
+                     (guint) event.soft,
+                     (guint) event.hard);
+
+        if (handle_kernel_event(self, &event))
+            changed = TRUE;
+    }
+
+    if (failed) {
+        nm_log_info(LOGD_RFKILL, "track killswitches via udev");
+        nm_clear_g_source_inst(&priv->rfkill_event_source);
+        nm_clear_fd(&priv->rfkill_fd);
+        udev_tracking_start(self);
+        changed = TRUE;
+    }
+
+    return changed;
+}
+
+static gboolean
+rfkill_event_cb(int fd, GIOCondition condition, gpointer user_data)
+{
+    NMRfkillManager *self = user_data;
+
+    if (read_kernel_events(self))
+        recheck_killswitches(self);
+    return G_SOURCE_CONTINUE;
+}
+
+/*****************************************************************************/
+
+static void
+nm_rfkill_manager_init(NMRfkillManager *self)
+{
+    NMRfkillManagerPrivate *priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+    guint                   i;
+
+    c_list_init(&priv->killswitch_lst_head);
+    priv->rfkill_fd = -1;
+
+    for (i = 0; i < NM_RFKILL_TYPE_MAX; i++)
+        priv->rfkill_states[i] = NM_RFKILL_STATE_UNAVAILABLE;
+}
+
+static NMRfkillManager *
+_rfkill_manager_new(int rfkill_fd)
+{
+    NMRfkillManager        *self;
+    NMRfkillManagerPrivate *priv;
+
+    self = g_object_new(NM_TYPE_RFKILL_MANAGER, NULL);
+    priv = NM_RFKILL_MANAGER_GET_PRIVATE(self);
+
+    priv->rfkill_fd = rfkill_fd;
+    if (priv->rfkill_fd >= 0) {
+        /* Upon open, kernel queues an ADD event for every existing killswitch.
+         * Afterwards, we get one event per change, so we never need to poll
+         * all killswitches. We don't need udev events in this case. */
+        priv->udev_client = nm_udev_client_new(NM_MAKE_STRV("rfkill"), NULL, NULL);
+        priv->rfkill_event_source =
+            nm_g_unix_fd_add_source(priv->rfkill_fd, G_IO_IN, rfkill_event_cb, self);
+        read_kernel_events(self);
+    } else
+        udev_tracking_start(self);
+
     recheck_killswitches(self);
+    return self;
 }
 
 NMRfkillManager *
 nm_rfkill_manager_new(void)
 {
-    return g_object_new(NM_TYPE_RFKILL_MANAGER, NULL);
+    int fd;
+    int errsv;
+
+    fd = open("/dev/rfkill", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        errsv = errno;
+        nm_log_dbg(LOGD_RFKILL,
+                   "cannot open /dev/rfkill (%s), track killswitches via udev",
+                   nm_strerror_native(errsv));
+    }
+    return _rfkill_manager_new(fd);
+}
+
+NMRfkillManager *
+_nm_rfkill_manager_new_for_fd(int fd)
+{
+    g_return_val_if_fail(fd >= 0, NULL);
+
+    return _rfkill_manager_new(fd);
 }
 
 static void
@@ -434,6 +695,8 @@ dispose(GObject *object)
     while ((ks = c_list_first_entry(&priv->killswitch_lst_head, Killswitch, killswitch_lst)))
         killswitch_destroy(ks);
 
+    nm_clear_g_source_inst(&priv->rfkill_event_source);
+    nm_clear_fd(&priv->rfkill_fd);
     priv->udev_client = nm_udev_client_destroy(priv->udev_client);
 
     G_OBJECT_CLASS(nm_rfkill_manager_parent_class)->dispose(object);
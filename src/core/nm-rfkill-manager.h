@@ -26,6 +26,22 @@ typedef enum {
     NM_RFKILL_TYPE_MAX = NM_RFKILL_TYPE_UNKNOWN,
 } NMRfkillType;
 
+/* From the kernel's <linux/rfkill.h>, for talking to /dev/rfkill. */
+#define KERN_RFKILL_OP_ADD        0
+#define KERN_RFKILL_OP_DEL        1
+#define KERN_RFKILL_OP_CHANGE     2
+#define KERN_RFKILL_OP_CHANGE_ALL 3
+#define KERN_RFKILL_TYPE_WLAN     1
+#define KERN_RFKILL_TYPE_WWAN     5
+
+struct rfkill_event {
+    uint32_t idx;
+    uint8_t  type;
+    uint8_t  op;
+    uint8_t  soft;
+    uint8_t  hard;
+} _nm_packed;
+
 const char *nm_rfkill_type_to_string(NMRfkillType rtype);
 
 #define NM_TYPE_RFKILL_MANAGER (nm_rfkill_manager_get_type())
@@ -46,6 +62,10 @@ GType nm_rfkill_manager_get_type(void);
 
 NMRfkillManager *nm_rfkill_manager_new(void);
 
+/* For tests. Takes ownership of @fd, which is read instead of /dev/rfkill. It must
+ * be non-blocking. */
+NMRfkillManager *_nm_rfkill_manager_new_for_fd(int fd);
+
 NMRfkillState nm_rfkill_manager_get_rfkill_state(NMRfkillManager *manager, NMRfkillType rtype);
 
 NMRadioFlags nm_rfkill_type_to_radio_available_flag(NMRfkillType type);
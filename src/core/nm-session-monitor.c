@@ -49,6 +49,9 @@ struct _NMSessionMonitor {
     struct {
         sd_login_monitor *monitor;
         GSource          *watch;
+
+        /* uid -> SdUidState. Only contains the users that were queried. */
+        GHashTable *uid_states;
     } sd;
 #endif
 
@@ -73,31 +76,90 @@ G_DEFINE_TYPE(NMSessionMonitor, nm_session_monitor, G_TYPE_OBJECT);
 /*****************************************************************************/
 
 #if SESSION_TRACKING_XLOGIND
+typedef enum {
+    SD_UID_STATE_NONE           = 0,
+    SD_UID_STATE_SESSION        = 0x1,
+    SD_UID_STATE_ACTIVE_SESSION = 0x2,
+
+    /* Never zero, so that it can be stored as non-NULL pointer. */
+    SD_UID_STATE_CACHED = 0x4,
+} SdUidState;
+
+static SdUidState
+st_sd_uid_state_read(uid_t uid)
+{
+    SdUidState state = SD_UID_STATE_CACHED;
+    int        status;
+
+    status = sd_uid_get_sessions(uid, FALSE, NULL);
+    if (status < 0)
+        _LOGE("failed to get " LOGIND_NAME " sessions for uid %d: %d", uid, status);
+    if (status <= 0)
+        return state;
+
+    state |= SD_UID_STATE_SESSION;
+
+    status = sd_uid_get_sessions(uid, TRUE, NULL);
+    if (status < 0)
+        _LOGE("failed to get " LOGIND_NAME " active sessions for uid %d: %d", uid, status);
+    if (status > 0)
+        state |= SD_UID_STATE_ACTIVE_SESSION;
+
+    return state;
+}
+
 static gboolean
 st_sd_session_exists(NMSessionMonitor *monitor, uid_t uid, gboolean active)
 {
-    int status;
+    SdUidState state;
 
     if (!monitor->sd.monitor)
         return FALSE;
 
-    status = sd_uid_get_sessions(uid, active, NULL);
-
-    if (status < 0)
-        _LOGE("failed to get " LOGIND_NAME " sessions for uid %d: %d", uid, status);
+    /* The state is only read once per user, and then kept up to date
+     * by st_sd_changed(). */
+    state = GPOINTER_TO_UINT(g_hash_table_lookup(monitor->sd.uid_states, GUINT_TO_POINTER(uid)));
+    if (state == SD_UID_STATE_NONE) {
+        state = st_sd_uid_state_read(uid);
+        g_hash_table_insert(monitor->sd.uid_states, GUINT_TO_POINTER(uid), GUINT_TO_POINTER(state));
+    }
 
-    return status > 0;
+    return NM_FLAGS_HAS(state, active ? SD_UID_STATE_ACTIVE_SESSION : SD_UID_STATE_SESSION);
 }
 
 static gboolean
 st_sd_changed(int fd, GIOCondition condition, gpointer user_data)
 {
-    NMSessionMonitor *monitor = user_data;
-
-    g_signal_emit(monitor, signals[CHANGED], 0);
+    NMSessionMonitor      *monitor      = user_data;
+    gs_unref_array GArray *changed_uids = NULL;
+    GHashTableIter         iter;
+    gpointer               p_uid;
+    gpointer               p_state;
 
     sd_login_monitor_flush(monitor->sd.monitor);
 
+    /* Only re-read the state of users that somebody asked for, and
+     * only notify about the users whose state actually changed. */
+    g_hash_table_iter_init(&iter, monitor->sd.uid_states);
+    while (g_hash_table_iter_next(&iter, &p_uid, &p_state)) {
+        uid_t      uid = GPOINTER_TO_UINT(p_uid);
+        SdUidState state;
+
+        state = st_sd_uid_state_read(uid);
+        if (state == GPOINTER_TO_UINT(p_state))
+            continue;
+
+        g_hash_table_iter_replace(&iter, GUINT_TO_POINTER(state));
+        if (!changed_uids)
+            changed_uids = g_array_new(FALSE, FALSE, sizeof(uid_t));
+        g_array_append_val(changed_uids, uid);
+    }
+
+    if (changed_uids) {
+        _LOGT("session state changed for %u users", changed_uids->len);
+        g_signal_emit(monitor, signals[CHANGED], 0, changed_uids);
+    }
+
     return G_SOURCE_CONTINUE;
 }
 
@@ -114,7 +176,8 @@ st_sd_init(NMSessionMonitor *monitor)
         return;
     }
 
-    monitor->sd.watch = nm_g_unix_fd_add_source(sd_login_monitor_get_fd(monitor->sd.monitor),
+    monitor->sd.uid_states = g_hash_table_new(nm_direct_hash, NULL);
+    monitor->sd.watch      = nm_g_unix_fd_add_source(sd_login_monitor_get_fd(monitor->sd.monitor),
                                                 G_IO_IN,
                                                 st_sd_changed,
                                                 monitor);
@@ -128,6 +191,7 @@ st_sd_finalize(NMSessionMonitor *monitor)
         monitor->sd.monitor = NULL;
     }
     nm_clear_g_source_inst(&monitor->sd.watch);
+    nm_clear_pointer(&monitor->sd.uid_states, g_hash_table_unref);
 }
 #endif /* SESSION_TRACKING_XLOGIND */
 
@@ -238,7 +302,8 @@ ck_changed(GFileMonitor     *file_monitor,
            GFileMonitorEvent event_type,
            gpointer          user_data)
 {
-    g_signal_emit(user_data, signals[CHANGED], 0);
+    /* We don't know which users are affected. */
+    g_signal_emit(user_data, signals[CHANGED], 0, NULL);
 }
 
 static void
@@ -344,6 +409,8 @@ nm_session_monitor_class_init(NMSessionMonitorClass *klass)
     /**
      * NMSessionMonitor::changed:
      * @monitor: A #NMSessionMonitor
+     * @changed_uids: (allow-none): a #GArray of uid_t for the users whose
+     *   session state changed, or %NULL if any user might be affected.
      *
      * Emitted when something changes.
      */
@@ -353,7 +420,8 @@ nm_session_monitor_class_init(NMSessionMonitorClass *klass)
                                     0,
                                     NULL,
                                     NULL,
-                                    g_cclosure_marshal_VOID__VOID,
+                                    g_cclosure_marshal_VOID__POINTER,
                                     G_TYPE_NONE,
-                                    0);
+                                    1,
+                                    G_TYPE_POINTER);
 }
@@ -303,6 +303,199 @@ test_ip6_address_general_2(void)
 
 /*****************************************************************************/
 
+static void
+test_ip6_address_sync_order(void)
+{
+    const int   ifindex         = DEVICE_IFINDEX;
+    SignalData *address_removed = add_signal_ifindex(NM_PLATFORM_SIGNAL_IP6_ADDRESS_CHANGED,
+                                                     NM_PLATFORM_SIGNAL_REMOVED,
+                                                     ip6_address_callback,
+                                                     ifindex);
+    gs_unref_ptrarray GPtrArray *known_addresses =
+        g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    GArray *addresses;
+    /* The addresses in the order we want, highest priority first. */
+    const char *const ADDRS[] = {
+        "2001:db8:1::3",
+        "2001:db8:1::1",
+        "2001:db8:1::2",
+        "2001:db8:1::4",
+    };
+    /* Kernel adds new addresses on top. Adding them in this order
+     * gives ::1, ::2, ::3, ::4. */
+    const guint ADD_ORDER[] = {3, 0, 2, 1};
+    guint       i;
+    guint       j;
+
+    for (i = 0; i < G_N_ELEMENTS(ADD_ORDER); i++) {
+        nmtstp_ip6_address_add(NULL,
+                               FALSE,
+                               ifindex,
+                               nmtst_inet6_from_string(ADDRS[ADD_ORDER[i]]),
+                               IP6_PLEN,
+                               in6addr_any,
+                               NM_PLATFORM_LIFETIME_PERMANENT,
+                               NM_PLATFORM_LIFETIME_PERMANENT,
+                               IFA_F_NODAD);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(ADDRS); i++) {
+        const NMPlatformIP6Address a = {
+            .ifindex     = ifindex,
+            .address     = nmtst_inet6_from_string(ADDRS[i]),
+            .plen        = IP6_PLEN,
+            .lifetime    = NM_PLATFORM_LIFETIME_PERMANENT,
+            .preferred   = NM_PLATFORM_LIFETIME_PERMANENT,
+            .n_ifa_flags = IFA_F_NODAD,
+        };
+
+        g_ptr_array_add(known_addresses,
+                        nmp_object_new(NMP_OBJECT_TYPE_IP6_ADDRESS, (const NMPlatformObject *) &a));
+    }
+
+    accept_signals(address_removed, 0, G_MAXINT);
+
+    /* Only ::3 has the wrong priority. Moving it on top must not touch
+     * the other addresses. */
+    g_assert(nm_platform_ip_address_sync(NM_PLATFORM_GET,
+                                         AF_INET6,
+                                         ifindex,
+                                         known_addresses,
+                                         NULL,
+                                         NMP_IP_ADDRESS_SYNC_FLAGS_NONE));
+    accept_signal(address_removed);
+
+    addresses = nmtstp_platform_ip6_address_get_all(NM_PLATFORM_GET, ifindex);
+    for (i = 0, j = 0; i < addresses->len; i++) {
+        const NMPlatformIP6Address *a = &nm_g_array_index(addresses, NMPlatformIP6Address, i);
+
+        if (IN6_IS_ADDR_LINKLOCAL(&a->address))
+            continue;
+        g_assert_cmpint(j, <, G_N_ELEMENTS(ADDRS));
+        nmtst_assert_ip6_address(&a->address, ADDRS[j++]);
+    }
+    g_assert_cmpint(j, ==, G_N_ELEMENTS(ADDRS));
+    g_array_unref(addresses);
+
+    for (i = 0; i < G_N_ELEMENTS(ADDRS); i++)
+        nmtstp_ip6_address_del(NULL,
+                               EX,
+                               ifindex,
+                               nmtst_inet6_from_string(ADDRS[i]),
+                               IP6_PLEN);
+
+    free_signal(address_removed);
+}
+
+/*****************************************************************************/
+
+static void
+test_ip4_address_sync_order(gconstpointer test_data)
+{
+    const int   TEST_IDX        = GPOINTER_TO_INT(test_data);
+    const int   ifindex         = DEVICE_IFINDEX;
+    SignalData *address_removed = add_signal_ifindex(NM_PLATFORM_SIGNAL_IP4_ADDRESS_CHANGED,
+                                                     NM_PLATFORM_SIGNAL_REMOVED,
+                                                     ip4_address_callback,
+                                                     ifindex);
+    gs_unref_ptrarray GPtrArray *known_addresses =
+        g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    const char *const PATH_ALL  = "/proc/sys/net/ipv4/conf/all/promote_secondaries";
+    const char *const PATH_DEV  = "/proc/sys/net/ipv4/conf/" DEVICE_NAME "/promote_secondaries";
+    gs_free char     *value_all = NULL;
+    /* The addresses in the order we want, the first one is the primary. */
+    const char *const ADDRS[] = {
+        "192.0.2.3",
+        "192.0.2.1",
+        "192.0.2.2",
+    };
+    /* Adding them in this order makes .1 the primary and .2, .3 the
+     * secondary addresses. */
+    const guint ADD_ORDER[] = {1, 2, 0};
+    GArray     *addresses;
+    guint       n_found;
+    guint       i;
+    guint       j;
+
+    /* Kernel promotes a secondary address if "promote_secondaries" is set for
+     * the device or for "all". Test both, and neither. */
+    value_all = nm_platform_sysctl_get(NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL));
+    g_assert(value_all);
+    g_assert(nm_platform_sysctl_set(NM_PLATFORM_GET,
+                                    NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL),
+                                    TEST_IDX == 2 ? "1" : "0"));
+    g_assert(nm_platform_sysctl_set(NM_PLATFORM_GET,
+                                    NMP_SYSCTL_PATHID_ABSOLUTE(PATH_DEV),
+                                    TEST_IDX == 3 ? "1" : "0"));
+
+    for (i = 0; i < G_N_ELEMENTS(ADD_ORDER); i++) {
+        in_addr_t addr = nmtst_inet4_from_string(ADDRS[ADD_ORDER[i]]);
+
+        nmtstp_ip4_address_add(NULL,
+                               EX,
+                               ifindex,
+                               addr,
+                               IP4_PLEN,
+                               addr,
+                               NM_PLATFORM_LIFETIME_PERMANENT,
+                               NM_PLATFORM_LIFETIME_PERMANENT,
+                               0,
+                               NULL);
+    }
+
+    for (i = 0; i < G_N_ELEMENTS(ADDRS); i++) {
+        const NMPlatformIP4Address a = {
+            .ifindex      = ifindex,
+            .address      = nmtst_inet4_from_string(ADDRS[i]),
+            .peer_address = nmtst_inet4_from_string(ADDRS[i]),
+            .plen         = IP4_PLEN,
+            .lifetime     = NM_PLATFORM_LIFETIME_PERMANENT,
+            .preferred    = NM_PLATFORM_LIFETIME_PERMANENT,
+        };
+
+        g_ptr_array_add(known_addresses,
+                        nmp_object_new(NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) &a));
+    }
+
+    accept_signals(address_removed, 0, G_MAXINT);
+
+    g_assert(nm_platform_ip_address_sync(NM_PLATFORM_GET,
+                                         AF_INET,
+                                         ifindex,
+                                         known_addresses,
+                                         NULL,
+                                         NMP_IP_ADDRESS_SYNC_FLAGS_NONE));
+
+    if (TEST_IDX == 1) {
+        /* Kernel deleted the secondary addresses together with .1. */
+        accept_signals(address_removed, 3, 3);
+    } else {
+        /* .1 and the promoted .2 were deleted, the promoted .3 was kept. */
+        accept_signals(address_removed, 2, 2);
+    }
+
+    addresses = nmtstp_platform_ip4_address_get_all(NM_PLATFORM_GET, ifindex);
+    for (i = 0, n_found = 0; i < addresses->len; i++) {
+        const NMPlatformIP4Address *a = &nm_g_array_index(addresses, NMPlatformIP4Address, i);
+
+        for (j = 0; j < G_N_ELEMENTS(ADDRS); j++) {
+            if (a->address == nmtst_inet4_from_string(ADDRS[j]))
+                break;
+        }
+        g_assert_cmpint(j, <, G_N_ELEMENTS(ADDRS));
+        g_assert_cmpint(NM_FLAGS_HAS(a->n_ifa_flags, IFA_F_SECONDARY), ==, j != 0);
+        n_found++;
+    }
+    g_assert_cmpint(n_found, ==, G_N_ELEMENTS(ADDRS));
+    g_array_unref(addresses);
+
+    g_assert(nm_platform_sysctl_set(NM_PLATFORM_GET, NMP_SYSCTL_PATHID_ABSOLUTE(PATH_ALL), value_all));
+
+    free_signal(address_removed);
+}
+
+/*****************************************************************************/
+
 static void
 test_ip4_address_peer(void)
 {
@@ -454,11 +647,25 @@ void
 _nmtstp_setup_tests(void)
 {
 #define add_test_func(testpath, test_func) nmtstp_env1_add_test_func(testpath, test_func, 1, FALSE)
+#define add_test_func_data(testpath, test_func, arg) \
+    nmtstp_env1_add_test_func_data(testpath, test_func, arg, 1, FALSE)
     add_test_func("/address/ipv4/general", test_ip4_address_general);
     add_test_func("/address/ipv6/general", test_ip6_address_general);
 
     add_test_func("/address/ipv4/general-2", test_ip4_address_general_2);
     add_test_func("/address/ipv6/general-2", test_ip6_address_general_2);
+    add_test_func("/address/ipv6/sync-order", test_ip6_address_sync_order);
+    if (nmtstp_is_root_test()) {
+        add_test_func_data("/address/ipv4/sync-order/1",
+                           test_ip4_address_sync_order,
+                           GINT_TO_POINTER(1));
+        add_test_func_data("/address/ipv4/sync-order/2",
+                           test_ip4_address_sync_order,
+                           GINT_TO_POINTER(2));
+        add_test_func_data("/address/ipv4/sync-order/3",
+                           test_ip4_address_sync_order,
+                           GINT_TO_POINTER(3));
+    }
 
     add_test_func("/address/ipv4/peer", test_ip4_address_peer);
     add_test_func("/address/ipv4/peer/zero", test_ip4_address_peer_zero);
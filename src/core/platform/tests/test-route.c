@@ -860,6 +860,84 @@ test_ip6_route_get(void)
     nmtstp_wait_for_signal(NM_PLATFORM_GET, 50);
 }
 
+static void
+test_ip6_route_expires(void)
+{
+    const int                 IFINDEX = nm_platform_link_get_ifindex(NM_PLATFORM_GET, DEVICE_NAME);
+    const NMPlatformIP6Route *r;
+    NMPlatformIP6Route        rt;
+    gint32                    now;
+
+    now = nm_utils_get_monotonic_timestamp_sec();
+
+    rt = ((NMPlatformIP6Route) {
+        .ifindex   = IFINDEX,
+        .rt_source = NM_IP_CONFIG_SOURCE_USER,
+        .network   = nmtst_inet6_from_string("2001:db8:e::"),
+        .plen      = 64,
+        .metric    = 1024,
+        .expires   = now + 30,
+    });
+
+    g_assert(NMTST_NM_ERR_SUCCESS(
+        nm_platform_ip6_route_add(NM_PLATFORM_GET, NMP_NLM_FLAG_REPLACE, &rt)));
+
+    /* kernel reports the remaining lifetime, which we convert back. Allow for
+     * the rounding and the time that passed meanwhile. */
+    r = nmtstp_ip6_route_get(NM_PLATFORM_GET, IFINDEX, &rt.network, rt.plen, rt.metric, NULL, 0);
+    g_assert(r);
+    g_assert_cmpint(r->expires, >=, now + 29);
+    g_assert_cmpint(r->expires, <=, now + 31);
+
+    g_assert(nmtstp_platform_ip6_route_delete(NM_PLATFORM_GET,
+                                              IFINDEX,
+                                              rt.network,
+                                              rt.plen,
+                                              rt.metric));
+}
+
+static void
+test_ip6_route_expires_refresh(void)
+{
+    const int IFINDEX = nm_platform_link_get_ifindex(NM_PLATFORM_GET, DEVICE_NAME);
+    gs_unref_ptrarray GPtrArray *routes = NULL;
+    const NMPlatformIP6Route    *r;
+    NMPlatformIP6Route           rt;
+    gint32                       now;
+
+    now = nm_utils_get_monotonic_timestamp_sec();
+
+    rt = ((NMPlatformIP6Route) {
+        .ifindex   = IFINDEX,
+        .rt_source = NM_IP_CONFIG_SOURCE_USER,
+        .network   = nmtst_inet6_from_string("2001:db8:e::"),
+        .plen      = 64,
+        .metric    = 1024,
+        .expires   = now + 30,
+    });
+
+    g_assert(NMTST_NM_ERR_SUCCESS(
+        nm_platform_ip6_route_add(NM_PLATFORM_GET, NMP_NLM_FLAG_REPLACE, &rt)));
+
+    /* Refreshing the lifetime fails with EEXIST and kernel sends no notification.
+     * Still, the cache must know about the new lifetime. */
+    rt.expires = now + 300;
+    routes     = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    g_ptr_array_add(routes, nmp_object_new(NMP_OBJECT_TYPE_IP6_ROUTE, &rt));
+    g_assert(nm_platform_ip_route_sync(NM_PLATFORM_GET, AF_INET6, IFINDEX, routes, NULL, NULL));
+
+    r = nmtstp_ip6_route_get(NM_PLATFORM_GET, IFINDEX, &rt.network, rt.plen, rt.metric, NULL, 0);
+    g_assert(r);
+    g_assert_cmpint(r->expires, >=, now + 299);
+    g_assert_cmpint(r->expires, <=, now + 301);
+
+    g_assert(nmtstp_platform_ip6_route_delete(NM_PLATFORM_GET,
+                                              IFINDEX,
+                                              rt.network,
+                                              rt.plen,
+                                              rt.metric));
+}
+
 static void
 test_ip6_route_options(gconstpointer test_data)
 {
@@ -1118,6 +1196,112 @@ again_find_idx:
 
 /*****************************************************************************/
 
+static void
+test_nexthop_route(void)
+{
+    NMPlatform                     *platform     = NM_PLATFORM_GET;
+    const int                       EX_          = -1;
+    const guint32                   NHID         = 4711;
+    gs_unref_ptrarray GPtrArray    *routes       = NULL;
+    gs_unref_ptrarray GPtrArray    *routes_prune = NULL;
+    nm_auto_nmpobj const NMPObject *nh_o         = NULL;
+    nm_auto_nmpobj const NMPObject *route_o      = NULL;
+    nm_auto_nmpobj const NMPObject *plat_o       = NULL;
+    const NMPlatformIP4Route       *r;
+    NMPlatformNexthop               nh;
+    NMPlatformIP4Route              rt;
+    int                             ifindex;
+    int                             res;
+
+    ifindex = nmtstp_link_veth_add(platform, EX_, "nm-nh-v0", "nm-nh-w0")->ifindex;
+    nmtstp_link_set_updown(platform, EX_, ifindex, TRUE);
+    nmtstp_link_set_updown(platform,
+                           EX_,
+                           nmtstp_link_get(platform, -1, "nm-nh-w0")->ifindex,
+                           TRUE);
+    nmtstp_ip4_address_add(platform,
+                           EX_,
+                           ifindex,
+                           nmtst_inet4_from_string("192.168.41.1"),
+                           24,
+                           nmtst_inet4_from_string("192.168.41.1"),
+                           3600,
+                           3600,
+                           0,
+                           NULL);
+
+    nh = ((NMPlatformNexthop) {
+        .id            = NHID,
+        .ifindex       = ifindex,
+        .addr_family   = AF_INET,
+        .gateway.addr4 = nmtst_inet4_from_string("192.168.41.2"),
+        .protocol      = RTPROT_STATIC,
+    });
+    nh_o = nmp_object_new(NMP_OBJECT_TYPE_NEXTHOP, &nh);
+
+    res = nm_platform_nexthop_add(platform, NMP_NLM_FLAG_REPLACE, nh_o);
+    if (res == -EOPNOTSUPP) {
+        g_test_skip("nexthop objects not supported by kernel");
+        goto out;
+    }
+    g_assert_cmpint(res, ==, 0);
+    g_assert(nm_platform_lookup_obj(platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, nh_o));
+
+    /* The route has no gateway, it uses the one of the nexthop. */
+    rt = ((NMPlatformIP4Route) {
+        .ifindex   = ifindex,
+        .nhid      = NHID,
+        .rt_source = NM_IP_CONFIG_SOURCE_USER,
+        .network   = nmtst_inet4_from_string("10.41.0.0"),
+        .plen      = 24,
+        .metric    = 50,
+    });
+    nm_platform_ip_route_normalize(AF_INET, (NMPlatformIPRoute *) &rt);
+    route_o = nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &rt);
+
+    routes = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+    g_ptr_array_add(routes, (gpointer) nmp_object_ref(route_o));
+    g_assert(nm_platform_ip_route_sync(platform, AF_INET, ifindex, routes, NULL, NULL));
+
+    /* We don't send RTA_OIF, and kernel reports the device of the nexthop (if
+     * at all). The cached route must still match the configured one. */
+    plat_o = nmp_object_ref(
+        nm_platform_lookup_obj(platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, route_o));
+    g_assert(plat_o);
+    r = NMP_OBJECT_CAST_IP4_ROUTE(plat_o);
+    g_assert_cmpint(r->nhid, ==, NHID);
+    g_assert_cmpint(r->gateway, ==, 0);
+    g_assert(NM_IN_SET(r->ifindex, 0, ifindex));
+    g_assert_cmpint(
+        nm_platform_ip4_route_cmp(&rt, r, NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY),
+        ==,
+        0);
+
+    /* Syncing again leaves the route alone. */
+    g_assert(nm_platform_ip_route_sync(platform, AF_INET, ifindex, routes, NULL, NULL));
+    g_assert(plat_o == nm_platform_lookup_obj(platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, route_o));
+
+    nmtstp_check_platform(platform, nmp_object_type_to_flags(NMP_OBJECT_TYPE_IP4_ROUTE));
+
+    if (r->ifindex == ifindex) {
+        /* In nexthop compat mode, the route is pruned with the device. */
+        routes_prune = nm_platform_ip_route_get_prune_list(platform,
+                                                           AF_INET,
+                                                           ifindex,
+                                                           NM_IP_ROUTE_TABLE_SYNC_MODE_ALL_PRUNE,
+                                                           NULL);
+        g_assert(nm_platform_ip_route_sync(platform, AF_INET, ifindex, NULL, routes_prune, NULL));
+        g_assert(!nm_platform_lookup_obj(platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, route_o));
+    }
+
+    g_assert(nm_platform_object_delete(platform, nh_o));
+
+out:
+    nmtstp_link_delete(platform, EX_, ifindex, NULL, TRUE);
+}
+
+/*****************************************************************************/
+
 #define FRA_SUPPRESS_IFGROUP   13
 #define FRA_SUPPRESS_PREFIXLEN 14
 #define FRA_L3MDEV             19
@@ -2239,6 +2423,104 @@ test_mptcp(gconstpointer test_data)
 
 /*****************************************************************************/
 
+static const NMPlatformMptcpAddr *
+_mptcp_addrs_find(GPtrArray *arr, int ifindex, in_addr_t addr)
+{
+    guint i;
+
+    for (i = 0; i < nm_g_ptr_array_len(arr); i++) {
+        const NMPlatformMptcpAddr *a = NMP_OBJECT_CAST_MPTCP_ADDR(arr->pdata[i]);
+
+        if (a->ifindex == ifindex && a->addr_family == AF_INET && a->addr.addr4 == addr)
+            return a;
+    }
+    return NULL;
+}
+
+static void
+test_mptcp_external_change(void)
+{
+    gs_unref_object NMPlatform                    *platform = g_object_ref(NM_PLATFORM_GET);
+    nm_auto_unref_global_tracker NMPGlobalTracker *global_tracker =
+        nmp_global_tracker_new(platform);
+    gconstpointer const             USER_TAG = &platform;
+    const int                       IFINDEX  = nm_platform_link_get_ifindex(platform, DEVICE_NAME);
+    const in_addr_t                 ADDR1    = htonl(0xC0A80101u);
+    const in_addr_t                 ADDR2    = htonl(0xC0A80102u);
+    nm_auto_nmpobj const NMPObject *obj1     = NULL;
+    nm_auto_nmpobj const NMPObject *obj2     = NULL;
+    const NMPlatformMptcpAddr      *a;
+    guint                           i;
+    int                             r;
+
+    g_assert_cmpint(IFINDEX, >, 0);
+
+    if (_mptcp_skip_test())
+        return;
+
+    obj1 = nmtst_object_new_mptcp_addr(.ifindex     = IFINDEX,
+                                       .addr_family = AF_INET,
+                                       .addr.addr4  = ADDR1);
+    obj2 = nmtst_object_new_mptcp_addr(.ifindex     = IFINDEX,
+                                       .addr_family = AF_INET,
+                                       .addr.addr4  = ADDR2);
+
+    nmp_global_tracker_track(global_tracker,
+                             NMP_OBJECT_TYPE_MPTCP_ADDR,
+                             NMP_OBJECT_CAST_MPTCP_ADDR(obj1),
+                             20,
+                             USER_TAG,
+                             NULL);
+    nmp_global_tracker_sync_mptcp_addrs(global_tracker, FALSE);
+
+    {
+        gs_unref_ptrarray GPtrArray *arr = NULL;
+
+        arr = nm_platform_mptcp_addrs_dump(platform);
+        a   = _mptcp_addrs_find(arr, IFINDEX, ADDR1);
+        g_assert(a);
+
+        /* Delete the endpoint behind our back, like `ip mptcp endpoint delete`. */
+        r = nm_platform_mptcp_addr_update(platform, FALSE, a);
+        g_assert(NMTST_NM_ERR_SUCCESS(r));
+    }
+
+    /* The next sync (without reapply) notices and adds it back. */
+    nmp_global_tracker_track(global_tracker,
+                             NMP_OBJECT_TYPE_MPTCP_ADDR,
+                             NMP_OBJECT_CAST_MPTCP_ADDR(obj2),
+                             10,
+                             USER_TAG,
+                             NULL);
+    nmp_global_tracker_sync_mptcp_addrs(global_tracker, FALSE);
+
+    {
+        gs_unref_ptrarray GPtrArray *arr = NULL;
+
+        arr = nm_platform_mptcp_addrs_dump(platform);
+        g_assert(_mptcp_addrs_find(arr, IFINDEX, ADDR1));
+        g_assert(_mptcp_addrs_find(arr, IFINDEX, ADDR2));
+    }
+
+    nmp_global_tracker_untrack_all(global_tracker, USER_TAG, TRUE, FALSE);
+    nmp_global_tracker_sync_mptcp_addrs(global_tracker, FALSE);
+
+    {
+        gs_unref_ptrarray GPtrArray *arr = NULL;
+
+        /* The next test uses the same netns. Make sure nothing is left. */
+        arr = nm_platform_mptcp_addrs_dump(platform);
+        for (i = 0; i < nm_g_ptr_array_len(arr); i++) {
+            r = nm_platform_mptcp_addr_update(platform,
+                                              FALSE,
+                                              NMP_OBJECT_CAST_MPTCP_ADDR(arr->pdata[i]));
+            g_assert(NMTST_NM_ERR_SUCCESS(r));
+        }
+    }
+}
+
+/*****************************************************************************/
+
 static void
 _ensure_onlink_routes(void)
 {
@@ -2488,13 +2770,16 @@ _nmtstp_setup_tests(void)
     add_test_func_data("/route/ip6_options/1", test_ip6_route_options, GINT_TO_POINTER(1));
     add_test_func_data("/route/ip6_options/2", test_ip6_route_options, GINT_TO_POINTER(2));
     add_test_func_data("/route/ip6_options/3", test_ip6_route_options, GINT_TO_POINTER(3));
+    add_test_func("/route/ip6_expires", test_ip6_route_expires);
 
     if (nmtstp_is_root_test()) {
         add_test_func_data("/route/ip/1", test_ip, GINT_TO_POINTER(1));
+        add_test_func("/route/ip6_expires_refresh", test_ip6_route_expires_refresh);
         add_test_func("/route/ip4_route_get", test_ip4_route_get);
         add_test_func("/route/ip6_route_get", test_ip6_route_get);
         add_test_func("/route/ip4_zero_gateway", test_ip4_zero_gateway);
         add_test_func("/route/via", test_via);
+        add_test_func("/route/nexthop", test_nexthop_route);
     }
 
     if (nmtstp_is_root_test()) {
@@ -2510,6 +2795,7 @@ _nmtstp_setup_tests(void)
     if (nmtstp_is_root_test()) {
         add_test_func_data("/route/mptcp/1", test_mptcp, GINT_TO_POINTER(1));
         add_test_func_data("/route/mptcp/2", test_mptcp, GINT_TO_POINTER(2));
+        add_test_func("/route/mptcp/external-change", test_mptcp_external_change);
     }
     if (nmtstp_is_root_test()) {
         add_test_func_data_with_if2("/route/test_cache_consistency_routes/1",
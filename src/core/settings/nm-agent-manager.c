@@ -40,6 +40,10 @@ typedef struct {
     CList request_lst_head;
 
     guint64 agent_version_id;
+
+    /* Whether the sort_rank of the fully registered agents is up to date.
+     * It is recomputed lazily after the agents or the sessions changed. */
+    bool agents_sorted : 1;
 } NMAgentManagerPrivate;
 
 struct _NMAgentManager {
@@ -216,6 +220,14 @@ struct _NMAgentManagerCallId {
 
                     NMAgentSecretsResultFunc callback;
                     gpointer                 callback_data;
+
+                    /* Concurrent requests for the same secrets are coalesced.
+                     * The first request (the leader) asks the agents, the
+                     * followers only wait for its result. Followers are not
+                     * in request_lst_head. */
+                    Request *leader;
+                    CList    followers_lst_head;
+                    CList    followers_lst;
                 } get;
             };
         } con;
@@ -267,6 +279,7 @@ _agent_remove(NMAgentManager *self, NMSecretAgent *agent)
     nm_clear_pointer(&agent->auth_chain, nm_auth_chain_destroy);
 
     c_list_unlink(&agent->agent_lst);
+    priv->agents_sorted = FALSE;
 
     g_signal_handlers_disconnect_by_func(agent, G_CALLBACK(agent_disconnected_cb), self);
 
@@ -396,6 +409,7 @@ _agent_permissions_check_done(NMAuthChain           *chain,
     agent->fully_registered = TRUE;
 
     priv->agent_version_id += 1;
+    priv->agents_sorted = FALSE;
 
     g_dbus_method_invocation_return_value(context, NULL);
 
@@ -565,7 +579,7 @@ request_new(NMAgentManager *self,
     req->request_type = request_type;
     req->detail       = g_strdup(detail);
     req->subject      = g_object_ref(subject);
-    c_list_link_tail(&NM_AGENT_MANAGER_GET_PRIVATE(self)->request_lst_head, &req->request_lst);
+    c_list_init(&req->request_lst);
     return req;
 }
 
@@ -580,6 +594,8 @@ request_free(Request *req)
         g_free(req->con.path);
         nm_clear_pointer(&req->con.chain, nm_auth_chain_destroy);
         if (req->request_type == REQUEST_TYPE_CON_GET) {
+            nm_assert(!req->con.get.leader);
+            nm_assert(c_list_is_empty(&req->con.get.followers_lst_head));
             g_free(req->con.get.setting_name);
             g_strfreev(req->con.get.hints);
             if (req->con.get.existing_secrets)
@@ -621,19 +637,36 @@ req_complete_release(Request    *req,
 {
     NMAgentManager *self = req->self;
 
+    Request        *follower;
+
     switch (req->request_type) {
     case REQUEST_TYPE_CON_GET:
-        req->con.get.callback(self,
-                              req,
-                              agent_dbus_owner,
-                              agent_username,
-                              req->con.current_has_modify,
-                              req->con.get.setting_name,
-                              req->con.get.flags,
-                              error ? NULL : secrets,
-                              error,
-                              req->con.get.callback_data);
+        nm_assert(!req->con.get.leader);
+
+        /* The callback is cleared if the caller of the leader cancelled, while
+         * followers still wait for the result. */
+        if (req->con.get.callback) {
+            req->con.get.callback(self,
+                                  req,
+                                  agent_dbus_owner,
+                                  agent_username,
+                                  req->con.current_has_modify,
+                                  req->con.get.setting_name,
+                                  req->con.get.flags,
+                                  error ? NULL : secrets,
+                                  error,
+                                  req->con.get.callback_data);
+        }
 
+        /* The callbacks may cancel other followers. Take them one by one. */
+        while ((follower = c_list_first_entry(&req->con.get.followers_lst_head,
+                                              Request,
+                                              con.get.followers_lst))) {
+            c_list_unlink(&follower->con.get.followers_lst);
+            follower->con.get.leader         = NULL;
+            follower->con.current_has_modify = req->con.current_has_modify;
+            req_complete_release(follower, secrets, agent_dbus_owner, agent_username, error);
+        }
         break;
     case REQUEST_TYPE_CON_SAVE:
     case REQUEST_TYPE_CON_DEL:
@@ -681,22 +714,87 @@ req_complete_error(Request *req, GError *error)
     req_complete(req, NULL, NULL, NULL, error);
 }
 
+typedef struct {
+    NMSecretAgent *agent;
+    guint64        start_time;
+    bool           active;
+} AgentSortData;
+
 static int
-agent_compare_func(gconstpointer aa, gconstpointer bb, gpointer user_data)
+_agent_sort_data_cmp(gconstpointer pa, gconstpointer pb, gpointer user_data)
+{
+    const AgentSortData *a = pa;
+    const AgentSortData *b = pb;
+
+    /* Prefer agents in active sessions */
+    NM_CMP_FIELD_BOOL(b, a, active);
+
+    /* Prefer agents launched later (this is essentially to ease agent debugging) */
+    NM_CMP_FIELD(b, a, start_time);
+    return 0;
+}
+
+static void
+_agents_ensure_sorted(NMAgentManager *self)
+{
+    NMAgentManagerPrivate *priv = NM_AGENT_MANAGER_GET_PRIVATE(self);
+    gs_free AgentSortData *arr  = NULL;
+    NMSecretAgent         *agent;
+    guint                  n;
+    guint                  i;
+
+    if (priv->agents_sorted)
+        return;
+
+    priv->agents_sorted = TRUE;
+
+    /* Querying the sessions and the process start times is expensive. Do
+     * it once per change of the agents or sessions, and not for every
+     * comparison of every request. */
+    n = c_list_length(&priv->agent_lst_head);
+    if (n == 0)
+        return;
+
+    arr = g_new(AgentSortData, n);
+    i   = 0;
+    c_list_for_each_entry (agent, &priv->agent_lst_head, agent_lst) {
+        arr[i++] = (AgentSortData) {
+            .agent      = agent,
+            .active     = nm_session_monitor_session_exists(priv->session_monitor,
+                                                            nm_secret_agent_get_owner_uid(agent),
+                                                            TRUE),
+            .start_time = nm_utils_get_start_time_for_pid(nm_secret_agent_get_pid(agent),
+                                                          NULL,
+                                                          NULL),
+        };
+    }
+
+    g_qsort_with_data(arr, n, sizeof(AgentSortData), _agent_sort_data_cmp, NULL);
+
+    for (i = 0; i < n; i++)
+        arr[i].agent->sort_rank = i;
+}
+
+static void
+session_changed_cb(NMSessionMonitor *session_monitor,
+                   const GArray     *changed_uids,
+                   NMAgentManager   *self)
 {
-    NMSecretAgent    *a   = (NMSecretAgent *) aa;
-    NMSecretAgent    *b   = (NMSecretAgent *) bb;
-    Request          *req = user_data;
-    NMSessionMonitor *sm;
-    gboolean          a_active, b_active;
-    gulong            a_pid, b_pid, requester;
-    guint64           a_start, b_start;
+    NM_AGENT_MANAGER_GET_PRIVATE(self)->agents_sorted = FALSE;
+}
 
-    a_pid = nm_secret_agent_get_pid(a);
-    b_pid = nm_secret_agent_get_pid(b);
+static int
+agent_compare_func(gconstpointer aa, gconstpointer bb, gpointer user_data)
+{
+    NMSecretAgent *a   = (NMSecretAgent *) aa;
+    NMSecretAgent *b   = (NMSecretAgent *) bb;
+    Request       *req = user_data;
+    gulong         a_pid, b_pid, requester;
 
     /* Prefer agents in the process the request came from */
     if (nm_auth_subject_get_subject_type(req->subject) == NM_AUTH_SUBJECT_TYPE_UNIX_PROCESS) {
+        a_pid     = nm_secret_agent_get_pid(a);
+        b_pid     = nm_secret_agent_get_pid(b);
         requester = nm_auth_subject_get_unix_process_pid(req->subject);
 
         if (a_pid != b_pid) {
@@ -707,23 +805,8 @@ agent_compare_func(gconstpointer aa, gconstpointer bb, gpointer user_data)
         }
     }
 
-    /* Prefer agents in active sessions */
-    sm       = NM_AGENT_MANAGER_GET_PRIVATE(req->self)->session_monitor;
-    a_active = nm_session_monitor_session_exists(sm, nm_secret_agent_get_owner_uid(a), TRUE);
-    b_active = nm_session_monitor_session_exists(sm, nm_secret_agent_get_owner_uid(b), TRUE);
-    if (a_active && !b_active)
-        return -1;
-    else if (!a_active && b_active)
-        return 1;
-
-    /* Prefer agents launched later (this is essentially to ease agent debugging) */
-    a_start = nm_utils_get_start_time_for_pid(a_pid, NULL, NULL);
-    b_start = nm_utils_get_start_time_for_pid(b_pid, NULL, NULL);
-    if (a_start > b_start)
-        return -1;
-    else if (a_start < b_start)
-        return 1;
-
+    /* Then the order by session and age, see _agents_ensure_sorted(). */
+    NM_CMP_FIELD(a, b, sort_rank);
     return 0;
 }
 
@@ -771,6 +854,8 @@ request_add_agent(Request *req, NMSecretAgent *agent)
 
     _LOGD(agent, "agent allowed for secrets request " LOG_REQ_FMT, LOG_REQ_ARG(req));
 
+    _agents_ensure_sorted(self);
+
     /* Add this agent to the list, sorted appropriately */
     req->pending =
         g_slist_insert_sorted_with_data(req->pending, g_object_ref(agent), agent_compare_func, req);
@@ -1208,6 +1293,66 @@ _con_get_try_complete_early(Request *req)
     return FALSE;
 }
 
+static gboolean
+_subject_equal(NMAuthSubject *a, NMAuthSubject *b)
+{
+    if (a == b)
+        return TRUE;
+    if (nm_auth_subject_get_subject_type(a) != nm_auth_subject_get_subject_type(b))
+        return FALSE;
+
+    switch (nm_auth_subject_get_subject_type(a)) {
+    case NM_AUTH_SUBJECT_TYPE_INTERNAL:
+        return TRUE;
+    case NM_AUTH_SUBJECT_TYPE_UNIX_PROCESS:
+        return nm_auth_subject_get_unix_process_pid(a) == nm_auth_subject_get_unix_process_pid(b)
+               && nm_auth_subject_get_unix_process_uid(a)
+                      == nm_auth_subject_get_unix_process_uid(b);
+    case NM_AUTH_SUBJECT_TYPE_UNIX_SESSION:
+        return nm_streq0(nm_auth_subject_get_unix_session_id(a),
+                         nm_auth_subject_get_unix_session_id(b));
+    default:
+        return FALSE;
+    }
+}
+
+static Request *
+_con_get_find_leader(NMAgentManager              *self,
+                     const char                  *path,
+                     NMAuthSubject               *subject,
+                     GVariant                    *existing_secrets,
+                     const char                  *setting_name,
+                     NMSecretAgentGetSecretsFlags flags,
+                     const char *const           *hints)
+{
+    NMAgentManagerPrivate *priv = NM_AGENT_MANAGER_GET_PRIVATE(self);
+    Request               *req;
+
+    /* The subject determines which agents are asked and in which order,
+     * and the existing secrets and hints what they are asked. Only requests
+     * where all of that is the same get the same answer. */
+    c_list_for_each_entry (req, &priv->request_lst_head, request_lst) {
+        if (req->request_type != REQUEST_TYPE_CON_GET)
+            continue;
+        if (req->con.get.flags != flags)
+            continue;
+        if (!nm_streq(req->con.path, path))
+            continue;
+        if (!nm_streq0(req->con.get.setting_name, setting_name))
+            continue;
+        if (!nm_strv_equal(req->con.get.hints, hints))
+            continue;
+        if (!_subject_equal(req->subject, subject))
+            continue;
+        if ((!req->con.get.existing_secrets) != (!existing_secrets))
+            continue;
+        if (existing_secrets && !g_variant_equal(req->con.get.existing_secrets, existing_secrets))
+            continue;
+        return req;
+    }
+    return NULL;
+}
+
 /**
  * nm_agent_manager_get_secrets:
  * @self:
@@ -1243,6 +1388,7 @@ nm_agent_manager_get_secrets(NMAgentManager              *self,
                              gpointer                     callback_data)
 {
     Request *req;
+    Request *leader;
 
     g_return_val_if_fail(self != NULL, NULL);
     g_return_val_if_fail(path && *path, NULL);
@@ -1271,6 +1417,22 @@ nm_agent_manager_get_secrets(NMAgentManager              *self,
     req->con.get.flags         = flags;
     req->con.get.callback      = callback;
     req->con.get.callback_data = callback_data;
+    c_list_init(&req->con.get.followers_lst_head);
+    c_list_init(&req->con.get.followers_lst);
+
+    leader =
+        _con_get_find_leader(self, path, subject, existing_secrets, setting_name, flags, hints);
+    if (leader) {
+        _LOGD(NULL,
+              "(" LOG_REQ_FMT ") wait for the result of identical request " LOG_REQ_FMT,
+              LOG_REQ_ARG(req),
+              LOG_REQ_ARG(leader));
+        req->con.get.leader = leader;
+        c_list_link_tail(&leader->con.get.followers_lst_head, &req->con.get.followers_lst);
+        return req;
+    }
+
+    c_list_link_tail(&NM_AGENT_MANAGER_GET_PRIVATE(self)->request_lst_head, &req->request_lst);
 
     if (!(req->con.get.flags & NM_SECRET_AGENT_GET_SECRETS_FLAG_ONLY_SYSTEM))
         request_add_agents(self, req);
@@ -1281,13 +1443,50 @@ nm_agent_manager_get_secrets(NMAgentManager              *self,
 void
 nm_agent_manager_cancel_secrets(NMAgentManager *self, NMAgentManagerCallId request_id)
 {
+    Request *leader;
+
     g_return_if_fail(self != NULL);
     g_return_if_fail(request_id);
     g_return_if_fail(request_id->request_type == REQUEST_TYPE_CON_GET);
 
+    leader = request_id->con.get.leader;
+    if (leader) {
+        c_list_unlink(&request_id->con.get.followers_lst);
+        request_id->con.get.leader = NULL;
+        req_complete_cancel(request_id, FALSE);
+
+        if (!leader->con.get.callback && c_list_is_empty(&leader->con.get.followers_lst_head)) {
+            /* Nobody waits for the leader anymore. */
+            c_list_unlink(&leader->request_lst);
+            request_free(leader);
+        }
+        return;
+    }
+
     nm_assert(c_list_contains(&NM_AGENT_MANAGER_GET_PRIVATE(self)->request_lst_head,
                               &request_id->request_lst));
 
+    if (!c_list_is_empty(&request_id->con.get.followers_lst_head)) {
+        gs_free_error GError *error = NULL;
+
+        /* Other callers still wait for the same secrets. Only complete the
+         * call of this caller, but keep the request going. */
+        nm_utils_error_set_cancelled(&error, FALSE, "NMAgentManager");
+        request_id->con.get.callback(self,
+                                     request_id,
+                                     NULL,
+                                     NULL,
+                                     FALSE,
+                                     request_id->con.get.setting_name,
+                                     request_id->con.get.flags,
+                                     NULL,
+                                     error,
+                                     request_id->con.get.callback_data);
+        request_id->con.get.callback      = NULL;
+        request_id->con.get.callback_data = NULL;
+        return;
+    }
+
     c_list_unlink(&request_id->request_lst);
 
     req_complete_cancel(request_id, FALSE);
@@ -1370,6 +1569,7 @@ nm_agent_manager_save_secrets(NMAgentManager *self,
     req = request_new(self, REQUEST_TYPE_CON_SAVE, nm_connection_get_id(connection), subject);
     req->con.path       = g_strdup(path);
     req->con.connection = g_object_ref(connection);
+    c_list_link_tail(&NM_AGENT_MANAGER_GET_PRIVATE(self)->request_lst_head, &req->request_lst);
 
     request_add_agents(self, req);
     req->idle_id = g_idle_add(request_start, req);
@@ -1449,6 +1649,7 @@ nm_agent_manager_delete_secrets(NMAgentManager *self, const char *path, NMConnec
     req->con.path       = g_strdup(path);
     req->con.connection = g_object_ref(connection);
     g_object_unref(subject);
+    c_list_link_tail(&NM_AGENT_MANAGER_GET_PRIVATE(self)->request_lst_head, &req->request_lst);
 
     request_add_agents(self, req);
     req->idle_id = g_idle_add(request_start, req);
@@ -1548,6 +1749,10 @@ constructed(GObject *object)
                      NM_AUTH_MANAGER_SIGNAL_CHANGED,
                      G_CALLBACK(authority_changed_cb),
                      object);
+    g_signal_connect(priv->session_monitor,
+                     NM_SESSION_MONITOR_CHANGED,
+                     G_CALLBACK(session_changed_cb),
+                     object);
 }
 
 static void
@@ -1575,7 +1780,12 @@ dispose(GObject *object)
 
     nm_dbus_object_unexport(NM_DBUS_OBJECT(object));
 
-    g_clear_object(&priv->session_monitor);
+    if (priv->session_monitor) {
+        g_signal_handlers_disconnect_by_func(priv->session_monitor,
+                                             G_CALLBACK(session_changed_cb),
+                                             object);
+        g_clear_object(&priv->session_monitor);
+    }
 
     G_OBJECT_CLASS(nm_agent_manager_parent_class)->dispose(object);
 }
@@ -33,7 +33,12 @@ struct _NMSecretAgent {
     CList                         agent_lst;
     struct _NMAuthChain          *auth_chain;
     struct _NMSecretAgentPrivate *_priv;
-    bool                          fully_registered : 1;
+
+    /* The position by preference among all agents. Maintained by
+     * NMAgentManager. */
+    guint sort_rank;
+
+    bool fully_registered : 1;
 };
 
 GType nm_secret_agent_get_type(void);
@@ -24,6 +24,7 @@
 #include "libnm-core-intern/nm-core-internal.h"
 #include "nm-audit-manager.h"
 #include "nm-settings.h"
+#include "nm-settings-utils.h"
 #include "nm-manager.h"
 #include "nm-dbus-manager.h"
 #include "settings/plugins/keyfile/nms-keyfile-storage.h"
@@ -137,6 +138,7 @@ typedef struct _NMSettingsConnectionPrivate {
     struct {
         NMConnectionSerializationOptions options;
         GVariant                        *variant;
+        NMSettUtilLruEntry               lru_entry;
     } getsettings_cached;
 
     NMSettingsStorage *storage;
@@ -156,6 +158,13 @@ typedef struct _NMSettingsConnectionPrivate {
     CList       seen_bssids_lst_head;
     GHashTable *seen_bssids_hash;
 
+    /* The uids of the "user" permissions, resolved from the user names. */
+    struct {
+        GArray *arr;
+        bool    valid : 1;
+        bool    has_unresolved : 1;
+    } permission_uids;
+
     guint64 timestamp; /* Up-to-date timestamp of connection use */
 
     guint64 last_secret_agent_version_id;
@@ -217,6 +226,7 @@ G_DEFINE_TYPE(NMSettingsConnection, nm_settings_connection, NM_TYPE_DBUS_OBJECT)
 /*****************************************************************************/
 
 static const GDBusSignalInfo             signal_info_updated;
+static const GDBusSignalInfo             signal_info_updated_settings;
 static const GDBusSignalInfo             signal_info_removed;
 static const NMDBusInterfaceInfoExtended interface_info_settings_connection;
 
@@ -340,6 +350,26 @@ nm_settings_connection_still_valid(NMSettingsConnection *self)
 
 /*****************************************************************************/
 
+/* The serialized settings for GetSettings() are cached, because clients tend
+ * to request them repeatedly. With many profiles, keeping them for every
+ * profile would about double the memory used for settings. Only keep the
+ * most recently requested ones.
+ *
+ * A client that enumerates all profiles requests each of them once. If there
+ * are more profiles than cache entries, a plain LRU would evict every entry
+ * before it is requested again. Instead, entries that were used during the
+ * last GETSETTINGS_CACHED_KEEP_MSEC are not evicted, and the settings of
+ * further profiles are returned without caching them. A cache miss costs one
+ * serialization of the profile, see "/settings/getsettings-cost" in
+ * test-core for numbers. */
+#define GETSETTINGS_CACHED_MAX       200
+#define GETSETTINGS_CACHED_KEEP_MSEC (60 * 1000)
+
+static NMSettUtilLru _getsettings_cached_lru =
+    NM_SETT_UTIL_LRU_INIT(_getsettings_cached_lru,
+                          GETSETTINGS_CACHED_MAX,
+                          GETSETTINGS_CACHED_KEEP_MSEC);
+
 static void
 _getsettings_cached_clear(NMSettingsConnectionPrivate *priv)
 {
@@ -347,14 +377,19 @@ _getsettings_cached_clear(NMSettingsConnectionPrivate *priv)
         priv->getsettings_cached.options.timestamp.has = FALSE;
         priv->getsettings_cached.options.timestamp.val = 0;
         nm_clear_g_free((gpointer *) &priv->getsettings_cached.options.seen_bssids);
+        nm_sett_util_lru_unlink(&_getsettings_cached_lru, &priv->getsettings_cached.lru_entry);
     }
 }
 
+/* Returns: (transfer none): the cached variant, or a floating reference if
+ *   the result was not cached. */
 static GVariant *
 _getsettings_cached_get(NMSettingsConnection *self, const NMConnectionSerializationOptions *options)
 {
     NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE(self);
     GVariant                    *variant;
+    NMSettUtilLruEntry          *evict;
+    gint64                       now_msec;
 
     if (priv->getsettings_cached.variant) {
         if (nm_connection_serialization_options_equal(&priv->getsettings_cached.options, options)) {
@@ -368,6 +403,9 @@ _getsettings_cached_get(NMSettingsConnection *self, const NMConnectionSerializat
             variant2 = g_variant_new("(@a{sa{sv}})", variant);
             nm_assert(g_variant_equal(priv->getsettings_cached.variant, variant2));
 #endif
+            nm_sett_util_lru_touch(&_getsettings_cached_lru,
+                                   &priv->getsettings_cached.lru_entry,
+                                   nm_utils_get_monotonic_timestamp_msec());
             return priv->getsettings_cached.variant;
         }
         _getsettings_cached_clear(priv);
@@ -380,12 +418,22 @@ _getsettings_cached_get(NMSettingsConnection *self, const NMConnectionSerializat
                                          options);
     nm_assert(variant);
 
+    now_msec = nm_utils_get_monotonic_timestamp_msec();
+    if (!nm_sett_util_lru_make_room(&_getsettings_cached_lru, now_msec, &evict))
+        return g_variant_new("(@a{sa{sv}})", variant);
+    if (evict) {
+        _getsettings_cached_clear(
+            c_list_entry(evict, NMSettingsConnectionPrivate, getsettings_cached.lru_entry));
+    }
+
     priv->getsettings_cached.variant = g_variant_ref_sink(g_variant_new("(@a{sa{sv}})", variant));
 
     priv->getsettings_cached.options = *options;
     priv->getsettings_cached.options.seen_bssids =
         nm_strv_dup_packed(priv->getsettings_cached.options.seen_bssids, -1);
 
+    nm_sett_util_lru_touch(&_getsettings_cached_lru, &priv->getsettings_cached.lru_entry, now_msec);
+
     return priv->getsettings_cached.variant;
 }
 
@@ -437,6 +485,7 @@ _nm_settings_connection_set_connection(NMSettingsConnection            *self,
         nm_assert_connection_unchanging(priv->connection);
 
         _getsettings_cached_clear(priv);
+        priv->permission_uids.valid = FALSE;
         _nm_settings_notify_sorted_by_autoconnect_priority_maybe_changed(priv->settings);
 
         /* note that we only return @connection_old if the new connection actually differs from
@@ -487,12 +536,55 @@ nm_settings_connection_get_last_secret_agent_version_id(NMSettingsConnection *se
 
 /*****************************************************************************/
 
+static const GArray *
+_permission_uids_ensure(NMSettingsConnection *self)
+{
+    NMSettingsConnectionPrivate *priv = NM_SETTINGS_CONNECTION_GET_PRIVATE(self);
+    NMSettingConnection         *s_con;
+    guint32                      num, i;
+
+    /* Resolving the user names is not free, so we cache the result until
+     * the profile changes. Names that could not be resolved are retried
+     * every time, because the user might have been created meanwhile. */
+    if (priv->permission_uids.valid && !priv->permission_uids.has_unresolved)
+        return priv->permission_uids.arr;
+
+    if (priv->permission_uids.arr)
+        g_array_set_size(priv->permission_uids.arr, 0);
+
+    priv->permission_uids.valid          = TRUE;
+    priv->permission_uids.has_unresolved = FALSE;
+
+    s_con = nm_connection_get_setting_connection(nm_settings_connection_get_connection(self));
+    num   = nm_setting_connection_get_num_permissions(s_con);
+    for (i = 0; i < num; i++) {
+        const char *ptype;
+        const char *user;
+        uid_t       uid;
+
+        if (!nm_setting_connection_get_permission(s_con, i, &ptype, &user, NULL))
+            continue;
+        if (!nm_streq(ptype, NM_SETTINGS_CONNECTION_PERMISSION_USER))
+            continue;
+        if (!nm_utils_name_to_uid(user, &uid)) {
+            priv->permission_uids.has_unresolved = TRUE;
+            continue;
+        }
+        if (!priv->permission_uids.arr)
+            priv->permission_uids.arr = g_array_new(FALSE, FALSE, sizeof(uid_t));
+        g_array_append_val(priv->permission_uids.arr, uid);
+    }
+
+    return priv->permission_uids.arr;
+}
+
 gboolean
 nm_settings_connection_check_visibility(NMSettingsConnection *self,
                                         NMSessionMonitor     *session_monitor)
 {
     NMSettingConnection *s_con;
-    guint32              num, i;
+    const GArray        *uids;
+    guint                i;
 
     g_return_val_if_fail(NM_IS_SETTINGS_CONNECTION(self), FALSE);
 
@@ -501,25 +593,55 @@ nm_settings_connection_check_visibility(NMSettingsConnection *self,
     s_con = nm_connection_get_setting_connection(nm_settings_connection_get_connection(self));
 
     /* Check every user in the ACL for a session */
-    num = nm_setting_connection_get_num_permissions(s_con);
-    if (num == 0)
+    if (nm_setting_connection_get_num_permissions(s_con) == 0)
         return TRUE;
 
-    for (i = 0; i < num; i++) {
-        const char *ptype;
-        const char *user;
-        uid_t       uid;
+    uids = _permission_uids_ensure(self);
+    for (i = 0; uids && i < uids->len; i++) {
+        if (nm_session_monitor_session_exists(session_monitor,
+                                              nm_g_array_index(uids, uid_t, i),
+                                              FALSE))
+            return TRUE;
+    }
 
-        if (!nm_setting_connection_get_permission(s_con, i, &ptype, &user, NULL))
-            continue;
-        if (!nm_streq(ptype, NM_SETTINGS_CONNECTION_PERMISSION_USER))
-            continue;
-        if (!nm_utils_name_to_uid(user, &uid))
-            continue;
-        if (!nm_session_monitor_session_exists(session_monitor, uid, FALSE))
-            continue;
+    return FALSE;
+}
 
+/**
+ * nm_settings_connection_check_visibility_depends_on:
+ * @self: the #NMSettingsConnection
+ * @uids: a #GArray of uid_t
+ *
+ * Returns: %TRUE if the visibility of @self might change when
+ *   the session state of any of the users in @uids changes.
+ */
+gboolean
+nm_settings_connection_check_visibility_depends_on(NMSettingsConnection *self, const GArray *uids)
+{
+    NMSettingsConnectionPrivate *priv;
+    NMSettingConnection         *s_con;
+    const GArray                *permission_uids;
+    guint                        i, j;
+
+    g_return_val_if_fail(NM_IS_SETTINGS_CONNECTION(self), FALSE);
+
+    priv  = NM_SETTINGS_CONNECTION_GET_PRIVATE(self);
+    s_con = nm_connection_get_setting_connection(nm_settings_connection_get_connection(self));
+
+    if (nm_setting_connection_get_num_permissions(s_con) == 0)
+        return FALSE;
+
+    permission_uids = _permission_uids_ensure(self);
+    if (priv->permission_uids.has_unresolved)
         return TRUE;
+
+    for (i = 0; permission_uids && i < permission_uids->len; i++) {
+        uid_t uid = nm_g_array_index(permission_uids, uid_t, i);
+
+        for (j = 0; j < uids->len; j++) {
+            if (uid == nm_g_array_index(uids, uid_t, j))
+                return TRUE;
+        }
     }
 
     return FALSE;
@@ -1397,21 +1519,12 @@ auth_start(NMSettingsConnection  *self,
 
 /**** DBus method handlers ************************************/
 
-static void
-get_settings_auth_cb(NMSettingsConnection  *self,
-                     GDBusMethodInvocation *context,
-                     NMAuthSubject         *subject,
-                     GError                *error,
-                     gpointer               data)
+static GVariant *
+_getsettings_get(NMSettingsConnection *self)
 {
     const char                      *seen_bssids_strv[SEEN_BSSIDS_MAX + 1];
     NMConnectionSerializationOptions options = {};
 
-    if (error) {
-        g_dbus_method_invocation_return_gerror(context, error);
-        return;
-    }
-
     /* Timestamp is not updated in connection's 'timestamp' property,
      * because it would force updating the connection and in turn
      * writing to /etc periodically, which we want to avoid. Rather real
@@ -1433,7 +1546,22 @@ get_settings_auth_cb(NMSettingsConnection  *self,
      * protected against leakage of secrets to unprivileged callers.
      */
 
-    g_dbus_method_invocation_return_value(context, _getsettings_cached_get(self, &options));
+    return _getsettings_cached_get(self, &options);
+}
+
+static void
+get_settings_auth_cb(NMSettingsConnection  *self,
+                     GDBusMethodInvocation *context,
+                     NMAuthSubject         *subject,
+                     GError                *error,
+                     gpointer               data)
+{
+    if (error) {
+        g_dbus_method_invocation_return_gerror(context, error);
+        return;
+    }
+
+    g_dbus_method_invocation_return_value(context, _getsettings_get(self));
 }
 
 static void
@@ -2140,6 +2268,21 @@ impl_settings_connection_clear_secrets(NMDBusObject                      *obj,
 void
 _nm_settings_connection_emit_dbus_signal_updated(NMSettingsConnection *self)
 {
+    NMSettingConnection *s_con;
+
+    /* For profiles that are visible to everybody, send the new settings along
+     * so that clients don't need to call GetSettings() in response. This is
+     * emitted before "Updated", so that clients that receive it can ignore the
+     * following "Updated" signal. */
+    s_con = nm_connection_get_setting_connection(nm_settings_connection_get_connection(self));
+    if (s_con && nm_setting_connection_get_num_permissions(s_con) == 0
+        && nm_dbus_object_is_exported(NM_DBUS_OBJECT(self))) {
+        nm_dbus_object_emit_signal_variant(NM_DBUS_OBJECT(self),
+                                           &interface_info_settings_connection,
+                                           &signal_info_updated_settings,
+                                           _getsettings_get(self));
+    }
+
     nm_dbus_object_emit_signal(NM_DBUS_OBJECT(self),
                                &interface_info_settings_connection,
                                &signal_info_updated,
@@ -2772,6 +2915,7 @@ nm_settings_connection_init(NMSettingsConnection *self)
     c_list_init(&priv->seen_bssids_lst_head);
     c_list_init(&priv->call_ids_lst_head);
     c_list_init(&priv->auth_lst_head);
+    c_list_init(&priv->getsettings_cached.lru_entry.lst);
 
     priv->agent_mgr = g_object_ref(nm_agent_manager_get());
     priv->settings  = g_object_ref(nm_settings_get());
@@ -2810,6 +2954,8 @@ dispose(GObject *object)
 
     nm_clear_pointer(&priv->seen_bssids_hash, g_hash_table_destroy);
 
+    nm_clear_pointer(&priv->permission_uids.arr, g_array_unref);
+
     g_clear_object(&priv->agent_mgr);
 
     g_clear_object(&priv->connection);
@@ -2832,6 +2978,10 @@ dispose(GObject *object)
 
 static const GDBusSignalInfo signal_info_updated = NM_DEFINE_GDBUS_SIGNAL_INFO_INIT("Updated", );
 
+static const GDBusSignalInfo signal_info_updated_settings = NM_DEFINE_GDBUS_SIGNAL_INFO_INIT(
+    "UpdatedSettings",
+    .args = NM_DEFINE_GDBUS_ARG_INFOS(NM_DEFINE_GDBUS_ARG_INFO("settings", "a{sa{sv}}"), ), );
+
 static const GDBusSignalInfo signal_info_removed = NM_DEFINE_GDBUS_SIGNAL_INFO_INIT("Removed", );
 
 static const NMDBusInterfaceInfoExtended interface_info_settings_connection = {
@@ -2880,7 +3030,9 @@ static const NMDBusInterfaceInfoExtended interface_info_settings_connection = {
                     .out_args =
                         NM_DEFINE_GDBUS_ARG_INFOS(NM_DEFINE_GDBUS_ARG_INFO("result", "a{sv}"), ), ),
                 .handle = impl_settings_connection_update2, ), ),
-        .signals    = NM_DEFINE_GDBUS_SIGNAL_INFOS(&signal_info_updated, &signal_info_removed, ),
+        .signals    = NM_DEFINE_GDBUS_SIGNAL_INFOS(&signal_info_updated,
+                                                &signal_info_updated_settings,
+                                                &signal_info_removed, ),
         .properties = NM_DEFINE_GDBUS_PROPERTY_INFOS(
             NM_DEFINE_DBUS_PROPERTY_INFO_EXTENDED_READABLE("Unsaved",
                                                            "b",
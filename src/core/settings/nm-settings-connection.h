@@ -282,6 +282,9 @@ void nm_settings_connection_cancel_secrets(NMSettingsConnection       *self,
 gboolean nm_settings_connection_check_visibility(NMSettingsConnection *self,
                                                  NMSessionMonitor     *session_monitor);
 
+gboolean nm_settings_connection_check_visibility_depends_on(NMSettingsConnection *self,
+                                                            const GArray         *uids);
+
 gboolean nm_settings_connection_check_permission(NMSettingsConnection *self,
                                                  const char           *permission);
 
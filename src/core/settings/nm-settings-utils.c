@@ -159,3 +159,66 @@ nm_sett_util_storages_steal(NMSettUtilStorages *storages,
 
     return storage;
 }
+
+/*****************************************************************************/
+
+void
+nm_sett_util_lru_touch(NMSettUtilLru *lru, NMSettUtilLruEntry *entry, gint64 now_msec)
+{
+    nm_assert(lru);
+    nm_assert(entry);
+
+    if (c_list_is_empty(&entry->lst)) {
+        nm_assert(lru->len < G_MAXUINT);
+        lru->len++;
+    }
+    nm_c_list_move_tail(&lru->lst_head, &entry->lst);
+    entry->used_at_msec = now_msec;
+}
+
+void
+nm_sett_util_lru_unlink(NMSettUtilLru *lru, NMSettUtilLruEntry *entry)
+{
+    nm_assert(lru);
+    nm_assert(entry);
+
+    if (c_list_is_empty(&entry->lst))
+        return;
+
+    nm_assert(lru->len > 0);
+    nm_assert(c_list_contains(&lru->lst_head, &entry->lst));
+    c_list_unlink(&entry->lst);
+    lru->len--;
+}
+
+/**
+ * nm_sett_util_lru_make_room:
+ * @lru: the #NMSettUtilLru
+ * @now_msec: the current timestamp
+ * @out_evict: (out): the entry that must be dropped to make room
+ *
+ * Returns: %TRUE if there is room for one more entry. In that case, if
+ *   @out_evict is set, the caller must first drop that entry (and unlink
+ *   it). %FALSE means the list is full of recently used entries and the new
+ *   one should not be added.
+ */
+gboolean
+nm_sett_util_lru_make_room(NMSettUtilLru *lru, gint64 now_msec, NMSettUtilLruEntry **out_evict)
+{
+    NMSettUtilLruEntry *entry;
+
+    nm_assert(lru);
+    nm_assert(out_evict);
+
+    *out_evict = NULL;
+
+    if (lru->len < lru->max_len)
+        return TRUE;
+
+    entry = c_list_first_entry(&lru->lst_head, NMSettUtilLruEntry, lst);
+    if (!entry || now_msec - entry->used_at_msec < lru->keep_msec)
+        return FALSE;
+
+    *out_evict = entry;
+    return TRUE;
+}
@@ -88,4 +88,37 @@ typedef struct {
 
 gboolean nm_sett_util_allow_filename_cb(const char *filename, gpointer user_data);
 
+/*****************************************************************************/
+
+/* A LRU list with a bounded length. Entries that were used within the last
+ * @keep_msec are never evicted to make room for new ones. That way, requesting
+ * more entries than fit (for example, by enumerating all of them) doesn't
+ * churn through the list; the new entries are just not added. */
+typedef struct {
+    CList  lst_head;
+    guint  len;
+    guint  max_len;
+    gint64 keep_msec;
+} NMSettUtilLru;
+
+typedef struct {
+    CList  lst;
+    gint64 used_at_msec;
+} NMSettUtilLruEntry;
+
+#define NM_SETT_UTIL_LRU_INIT(lru, _max_len, _keep_msec) \
+    {                                                   \
+        .lst_head  = C_LIST_INIT((lru).lst_head),       \
+        .max_len   = (_max_len),                        \
+        .keep_msec = (_keep_msec),                      \
+    }
+
+void nm_sett_util_lru_touch(NMSettUtilLru *lru, NMSettUtilLruEntry *entry, gint64 now_msec);
+
+void nm_sett_util_lru_unlink(NMSettUtilLru *lru, NMSettUtilLruEntry *entry);
+
+gboolean nm_sett_util_lru_make_room(NMSettUtilLru       *lru,
+                                    gint64               now_msec,
+                                    NMSettUtilLruEntry **out_evict);
+
 #endif /* __NM_SETTINGS_UTILS_H__ */
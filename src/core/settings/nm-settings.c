@@ -3912,7 +3912,9 @@ nm_settings_device_removed(NMSettings *self, NMDevice *device, gboolean quitting
 /*****************************************************************************/
 
 static void
-session_monitor_changed_cb(NMSessionMonitor *session_monitor, NMSettings *self)
+session_monitor_changed_cb(NMSessionMonitor *session_monitor,
+                           const GArray     *changed_uids,
+                           NMSettings       *self)
 {
     NMSettingsPrivate           *priv = NM_SETTINGS_GET_PRIVATE(self);
     NMSettingsConnection *const *list;
@@ -3925,6 +3927,12 @@ again:
     for (i = 0; i < len; i++) {
         gboolean is_visible;
 
+        /* Only profiles that restrict visibility to one of the affected
+         * users need to be rechecked. */
+        if (changed_uids
+            && !nm_settings_connection_check_visibility_depends_on(list[i], changed_uids))
+            continue;
+
         is_visible = nm_settings_connection_check_visibility(list[i], session_monitor);
         nm_settings_connection_set_flags(list[i],
                                          NM_SETTINGS_CONNECTION_INT_FLAGS_VISIBLE,
@@ -19,6 +19,7 @@
 #include "dns/nm-dns-manager.h"
 #include "nm-connectivity.h"
 #include "nm-firewall-utils.h"
+#include "settings/nm-settings-utils.h"
 
 #include "nm-test-utils-core.h"
 
@@ -2772,6 +2773,140 @@ test_nm_firewall_nft_stdio_mlag(void)
 
 /*****************************************************************************/
 
+typedef struct {
+    NMSettUtilLruEntry lru_entry;
+    bool               cached : 1;
+} TestLruData;
+
+static gboolean
+_test_lru_request(NMSettUtilLru *lru, TestLruData *d, gint64 now_msec)
+{
+    NMSettUtilLruEntry *evict;
+
+    if (d->cached) {
+        nm_sett_util_lru_touch(lru, &d->lru_entry, now_msec);
+        return TRUE;
+    }
+
+    if (!nm_sett_util_lru_make_room(lru, now_msec, &evict))
+        return FALSE;
+    if (evict) {
+        c_list_entry(evict, TestLruData, lru_entry)->cached = FALSE;
+        nm_sett_util_lru_unlink(lru, evict);
+    }
+    d->cached = TRUE;
+    nm_sett_util_lru_touch(lru, &d->lru_entry, now_msec);
+    return FALSE;
+}
+
+static void
+test_settings_lru(void)
+{
+    NMSettUtilLru lru = NM_SETT_UTIL_LRU_INIT(lru, 5, 1000);
+    TestLruData   data[20];
+    guint         hits;
+    guint         i;
+
+    for (i = 0; i < G_N_ELEMENTS(data); i++) {
+        data[i] = (TestLruData) {};
+        c_list_init(&data[i].lru_entry.lst);
+    }
+
+    /* The first enumeration fills the list, then stops adding. */
+    hits = 0;
+    for (i = 0; i < G_N_ELEMENTS(data); i++)
+        hits += _test_lru_request(&lru, &data[i], 100);
+    g_assert_cmpint(hits, ==, 0);
+    g_assert_cmpint(lru.len, ==, 5);
+    for (i = 0; i < G_N_ELEMENTS(data); i++)
+        g_assert_cmpint(data[i].cached, ==, i < 5);
+
+    /* A second enumeration shortly after hits the same entries. A plain LRU
+     * would have no hits at all. */
+    hits = 0;
+    for (i = 0; i < G_N_ELEMENTS(data); i++)
+        hits += _test_lru_request(&lru, &data[i], 200);
+    g_assert_cmpint(hits, ==, 5);
+
+    /* Once the entries are no longer used, they make room for others. */
+    g_assert(!_test_lru_request(&lru, &data[10], 1300));
+    g_assert(data[10].cached);
+    g_assert(!data[0].cached);
+    g_assert(_test_lru_request(&lru, &data[10], 1300));
+    g_assert_cmpint(lru.len, ==, 5);
+
+    for (i = 0; i < G_N_ELEMENTS(data); i++)
+        nm_sett_util_lru_unlink(&lru, &data[i].lru_entry);
+    g_assert_cmpint(lru.len, ==, 0);
+    g_assert(c_list_is_empty(&lru.lst_head));
+}
+
+static void
+test_settings_getsettings_cost(void)
+{
+    const guint                  N           = nmtst_test_quick() ? 2000 : 20000;
+    gs_unref_ptrarray GPtrArray *connections = NULL;
+    gs_unref_ptrarray GPtrArray *variants    = NULL;
+    gsize                        size_total  = 0;
+    double                       t_serialize;
+    guint                        i;
+
+    /* Measure what the GetSettings() cache in NMSettingsConnection saves and
+     * costs: the time to serialize a profile on a cache miss, and the size of
+     * a cached entry. */
+
+    connections = g_ptr_array_new_with_free_func(g_object_unref);
+    for (i = 0; i < N; i++) {
+        gs_free char      *id = g_strdup_printf("profile-%u", i);
+        NMConnection      *con;
+        NMSettingIPConfig *s_ip4;
+        NMIPAddress       *addr;
+
+        con = nmtst_create_minimal_connection(id, NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+
+        s_ip4 = NM_SETTING_IP_CONFIG(nm_setting_ip4_config_new());
+        g_object_set(s_ip4,
+                     NM_SETTING_IP_CONFIG_METHOD,
+                     NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+                     NM_SETTING_IP_CONFIG_GATEWAY,
+                     "10.0.0.1",
+                     NULL);
+        addr = nm_ip_address_new(AF_INET, "10.0.0.2", 24, NULL);
+        nm_setting_ip_config_add_address(s_ip4, addr);
+        nm_ip_address_unref(addr);
+        nm_setting_ip_config_add_dns(s_ip4, "10.0.0.53");
+        nm_connection_add_setting(con, NM_SETTING(s_ip4));
+
+        nmtst_connection_normalize(con);
+        g_ptr_array_add(connections, con);
+    }
+
+    variants = g_ptr_array_new_full(N, (GDestroyNotify) g_variant_unref);
+
+    g_test_timer_start();
+    for (i = 0; i < N; i++) {
+        GVariant *variant;
+
+        variant =
+            nm_connection_to_dbus(connections->pdata[i], NM_CONNECTION_SERIALIZE_WITH_NON_SECRET);
+        g_ptr_array_add(variants, g_variant_ref_sink(g_variant_new("(@a{sa{sv}})", variant)));
+    }
+    t_serialize = g_test_timer_elapsed();
+
+    for (i = 0; i < N; i++)
+        size_total += g_variant_get_size(variants->pdata[i]);
+
+    g_test_message("GetSettings() of %u profiles: %.3f msec to serialize (%.1f usec per cache "
+                   "miss), %zu KiB serialized (%zu bytes per cache entry, at least)",
+                   N,
+                   t_serialize * 1000.0,
+                   t_serialize * 1000000.0 / N,
+                   size_total / 1024,
+                   size_total / N);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -2781,6 +2916,9 @@ main(int argc, char **argv)
 
     g_test_add_func("/general/test_config_h", test_config_h);
 
+    g_test_add_func("/settings/lru", test_settings_lru);
+    g_test_add_func("/settings/getsettings-cost", test_settings_getsettings_cost);
+
     g_test_add_func("/general/test_logging_domains", test_logging_domains);
     g_test_add_func("/general/test_logging_error", test_logging_error);
 
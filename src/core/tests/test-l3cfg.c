@@ -520,6 +520,121 @@ test_l3cfg(gconstpointer test_data)
 
 /*****************************************************************************/
 
+static void
+test_l3cfg_ip6_route_expired(void)
+{
+    nm_auto(_test_fixture_1_teardown) TestFixture1 test_fixture = {};
+    const TestFixture1                            *f;
+    gs_unref_object NML3Cfg                       *l3cfg0 = NULL;
+    nm_auto_unref_l3cd_init NML3ConfigData        *l3cd   = NULL;
+    NML3CfgCommitTypeHandle                       *commit_type;
+    NMPlatformIP6Route                             rt_expires;
+    NMPlatformIP6Route                             rt_permanent;
+    gint32                                         now;
+
+    f = _test_fixture_1_setup(&test_fixture, 1);
+
+    l3cfg0 = _netns_access_l3cfg(f->netns, f->ifindex0);
+
+    commit_type =
+        nm_l3cfg_commit_type_register(l3cfg0, NM_L3_CFG_COMMIT_TYPE_UPDATE, NULL, "test");
+
+    now = nm_utils_get_monotonic_timestamp_sec();
+
+    rt_expires = ((NMPlatformIP6Route) {
+        .ifindex   = f->ifindex0,
+        .rt_source = NM_IP_CONFIG_SOURCE_NDISC,
+        .network   = nmtst_inet6_from_string("2001:db8:1::"),
+        .plen      = 64,
+        .metric    = 1024,
+        .expires   = now + 2,
+    });
+    rt_permanent         = rt_expires;
+    rt_permanent.network = nmtst_inet6_from_string("2001:db8:2::");
+    rt_permanent.expires = 0;
+
+    l3cd = nm_l3_config_data_new(f->multiidx, f->ifindex0, NM_IP_CONFIG_SOURCE_NDISC);
+    nm_l3_config_data_add_address_6(
+        l3cd,
+        NM_PLATFORM_IP6_ADDRESS_INIT(.address = nmtst_inet6_from_string("1:2:3:4::45"),
+                                     .plen    = 64, ));
+    nm_l3_config_data_add_route_6(l3cd, &rt_expires);
+    nm_l3_config_data_add_route_6(l3cd, &rt_permanent);
+
+    nm_l3cfg_add_config(l3cfg0,
+                        GINT_TO_POINTER('a'),
+                        FALSE,
+                        l3cd,
+                        'a',
+                        0,
+                        0,
+                        NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP4,
+                        NM_PLATFORM_ROUTE_METRIC_DEFAULT_IP6,
+                        0,
+                        0,
+                        NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                        NM_DNS_PRIORITY_DEFAULT_NORMAL,
+                        NM_L3_ACD_DEFEND_TYPE_NEVER,
+                        0,
+                        NM_L3CFG_CONFIG_FLAGS_NONE,
+                        NM_L3_CONFIG_MERGE_FLAGS_NONE);
+
+    nm_l3cfg_commit(l3cfg0, NM_L3_CFG_COMMIT_TYPE_UPDATE);
+
+    g_assert(nmtstp_ip6_route_get(f->platform,
+                                  f->ifindex0,
+                                  &rt_expires.network,
+                                  rt_expires.plen,
+                                  rt_expires.metric,
+                                  NULL,
+                                  0));
+    g_assert(nmtstp_ip6_route_get(f->platform,
+                                  f->ifindex0,
+                                  &rt_permanent.network,
+                                  rt_permanent.plen,
+                                  rt_permanent.metric,
+                                  NULL,
+                                  0));
+
+    /* Wait until the lifetime is over. Kernel may or may not have removed the
+     * route by then. Remove it, like kernel would. */
+    nmtst_main_context_iterate_until(NULL, 3100, FALSE);
+    g_assert(nmtstp_platform_ip6_route_delete(f->platform,
+                                              f->ifindex0,
+                                              rt_expires.network,
+                                              rt_expires.plen,
+                                              rt_expires.metric));
+    g_assert(nmtstp_platform_ip6_route_delete(f->platform,
+                                              f->ifindex0,
+                                              rt_permanent.network,
+                                              rt_permanent.plen,
+                                              rt_permanent.metric));
+
+    /* The config still contains the expired route, as NDisc did not yet drop
+     * it. A commit doesn't add it back, but it re-adds the permanent one. */
+    nm_l3cfg_commit(l3cfg0, NM_L3_CFG_COMMIT_TYPE_UPDATE);
+
+    g_assert(!nmtstp_ip6_route_get(f->platform,
+                                   f->ifindex0,
+                                   &rt_expires.network,
+                                   rt_expires.plen,
+                                   rt_expires.metric,
+                                   NULL,
+                                   0));
+    g_assert(nmtstp_ip6_route_get(f->platform,
+                                  f->ifindex0,
+                                  &rt_permanent.network,
+                                  rt_permanent.plen,
+                                  rt_permanent.metric,
+                                  NULL,
+                                  0));
+
+    nm_l3cfg_commit_type_unregister(l3cfg0, commit_type);
+    nm_l3cfg_remove_config_all(l3cfg0, GINT_TO_POINTER('a'));
+}
+
+/*****************************************************************************/
+
 #define L3IPV4LL_ACD_TIMEOUT_MSEC 1500u
 
 typedef struct {
@@ -1089,6 +1204,7 @@ _nmtstp_setup_tests(void)
     g_test_add_data_func("/l3cfg/2", GINT_TO_POINTER(2), test_l3cfg);
     g_test_add_data_func("/l3cfg/3", GINT_TO_POINTER(3), test_l3cfg);
     g_test_add_data_func("/l3cfg/4", GINT_TO_POINTER(4), test_l3cfg);
+    g_test_add_func("/l3cfg/ip6-route-expired", test_l3cfg_ip6_route_expired);
     g_test_add_data_func("/l3-ipv4ll/1", GINT_TO_POINTER(1), test_l3_ipv4ll);
     g_test_add_data_func("/l3-ipv4ll/2", GINT_TO_POINTER(2), test_l3_ipv4ll);
     g_test_add_data_func("/l3-ipv6ll/1", GINT_TO_POINTER(1), test_l3_ipv6ll);
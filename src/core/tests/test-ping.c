@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include <fcntl.h>
+
+#include "nm-ping.h"
+#include "nm-test-utils-core.h"
+
+/* No such interface exists. */
+#define IFINDEX_NONEXISTING G_MAXINT
+
+/*****************************************************************************/
+
+typedef struct {
+    NMPingProbe *probe_a;
+    NMPingProbe *probe_b;
+    NMPingProbe *probe_c;
+    guint        a_count;
+    guint        c_count;
+} TestData;
+
+static NMPingProbe *
+_probe_start(int                 addr_family,
+             const char         *addr_str,
+             int                 ifindex,
+             NMPingProbeCallback callback,
+             gpointer            user_data)
+{
+    gs_free_error GError *error = NULL;
+    NMIPAddr              addr;
+    NMPingProbe          *probe;
+
+    if (!nm_inet_parse_bin(addr_family, addr_str, NULL, &addr))
+        g_assert_not_reached();
+
+    probe = nm_ping_probe_start(addr_family, &addr, ifindex, callback, user_data, &error);
+    if (!probe) {
+        /* We need either net.ipv4.ping_group_range or CAP_NET_RAW. */
+        g_assert(error);
+        g_test_skip(error->message);
+    }
+    return probe;
+}
+
+static void
+_probe_a_cb(NMPingProbe *probe, gpointer user_data)
+{
+    TestData *data = user_data;
+
+    g_assert(probe == data->probe_a);
+    data->probe_a = NULL;
+    data->a_count++;
+}
+
+static void
+_probe_b_cb(NMPingProbe *probe, gpointer user_data)
+{
+    /* The replies arrive on loopback, not on the interface of this probe. */
+    g_assert_not_reached();
+}
+
+static void
+_probe_c_cb(NMPingProbe *probe, gpointer user_data)
+{
+    TestData *data = user_data;
+
+    g_assert(probe == data->probe_c);
+    data->probe_c = NULL;
+    data->c_count++;
+
+    /* Cancelling the last other probe of the socket from within the callback
+     * must not free the socket while it is still dispatching. */
+    nm_clear_pointer(&data->probe_b, nm_ping_probe_cancel);
+}
+
+static void
+test_ping_loopback4(void)
+{
+    TestData data = {};
+    int      fd;
+
+    data.probe_a = _probe_start(AF_INET, "127.0.0.1", NM_LOOPBACK_IFINDEX, _probe_a_cb, &data);
+    if (!data.probe_a)
+        return;
+
+    /* The probes of one address family share a socket. */
+    data.probe_b = _probe_start(AF_INET, "127.0.0.1", IFINDEX_NONEXISTING, _probe_b_cb, &data);
+    data.probe_c = _probe_start(AF_INET, "127.0.0.2", NM_LOOPBACK_IFINDEX, _probe_c_cb, &data);
+    g_assert(data.probe_b && data.probe_c);
+
+    fd = _nm_ping_probe_get_fd(data.probe_a);
+    g_assert_cmpint(fd, >=, 0);
+    g_assert_cmpint(_nm_ping_probe_get_fd(data.probe_b), ==, fd);
+    g_assert_cmpint(_nm_ping_probe_get_fd(data.probe_c), ==, fd);
+
+    /* The reply to 127.0.0.1 only completes the probe on loopback. The other
+     * one is only cancelled by the callback of the 127.0.0.2 probe. */
+    nmtst_main_context_iterate_until_assert(NULL, 5000, !data.probe_a && !data.probe_c);
+    g_assert_cmpint(data.a_count, ==, 1);
+    g_assert_cmpint(data.c_count, ==, 1);
+    g_assert(!data.probe_b);
+
+    /* With the last probe gone, the socket is closed. */
+    g_assert_cmpint(fcntl(fd, F_GETFD), ==, -1);
+    g_assert_cmpint(errno, ==, EBADF);
+
+    /* ... and created again for the next probe. */
+    data.probe_a = _probe_start(AF_INET, "127.0.0.1", NM_LOOPBACK_IFINDEX, _probe_a_cb, &data);
+    g_assert(data.probe_a);
+    nmtst_main_context_iterate_until_assert(NULL, 5000, !data.probe_a);
+    g_assert_cmpint(data.a_count, ==, 2);
+}
+
+static void
+test_ping_loopback6(void)
+{
+    gs_free char *disable_ipv6 = NULL;
+    TestData      data         = {};
+
+    if (!g_file_get_contents("/proc/sys/net/ipv6/conf/lo/disable_ipv6", &disable_ipv6, NULL, NULL)
+        || !nm_streq(g_strstrip(disable_ipv6), "0")) {
+        g_test_skip("IPv6 is not enabled on loopback");
+        return;
+    }
+
+    data.probe_a = _probe_start(AF_INET6, "::1", NM_LOOPBACK_IFINDEX, _probe_a_cb, &data);
+    if (!data.probe_a)
+        return;
+
+    data.probe_b = _probe_start(AF_INET6, "::1", IFINDEX_NONEXISTING, _probe_b_cb, &data);
+    g_assert(data.probe_b);
+    g_assert_cmpint(_nm_ping_probe_get_fd(data.probe_b), ==, _nm_ping_probe_get_fd(data.probe_a));
+
+    nmtst_main_context_iterate_until_assert(NULL, 5000, !data.probe_a);
+    g_assert_cmpint(data.a_count, ==, 1);
+
+    nm_clear_pointer(&data.probe_b, nm_ping_probe_cancel);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE();
+
+int
+main(int argc, char **argv)
+{
+    nmtst_init_with_logging(&argc, &argv, NULL, "ALL");
+
+    g_test_add_func("/ping/loopback4", test_ping_loopback4);
+    g_test_add_func("/ping/loopback6", test_ping_loopback6);
+
+    return g_test_run();
+}
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "src/core/nm-default-daemon.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "nm-rfkill-manager.h"
+
+#include "nm-test-utils-core.h"
+
+/* Indexes that no real killswitch on the test host has. */
+#define IDX_WLAN 4000
+#define IDX_WWAN 4001
+
+/*****************************************************************************/
+
+static void
+_rfkill_changed_cb(NMRfkillManager *manager, guint rtype, guint state, gpointer user_data)
+{
+    guint *n_changed = user_data;
+
+    (*n_changed)++;
+}
+
+static void
+_write_event(int fd, guint32 idx, guint8 type, guint8 op, gboolean soft, gboolean hard)
+{
+    struct rfkill_event event = {
+        .idx  = idx,
+        .type = type,
+        .op   = op,
+        .soft = soft,
+        .hard = hard,
+    };
+
+    g_assert_cmpint(write(fd, &event, sizeof(event)), ==, sizeof(event));
+}
+
+static gboolean
+_host_has_killswitches(void)
+{
+    GDir    *dir;
+    gboolean has;
+
+    dir = g_dir_open("/sys/class/rfkill", 0, NULL);
+    if (!dir)
+        return FALSE;
+    has = !!g_dir_read_name(dir);
+    g_dir_close(dir);
+    return has;
+}
+
+/*****************************************************************************/
+
+static void
+test_events(void)
+{
+    gs_unref_object NMRfkillManager *manager = NULL;
+    nm_auto_close int                fd_w    = -1;
+    int                              fds[2];
+    guint                            n_changed = 0;
+
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0)
+        g_assert_not_reached();
+    fd_w = fds[1];
+
+    /* Like the kernel, queue an ADD event for the existing killswitches. */
+    _write_event(fd_w, IDX_WLAN, KERN_RFKILL_TYPE_WLAN, KERN_RFKILL_OP_ADD, FALSE, FALSE);
+
+    manager = _nm_rfkill_manager_new_for_fd(fds[0]);
+    g_signal_connect(manager,
+                     NM_RFKILL_MANAGER_SIGNAL_RFKILL_CHANGED,
+                     G_CALLBACK(_rfkill_changed_cb),
+                     &n_changed);
+
+    /* The initial events are read synchronously. */
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WLAN),
+                    ==,
+                    NM_RFKILL_STATE_UNBLOCKED);
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WWAN),
+                    ==,
+                    NM_RFKILL_STATE_UNAVAILABLE);
+
+    _write_event(fd_w, IDX_WLAN, KERN_RFKILL_TYPE_WLAN, KERN_RFKILL_OP_CHANGE, TRUE, FALSE);
+    nmtst_main_context_iterate_until_assert(NULL, 1000, n_changed == 1);
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WLAN),
+                    ==,
+                    NM_RFKILL_STATE_SOFT_BLOCKED);
+
+    /* An event that doesn't change the state is not signaled. Neither is
+     * one for a type that we don't track. */
+    _write_event(fd_w, IDX_WLAN, KERN_RFKILL_TYPE_WLAN, KERN_RFKILL_OP_CHANGE, TRUE, FALSE);
+    _write_event(fd_w, IDX_WWAN + 1, 2, KERN_RFKILL_OP_ADD, TRUE, TRUE);
+    _write_event(fd_w, IDX_WWAN, KERN_RFKILL_TYPE_WWAN, KERN_RFKILL_OP_ADD, FALSE, TRUE);
+    nmtst_main_context_iterate_until_assert(NULL, 1000, n_changed == 2);
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WWAN),
+                    ==,
+                    NM_RFKILL_STATE_HARD_BLOCKED);
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WLAN),
+                    ==,
+                    NM_RFKILL_STATE_SOFT_BLOCKED);
+
+    _write_event(fd_w, IDX_WLAN, KERN_RFKILL_TYPE_WLAN, KERN_RFKILL_OP_DEL, FALSE, FALSE);
+    nmtst_main_context_iterate_until_assert(NULL, 1000, n_changed == 3);
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WLAN),
+                    ==,
+                    NM_RFKILL_STATE_UNAVAILABLE);
+
+    /* When reading fails, the manager falls back to udev. That re-reads the
+     * remaining killswitch from sysfs, where it doesn't exist. */
+    NMTST_EXPECT_NM_WARN("*unexpected end of file on /dev/rfkill*");
+    nm_clear_fd(&fd_w);
+    if (_host_has_killswitches()) {
+        /* The state then depends on the killswitches of the host. */
+        nmtst_main_context_iterate_until(NULL, 1000, FALSE);
+        g_test_assert_expected_messages();
+        return;
+    }
+    nmtst_main_context_iterate_until_assert(NULL, 1000, n_changed == 4);
+    g_test_assert_expected_messages();
+    g_assert_cmpint(nm_rfkill_manager_get_rfkill_state(manager, NM_RFKILL_TYPE_WWAN),
+                    ==,
+                    NM_RFKILL_STATE_UNAVAILABLE);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE();
+
+int
+main(int argc, char **argv)
+{
+    nmtst_init_assert_logging(&argc, &argv, "WARN", "DEFAULT");
+
+    g_test_add_func("/rfkill-manager/events", test_events);
+
+    return g_test_run();
+}
@@ -326,6 +326,65 @@ test_rate_limit_check(void)
 
 /*****************************************************************************/
 
+#define IDLE_BATCH_N 6
+
+typedef struct {
+    NMUtilsIdleBatch batch;
+    CList            lst[IDLE_BATCH_N];
+    guint            n_handled[IDLE_BATCH_N];
+    guint            n_rescheduled;
+} IdleBatchData;
+
+static void
+idle_batch_cb(CList *lst, gpointer user_data)
+{
+    IdleBatchData *data = user_data;
+    guint          idx  = lst - data->lst;
+
+    g_assert_cmpint(idx, <, IDLE_BATCH_N);
+    g_assert(!c_list_is_linked(lst));
+
+    data->n_handled[idx]++;
+
+    /* Use up the budget, so that every batch runs only one element. */
+    g_usleep((data->batch.budget_msec + 2) * 1000);
+
+    if (data->n_rescheduled < IDLE_BATCH_N - 1) {
+        /* queue another element while the batch runs. */
+        data->n_rescheduled++;
+        nm_utils_idle_batch_link(&data->batch, lst);
+    }
+}
+
+static void
+test_idle_batch(void)
+{
+    IdleBatchData data = {};
+    guint         i;
+
+    data.batch = (NMUtilsIdleBatch) NM_UTILS_IDLE_BATCH_INIT(data.batch, idle_batch_cb, &data, 1);
+
+    for (i = 0; i < IDLE_BATCH_N; i++) {
+        c_list_init(&data.lst[i]);
+        nm_utils_idle_batch_link(&data.batch, &data.lst[i]);
+    }
+
+    /* Dequeuing an element is just unlinking it. */
+    c_list_unlink(&data.lst[IDLE_BATCH_N - 1]);
+
+    nmtst_main_context_iterate_until_assert(NULL, 5000, !data.batch.source);
+
+    g_assert(c_list_is_empty(&data.batch.lst_head));
+    for (i = 0; i < IDLE_BATCH_N - 1; i++)
+        g_assert_cmpint(data.n_handled[i], ==, 2);
+    g_assert_cmpint(data.n_handled[IDLE_BATCH_N - 1], ==, 1);
+
+    /* No source must be left running. */
+    nmtst_main_context_assert_no_dispatch(NULL, 50);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -337,6 +396,7 @@ main(int argc, char **argv)
     g_test_add_func("/utils/hw_addr_gen_stable_eth", test_hw_addr_gen_stable_eth);
     g_test_add_func("/utils/shorten-hostname", test_shorten_hostname);
     g_test_add_func("/utils/rate-limit-check", test_rate_limit_check);
+    g_test_add_func("/utils/idle-batch", test_idle_batch);
 
     return g_test_run();
 }
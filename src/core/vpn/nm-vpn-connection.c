@@ -1935,6 +1935,69 @@ _dbus_signal_config_cb(NMVpnConnection *self, GVariant *dict)
     _check_complete(self, TRUE);
 }
 
+typedef struct {
+    guint32 route_table;
+    int     ifindex;
+} AggregateOtherRoutesData;
+
+static gboolean
+_l3cd_add_routes_other_predicate(const NMPObject *obj, gpointer user_data)
+{
+    const AggregateOtherRoutesData *data = user_data;
+
+    /* Routes on the VPN interface itself are replaced by this configuration. */
+    return obj->ip_route.ifindex != data->ifindex
+           && nm_platform_ip_route_get_effective_table(&obj->ip_route) == data->route_table;
+}
+
+static void
+_l3cd_add_routes(NMVpnConnection *self, NML3ConfigData *l3cd, int addr_family, GArray *routes)
+{
+    NMVpnConnectionPrivate *priv = NM_VPN_CONNECTION_GET_PRIVATE(self);
+    guint                   len  = routes->len;
+    guint                   i;
+
+    /* Split-tunnel setups may push thousands of adjacent prefixes. Optionally
+     * merge them into a minimal set of routes before they reach the platform. */
+    if (len > 1
+        && nm_config_data_get_value_boolean(NM_CONFIG_GET_DATA,
+                                            NM_CONFIG_KEYFILE_GROUP_MAIN,
+                                            NM_CONFIG_KEYFILE_KEY_MAIN_VPN_ROUTE_AGGREGATION,
+                                            FALSE)) {
+        gs_unref_ptrarray GPtrArray *other_routes = NULL;
+        AggregateOtherRoutesData     data;
+        NMPLookup                    lookup;
+
+        /* The merged routes compete with the other routes in the same table,
+         * so these must be taken into account. */
+        data = (AggregateOtherRoutesData) {
+            .route_table = get_route_table(self, addr_family, TRUE),
+            .ifindex     = nm_l3_config_data_get_ifindex(l3cd),
+        };
+        other_routes = nm_platform_lookup_clone(
+            nm_netns_get_platform(priv->netns),
+            nmp_lookup_init_obj_type(&lookup, NMP_OBJECT_TYPE_IP_ROUTE(NM_IS_IPv4(addr_family))),
+            _l3cd_add_routes_other_predicate,
+            &data);
+
+        len = nm_platform_ip_route_aggregate(addr_family,
+                                             nm_g_array_index_p(routes, NMPlatformIPXRoute, 0),
+                                             routes->len,
+                                             other_routes);
+        _LOGD("aggregated %u IPv%c routes from the VPN plugin to %u",
+              routes->len,
+              nm_utils_addr_family_to_char(addr_family),
+              len);
+    }
+
+    for (i = 0; i < len; i++) {
+        nm_l3_config_data_add_route(l3cd,
+                                    addr_family,
+                                    NULL,
+                                    &nm_g_array_index(routes, NMPlatformIPXRoute, i).rx);
+    }
+}
+
 static void
 _dbus_signal_ip_config_cb(NMVpnConnection *self, int addr_family, GVariant *dict)
 {
@@ -2141,9 +2204,12 @@ _dbus_signal_ip_config_cb(NMVpnConnection *self, int addr_family, GVariant *dict
     } else if (IS_IPv4) {
         if (g_variant_lookup(dict, NM_VPN_PLUGIN_IP4_CONFIG_ROUTES, "aau", &var_iter)) {
             _nm_unused nm_auto_free_variant_iter GVariantIter *var_iter_ref_owner = var_iter;
+            gs_unref_array GArray                             *routes             = NULL;
             NMPlatformIPXRoute                                 route              = {};
             guint32                                            plen;
 
+            routes = g_array_new(FALSE, FALSE, sizeof(NMPlatformIPXRoute));
+
             while (g_variant_iter_next(var_iter, "@au", &v)) {
                 _nm_unused gs_unref_variant GVariant *v_ref_owner = v;
 
@@ -2176,15 +2242,18 @@ _dbus_signal_ip_config_cb(NMVpnConnection *self, int addr_family, GVariant *dict
                         break;
                     }
 
-                    nm_l3_config_data_add_route_4(l3cd, &route.r4);
+                    g_array_append_val(routes, route);
                     break;
                 default:
                     break;
                 }
             }
+
+            _l3cd_add_routes(self, l3cd, AF_INET, routes);
         }
     } else {
         _nm_unused nm_auto_free_variant_iter GVariantIter *var_iter_ref_owner = NULL;
+        gs_unref_array GArray                             *routes             = NULL;
         NMPlatformIPXRoute                                 route              = {};
         guint32                                            prefix;
         guint32                                            metric;
@@ -2201,6 +2270,8 @@ _dbus_signal_ip_config_cb(NMVpnConnection *self, int addr_family, GVariant *dict
 
         var_iter_ref_owner = var_iter;
 
+        routes = g_array_new(FALSE, FALSE, sizeof(NMPlatformIPXRoute));
+
         while (TRUE) {
             gs_unref_variant GVariant *next_hop = NULL;
             gs_unref_variant GVariant *dest     = NULL;
@@ -2259,8 +2330,10 @@ _dbus_signal_ip_config_cb(NMVpnConnection *self, int addr_family, GVariant *dict
                 continue;
             }
 
-            nm_l3_config_data_add_route_6(l3cd, &route.r6);
+            g_array_append_val(routes, route);
         }
+
+        _l3cd_add_routes(self, l3cd, AF_INET6, routes);
     }
 
     if (g_variant_lookup(dict,
@@ -2579,31 +2652,33 @@ _get_log_level(void)
     return LOG_EMERG;
 }
 
-static gboolean
-nm_vpn_service_daemon_exec(NMVpnConnection *self, GError **error)
-{
-    NMVpnConnectionPrivate *priv;
-    GPid                    pid;
-    char                   *vpn_argv[4];
-    gs_free char          **envp = NULL;
-    char                    env_log_level[NM_STRLEN("NM_VPN_LOG_LEVEL=") + 100];
-    char                    env_log_syslog[NM_STRLEN("NM_VPN_LOG_SYSLOG=") + 10];
-    const gsize             N_ENVIRON_EXTRA = 3;
-    char                  **p_environ;
-    gsize                   n_environ;
-    gsize                   i;
-    gsize                   j;
-
-    g_return_val_if_fail(NM_IS_VPN_CONNECTION(self), FALSE);
-
-    priv = NM_VPN_CONNECTION_GET_PRIVATE(self);
+gboolean
+nm_vpn_service_daemon_exec(NMVpnPluginInfo *plugin_info,
+                           const char      *bus_name,
+                           gboolean         standby,
+                           GPid            *out_pid,
+                           GError         **error)
+{
+    GPid           pid;
+    char          *vpn_argv[4];
+    gs_free char **envp = NULL;
+    char           env_log_level[NM_STRLEN("NM_VPN_LOG_LEVEL=") + 100];
+    char           env_log_syslog[NM_STRLEN("NM_VPN_LOG_SYSLOG=") + 10];
+    const gsize    N_ENVIRON_EXTRA = 4;
+    char         **p_environ;
+    gsize          n_environ;
+    gsize          i;
+    gsize          j;
+
+    g_return_val_if_fail(NM_IS_VPN_PLUGIN_INFO(plugin_info), FALSE);
+    g_return_val_if_fail(bus_name, FALSE);
 
     i             = 0;
-    vpn_argv[i++] = (char *) nm_vpn_plugin_info_get_program(priv->plugin_info);
+    vpn_argv[i++] = (char *) nm_vpn_plugin_info_get_program(plugin_info);
     g_return_val_if_fail(vpn_argv[0], FALSE);
-    if (nm_vpn_plugin_info_supports_multiple(priv->plugin_info)) {
+    if (nm_vpn_plugin_info_supports_multiple(plugin_info)) {
         vpn_argv[i++] = "--bus-name";
-        vpn_argv[i++] = priv->dbus.bus_name;
+        vpn_argv[i++] = (char *) bus_name;
     }
     vpn_argv[i++] = NULL;
 
@@ -2613,7 +2688,8 @@ nm_vpn_service_daemon_exec(NMVpnConnection *self, GError **error)
     envp      = g_new(char *, n_environ + N_ENVIRON_EXTRA);
     for (i = 0, j = 0; j < n_environ; j++) {
         if (NM_STR_HAS_PREFIX(p_environ[j], "NM_VPN_LOG_LEVEL=")
-            || NM_STR_HAS_PREFIX(p_environ[j], "NM_VPN_LOG_SYSLOG="))
+            || NM_STR_HAS_PREFIX(p_environ[j], "NM_VPN_LOG_SYSLOG=")
+            || NM_STR_HAS_PREFIX(p_environ[j], "NM_VPN_STANDBY="))
             continue;
         envp[i++] = p_environ[j];
     }
@@ -2629,13 +2705,26 @@ nm_vpn_service_daemon_exec(NMVpnConnection *self, GError **error)
                                "NM_VPN_LOG_SYSLOG=%c",
                                nm_logging_syslog_enabled() ? '1' : '0');
 
+    /* NM_VPN_STANDBY: the service is kept running in standby and should not
+     * quit when it is idle. */
+    if (standby)
+        envp[i++] = "NM_VPN_STANDBY=1";
+
     envp[i++] = NULL;
     nm_assert(i <= n_environ + N_ENVIRON_EXTRA);
 
-    if (!g_spawn_async(NULL, vpn_argv, envp, 0, nm_utils_setpgid, NULL, &pid, error))
+    /* The caller is responsible to reap the child. */
+    if (!g_spawn_async(NULL,
+                       vpn_argv,
+                       envp,
+                       G_SPAWN_DO_NOT_REAP_CHILD,
+                       nm_utils_setpgid,
+                       NULL,
+                       &pid,
+                       error))
         return FALSE;
 
-    _LOGD("starting: VPN service has PID %lld", (long long) pid);
+    NM_SET_OUT(out_pid, pid);
     return TRUE;
 }
 
@@ -2720,16 +2809,22 @@ _name_owner_changed(NMVpnConnection *self, const char *owner, gboolean initializ
 
     if (!owner && initializing) {
         gs_free_error GError *error = NULL;
+        GPid                  pid;
 
         nm_assert(!priv->dbus.owner);
         _LOGT("dbus: no name owner for %s (start VPN service)", priv->dbus.bus_name);
 
-        if (!nm_vpn_service_daemon_exec(self, &error)) {
+        if (!nm_vpn_manager_service_spawn(nm_vpn_manager_get(),
+                                          priv->plugin_info,
+                                          priv->dbus.bus_name,
+                                          &pid,
+                                          &error)) {
             _LOGW("starting: failure to start VPN service: %s", error->message);
             nm_vpn_connection_disconnect(self,
                                          NM_ACTIVE_CONNECTION_STATE_REASON_SERVICE_START_FAILED,
                                          FALSE);
-        }
+        } else
+            _LOGD("starting: VPN service has PID %lld", (long long) pid);
         priv->start_timeout_source = nm_g_timeout_add_seconds_source(5, _start_timeout_cb, self);
         return;
     }
@@ -63,4 +63,10 @@ struct in6_addr *nm_vpn_connection_get_ip6_internal_gateway(NMVpnConnection *sel
 
 guint32 nm_vpn_connection_get_ip_route_metric(NMVpnConnection *self, int addr_family);
 
+gboolean nm_vpn_service_daemon_exec(NMVpnPluginInfo *plugin_info,
+                                    const char      *bus_name,
+                                    gboolean         standby,
+                                    GPid            *out_pid,
+                                    GError         **error);
+
 #endif /* __NM_VPN_CONNECTION_H__ */
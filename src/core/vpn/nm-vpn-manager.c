@@ -8,22 +8,44 @@
 
 #include "nm-vpn-manager.h"
 
+#include <sys/wait.h>
+#include <signal.h>
+
+#include "NetworkManagerUtils.h"
 #include "nm-vpn-plugin-info.h"
 #include "nm-vpn-connection.h"
 #include "nm-setting-vpn.h"
 #include "nm-vpn-dbus-interface.h"
+#include "nm-config.h"
+#include "nm-dbus-manager.h"
 #include "libnm-core-intern/nm-core-internal.h"
+#include "libnm-glib-aux/nm-dbus-aux.h"
+
+/* Don't restart a standby service more often than this. A plugin that
+ * crashes right away should not keep us busy. */
+#define STANDBY_RESPAWN_MIN_MSEC 10000
 
 typedef struct {
-    GSList       *plugins;
-    GFileMonitor *monitor_etc;
-    GFileMonitor *monitor_lib;
-    gulong        monitor_id_etc;
-    gulong        monitor_id_lib;
+    GSList          *plugins;
+    GFileMonitor    *monitor_etc;
+    GFileMonitor    *monitor_lib;
+    NMConfig        *config;
+    GDBusConnection *dbus_connection;
+    gulong           monitor_id_etc;
+    gulong           monitor_id_lib;
 
     /* This is only used for services that don't support multiple
      * connections, to guard access to them. */
     GHashTable *active_services;
+
+    /* The services that are kept running in standby, so that activating
+     * a connection does not need to wait for the plugin to start. Maps the
+     * service name to a StandbyService. */
+    GHashTable *standby_services;
+
+    /* The plugin processes that we started and that did not exit yet. Maps
+     * the bus name to a ServiceProcess. */
+    GHashTable *service_processes;
 } NMVpnManagerPrivate;
 
 struct _NMVpnManager {
@@ -41,6 +63,395 @@ G_DEFINE_TYPE(NMVpnManager, nm_vpn_manager, G_TYPE_OBJECT)
 
 /*****************************************************************************/
 
+typedef struct {
+    NMVpnManager *self;
+    char         *bus_name;
+    GSource      *child_watch_source;
+    GPid          pid;
+
+    /* The process was started with NM_VPN_STANDBY=1, so it never quits on
+     * its own. We must terminate it once it is no longer needed. */
+    bool standby : 1;
+    bool stopping : 1;
+} ServiceProcess;
+
+typedef struct {
+    NMVpnManager    *self;
+    NMVpnPluginInfo *plugin_info;
+    GCancellable    *cancellable;
+    GSource         *respawn_source;
+    gint64           spawned_at_msec;
+    guint            name_owner_changed_id;
+    bool             name_owner_initialized : 1;
+    bool             has_name_owner : 1;
+
+    /* The service exited successfully on its own, most likely because it was
+     * idle and does not support staying in standby. Don't restart it. */
+    bool idle_exited : 1;
+} StandbyService;
+
+static void _standby_service_check(StandbyService *standby);
+
+/*****************************************************************************/
+
+static void
+_service_process_free(gpointer data)
+{
+    ServiceProcess *process = data;
+
+    nm_clear_g_source_inst(&process->child_watch_source);
+    g_free(process->bus_name);
+    nm_g_slice_free(process);
+}
+
+static void
+_service_process_stop(ServiceProcess *process)
+{
+    if (process->stopping)
+        return;
+
+    nm_log_dbg(LOGD_VPN,
+               "vpn: stop service %s with PID %lld",
+               process->bus_name,
+               (long long) process->pid);
+
+    /* The child watch reaps the process. */
+    process->stopping = TRUE;
+    kill(process->pid, SIGTERM);
+}
+
+static void
+_service_process_child_watch_cb(GPid pid, int status, gpointer user_data)
+{
+    ServiceProcess      *process = user_data;
+    NMVpnManagerPrivate *priv    = NM_VPN_MANAGER_GET_PRIVATE(process->self);
+    StandbyService      *standby;
+    gboolean             success;
+
+    success = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    nm_log_dbg(LOGD_VPN,
+               "vpn: service %s with PID %lld %s",
+               process->bus_name,
+               (long long) pid,
+               success ? "exited" : "failed");
+
+    standby = g_hash_table_lookup(priv->standby_services, process->bus_name);
+
+    /* Frees @process. */
+    g_hash_table_remove(priv->service_processes, process->bus_name);
+
+    if (standby) {
+        standby->idle_exited = success;
+        _standby_service_check(standby);
+    }
+}
+
+/**
+ * nm_vpn_manager_service_spawn:
+ * @self: the #NMVpnManager
+ * @plugin_info: the plugin to start
+ * @bus_name: the D-Bus name the service is expected to acquire
+ * @out_pid: (out) (optional): the PID of the service process
+ * @error: location to store error, or %NULL
+ *
+ * Starts the VPN service process, unless a process for @bus_name that we
+ * started earlier is still running. In that case, the caller should wait
+ * for that process to acquire the bus name.
+ *
+ * Returns: %TRUE if the service was started or is already starting.
+ */
+gboolean
+nm_vpn_manager_service_spawn(NMVpnManager    *self,
+                             NMVpnPluginInfo *plugin_info,
+                             const char      *bus_name,
+                             GPid            *out_pid,
+                             GError         **error)
+{
+    NMVpnManagerPrivate *priv;
+    ServiceProcess      *process;
+    StandbyService      *standby;
+    GPid                 pid;
+
+    g_return_val_if_fail(NM_IS_VPN_MANAGER(self), FALSE);
+    g_return_val_if_fail(NM_IS_VPN_PLUGIN_INFO(plugin_info), FALSE);
+    g_return_val_if_fail(bus_name, FALSE);
+
+    priv = NM_VPN_MANAGER_GET_PRIVATE(self);
+
+    process = g_hash_table_lookup(priv->service_processes, bus_name);
+    if (process) {
+        NM_SET_OUT(out_pid, process->pid);
+        return TRUE;
+    }
+
+    standby = g_hash_table_lookup(priv->standby_services, bus_name);
+    if (standby) {
+        standby->spawned_at_msec = nm_utils_get_monotonic_timestamp_msec();
+        standby->idle_exited     = FALSE;
+    }
+
+    if (!nm_vpn_service_daemon_exec(plugin_info, bus_name, !!standby, &pid, error))
+        return FALSE;
+
+    process  = g_slice_new(ServiceProcess);
+    *process = (ServiceProcess) {
+        .self     = self,
+        .bus_name = g_strdup(bus_name),
+        .pid      = pid,
+        .standby  = !!standby,
+    };
+    process->child_watch_source =
+        nm_g_child_watch_add_source(pid, _service_process_child_watch_cb, process);
+    g_hash_table_insert(priv->service_processes, process->bus_name, process);
+
+    NM_SET_OUT(out_pid, pid);
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+static const char *
+_standby_service_get_name(StandbyService *standby)
+{
+    return nm_vpn_plugin_info_get_service(standby->plugin_info);
+}
+
+static void
+_standby_service_spawn(StandbyService *standby)
+{
+    gs_free_error GError *error = NULL;
+    GPid                  pid;
+
+    if (!nm_vpn_manager_service_spawn(standby->self,
+                                      standby->plugin_info,
+                                      _standby_service_get_name(standby),
+                                      &pid,
+                                      &error)) {
+        nm_log_warn(LOGD_VPN,
+                    "vpn: failed to start standby service %s: %s",
+                    _standby_service_get_name(standby),
+                    error->message);
+        return;
+    }
+
+    nm_log_dbg(LOGD_VPN,
+               "vpn: started standby service %s with PID %lld",
+               _standby_service_get_name(standby),
+               (long long) pid);
+}
+
+static gboolean
+_standby_service_respawn_cb(gpointer user_data)
+{
+    StandbyService *standby = user_data;
+
+    nm_clear_g_source_inst(&standby->respawn_source);
+    _standby_service_check(standby);
+    return G_SOURCE_CONTINUE;
+}
+
+static void
+_standby_service_check(StandbyService *standby)
+{
+    NMVpnManagerPrivate *priv = NM_VPN_MANAGER_GET_PRIVATE(standby->self);
+    gint64               now_msec;
+
+    if (!standby->name_owner_initialized || standby->has_name_owner || standby->respawn_source
+        || standby->idle_exited)
+        return;
+
+    /* While a connection uses the service, the connection takes care of it. */
+    if (g_hash_table_contains(priv->active_services, _standby_service_get_name(standby)))
+        return;
+
+    /* A process we started is still starting up or shutting down. We check
+     * again once it exits. */
+    if (g_hash_table_contains(priv->service_processes, _standby_service_get_name(standby)))
+        return;
+
+    now_msec = nm_utils_get_monotonic_timestamp_msec();
+    if (standby->spawned_at_msec != 0
+        && now_msec < standby->spawned_at_msec + STANDBY_RESPAWN_MIN_MSEC) {
+        standby->respawn_source =
+            nm_g_timeout_add_source(standby->spawned_at_msec + STANDBY_RESPAWN_MIN_MSEC - now_msec,
+                                    _standby_service_respawn_cb,
+                                    standby);
+        return;
+    }
+
+    _standby_service_spawn(standby);
+}
+
+static void
+_standby_service_set_name_owner(StandbyService *standby, const char *name_owner)
+{
+    standby->name_owner_initialized = TRUE;
+    standby->has_name_owner         = !!nm_str_not_empty(name_owner);
+
+    nm_log_trace(LOGD_VPN,
+                 "vpn: standby service %s %s",
+                 _standby_service_get_name(standby),
+                 standby->has_name_owner ? "is running" : "is not running");
+
+    _standby_service_check(standby);
+}
+
+static void
+_standby_service_name_owner_changed_cb(GDBusConnection *connection,
+                                       const char      *sender_name,
+                                       const char      *object_path,
+                                       const char      *interface_name,
+                                       const char      *signal_name,
+                                       GVariant        *parameters,
+                                       gpointer         user_data)
+{
+    StandbyService *standby = user_data;
+    const char     *new_owner;
+
+    if (!standby->name_owner_initialized)
+        return;
+
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(sss)")))
+        return;
+
+    g_variant_get(parameters, "(&s&s&s)", NULL, NULL, &new_owner);
+
+    _standby_service_set_name_owner(standby, new_owner);
+}
+
+static void
+_standby_service_name_owner_get_cb(const char *name_owner, GError *error, gpointer user_data)
+{
+    StandbyService *standby;
+
+    if (nm_utils_error_is_cancelled(error))
+        return;
+
+    standby = user_data;
+    _standby_service_set_name_owner(standby, name_owner);
+}
+
+static StandbyService *
+_standby_service_new(NMVpnManager *self, NMVpnPluginInfo *plugin_info)
+{
+    NMVpnManagerPrivate *priv = NM_VPN_MANAGER_GET_PRIVATE(self);
+    StandbyService      *standby;
+
+    standby  = g_slice_new(StandbyService);
+    *standby = (StandbyService) {
+        .self        = self,
+        .plugin_info = g_object_ref(plugin_info),
+        .cancellable = g_cancellable_new(),
+    };
+
+    standby->name_owner_changed_id =
+        nm_dbus_connection_signal_subscribe_name_owner_changed(priv->dbus_connection,
+                                                               _standby_service_get_name(standby),
+                                                               _standby_service_name_owner_changed_cb,
+                                                               standby,
+                                                               NULL);
+
+    nm_dbus_connection_call_get_name_owner(priv->dbus_connection,
+                                           _standby_service_get_name(standby),
+                                           -1,
+                                           standby->cancellable,
+                                           _standby_service_name_owner_get_cb,
+                                           standby);
+    return standby;
+}
+
+static void
+_standby_service_free(gpointer data)
+{
+    StandbyService      *standby = data;
+    NMVpnManagerPrivate *priv    = NM_VPN_MANAGER_GET_PRIVATE(standby->self);
+    ServiceProcess      *process;
+
+    nm_log_dbg(LOGD_VPN, "vpn: stop keeping service %s in standby", _standby_service_get_name(standby));
+
+    nm_clear_g_dbus_connection_signal(priv->dbus_connection, &standby->name_owner_changed_id);
+    nm_clear_g_cancellable(&standby->cancellable);
+    nm_clear_g_source_inst(&standby->respawn_source);
+
+    /* A process that we started for standby doesn't quit when idle. Stop
+     * it, unless a connection still uses it. In that case, we stop it once
+     * the connection is gone. */
+    process = g_hash_table_lookup(priv->service_processes, _standby_service_get_name(standby));
+    if (process && process->standby
+        && !g_hash_table_contains(priv->active_services, _standby_service_get_name(standby)))
+        _service_process_stop(process);
+
+    g_object_unref(standby->plugin_info);
+    nm_g_slice_free(standby);
+}
+
+static void
+_standby_services_update(NMVpnManager *self)
+{
+    NMVpnManagerPrivate           *priv   = NM_VPN_MANAGER_GET_PRIVATE(self);
+    gs_unref_hashtable GHashTable *wanted = NULL;
+    gs_free char                  *value  = NULL;
+    gs_free const char           **strv   = NULL;
+    GHashTableIter                 iter;
+    StandbyService                *standby;
+    const char                    *service;
+    NMVpnPluginInfo               *plugin_info;
+    gsize                          i;
+
+    if (!priv->dbus_connection)
+        return;
+
+    value = nm_config_data_get_value(nm_config_get_data(priv->config),
+                                     NM_CONFIG_KEYFILE_GROUP_MAIN,
+                                     NM_CONFIG_KEYFILE_KEY_MAIN_VPN_STANDBY_SERVICES,
+                                     NM_CONFIG_GET_VALUE_STRIP | NM_CONFIG_GET_VALUE_NO_EMPTY);
+    strv  = nm_strsplit_set(value, ",; \t\n");
+
+    wanted = g_hash_table_new(nm_str_hash, g_str_equal);
+    for (i = 0; strv && strv[i]; i++) {
+        plugin_info = nm_vpn_plugin_info_list_find_by_service(priv->plugins, strv[i]);
+        if (!plugin_info)
+            plugin_info = nm_vpn_plugin_info_list_find_by_name(priv->plugins, strv[i]);
+        if (!plugin_info) {
+            nm_log_dbg(LOGD_VPN, "vpn: standby service %s is not installed", strv[i]);
+            continue;
+        }
+
+        if (nm_vpn_plugin_info_supports_multiple(plugin_info)) {
+            /* Such plugins are started with a bus name that is specific to
+             * the active connection. They cannot be started ahead of time. */
+            nm_log_dbg(LOGD_VPN,
+                       "vpn: standby is not supported for service %s which supports "
+                       "multiple connections",
+                       nm_vpn_plugin_info_get_service(plugin_info));
+            continue;
+        }
+
+        g_hash_table_insert(wanted,
+                            (gpointer) nm_vpn_plugin_info_get_service(plugin_info),
+                            plugin_info);
+    }
+
+    g_hash_table_iter_init(&iter, priv->standby_services);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &standby)) {
+        if (g_hash_table_lookup(wanted, _standby_service_get_name(standby)) != standby->plugin_info)
+            g_hash_table_iter_remove(&iter);
+    }
+
+    g_hash_table_iter_init(&iter, wanted);
+    while (g_hash_table_iter_next(&iter, (gpointer *) &service, (gpointer *) &plugin_info)) {
+        if (g_hash_table_contains(priv->standby_services, service))
+            continue;
+
+        nm_log_dbg(LOGD_VPN, "vpn: keep service %s in standby", service);
+        standby = _standby_service_new(self, plugin_info);
+        g_hash_table_insert(priv->standby_services,
+                            (gpointer) _standby_service_get_name(standby),
+                            standby);
+    }
+}
+
 static void
 vpn_state_changed(NMVpnConnection *vpn, GParamSpec *pspec, NMVpnManager *manager)
 {
@@ -49,7 +460,22 @@ vpn_state_changed(NMVpnConnection *vpn, GParamSpec *pspec, NMVpnManager *manager
     const char             *service_name = nm_vpn_connection_get_service(vpn);
 
     if (state == NM_ACTIVE_CONNECTION_STATE_DEACTIVATED) {
+        StandbyService *standby;
+        ServiceProcess *process;
+
         g_hash_table_remove(priv->active_services, service_name);
+
+        standby = g_hash_table_lookup(priv->standby_services, service_name);
+        if (standby)
+            _standby_service_check(standby);
+        else {
+            /* The service was started for standby, but meanwhile it was
+             * removed from the standby list. */
+            process = g_hash_table_lookup(priv->service_processes, service_name);
+            if (process && process->standby)
+                _service_process_stop(process);
+        }
+
         g_signal_handlers_disconnect_by_func(vpn, vpn_state_changed, manager);
         g_object_unref(manager);
     }
@@ -191,6 +617,7 @@ vpn_dir_changed(GFileMonitor     *monitor,
 
         nm_log_dbg(LOGD_VPN, "vpn: service file %s deleted", path);
         nm_vpn_plugin_info_list_remove(&priv->plugins, plugin_info);
+        _standby_services_update(self);
         break;
     case G_FILE_MONITOR_EVENT_CREATED:
     case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
@@ -221,6 +648,7 @@ vpn_dir_changed(GFileMonitor     *monitor,
         nm_log_dbg(LOGD_VPN, "vpn: service file %s created or modified", path);
         try_add_plugin(self, plugin_info);
         g_object_unref(plugin_info);
+        _standby_services_update(self);
         break;
     default:
         nm_log_dbg(LOGD_VPN, "vpn: service file %s change event %d", path, event_type);
@@ -228,6 +656,17 @@ vpn_dir_changed(GFileMonitor     *monitor,
     }
 }
 
+static void
+config_changed_cb(NMConfig           *config,
+                  NMConfigData       *config_data,
+                  NMConfigChangeFlags changes,
+                  NMConfigData       *old_data,
+                  NMVpnManager       *self)
+{
+    if (NM_FLAGS_HAS(changes, NM_CONFIG_CHANGE_VALUES))
+        _standby_services_update(self);
+}
+
 /*****************************************************************************/
 
 NM_DEFINE_SINGLETON_GETTER(NMVpnManager, nm_vpn_manager_get, NM_TYPE_VPN_MANAGER);
@@ -273,12 +712,26 @@ nm_vpn_manager_init(NMVpnManager *self)
     g_slist_free_full(infos, g_object_unref);
 
     priv->active_services = g_hash_table_new_full(nm_str_hash, g_str_equal, g_free, NULL);
+
+    priv->standby_services =
+        g_hash_table_new_full(nm_str_hash, g_str_equal, NULL, _standby_service_free);
+    priv->service_processes =
+        g_hash_table_new_full(nm_str_hash, g_str_equal, NULL, _service_process_free);
+    priv->dbus_connection = nm_g_object_ref(NM_MAIN_DBUS_CONNECTION_GET);
+    priv->config          = g_object_ref(nm_config_get());
+    g_signal_connect(priv->config,
+                     NM_CONFIG_SIGNAL_CONFIG_CHANGED,
+                     G_CALLBACK(config_changed_cb),
+                     self);
+    _standby_services_update(self);
 }
 
 static void
 dispose(GObject *object)
 {
     NMVpnManagerPrivate *priv = NM_VPN_MANAGER_GET_PRIVATE(object);
+    GHashTableIter       iter;
+    ServiceProcess      *process;
 
     if (priv->monitor_etc) {
         if (priv->monitor_id_etc)
@@ -294,6 +747,34 @@ dispose(GObject *object)
         g_clear_object(&priv->monitor_lib);
     }
 
+    if (priv->config) {
+        g_signal_handlers_disconnect_by_func(priv->config, config_changed_cb, object);
+        g_clear_object(&priv->config);
+    }
+
+    nm_clear_pointer(&priv->standby_services, g_hash_table_unref);
+
+    if (priv->service_processes) {
+        /* Standby processes don't quit on their own. As nobody is left to
+         * watch them, hand them over to nm_utils_kill_child_async(), which
+         * also reaps them and kills them for good if they don't exit. */
+        g_hash_table_iter_init(&iter, priv->service_processes);
+        while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &process)) {
+            if (!process->standby)
+                continue;
+            nm_clear_g_source_inst(&process->child_watch_source);
+            nm_utils_kill_child_async(process->pid,
+                                      SIGTERM,
+                                      LOGD_VPN,
+                                      process->bus_name,
+                                      2000,
+                                      NULL,
+                                      NULL);
+        }
+        nm_clear_pointer(&priv->service_processes, g_hash_table_unref);
+    }
+    g_clear_object(&priv->dbus_connection);
+
     while (priv->plugins)
         nm_vpn_plugin_info_list_remove(&priv->plugins, priv->plugins->data);
 
@@ -29,4 +29,10 @@ NMVpnManager *nm_vpn_manager_get(void);
 gboolean
 nm_vpn_manager_activate_connection(NMVpnManager *manager, NMVpnConnection *vpn, GError **error);
 
+gboolean nm_vpn_manager_service_spawn(NMVpnManager    *self,
+                                      NMVpnPluginInfo *plugin_info,
+                                      const char      *bus_name,
+                                      GPid            *out_pid,
+                                      GError         **error);
+
 #endif /* __NM_VPN_MANAGER_H__ */
@@ -36,6 +36,8 @@
 #define NM_CONFIG_KEYFILE_KEY_MAIN_PLUGINS                     "plugins"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_RC_MANAGER                  "rc-manager"
 #define NM_CONFIG_KEYFILE_KEY_MAIN_SYSTEMD_RESOLVED            "systemd-resolved"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_VPN_ROUTE_AGGREGATION       "vpn-route-aggregation"
+#define NM_CONFIG_KEYFILE_KEY_MAIN_VPN_STANDBY_SERVICES        "vpn-standby-services"
 
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_AUDIT   "audit"
 #define NM_CONFIG_KEYFILE_KEY_LOGGING_BACKEND "backend"
@@ -63,14 +65,15 @@
 #define NM_CONFIG_KEYFILE_KEY_GLOBAL_DNS_DOMAIN_SERVERS "servers"
 #define NM_CONFIG_KEYFILE_KEY_GLOBAL_DNS_DOMAIN_OPTIONS "options"
 
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_MANAGED                    "managed"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_IGNORE_CARRIER             "ignore-carrier"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_CHECK_CONNECTIVITY         "check-connectivity"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_SRIOV_NUM_VFS              "sriov-num-vfs"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION         "keep-configuration"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_ALLOWED_CONNECTIONS        "allowed-connections"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_BACKEND               "wifi.backend"
-#define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_RAND_MAC_ADDRESS "wifi.scan-rand-mac-address"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_MANAGED                     "managed"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_IGNORE_CARRIER              "ignore-carrier"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_CHECK_CONNECTIVITY          "check-connectivity"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_SRIOV_NUM_VFS               "sriov-num-vfs"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION          "keep-configuration"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_KEEP_CONFIGURATION_ON_SLEEP "keep-configuration-on-sleep"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_ALLOWED_CONNECTIONS         "allowed-connections"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_BACKEND                "wifi.backend"
+#define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_RAND_MAC_ADDRESS  "wifi.scan-rand-mac-address"
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_SCAN_GENERATE_MAC_ADDRESS_MASK \
     "wifi.scan-generate-mac-address-mask"
 #define NM_CONFIG_KEYFILE_KEY_DEVICE_CARRIER_WAIT_TIMEOUT "carrier-wait-timeout"
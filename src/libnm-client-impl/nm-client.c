@@ -288,6 +288,7 @@ typedef struct {
     guint dbsid_nm_object_manager;
     guint dbsid_dbus_properties_properties_changed;
     guint dbsid_nm_settings_connection_updated;
+    guint dbsid_nm_settings_connection_updated_settings;
     guint dbsid_nm_connection_active_state_changed;
     guint dbsid_nm_vpn_connection_state_changed;
     guint dbsid_nm_check_permissions;
@@ -3415,11 +3416,61 @@ _dbus_settings_updated_cb(GDBusConnection *connection,
         return;
     }
 
+    if (_nm_remote_settings_updated_consume(NM_REMOTE_CONNECTION(dbobj->nmobj))) {
+        NML_NMCLIENT_LOG_T(self,
+                           "%s: [%s] Updated signal received (settings already received)",
+                           log_context,
+                           object_path);
+        return;
+    }
+
     NML_NMCLIENT_LOG_T(self, "%s: [%s] Updated signal received", log_context, object_path);
 
     _nm_client_get_settings_call(self, dbobj);
 }
 
+static void
+_dbus_settings_updated_settings_cb(GDBusConnection *connection,
+                                   const char      *sender_name,
+                                   const char      *object_path,
+                                   const char      *signal_interface_name,
+                                   const char      *signal_name,
+                                   GVariant        *parameters,
+                                   gpointer         user_data)
+{
+    NMClient                  *self        = user_data;
+    NMClientPrivate           *priv        = NM_CLIENT_GET_PRIVATE(self);
+    const char                *log_context = "settings-updated-settings";
+    gs_unref_variant GVariant *settings    = NULL;
+    NMLDBusObject             *dbobj;
+
+    if (priv->get_managed_objects_cancellable) {
+        /* we still wait for the initial GetManagedObjects(). Ignore the event. */
+        return;
+    }
+
+    if (!g_variant_is_of_type(parameters, G_VARIANT_TYPE("(a{sa{sv}})")))
+        return;
+
+    dbobj = _dbobjs_dbobj_get_s(self, object_path);
+
+    if (!dbobj || !NM_IS_REMOTE_CONNECTION(dbobj->nmobj)) {
+        NML_NMCLIENT_LOG_W(self,
+                           "%s: [%s] ignore UpdatedSettings signal for non-existing setting",
+                           log_context,
+                           object_path);
+        return;
+    }
+
+    NML_NMCLIENT_LOG_T(self, "%s: [%s] UpdatedSettings signal received", log_context, object_path);
+
+    g_variant_get(parameters, "(@a{sa{sv}})", &settings);
+
+    _nm_remote_settings_updated_settings_commit(NM_REMOTE_CONNECTION(dbobj->nmobj), settings);
+
+    _dbus_handle_changes_commit(self, TRUE);
+}
+
 /*****************************************************************************/
 
 static void
@@ -6985,6 +7036,18 @@ _init_fetch_all(NMClient *self)
                                            self,
                                            NULL);
 
+    priv->dbsid_nm_settings_connection_updated_settings =
+        g_dbus_connection_signal_subscribe(priv->dbus_connection,
+                                           priv->name_owner,
+                                           NM_DBUS_INTERFACE_SETTINGS_CONNECTION,
+                                           "UpdatedSettings",
+                                           NULL,
+                                           NULL,
+                                           G_DBUS_SIGNAL_FLAGS_NONE,
+                                           _dbus_settings_updated_settings_cb,
+                                           self,
+                                           NULL);
+
     priv->dbsid_nm_connection_active_state_changed =
         g_dbus_connection_signal_subscribe(priv->dbus_connection,
                                            priv->name_owner,
@@ -7056,6 +7119,8 @@ _init_release_all(NMClient *self)
                                       &priv->dbsid_dbus_properties_properties_changed);
     nm_clear_g_dbus_connection_signal(priv->dbus_connection,
                                       &priv->dbsid_nm_settings_connection_updated);
+    nm_clear_g_dbus_connection_signal(priv->dbus_connection,
+                                      &priv->dbsid_nm_settings_connection_updated_settings);
     nm_clear_g_dbus_connection_signal(priv->dbus_connection,
                                       &priv->dbsid_nm_connection_active_state_changed);
     nm_clear_g_dbus_connection_signal(priv->dbus_connection,
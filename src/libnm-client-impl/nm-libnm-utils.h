@@ -1046,6 +1046,10 @@ GCancellable *_nm_remote_settings_get_settings_prepare(NMRemoteConnection *self)
 
 void _nm_remote_settings_get_settings_commit(NMRemoteConnection *self, GVariant *settings);
 
+void _nm_remote_settings_updated_settings_commit(NMRemoteConnection *self, GVariant *settings);
+
+gboolean _nm_remote_settings_updated_consume(NMRemoteConnection *self);
+
 /*****************************************************************************/
 
 void
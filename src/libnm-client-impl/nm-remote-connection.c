@@ -44,6 +44,10 @@ typedef struct {
 
     bool visible : 1;
     bool is_initialized : 1;
+
+    /* Whether the settings were already received via the "UpdatedSettings"
+     * signal, so that the following "Updated" signal can be ignored. */
+    bool updated_settings_received : 1;
 } NMRemoteConnectionPrivate;
 
 struct _NMRemoteConnection {
@@ -698,6 +702,30 @@ _nm_remote_settings_get_settings_commit(NMRemoteConnection *self, GVariant *sett
         _nm_client_notify_object_changed(_nm_object_get_client(self), _nm_object_get_dbobj(self));
 }
 
+void
+_nm_remote_settings_updated_settings_commit(NMRemoteConnection *self, GVariant *settings)
+{
+    NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE(self);
+
+    /* A pending GetSettings() call would only return outdated settings. */
+    nm_clear_g_cancellable(&priv->get_settings_cancellable);
+
+    priv->updated_settings_received = TRUE;
+    _nm_remote_settings_get_settings_commit(self, settings);
+}
+
+gboolean
+_nm_remote_settings_updated_consume(NMRemoteConnection *self)
+{
+    NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE(self);
+
+    if (!priv->updated_settings_received)
+        return FALSE;
+
+    priv->updated_settings_received = FALSE;
+    return TRUE;
+}
+
 /*****************************************************************************/
 
 static gboolean
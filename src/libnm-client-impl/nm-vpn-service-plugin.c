@@ -42,6 +42,9 @@ typedef struct {
     char            *dbus_service_name;
     gboolean         dbus_watch_peer;
 
+    /* NetworkManager keeps the service running in standby, don't quit when idle. */
+    gboolean standby;
+
     /* Temporary stuff */
     guint    connect_timer;
     guint    quit_timer;
@@ -335,6 +338,8 @@ schedule_quit_timer(NMVpnServicePlugin *self)
     NMVpnServicePluginPrivate *priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE(self);
 
     nm_clear_g_source(&priv->quit_timer);
+    if (priv->standby)
+        return;
     priv->quit_timer =
         g_timeout_add_seconds(NM_VPN_SERVICE_PLUGIN_QUIT_TIMER, quit_timer_expired, self);
 }
@@ -1055,6 +1060,10 @@ one_plugin_destroyed(gpointer data, GObject *object)
 static void
 nm_vpn_service_plugin_init(NMVpnServicePlugin *plugin)
 {
+    NMVpnServicePluginPrivate *priv = NM_VPN_SERVICE_PLUGIN_GET_PRIVATE(plugin);
+
+    priv->standby = nm_streq0(g_getenv("NM_VPN_STANDBY"), "1");
+
     active_plugins = g_slist_append(active_plugins, plugin);
     g_object_weak_ref(G_OBJECT(plugin), one_plugin_destroyed, NULL);
 }
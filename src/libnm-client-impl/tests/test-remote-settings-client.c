@@ -258,6 +258,77 @@ test_make_visible(void)
 
 /*****************************************************************************/
 
+static guint
+_get_settings_call_count(void)
+{
+    gs_unref_variant GVariant *ret   = NULL;
+    GError                    *error = NULL;
+    guint32                    count;
+
+    ret = g_dbus_proxy_call_sync(gl.sinfo->proxy,
+                                 "GetSettingsCallCount",
+                                 NULL,
+                                 G_DBUS_CALL_FLAGS_NONE,
+                                 -1,
+                                 NULL,
+                                 &error);
+    nmtst_assert_success(ret, error);
+    g_variant_get(ret, "(u)", &count);
+    return count;
+}
+
+static void
+test_updated_settings(void)
+{
+    const guint         N_UPDATES = nmtst_test_quick() ? 100 : 1000;
+    NMClient           *clients[3];
+    NMRemoteConnection *remote;
+    const char         *path;
+    const char         *uuid;
+    char                id[100];
+    guint               n_get_settings;
+    guint               i;
+
+    if (!nmtstc_service_available(gl.sinfo))
+        return;
+
+    g_assert(gl.remote);
+    path = nm_connection_get_path(NM_CONNECTION(gl.remote));
+    uuid = nm_connection_get_uuid(NM_CONNECTION(gl.remote));
+
+    clients[0] = g_object_ref(gl.client);
+    clients[1] = nmtstc_client_new(TRUE);
+    clients[2] = nmtstc_client_new(TRUE);
+
+    n_get_settings = _get_settings_call_count();
+
+    for (i = 0; i < N_UPDATES; i++) {
+        gs_unref_object NMConnection *connection = NULL;
+
+        connection = nmtst_create_minimal_connection(nm_sprintf_buf(id, "updated-settings-%u", i),
+                                                     uuid,
+                                                     NM_SETTING_WIRED_SETTING_NAME,
+                                                     NULL);
+        nmtstc_service_update_connection(gl.sinfo, path, connection, TRUE);
+    }
+
+    /* All clients see the last update, without fetching the settings. */
+    for (i = 0; i < G_N_ELEMENTS(clients); i++) {
+        nmtst_main_context_iterate_until_assert(
+            NULL,
+            5000,
+            (remote = nm_client_get_connection_by_path(clients[i], path))
+                && nm_streq0(nm_connection_get_id(NM_CONNECTION(remote)), id));
+    }
+
+    g_assert_cmpint(_get_settings_call_count(), ==, n_get_settings);
+
+    for (i = 0; i < G_N_ELEMENTS(clients); i++)
+        g_object_unref(clients[i]);
+}
+
+/*****************************************************************************/
+
 static void
 deleted_cb(GObject *proxy, GAsyncResult *result, gpointer user_data)
 {
@@ -483,6 +554,7 @@ main(int argc, char **argv)
     g_test_add_func("/client/add_connection", test_add_connection);
     g_test_add_func("/client/make_invisible", test_make_invisible);
     g_test_add_func("/client/make_visible", test_make_visible);
+    g_test_add_func("/client/updated_settings", test_updated_settings);
     g_test_add_func("/client/remove_connection", test_remove_connection);
     g_test_add_func("/client/add_remove_connection", test_add_remove_connection);
     g_test_add_func("/client/add_bad_connection", test_add_bad_connection);
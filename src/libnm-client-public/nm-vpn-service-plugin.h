@@ -36,6 +36,18 @@ G_BEGIN_DECLS
 /**
  * NMVpnServicePlugin:
  *
+ * Base class for VPN service plugins.
+ *
+ * When a plugin is idle, it quits after a while. If NetworkManager is
+ * configured to keep the service in standby (see "vpn-standby-services"
+ * in NetworkManager.conf), it starts the plugin with the environment
+ * variable <literal>NM_VPN_STANDBY=1</literal>. A plugin started like
+ * that does not quit when idle, and NetworkManager is responsible for
+ * stopping it. It does so by sending SIGTERM, after which the plugin
+ * disconnects any active connection and quits (the same as on SIGTERM
+ * in general). Plugins that don't use #NMVpnServicePlugin and want to
+ * support standby must follow the same contract.
+ *
  * Since: 1.2
  */
 typedef struct {
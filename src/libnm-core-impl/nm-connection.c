@@ -962,18 +962,16 @@ out:
 gboolean
 _nm_setting_connection_verify_no_duplicate_addresses(GArray *addresses, GError **error)
 {
-    guint i, j;
+    gs_unref_hashtable GHashTable *ht = NULL;
+    guint                          i;
 
-    if (addresses->len <= 1) {
+    if (addresses->len <= 1)
         return TRUE;
-    } else {
-        for (i = 0; i < addresses->len - 1; i++) {
-            for (j = i + 1; j < addresses->len; j++) {
-                if (nm_streq0(nm_g_array_index(addresses, const char *, i),
-                              nm_g_array_index(addresses, const char *, j)))
-                    return FALSE;
-            }
-        }
+
+    ht = g_hash_table_new(nm_str_hash, g_str_equal);
+    for (i = 0; i < addresses->len; i++) {
+        if (!g_hash_table_add(ht, (gpointer) nm_g_array_index(addresses, const char *, i)))
+            return FALSE;
     }
 
     return TRUE;
@@ -1034,10 +1032,11 @@ _normalize_connection_secondaries(NMConnection *self)
 static gboolean
 _normalize_connection_ip_ping_addresses(NMConnection *self)
 {
-    NMSettingConnection *s_con = nm_connection_get_setting_connection(self);
-    GArray              *addresses;
-    gs_strfreev char   **strv = NULL;
-    guint                i, j, k;
+    NMSettingConnection           *s_con = nm_connection_get_setting_connection(self);
+    GArray                        *addresses;
+    gs_strfreev char             **strv = NULL;
+    gs_unref_hashtable GHashTable *ht   = NULL;
+    guint                          i, j;
 
     nm_assert(s_con);
 
@@ -1050,17 +1049,10 @@ _normalize_connection_ip_ping_addresses(NMConnection *self)
 
     strv = nm_strvarray_get_strv_notempty_dup(addresses, NULL);
 
+    ht = g_hash_table_new(nm_str_hash, g_str_equal);
     for (i = 0, j = 0; strv[i]; i++) {
-        gboolean found = FALSE;
-
-        for (k = 0; k < j; k++) {
-            if (nm_streq0(strv[i], strv[k])) {
-                found = TRUE;
-                break;
-            }
-        }
-
-        if (found) {
+        if (!g_hash_table_add(ht, strv[i])) {
+            nm_clear_g_free(&strv[i]);
             continue;
         }
 
@@ -591,6 +591,11 @@ struct NMIPRoute {
     gint8  family;
     guint8 prefix;
 
+    /* Whether _nm_ip_route_attribute_validate_all() already succeeded for
+     * the current attributes and next-hop. Cleared by the setters that
+     * affect the outcome of the validation. */
+    bool attributes_valid : 1;
+
     char       *dest;
     char       *next_hop;
     GHashTable *attributes;
@@ -841,6 +846,7 @@ nm_ip_route_dup(NMIPRoute *route)
         while (g_hash_table_iter_next(&iter, (gpointer *) &key, (gpointer *) &value))
             nm_ip_route_set_attribute(copy, key, value);
     }
+    copy->attributes_valid = route->attributes_valid;
 
     return copy;
 }
@@ -1019,6 +1025,7 @@ nm_ip_route_set_next_hop(NMIPRoute *route, const char *next_hop)
 
     g_free(route->next_hop);
     route->next_hop = canonicalize_ip_binary(route->family, next_hop ? &next_hop_bin : NULL, TRUE);
+    route->attributes_valid = FALSE;
 }
 
 /**
@@ -1065,6 +1072,7 @@ nm_ip_route_set_next_hop_binary(NMIPRoute *route, gconstpointer next_hop)
 
     g_free(route->next_hop);
     route->next_hop = canonicalize_ip_binary(route->family, next_hop, TRUE);
+    route->attributes_valid = FALSE;
 }
 
 /**
@@ -1199,6 +1207,8 @@ nm_ip_route_set_attribute(NMIPRoute *route, const char *name, GVariant *value)
         g_hash_table_insert(route->attributes, g_strdup(name), g_variant_ref_sink(value));
     else
         g_hash_table_remove(route->attributes, name);
+
+    route->attributes_valid = FALSE;
 }
 
 static const NMVariantAttributeSpec *const ip_route_attribute_spec[] = {
@@ -1250,6 +1260,11 @@ static const NMVariantAttributeSpec *const ip_route_attribute_spec[] = {
                                      G_VARIANT_TYPE_UINT32,
                                      .v4 = TRUE,
                                      .v6 = TRUE, ),
+    NM_VARIANT_ATTRIBUTE_SPEC_DEFINE(NM_IP_ROUTE_ATTRIBUTE_NHID,
+                                     G_VARIANT_TYPE_UINT32,
+                                     .v4          = TRUE,
+                                     .v6          = TRUE,
+                                     .type_detail = 'n', ),
     NM_VARIANT_ATTRIBUTE_SPEC_DEFINE(NM_IP_ROUTE_ATTRIBUTE_ONLINK,
                                      G_VARIANT_TYPE_BOOLEAN,
                                      .v4 = TRUE,
@@ -1306,9 +1321,10 @@ nm_ip_route_get_variant_attribute_spec(void)
 }
 
 typedef struct {
-    int    type;
-    int    scope;
-    gint16 weight;
+    int     type;
+    int     scope;
+    gint16  weight;
+    guint32 nhid;
 } IPRouteAttrParseData;
 
 static gboolean
@@ -1447,6 +1463,18 @@ _ip_route_attribute_validate(const char           *name,
         if (parse_data)
             parse_data->weight = (guint16) u32;
         break;
+    case 'n': /* nhid */
+        u32 = g_variant_get_uint32(value);
+        if (u32 == 0) {
+            g_set_error_literal(error,
+                                NM_CONNECTION_ERROR,
+                                NM_CONNECTION_ERROR_FAILED,
+                                _("route nhid cannot be zero"));
+            return FALSE;
+        }
+        if (parse_data)
+            parse_data->nhid = u32;
+        break;
     case '\0':
         break;
     default:
@@ -1504,7 +1532,7 @@ _nm_ip_route_attribute_validate_all(const NMIPRoute *route, GError **error)
     g_return_val_if_fail(route, FALSE);
     g_return_val_if_fail(!error || !*error, FALSE);
 
-    if (!route->attributes)
+    if (!route->attributes || route->attributes_valid)
         return TRUE;
 
     attrs = nm_utils_named_values_from_strdict(route->attributes,
@@ -1558,6 +1586,36 @@ _nm_ip_route_attribute_validate_all(const NMIPRoute *route, GError **error)
         }
     }
 
+    if (parse_data.nhid != 0) {
+        /* The nexthop object provides device and gateway. */
+        if (parse_data.type != RTN_UNICAST) {
+            g_set_error(error,
+                        NM_CONNECTION_ERROR,
+                        NM_CONNECTION_ERROR_INVALID_PROPERTY,
+                        _("a %s route cannot have a \"nhid\""),
+                        nm_net_aux_rtnl_rtntype_n2a(parse_data.type));
+            return FALSE;
+        }
+        if (route->next_hop) {
+            g_set_error_literal(error,
+                                NM_CONNECTION_ERROR,
+                                NM_CONNECTION_ERROR_INVALID_PROPERTY,
+                                _("a route with \"nhid\" cannot have a next-hop"));
+            return FALSE;
+        }
+        if (parse_data.weight > 0) {
+            g_set_error_literal(error,
+                                NM_CONNECTION_ERROR,
+                                NM_CONNECTION_ERROR_INVALID_PROPERTY,
+                                _("a route with \"nhid\" cannot have a \"weight\""));
+            return FALSE;
+        }
+    }
+
+    /* Only the successful result is cached. The caller may want the error
+     * message on failure, and invalid profiles are not the common case. The
+     * flag is a cache, so we update it even via a const pointer. */
+    ((NMIPRoute *) route)->attributes_valid = TRUE;
     return TRUE;
 }
 
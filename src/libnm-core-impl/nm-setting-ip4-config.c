@@ -1220,6 +1220,12 @@ nm_setting_ip4_config_class_init(NMSettingIP4ConfigClass *klass)
      *        <para><literal>"mtu"</literal> - an unsigned 32 bit integer.</para>
      *      </listitem>
      *      <listitem>
+     *        <para><literal>"nhid"</literal> - an unsigned 32 bit integer. The ID
+     *          of a kernel nexthop object that provides device and gateway of the
+     *          route. The nexthop is not managed by NetworkManager. Such a route
+     *          cannot have a next hop or a "weight".</para>
+     *      </listitem>
+     *      <listitem>
      *        <para><literal>"onlink"</literal> - a boolean value. The onlink flag
      *          is ignored for IPv4 routes without a gateway. That also means,
      *          with a positive "weight" the route cannot merge with ECMP routes
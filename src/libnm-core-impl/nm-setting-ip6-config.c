@@ -1472,6 +1472,12 @@ nm_setting_ip6_config_class_init(NMSettingIP6ConfigClass *klass)
      *        <para><literal>"mtu"</literal> - an unsigned 32 bit integer.</para>
      *      </listitem>
      *      <listitem>
+     *        <para><literal>"nhid"</literal> - an unsigned 32 bit integer. The ID
+     *          of a kernel nexthop object that provides device and gateway of the
+     *          route. The nexthop is not managed by NetworkManager. Such a route
+     *          cannot have a next hop or a "weight".</para>
+     *      </listitem>
+     *      <listitem>
      *        <para><literal>"onlink"</literal> - a boolean value.</para>
      *      </listitem>
      *      <listitem>
@@ -2173,6 +2173,8 @@ init_from_dbus(NMSetting                      *setting,
                GError                        **error)
 {
     const NMSettInfoSetting *sett_info;
+    gs_free guint32         *value_idxs_free = NULL;
+    guint32                 *value_idxs;
     guint16                  i;
 
     nm_assert(NM_IS_SETTING(setting));
@@ -2212,6 +2214,34 @@ init_from_dbus(NMSetting                      *setting,
         return TRUE;
     }
 
+    /* Looking up each known property in @setting_dict with g_variant_lookup_value()
+     * scans the dictionary once per property. Instead, index the dictionary once by
+     * mapping each property to the position of its entry (plus one, zero meaning
+     * absent). Like g_variant_lookup_value(), the first entry wins. The properties
+     * are still applied in the same order as before. */
+    value_idxs = nm_malloc0_maybe_a(300,
+                                    sizeof(guint32) * sett_info->property_infos_len,
+                                    &value_idxs_free);
+    {
+        GVariantIter iter;
+        const char  *key;
+        guint32      n = 0;
+
+        g_variant_iter_init(&iter, setting_dict);
+        while (g_variant_iter_next(&iter, "{&sv}", &key, NULL)) {
+            const NMSettInfoProperty *property_info;
+
+            property_info = _nm_sett_info_setting_get_property_info(sett_info, key);
+            if (property_info) {
+                guint32 *p_idx = &value_idxs[property_info - sett_info->property_infos];
+
+                if (*p_idx == 0)
+                    *p_idx = n + 1u;
+            }
+            n++;
+        }
+    }
+
     for (i = 0; i < sett_info->property_infos_len; i++) {
         const NMSettInfoProperty  *property_info = &sett_info->property_infos[i];
         gs_unref_variant GVariant *value         = NULL;
@@ -2223,7 +2253,8 @@ init_from_dbus(NMSetting                      *setting,
         nm_assert(!property_info->param_spec
                   || NM_FLAGS_HAS(property_info->param_spec->flags, G_PARAM_WRITABLE));
 
-        value = g_variant_lookup_value(setting_dict, property_info->name, NULL);
+        if (value_idxs[i] != 0)
+            g_variant_get_child(setting_dict, value_idxs[i] - 1u, "{&sv}", NULL, &value);
 
         if (!value) {
             if (property_info->property_type->missing_from_dbus_fcn
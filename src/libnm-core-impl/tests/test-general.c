@@ -2597,6 +2597,11 @@ test_setting_ip_route_attributes(void)
     TEST_ATTR("quickack", boolean, TRUE, AF_INET, TRUE, TRUE);
     TEST_ATTR("quickack", boolean, TRUE, AF_INET6, TRUE, TRUE);
 
+    TEST_ATTR("nhid", uint32, 10, AF_INET, TRUE, TRUE);
+    TEST_ATTR("nhid", uint32, 10, AF_INET6, TRUE, TRUE);
+    TEST_ATTR("nhid", uint32, 0, AF_INET, FALSE, TRUE);
+    TEST_ATTR("nhid", string, "10", AF_INET, FALSE, TRUE);
+
     TEST_ATTR("rto_min", uint32, 1000, AF_INET, TRUE, TRUE);
     TEST_ATTR("rto_min", uint32, 1000, AF_INET6, TRUE, TRUE);
 
@@ -3667,6 +3672,70 @@ test_connection_new_from_dbus(void)
     g_object_unref(connection);
 }
 
+static void
+test_connection_new_from_dbus_many(void)
+{
+    gs_unref_ptrarray GPtrArray *dicts = NULL;
+    const guint                  n     = nmtst_test_quick() ? 1000 : 10000;
+    gdouble                      elapsed;
+    guint                        i;
+
+    dicts = g_ptr_array_new_with_free_func((GDestroyNotify) g_variant_unref);
+    for (i = 0; i < n; i++) {
+        gs_unref_object NMConnection         *connection = NULL;
+        nm_auto_unref_ip_address NMIPAddress *addr       = NULL;
+        NMSettingIPConfig                    *s_ip4;
+        gs_free char                         *id = g_strdup_printf("profile-%u", i);
+        char                                  addr_str[NM_INET_ADDRSTRLEN];
+
+        connection = new_test_connection();
+        g_object_set(nm_connection_get_setting_connection(connection),
+                     NM_SETTING_CONNECTION_ID,
+                     id,
+                     NULL);
+
+        s_ip4 = nm_connection_get_setting_ip4_config(connection);
+        g_object_set(s_ip4, NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL, NULL);
+        addr = nm_ip_address_new(AF_INET,
+                                 nm_inet4_ntop(htonl(0x0a000001u + (i << 8)), addr_str),
+                                 24,
+                                 NULL);
+        nm_setting_ip_config_add_address(s_ip4, addr);
+
+        nmtst_connection_normalize(connection);
+        g_ptr_array_add(dicts,
+                        g_variant_ref_sink(
+                            nm_connection_to_dbus(connection, NM_CONNECTION_SERIALIZE_ALL)));
+    }
+
+    g_test_timer_start();
+    for (i = 0; i < n; i++) {
+        gs_unref_object NMConnection *connection = NULL;
+        gs_free_error GError         *error      = NULL;
+
+        connection = _nm_simple_connection_new_from_dbus(dicts->pdata[i],
+                                                         NM_SETTING_PARSE_FLAGS_STRICT,
+                                                         &error);
+        nmtst_assert_success(connection, error);
+
+        if (i == n - 1) {
+            gs_free char *id = g_strdup_printf("profile-%u", i);
+
+            g_assert_cmpstr(nm_connection_get_id(connection), ==, id);
+            g_assert_cmpint(nm_setting_ip_config_get_num_addresses(
+                                nm_connection_get_setting_ip4_config(connection)),
+                            ==,
+                            1);
+        }
+    }
+    elapsed = g_test_timer_elapsed();
+
+    g_test_message("converting %u connections from D-Bus took %.3f msec (%.3f usec each)",
+                   n,
+                   elapsed * 1000.0,
+                   elapsed * 1000000.0 / n);
+}
+
 static void
 check_permission(NMSettingConnection *s_con, guint32 idx, const char *expected_uname)
 {
@@ -11733,6 +11802,8 @@ main(int argc, char **argv)
     g_test_add_func("/core/general/test_connection_replace_settings_bad",
                     test_connection_replace_settings_bad);
     g_test_add_func("/core/general/test_connection_new_from_dbus", test_connection_new_from_dbus);
+    g_test_add_func("/core/general/test_connection_new_from_dbus_many",
+                    test_connection_new_from_dbus_many);
     g_test_add_func("/core/general/test_connection_normalize_virtual_iface_name",
                     test_connection_normalize_virtual_iface_name);
     g_test_add_func("/core/general/test_connection_normalize_uuid", test_connection_normalize_uuid);
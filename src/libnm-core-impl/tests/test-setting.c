@@ -5235,6 +5235,70 @@ test_setting_connection_empty_address_and_route(void)
 
 /*****************************************************************************/
 
+static void
+test_setting_ip_config_verify_many_routes(void)
+{
+    gs_unref_object NMConnection *con    = NULL;
+    gs_unref_ptrarray GPtrArray  *routes = NULL;
+    NMSettingIPConfig            *s_ip4;
+    NMIPRoute                    *route;
+    gs_free_error GError         *error = NULL;
+    const guint                   n     = nmtst_test_quick() ? 5000 : 50000;
+    gdouble                       t_first;
+    gdouble                       t_second;
+    guint                         i;
+
+    con   = nmtst_create_minimal_connection("wired", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+    s_ip4 = (NMSettingIPConfig *) nm_setting_ip4_config_new();
+    nm_connection_add_setting(con, NM_SETTING(s_ip4));
+    g_object_set(s_ip4, NM_SETTING_IP_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_AUTO, NULL);
+
+    routes = g_ptr_array_new_with_free_func((GDestroyNotify) nm_ip_route_unref);
+    for (i = 0; i < n; i++) {
+        in_addr_t dest = htonl(0x0a000000u | (i << 8));
+
+        route = nm_ip_route_new_binary(AF_INET, &dest, 24, NULL, -1, NULL);
+        nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_TABLE, g_variant_new_uint32(100));
+        nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_MTU, g_variant_new_uint32(1400));
+        nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_TYPE, g_variant_new_string("unicast"));
+        g_ptr_array_add(routes, route);
+    }
+    g_object_set(s_ip4, NM_SETTING_IP_CONFIG_ROUTES, routes, NULL);
+    g_assert_cmpint(nm_setting_ip_config_get_num_routes(s_ip4), ==, n);
+
+    g_test_timer_start();
+    nmtst_assert_connection_verifies(con);
+    t_first = g_test_timer_elapsed();
+
+    g_test_timer_start();
+    nmtst_assert_connection_verifies(con);
+    t_second = g_test_timer_elapsed();
+
+    g_test_message("verify of %u routes took %.3f msec (%.3f msec with cached attributes)",
+                   n,
+                   t_first * 1000.0,
+                   t_second * 1000.0);
+
+    /* Changing the attributes of a route must invalidate the cached result. */
+    route = nm_setting_ip_config_get_route(s_ip4, n / 2);
+    nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_TYPE, g_variant_new_string("blackhole"));
+    nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_WEIGHT, g_variant_new_uint32(5));
+    g_assert(!nm_setting_verify((NMSetting *) s_ip4, con, &error));
+    g_assert_error(error, NM_CONNECTION_ERROR, NM_CONNECTION_ERROR_INVALID_PROPERTY);
+    nm_clear_error(&error);
+
+    nm_ip_route_set_attribute(route, NM_IP_ROUTE_ATTRIBUTE_WEIGHT, NULL);
+    nmtst_assert_connection_verifies(con);
+
+    /* ... and so must setting a next-hop on a blackhole route. */
+    nm_ip_route_set_next_hop(route, "10.255.0.1");
+    g_assert(!nm_setting_verify((NMSetting *) s_ip4, con, &error));
+    g_assert_error(error, NM_CONNECTION_ERROR, NM_CONNECTION_ERROR_INVALID_PROPERTY);
+    nm_clear_error(&error);
+}
+
+/*****************************************************************************/
+
 static void
 test_setting_connection_secondaries_verify(void)
 {
@@ -5800,6 +5864,8 @@ main(int argc, char **argv)
 
     g_test_add_func("/libnm/settings/test_setting_connection_empty_address_and_route",
                     test_setting_connection_empty_address_and_route);
+    g_test_add_func("/libnm/settings/ip-config/verify-many-routes",
+                    test_setting_ip_config_verify_many_routes);
     g_test_add_func("/libnm/settings/test_setting_connection_secondaries_verify",
                     test_setting_connection_secondaries_verify);
 
@@ -173,6 +173,7 @@ gboolean nm_ip_route_attribute_validate(const char *name,
 #define NM_IP_ROUTE_ATTRIBUTE_LOCK_MTU      "lock-mtu"
 #define NM_IP_ROUTE_ATTRIBUTE_LOCK_WINDOW   "lock-window"
 #define NM_IP_ROUTE_ATTRIBUTE_MTU           "mtu"
+#define NM_IP_ROUTE_ATTRIBUTE_NHID          "nhid"
 #define NM_IP_ROUTE_ATTRIBUTE_ONLINK        "onlink"
 #define NM_IP_ROUTE_ATTRIBUTE_QUICKACK      "quickack"
 #define NM_IP_ROUTE_ATTRIBUTE_RTO_MIN       "rto_min"
@@ -172,7 +172,8 @@ typedef enum _nm_packed {
 #define BRIDGE_FLAGS_CONTROLLER BRIDGE_FLAGS_MASTER
 
 G_STATIC_ASSERT(RTA_MAX == (__RTA_MAX - 1));
-#define RTA_PREF 20
+#define RTA_PREF    20
+#define RTA_EXPIRES 23
 #undef RTA_MAX
 #define RTA_MAX (NM_MAX_CONST((__RTA_MAX - 1), RTA_PREF))
 
@@ -227,6 +228,23 @@ G_STATIC_ASSERT(RTA_MAX == (__RTA_MAX - 1));
 
 /*****************************************************************************/
 
+/* Nexthop objects appeared in kernel 5.3, dated 15 September, 2019. */
+#ifndef RTM_NEWNEXTHOP
+#define RTM_NEWNEXTHOP 104
+#define RTM_DELNEXTHOP 105
+#define RTM_GETNEXTHOP 106
+#endif
+
+#ifndef RTNLGRP_NEXTHOP
+#define RTNLGRP_NEXTHOP 32
+#endif
+
+#ifndef RTA_NH_ID
+#define RTA_NH_ID 30
+#endif
+
+/*****************************************************************************/
+
 #define IFLA_MACSEC_UNSPEC         0
 #define IFLA_MACSEC_SCI            1
 #define IFLA_MACSEC_PORT           2
@@ -327,6 +345,11 @@ G_STATIC_ASSERT(RTA_MAX == (__RTA_MAX - 1));
 #define IFLA_VF_VLAN_INFO_UNSPEC 0
 #define IFLA_VF_VLAN_INFO        1
 
+/* Appeared in the kernel 4.20 */
+#ifndef RTEXT_FILTER_SKIP_STATS
+#define RTEXT_FILTER_SKIP_STATS (1 << 3)
+#endif
+
 /*****************************************************************************/
 
 #define NDA_CONTROLLER NDA_MASTER
@@ -412,8 +435,9 @@ typedef enum {
     REFRESH_ALL_TYPE_RTNL_ROUTING_RULES_IP6 = 6,
     REFRESH_ALL_TYPE_RTNL_QDISCS            = 7,
     REFRESH_ALL_TYPE_RTNL_TFILTERS          = 8,
+    REFRESH_ALL_TYPE_RTNL_NEXTHOPS          = 9,
 
-    REFRESH_ALL_TYPE_GENL_FAMILIES = 9,
+    REFRESH_ALL_TYPE_GENL_FAMILIES = 10,
 
     _REFRESH_ALL_TYPE_NUM,
 } RefreshAllType;
@@ -445,16 +469,17 @@ typedef enum _nm_packed {
         1 << F(6, REFRESH_ALL_TYPE_RTNL_ROUTING_RULES_IP6),
     DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS   = 1 << F(7, REFRESH_ALL_TYPE_RTNL_QDISCS),
     DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS = 1 << F(8, REFRESH_ALL_TYPE_RTNL_TFILTERS),
+    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS = 1 << F(9, REFRESH_ALL_TYPE_RTNL_NEXTHOPS),
 
-    DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES = 1 << F(9, REFRESH_ALL_TYPE_GENL_FAMILIES),
+    DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES = 1 << F(10, REFRESH_ALL_TYPE_GENL_FAMILIES),
 #undef F
 
-    DELAYED_ACTION_TYPE_READ_RTNL              = 1 << 10,
-    DELAYED_ACTION_TYPE_READ_GENL              = 1 << 11,
-    DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_RTNL = 1 << 12,
-    DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_GENL = 1 << 13,
-    DELAYED_ACTION_TYPE_REFRESH_LINK           = 1 << 14,
-    DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED   = 1 << 15,
+    DELAYED_ACTION_TYPE_READ_RTNL              = 1 << 11,
+    DELAYED_ACTION_TYPE_READ_GENL              = 1 << 12,
+    DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_RTNL = 1 << 13,
+    DELAYED_ACTION_TYPE_WAIT_FOR_RESPONSE_GENL = 1 << 14,
+    DELAYED_ACTION_TYPE_REFRESH_LINK           = 1 << 15,
+    DELAYED_ACTION_TYPE_CONTROLLER_CONNECTED   = 1 << 16,
 
     __DELAYED_ACTION_TYPE_MAX,
 
@@ -469,7 +494,8 @@ typedef enum _nm_packed {
                                            | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP6_ROUTES
                                            | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_ROUTING_RULES_ALL
                                            | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS
-                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS,
+                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS
+                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS,
 
     DELAYED_ACTION_TYPE_REFRESH_GENL_ALL = DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES,
 
@@ -566,6 +592,9 @@ typedef struct {
 
     guint32 pruning[_REFRESH_ALL_TYPE_NUM];
 
+    /* Whether kernel supports nexthop objects (RTNLGRP_NEXTHOP). */
+    bool nexthop_supported : 1;
+
     GHashTable *sysctl_get_prev_values;
     CList       sysctl_list;
     CList       sysctl_clear_cache_lst;
@@ -1190,6 +1219,20 @@ _addrtime_get_lifetimes(guint32  timestamp,
     *out_preferred = preferred;
 }
 
+/* Convert rta_expires of an IPv6 route's rta_cacheinfo to the absolute
+ * expiry in nm_utils_get_monotonic_timestamp_sec() scale. Like the
+ * timestamps of ifa_cacheinfo, rta_expires counts in 1/100th of a second,
+ * but it is relative to the moment when kernel constructed the message. */
+static guint32
+_routetime_expires_to_nm(gint32 rta_expires)
+{
+    if (rta_expires <= 0)
+        return 0;
+
+    /* round up, so that we never claim an earlier expiry than kernel. */
+    return nm_utils_get_monotonic_timestamp_sec() + (((guint32) rta_expires) + 99u) / 100u;
+}
+
 /*****************************************************************************/
 
 static const NMPObject *
@@ -4018,6 +4061,7 @@ _new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter
         [RTA_VIA]       = {.minlen = nm_offsetofend(struct rtvia, rtvia_family)},
         [RTA_METRICS]   = {.type = NLA_NESTED},
         [RTA_MULTIPATH] = {.type = NLA_NESTED},
+        [RTA_NH_ID]     = {.type = NLA_U32},
     };
     guint                     multihop_idx;
     const struct rtmsg       *rtm;
@@ -4053,6 +4097,7 @@ _new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter
     guint32                         lock        = 0;
     gboolean                        quickack    = FALSE;
     gboolean                        rto_min_set = FALSE;
+    guint32                         nhid        = 0;
 
     nm_assert((parse_nlmsg_iter->iter_more && parse_nlmsg_iter->ip6_route.next_multihop > 0)
               || (!parse_nlmsg_iter->iter_more && parse_nlmsg_iter->ip6_route.next_multihop == 0));
@@ -4096,6 +4141,30 @@ _new_from_nl_route(const struct nlmsghdr *nlh, gboolean id_only, ParseNlmsgIter
     if (rtm->rtm_dst_len > (IS_IPv4 ? 32 : 128))
         return NULL;
 
+    if (tb[RTA_NH_ID]) {
+        /* The route refers to a nexthop object. With nexthop compat mode (the
+         * default), kernel additionally expands the nexthop into RTA_OIF, RTA_GATEWAY
+         * and RTA_MULTIPATH. We don't want to split such routes into several
+         * single-hop routes, they are identified by their nexthop ID. Only remember
+         * the device, so that the route stays associated with an interface. */
+        nhid = nla_get_u32(tb[RTA_NH_ID]);
+        if (nhid == 0)
+            return NULL;
+
+        if (multihop_idx > 0)
+            return nm_assert_unreachable_val(NULL);
+
+        nh.found = TRUE;
+        if (tb[RTA_OIF])
+            nh.ifindex = nla_get_u32(tb[RTA_OIF]);
+        else if (tb[RTA_MULTIPATH]
+                 && (gsize) nla_len(tb[RTA_MULTIPATH]) >= sizeof(struct rtnexthop))
+            nh.ifindex = nla_data_as(struct rtnexthop, tb[RTA_MULTIPATH])->rtnh_ifindex;
+        if (IS_IPv4)
+            v4_n_nexthops = 1;
+        goto rta_nexthop_done;
+    }
+
     if (tb[RTA_MULTIPATH]) {
         size_t            tlen;
         struct rtnexthop *rtnh;
@@ -4280,6 +4349,8 @@ rta_multipath_done:
         }
     }
 
+rta_nexthop_done:
+
     /*****************************************************************/
 
     mss = 0;
@@ -4331,6 +4402,7 @@ rta_multipath_done:
         tb[RTA_TABLE] ? nla_get_u32(tb[RTA_TABLE]) : (guint32) rtm->rtm_table);
 
     obj->ip_route.ifindex = nh.ifindex;
+    obj->ip_route.nhid    = nhid;
 
     if (IS_IPv4) {
         nm_assert((!!nh.found) == (v4_n_nexthops > 0u));
@@ -4406,11 +4478,22 @@ rta_multipath_done:
     if (!IS_IPv4) {
         if (tb[RTA_PREF])
             obj->ip6_route.rt_pref = nla_get_u8(tb[RTA_PREF]);
+        if (tb[RTA_CACHEINFO]) {
+            const struct rta_cacheinfo *ci = nla_data(tb[RTA_CACHEINFO]);
+
+            obj->ip6_route.expires = _routetime_expires_to_nm(ci->rta_expires);
+        }
     }
 
     obj->ip_route.r_rtm_flags = rtm->rtm_flags;
     obj->ip_route.rt_source   = nmp_utils_ip_config_source_from_rtprot(rtm->rtm_protocol);
 
+    if (nhid != 0) {
+        /* In compat mode, kernel also reports the onlink flag of the nexthop
+         * object. That belongs to the nexthop, not to the route. */
+        obj->ip_route.r_rtm_flags &= ~((unsigned) RTNH_F_ONLINK);
+    }
+
     if (nh.has_more) {
         parse_nlmsg_iter->iter_more               = TRUE;
         parse_nlmsg_iter->ip6_route.next_multihop = multihop_idx + 1;
@@ -4666,6 +4749,93 @@ _new_from_nl_routing_rule(const struct nlmsghdr *nlh, gboolean id_only)
     return g_steal_pointer(&obj);
 }
 
+static NMPObject *
+_new_from_nl_nexthop(const struct nlmsghdr *nlh, gboolean id_only)
+{
+    static const struct nla_policy policy[] = {
+        [NHA_ID] =
+            {
+                .type = NLA_U32,
+            },
+        [NHA_GROUP]      = {/* array of struct nexthop_grp */},
+        [NHA_GROUP_TYPE] = {.type = NLA_U16},
+        [NHA_BLACKHOLE]  = {.type = NLA_FLAG},
+        [NHA_OIF] =
+            {
+                .type = NLA_U32,
+            },
+        [NHA_GATEWAY] = {/* struct in_addr, struct in6_addr */},
+    };
+    struct nlattr            *tb[G_N_ELEMENTS(policy)];
+    const struct nhmsg       *nhm;
+    NMPlatformNexthop        *props;
+    nm_auto_nmpobj NMPObject *obj = NULL;
+    guint32                   id;
+
+    if (nlmsg_parse_arr(nlh, sizeof(*nhm), tb, policy) < 0)
+        return NULL;
+
+    if (!tb[NHA_ID])
+        return NULL;
+
+    id = nla_get_u32(tb[NHA_ID]);
+    if (id == 0)
+        return NULL;
+
+    nhm = nlmsg_data(nlh);
+
+    obj   = nmp_object_new(NMP_OBJECT_TYPE_NEXTHOP, NULL);
+    props = &obj->nexthop;
+
+    props->id = id;
+
+    if (id_only)
+        return g_steal_pointer(&obj);
+
+    props->addr_family = nhm->nh_family;
+    props->protocol    = nhm->nh_protocol;
+    props->flags       = nhm->nh_flags;
+
+    if (tb[NHA_BLACKHOLE])
+        props->blackhole = TRUE;
+
+    if (tb[NHA_OIF])
+        props->ifindex = nla_get_u32(tb[NHA_OIF]);
+
+    if (tb[NHA_GATEWAY]) {
+        if (!nm_ip_addr_set_from_untrusted(props->addr_family,
+                                           &props->gateway,
+                                           nla_data(tb[NHA_GATEWAY]),
+                                           nla_len(tb[NHA_GATEWAY]),
+                                           NULL))
+            return NULL;
+    }
+
+    if (tb[NHA_GROUP]) {
+        const struct nexthop_grp    *grp = nla_data(tb[NHA_GROUP]);
+        NMPlatformNexthopGroupEntry *group;
+        gsize                        n;
+        gsize                        i;
+
+        n = nla_len(tb[NHA_GROUP]) / sizeof(struct nexthop_grp);
+        if (n == 0 || n > G_MAXUINT16
+            || (gsize) nla_len(tb[NHA_GROUP]) != n * sizeof(struct nexthop_grp))
+            return NULL;
+
+        group = g_new(NMPlatformNexthopGroupEntry, n);
+        for (i = 0; i < n; i++) {
+            group[i] = (NMPlatformNexthopGroupEntry){
+                .id     = grp[i].id,
+                .weight = ((guint16) grp[i].weight) + 1u,
+            };
+        }
+        obj->_nexthop.group = group;
+        props->group_len    = n;
+    }
+
+    return g_steal_pointer(&obj);
+}
+
 static guint32
 psched_tick_to_time(NMPlatform *platform, guint32 tick)
 {
@@ -4885,6 +5055,10 @@ nmp_object_new_from_nl(NMPlatform               *platform,
     case RTM_DELRULE:
     case RTM_GETRULE:
         return _new_from_nl_routing_rule(msghdr, id_only);
+    case RTM_NEWNEXTHOP:
+    case RTM_DELNEXTHOP:
+    case RTM_GETNEXTHOP:
+        return _new_from_nl_nexthop(msghdr, id_only);
     case RTM_NEWQDISC:
     case RTM_DELQDISC:
     case RTM_GETQDISC:
@@ -5782,7 +5956,7 @@ _nl_msg_new_route(uint16_t nlmsg_type, uint16_t nlmsg_flags, const NMPObject *ob
             NLA_PUT(msg, RTA_PREFSRC, addr_len, &obj->ip6_route.pref_src);
     }
 
-    if (IS_IPv4 && obj->ip4_route.n_nexthops > 1u) {
+    if (IS_IPv4 && obj->ip4_route.n_nexthops > 1u && obj->ip_route.nhid == 0) {
         struct nlattr *multipath;
         guint          i;
 
@@ -5861,35 +6035,48 @@ _nl_msg_new_route(uint16_t nlmsg_type, uint16_t nlmsg_flags, const NMPObject *ob
         nla_nest_end(msg, metrics);
     }
 
-    /* We currently don't have need for multi-hop routes... */
-    if (IS_IPv4) {
-        if (obj->ip4_route.gateway == INADDR_ANY && obj->ip4_route.via.addr_family != AF_UNSPEC) {
-            struct rtvia *rtvia;
-
-            nm_assert(obj->ip4_route.via.addr_family == AF_INET6);
-
-            rtvia = nla_data(nla_reserve(
-                msg,
-                RTA_VIA,
-                sizeof(*rtvia) + nm_utils_addr_family_to_size(obj->ip4_route.via.addr_family)));
-            if (!rtvia)
-                goto nla_put_failure;
-            rtvia->rtvia_family = obj->ip4_route.via.addr_family;
-            memcpy(rtvia->rtvia_addr,
-                   obj->ip4_route.via.addr.addr_ptr,
-                   nm_utils_addr_family_to_size(obj->ip4_route.via.addr_family));
+    if (obj->ip_route.nhid != 0) {
+        /* The nexthop object provides gateway and device. Kernel rejects
+         * RTA_OIF/RTA_GATEWAY together with RTA_NH_ID. */
+        NLA_PUT_U32(msg, RTA_NH_ID, obj->ip_route.nhid);
+    } else {
+        /* We currently don't have need for multi-hop routes... */
+        if (IS_IPv4) {
+            if (obj->ip4_route.gateway == INADDR_ANY
+                && obj->ip4_route.via.addr_family != AF_UNSPEC) {
+                struct rtvia *rtvia;
+
+                nm_assert(obj->ip4_route.via.addr_family == AF_INET6);
+
+                rtvia = nla_data(nla_reserve(
+                    msg,
+                    RTA_VIA,
+                    sizeof(*rtvia) + nm_utils_addr_family_to_size(obj->ip4_route.via.addr_family)));
+                if (!rtvia)
+                    goto nla_put_failure;
+                rtvia->rtvia_family = obj->ip4_route.via.addr_family;
+                memcpy(rtvia->rtvia_addr,
+                       obj->ip4_route.via.addr.addr_ptr,
+                       nm_utils_addr_family_to_size(obj->ip4_route.via.addr_family));
+            } else {
+                NLA_PUT(msg, RTA_GATEWAY, addr_len, &obj->ip4_route.gateway);
+            }
         } else {
-            NLA_PUT(msg, RTA_GATEWAY, addr_len, &obj->ip4_route.gateway);
+            if (!IN6_IS_ADDR_UNSPECIFIED(&obj->ip6_route.gateway))
+                NLA_PUT(msg, RTA_GATEWAY, addr_len, &obj->ip6_route.gateway);
         }
-    } else {
-        if (!IN6_IS_ADDR_UNSPECIFIED(&obj->ip6_route.gateway))
-            NLA_PUT(msg, RTA_GATEWAY, addr_len, &obj->ip6_route.gateway);
+        NLA_PUT_U32(msg, RTA_OIF, obj->ip_route.ifindex);
     }
-    NLA_PUT_U32(msg, RTA_OIF, obj->ip_route.ifindex);
 
     if (!IS_IPv4 && obj->ip6_route.rt_pref != NM_ICMPV6_ROUTER_PREF_MEDIUM)
         NLA_PUT_U8(msg, RTA_PREF, obj->ip6_route.rt_pref);
 
+    if (!IS_IPv4 && obj->ip6_route.expires != 0) {
+        NLA_PUT_U32(msg,
+                    RTA_EXPIRES,
+                    nm_platform_ip6_route_get_expires_remaining(obj->ip6_route.expires, 0));
+    }
+
     return g_steal_pointer(&msg);
 
 nla_put_failure:
@@ -6011,6 +6198,66 @@ nla_put_failure:
     g_return_val_if_reached(NULL);
 }
 
+static struct nl_msg *
+_nl_msg_new_nexthop(uint16_t nlmsg_type, uint16_t nlmsg_flags, const NMPObject *obj)
+{
+    nm_auto_nlmsg struct nl_msg *msg     = NULL;
+    const NMPlatformNexthop     *nexthop = NMP_OBJECT_CAST_NEXTHOP(obj);
+    const gboolean               is_del  = (nlmsg_type == RTM_DELNEXTHOP);
+
+    msg = nlmsg_alloc_new(0, nlmsg_type, nlmsg_flags);
+
+    {
+        const struct nhmsg nhm = {
+            .nh_family   = is_del ? AF_UNSPEC : nexthop->addr_family,
+            .nh_protocol = is_del ? RTPROT_UNSPEC : nexthop->protocol,
+            .nh_flags    = is_del ? 0u : (nexthop->flags & ((guint32) RTNH_F_ONLINK)),
+        };
+
+        if (nlmsg_append_struct(msg, &nhm) < 0)
+            goto nla_put_failure;
+    }
+
+    NLA_PUT_U32(msg, NHA_ID, nexthop->id);
+
+    if (is_del) {
+        /* kernel identifies the nexthop only by its ID. */
+        return g_steal_pointer(&msg);
+    }
+
+    if (nexthop->group_len > 0) {
+        gs_free struct nexthop_grp *grp = NULL;
+        guint                       i;
+
+        nm_assert(obj->_nexthop.group);
+
+        grp = g_new0(struct nexthop_grp, nexthop->group_len);
+        for (i = 0; i < nexthop->group_len; i++) {
+            grp[i].id = obj->_nexthop.group[i].id;
+            /* netlink encodes the weight as "weight - 1" in a u8. */
+            grp[i].weight = NM_CLAMP((guint) obj->_nexthop.group[i].weight, 1u, 256u) - 1u;
+        }
+        NLA_PUT(msg, NHA_GROUP, sizeof(struct nexthop_grp) * nexthop->group_len, grp);
+    } else if (nexthop->blackhole)
+        NLA_PUT_FLAG(msg, NHA_BLACKHOLE);
+    else {
+        if (nexthop->ifindex > 0)
+            NLA_PUT_U32(msg, NHA_OIF, nexthop->ifindex);
+        if (NM_IN_SET(nexthop->addr_family, AF_INET, AF_INET6)
+            && !nm_ip_addr_is_null(nexthop->addr_family, &nexthop->gateway)) {
+            NLA_PUT(msg,
+                    NHA_GATEWAY,
+                    nm_utils_addr_family_to_size(nexthop->addr_family),
+                    &nexthop->gateway);
+        }
+    }
+
+    return g_steal_pointer(&msg);
+
+nla_put_failure:
+    g_return_val_if_reached(NULL);
+}
+
 static struct nl_msg *
 _nl_msg_new_qdisc(uint16_t nlmsg_type, uint16_t nlmsg_flags, const NMPlatformQdisc *qdisc)
 {
@@ -6783,6 +7030,7 @@ refresh_all_type_get_info(RefreshAllType refresh_all_type)
         R_ROUTE(REFRESH_ALL_TYPE_RTNL_ROUTING_RULES_IP6, NMP_OBJECT_TYPE_ROUTING_RULE, AF_INET6),
         R_ROUTE(REFRESH_ALL_TYPE_RTNL_QDISCS, NMP_OBJECT_TYPE_QDISC, AF_UNSPEC),
         R_ROUTE(REFRESH_ALL_TYPE_RTNL_TFILTERS, NMP_OBJECT_TYPE_TFILTER, AF_UNSPEC),
+        R_ROUTE(REFRESH_ALL_TYPE_RTNL_NEXTHOPS, NMP_OBJECT_TYPE_NEXTHOP, AF_UNSPEC),
         R_GENERIC(REFRESH_ALL_TYPE_GENL_FAMILIES, NMP_OBJECT_TYPE_UNKNOWN, AF_UNSPEC),
     };
 #undef R_GENERIC
@@ -6818,6 +7066,8 @@ static NM_UTILS_LOOKUP_DEFINE(
     NM_UTILS_LOOKUP_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS, REFRESH_ALL_TYPE_RTNL_QDISCS),
     NM_UTILS_LOOKUP_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS,
                          REFRESH_ALL_TYPE_RTNL_TFILTERS),
+    NM_UTILS_LOOKUP_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS,
+                         REFRESH_ALL_TYPE_RTNL_NEXTHOPS),
     NM_UTILS_LOOKUP_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES,
                          REFRESH_ALL_TYPE_GENL_FAMILIES),
     NM_UTILS_LOOKUP_ITEM_IGNORE_OTHER(), );
@@ -6854,6 +7104,8 @@ refresh_all_type_from_needle_object(const NMPObject *obj_needle)
         return REFRESH_ALL_TYPE_RTNL_QDISCS;
     case NMP_OBJECT_TYPE_TFILTER:
         return REFRESH_ALL_TYPE_RTNL_TFILTERS;
+    case NMP_OBJECT_TYPE_NEXTHOP:
+        return REFRESH_ALL_TYPE_RTNL_NEXTHOPS;
     case NMP_OBJECT_TYPE_ROUTING_RULE:
         switch (NMP_OBJECT_CAST_ROUTING_RULE(obj_needle)->addr_family) {
         case AF_INET:
@@ -6920,6 +7172,8 @@ static NM_UTILS_LOOKUP_STR_DEFINE(
                              "refresh-all-rtnl-qdiscs"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS,
                              "refresh-all-rtnl-tfilters"),
+    NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS,
+                             "refresh-all-rtnl-nexthops"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES,
                              "refresh-all-genl-families"),
     NM_UTILS_LOOKUP_STR_ITEM(DELAYED_ACTION_TYPE_REFRESH_LINK, "refresh-link"),
@@ -7370,6 +7624,8 @@ delayed_action_schedule_refresh_all(NMPlatform *platform, NMPNetlinkProtocol net
             action_type |= (DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS
                             | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS);
         }
+        if (NM_LINUX_PLATFORM_GET_PRIVATE(platform)->nexthop_supported)
+            action_type |= DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS;
     } else {
         nm_assert(netlink_protocol == NMP_NETLINK_GENERIC);
         action_type = DELAYED_ACTION_TYPE_REFRESH_ALL_GENL_FAMILIES;
@@ -7558,6 +7814,9 @@ cache_on_change(NMPlatform      *platform,
                         | (nm_platform_get_cache_tc(platform)
                                ? (DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_QDISCS
                                   | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_TFILTERS)
+                               : DELAYED_ACTION_TYPE_NONE)
+                        | (NM_LINUX_PLATFORM_GET_PRIVATE(platform)->nexthop_supported
+                               ? DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_NEXTHOPS
                                : DELAYED_ACTION_TYPE_NONE),
                     NULL);
             }
@@ -7721,6 +7980,17 @@ cache_on_change(NMPlatform      *platform,
                                     NULL);
         }
     } break;
+    case NMP_OBJECT_TYPE_NEXTHOP:
+    {
+        /* When a nexthop gets deleted, kernel also removes the routes that refer
+         * to it, without sending RTM_DELROUTE notifications. */
+        if (cache_op == NMP_CACHE_OPS_REMOVED) {
+            delayed_action_schedule(platform,
+                                    DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP4_ROUTES
+                                        | DELAYED_ACTION_TYPE_REFRESH_ALL_RTNL_IP6_ROUTES,
+                                    NULL);
+        }
+    } break;
     default:
         break;
     }
@@ -7976,6 +8246,15 @@ _nl_msg_new_dump_rtnl(NMPObjectType obj_type, int preferred_addr_family)
         if (nlmsg_append_struct(nlmsg, &frh) < 0)
             g_return_val_if_reached(NULL);
     } break;
+    case NMP_OBJECT_TYPE_NEXTHOP:
+    {
+        struct nhmsg nhm = {
+            .nh_family = preferred_addr_family,
+        };
+
+        if (nlmsg_append_struct(nlmsg, &nhm) < 0)
+            g_return_val_if_reached(NULL);
+    } break;
     default:
         g_return_val_if_reached(NULL);
     }
@@ -8273,6 +8552,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
                   RTM_DELADDR,
                   RTM_DELROUTE,
                   RTM_DELRULE,
+                  RTM_DELNEXTHOP,
                   RTM_DELQDISC,
                   RTM_DELTFILTER)) {
         /* The event notifies about a deleted object. We don't need to initialize all
@@ -8297,6 +8577,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
                      RTM_NEWLINK,
                      RTM_NEWROUTE,
                      RTM_NEWRULE,
+                     RTM_NEWNEXTHOP,
                      RTM_NEWQDISC,
                      RTM_NEWTFILTER)) {
         is_dump =
@@ -8322,6 +8603,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
         case RTM_NEWLINK:
         case RTM_NEWQDISC:
         case RTM_NEWRULE:
+        case RTM_NEWNEXTHOP:
         case RTM_NEWTFILTER:
             cache_op = nmp_cache_update_netlink(cache, obj, is_dump, &obj_old, &obj_new);
             if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
@@ -8438,6 +8720,7 @@ _rtnl_handle_msg(NMPlatform *platform, const struct nl_msg_lite *msg)
         case RTM_DELQDISC:
         case RTM_DELROUTE:
         case RTM_DELRULE:
+        case RTM_DELNEXTHOP:
         case RTM_DELTFILTER:
             cache_op = nmp_cache_remove_netlink(cache, obj, &obj_old, &obj_new);
             if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
@@ -9531,18 +9814,232 @@ link_set_sriov_params_async(NMPlatform             *platform,
     sriov_async_call_next_step(async_state);
 }
 
+typedef struct {
+    NMPlatformVF     vf;
+    NMPlatformVFVlan vlan;
+} SriovVFState;
+
+typedef struct {
+    int     ifindex;
+    GArray *vfs;
+} SriovVFData;
+
+static void
+_sriov_vf_parse_info(SriovVFData *data, const struct nlattr *info)
+{
+    static const struct nla_policy policy[] = {
+        [IFLA_VF_MAC]       = {.minlen = sizeof(struct ifla_vf_mac)},
+        [IFLA_VF_VLAN]      = {.minlen = sizeof(struct ifla_vf_vlan)},
+        [IFLA_VF_SPOOFCHK]  = {.minlen = sizeof(struct _ifla_vf_setting)},
+        [IFLA_VF_RATE]      = {.minlen = sizeof(struct _ifla_vf_rate)},
+        [IFLA_VF_TRUST]     = {.minlen = sizeof(struct _ifla_vf_setting)},
+        [IFLA_VF_VLAN_LIST] = {.type = NLA_NESTED},
+    };
+    struct nlattr            *tb[G_N_ELEMENTS(policy)];
+    const struct ifla_vf_mac *ivm;
+    SriovVFState             *state;
+    struct nlattr            *attr;
+    int                       rem;
+
+    if (nla_parse_nested_arr(tb, info, policy) < 0)
+        return;
+
+    /* Every IFLA_VF_INFO carries IFLA_VF_MAC, it tells the VF index. */
+    if (!tb[IFLA_VF_MAC])
+        return;
+    ivm = nla_data_as(struct ifla_vf_mac, tb[IFLA_VF_MAC]);
+
+    g_array_set_size(data->vfs, data->vfs->len + 1);
+    state  = &nm_g_array_last(data->vfs, SriovVFState);
+    *state = (SriovVFState) {
+        .vf =
+            {
+                .index    = ivm->vf,
+                .spoofchk = -1,
+                .trust    = -1,
+            },
+    };
+
+    G_STATIC_ASSERT_EXPR(sizeof(state->vf.mac.data) <= sizeof(ivm->mac));
+    memcpy(state->vf.mac.data, ivm->mac, sizeof(state->vf.mac.data));
+    state->vf.mac.len = sizeof(state->vf.mac.data);
+
+    if (tb[IFLA_VF_SPOOFCHK]) {
+        /* The kernel reports -1 if the driver doesn't know. */
+        state->vf.spoofchk =
+            (gint32) nla_data_as(struct _ifla_vf_setting, tb[IFLA_VF_SPOOFCHK])->setting;
+    }
+
+    if (tb[IFLA_VF_TRUST])
+        state->vf.trust = (gint32) nla_data_as(struct _ifla_vf_setting, tb[IFLA_VF_TRUST])->setting;
+
+    if (tb[IFLA_VF_RATE]) {
+        const struct _ifla_vf_rate *ivr = nla_data_as(struct _ifla_vf_rate, tb[IFLA_VF_RATE]);
+
+        state->vf.min_tx_rate = ivr->min_tx_rate;
+        state->vf.max_tx_rate = ivr->max_tx_rate;
+    }
+
+    if (tb[IFLA_VF_VLAN]) {
+        const struct ifla_vf_vlan *ivv = nla_data_as(struct ifla_vf_vlan, tb[IFLA_VF_VLAN]);
+
+        state->vlan.id  = ivv->vlan;
+        state->vlan.qos = ivv->qos;
+    }
+
+    if (tb[IFLA_VF_VLAN_LIST]) {
+        /* Only the VLAN list tells the protocol. */
+        nla_for_each_nested (attr, tb[IFLA_VF_VLAN_LIST], rem) {
+            const struct _ifla_vf_vlan_info *ivvi;
+
+            if (nla_type(attr) != IFLA_VF_VLAN_INFO
+                || nla_len(attr) < (int) sizeof(struct _ifla_vf_vlan_info))
+                continue;
+
+            ivvi                 = nla_data_as(struct _ifla_vf_vlan_info, attr);
+            state->vlan.id       = ivvi->vlan;
+            state->vlan.qos      = ivvi->qos;
+            state->vlan.proto_ad = (ivvi->vlan_proto == htons(ETH_P_8021AD));
+            break;
+        }
+    }
+
+    if (state->vlan.id != 0 || state->vlan.qos != 0)
+        state->vf.num_vlans = 1;
+}
+
+static int
+get_sriov_vfs_cb(const struct nl_msg *msg, void *arg)
+{
+    static const struct nla_policy policy[] = {
+        [IFLA_VFINFO_LIST] = {.type = NLA_NESTED},
+    };
+    struct nlattr    *tb[G_N_ELEMENTS(policy)];
+    SriovVFData      *data = arg;
+    struct ifinfomsg *ifinfo;
+    struct nlattr    *attr;
+    int               rem;
+
+    if (nlmsg_parse_arr(nlmsg_hdr(msg), sizeof(struct ifinfomsg), tb, policy) < 0)
+        return NL_SKIP;
+
+    ifinfo = NLMSG_DATA(nlmsg_hdr(msg));
+    if (ifinfo->ifi_index != data->ifindex)
+        return NL_SKIP;
+
+    if (!data->vfs)
+        data->vfs = g_array_new(FALSE, FALSE, sizeof(SriovVFState));
+
+    if (!tb[IFLA_VFINFO_LIST])
+        return NL_OK;
+
+    nla_for_each_nested (attr, tb[IFLA_VFINFO_LIST], rem) {
+        if (nla_type(attr) == IFLA_VF_INFO)
+            _sriov_vf_parse_info(data, attr);
+    }
+
+    return NL_OK;
+}
+
+/* Returns the current VF configuration of the PF @ifindex, or %NULL on failure.
+ * The link cache doesn't know it, because the VF info is only sent with
+ * RTEXT_FILTER_VF and would bloat every link message. */
+static GArray *
+_link_get_sriov_vfs(NMPlatform *platform, int ifindex)
+{
+    nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    struct nl_sock              *sk    = NULL;
+    SriovVFData                  data;
+    SriovVFState                *state;
+    guint                        i;
+    int                          nle;
+
+    nlmsg = _nl_msg_new_link_full(RTM_GETLINK, 0, ifindex, NULL, AF_UNSPEC, 0, 0, 0);
+    if (!nlmsg)
+        g_return_val_if_reached(NULL);
+
+    NLA_PUT_U32(nlmsg, IFLA_EXT_MASK, RTEXT_FILTER_VF | RTEXT_FILTER_SKIP_STATS);
+
+    nle = nl_socket_new(&sk, NETLINK_ROUTE, NL_SOCKET_FLAGS_NONE, 0, 0);
+    if (nle < 0) {
+        _LOGD("get-sriov-vfs: error opening socket: %s (%d)", nm_strerror(nle), nle);
+        return NULL;
+    }
+
+    data = ((SriovVFData) {
+        .ifindex = ifindex,
+    });
+
+    nle = nl_send_auto(sk, nlmsg);
+    if (nle < 0) {
+        _LOGD("get-sriov-vfs: failed sending request: %s (%d)", nm_strerror(nle), nle);
+        goto out;
+    }
+
+    do {
+        nle = nl_recvmsgs(sk,
+                          &((const struct nl_cb) {
+                              .valid_cb  = get_sriov_vfs_cb,
+                              .valid_arg = &data,
+                          }));
+    } while (nle == -EAGAIN);
+
+    if (nle < 0) {
+        _LOGD("get-sriov-vfs: recv failed: %s (%d)", nm_strerror(nle), nle);
+        nm_clear_pointer(&data.vfs, g_array_unref);
+        goto out;
+    }
+
+    if (data.vfs) {
+        /* Only now the array doesn't move anymore. */
+        for (i = 0; i < data.vfs->len; i++) {
+            state = &nm_g_array_index(data.vfs, SriovVFState, i);
+            if (state->vf.num_vlans > 0)
+                state->vf.vlans = &state->vlan;
+        }
+    }
+
+out:
+    nl_socket_free(sk);
+    return data.vfs;
+
+nla_put_failure:
+    g_return_val_if_reached(NULL);
+}
+
+static const NMPlatformVF *
+_sriov_vfs_find(GArray *vfs, guint32 index)
+{
+    guint i;
+
+    for (i = 0; i < vfs->len; i++) {
+        const SriovVFState *state = &nm_g_array_index(vfs, SriovVFState, i);
+
+        if (state->vf.index == index)
+            return &state->vf;
+    }
+    return NULL;
+}
+
 static gboolean
 link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const *vfs)
 {
-    nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    nm_auto_nlmsg struct nl_msg *nlmsg       = NULL;
+    gs_unref_array GArray       *current_vfs = NULL;
     struct nlattr               *list, *info, *vlan_list;
-    guint                        i      = 0;
-    guint                        num    = 0;
-    size_t                       buflen = 0;
+    guint                        i        = 0;
+    guint                        num      = 0;
+    guint                        num_sent = 0;
+    size_t                       buflen   = 0;
 
     while (vfs[num])
         num++;
 
+    /* Only program the VFs and attributes that differ from what the kernel
+     * has. Some drivers reset the VF whenever it is configured. If the state
+     * can't be read, configure everything. */
+    current_vfs = _link_get_sriov_vfs(platform, ifindex);
+
     /* A single IFLA_VF_INFO shouldn't take more than 200 bytes. */
     buflen = (num + 1) * 200;
     nlmsg  = _nl_msg_new_link_full(RTM_NEWLINK, 0, ifindex, NULL, AF_UNSPEC, 0, 0, buflen);
@@ -9553,12 +10050,30 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
         goto nla_put_failure;
 
     for (; vfs[i]; i++) {
-        const NMPlatformVF *vf = vfs[i];
+        const NMPlatformVF   *vf = vfs[i];
+        NMPSriovVFChangeFlags changes;
+
+        /* Kernel only supports one VLAN per VF now. If this
+         * changes in the future, we need to figure out how to
+         * clear existing VLANs and set new ones in one message
+         * with the new API.*/
+        if (vf->num_vlans > 1) {
+            _LOGW("multiple VLANs per VF are not supported at the moment");
+            return FALSE;
+        }
+
+        changes = nmp_utils_sriov_vf_get_changes(
+            vf,
+            current_vfs ? _sriov_vfs_find(current_vfs, vf->index) : NULL);
+        if (changes == NMP_SRIOV_VF_CHANGE_NONE) {
+            _LOGT("sriov: VF %u is already configured", vf->index);
+            continue;
+        }
 
         if (!(info = nla_nest_start(nlmsg, IFLA_VF_INFO)))
             goto nla_put_failure;
 
-        if (vf->spoofchk >= 0) {
+        if (NM_FLAGS_HAS(changes, NMP_SRIOV_VF_CHANGE_SPOOFCHK)) {
             struct _ifla_vf_setting ivs = {0};
 
             ivs.vf      = vf->index;
@@ -9566,7 +10081,7 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             NLA_PUT(nlmsg, IFLA_VF_SPOOFCHK, sizeof(ivs), &ivs);
         }
 
-        if (vf->trust >= 0) {
+        if (NM_FLAGS_HAS(changes, NMP_SRIOV_VF_CHANGE_TRUST)) {
             struct _ifla_vf_setting ivs = {0};
 
             ivs.vf      = vf->index;
@@ -9574,7 +10089,7 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             NLA_PUT(nlmsg, IFLA_VF_TRUST, sizeof(ivs), &ivs);
         }
 
-        if (vf->mac.len) {
+        if (NM_FLAGS_HAS(changes, NMP_SRIOV_VF_CHANGE_MAC)) {
             struct ifla_vf_mac ivm = {0};
 
             ivm.vf = vf->index;
@@ -9582,7 +10097,7 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             NLA_PUT(nlmsg, IFLA_VF_MAC, sizeof(ivm), &ivm);
         }
 
-        if (vf->min_tx_rate || vf->max_tx_rate) {
+        if (NM_FLAGS_HAS(changes, NMP_SRIOV_VF_CHANGE_RATE)) {
             struct _ifla_vf_rate ivr = {0};
 
             ivr.vf          = vf->index;
@@ -9591,14 +10106,7 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             NLA_PUT(nlmsg, IFLA_VF_RATE, sizeof(ivr), &ivr);
         }
 
-        /* Kernel only supports one VLAN per VF now. If this
-         * changes in the future, we need to figure out how to
-         * clear existing VLANs and set new ones in one message
-         * with the new API.*/
-        if (vf->num_vlans > 1) {
-            _LOGW("multiple VLANs per VF are not supported at the moment");
-            return FALSE;
-        } else {
+        if (NM_FLAGS_HAS(changes, NMP_SRIOV_VF_CHANGE_VLAN)) {
             struct _ifla_vf_vlan_info ivvi = {0};
 
             if (!(vlan_list = nla_nest_start(nlmsg, IFLA_VF_VLAN_LIST)))
@@ -9620,9 +10128,16 @@ link_set_sriov_vfs(NMPlatform *platform, int ifindex, const NMPlatformVF *const
             nla_nest_end(nlmsg, vlan_list);
         }
         nla_nest_end(nlmsg, info);
+        num_sent++;
     }
     nla_nest_end(nlmsg, list);
 
+    if (num_sent == 0) {
+        _LOGD("sriov: all %u VFs are already configured", num);
+        return TRUE;
+    }
+
+    _LOGD("sriov: configuring %u of %u VFs", num_sent, num);
     return (do_change_link(platform, CHANGE_LINK_TYPE_UNSPEC, ifindex, nlmsg, NULL) >= 0);
 nla_put_failure:
     _LOGE("error building SR-IOV VFs netlink message: used %u/%zu bytes for %u/%u VFs",
@@ -9634,11 +10149,12 @@ nla_put_failure:
 }
 
 static gboolean
-link_set_bridge_vlans(NMPlatform                 *platform,
-                      int                         ifindex,
-                      gboolean                    on_controller,
-                      const NMPlatformBridgeVlan *vlans,
-                      guint                       num_vlans)
+_link_change_bridge_vlans(NMPlatform                 *platform,
+                          int                         ifindex,
+                          gboolean                    on_controller,
+                          gboolean                    is_del,
+                          const NMPlatformBridgeVlan *vlans,
+                          guint                       num_vlans)
 {
     nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
     struct nlattr               *list;
@@ -9646,8 +10162,9 @@ link_set_bridge_vlans(NMPlatform                 *platform,
     guint                        i;
 
     nm_assert(num_vlans == 0 || vlans);
+    nm_assert(!is_del || num_vlans > 0);
 
-    nlmsg = _nl_msg_new_link_full(num_vlans > 0 ? RTM_SETLINK : RTM_DELLINK,
+    nlmsg = _nl_msg_new_link_full((num_vlans > 0 && !is_del) ? RTM_SETLINK : RTM_DELLINK,
                                   0,
                                   ifindex,
                                   NULL,
@@ -9666,7 +10183,7 @@ link_set_bridge_vlans(NMPlatform                 *platform,
                 on_controller ? BRIDGE_FLAGS_CONTROLLER : BRIDGE_FLAGS_SELF);
 
     if (num_vlans > 0) {
-        /* Add VLANs */
+        /* Add (or with @is_del, remove) the VLANs */
         for (i = 0; i < num_vlans; i++) {
             const NMPlatformBridgeVlan *vlan     = &vlans[i];
             gboolean                    is_range = vlan->vid_start != vlan->vid_end;
@@ -9674,10 +10191,12 @@ link_set_bridge_vlans(NMPlatform                 *platform,
             vinfo.vid   = vlan->vid_start;
             vinfo.flags = is_range ? BRIDGE_VLAN_INFO_RANGE_BEGIN : 0;
 
-            if (vlan->untagged)
-                vinfo.flags |= BRIDGE_VLAN_INFO_UNTAGGED;
-            if (vlan->pvid)
-                vinfo.flags |= BRIDGE_VLAN_INFO_PVID;
+            if (!is_del) {
+                if (vlan->untagged)
+                    vinfo.flags |= BRIDGE_VLAN_INFO_UNTAGGED;
+                if (vlan->pvid)
+                    vinfo.flags |= BRIDGE_VLAN_INFO_PVID;
+            }
 
             NLA_PUT(nlmsg, IFLA_BRIDGE_VLAN_INFO, sizeof(vinfo), &vinfo);
 
@@ -9705,6 +10224,26 @@ nla_put_failure:
     g_return_val_if_reached(FALSE);
 }
 
+static gboolean
+link_set_bridge_vlans(NMPlatform                 *platform,
+                      int                         ifindex,
+                      gboolean                    on_controller,
+                      const NMPlatformBridgeVlan *vlans,
+                      guint                       num_vlans)
+{
+    return _link_change_bridge_vlans(platform, ifindex, on_controller, FALSE, vlans, num_vlans);
+}
+
+static gboolean
+link_del_bridge_vlans(NMPlatform                 *platform,
+                      int                         ifindex,
+                      gboolean                    on_controller,
+                      const NMPlatformBridgeVlan *vlans,
+                      guint                       num_vlans)
+{
+    return _link_change_bridge_vlans(platform, ifindex, on_controller, TRUE, vlans, num_vlans);
+}
+
 typedef struct {
     int     ifindex;
     GArray *vlans;
@@ -10726,16 +11265,36 @@ ip6_address_delete(NMPlatform *platform, int ifindex, struct in6_addr addr, guin
 static int
 ip_route_add(NMPlatform *platform, NMPNlmFlags flags, NMPObject *obj_stack, char **out_extack_msg)
 {
-    nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+    nm_auto_nlmsg struct nl_msg    *nlmsg   = NULL;
+    nm_auto_nmpobj const NMPObject *obj_old = NULL;
+    nm_auto_nmpobj const NMPObject *obj_new = NULL;
+    NMPCacheOpsType                 cache_op;
+    int                             r;
 
     nlmsg = _nl_msg_new_route(RTM_NEWROUTE, flags & NMP_NLM_FLAG_FMASK, obj_stack);
     if (!nlmsg)
         g_return_val_if_reached(-NME_BUG);
-    return do_add_addrroute(platform,
-                            obj_stack,
-                            nlmsg,
-                            NM_FLAGS_HAS(flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE),
-                            out_extack_msg);
+    r = do_add_addrroute(platform,
+                         obj_stack,
+                         nlmsg,
+                         NM_FLAGS_HAS(flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE),
+                         out_extack_msg);
+
+    if (r == -EEXIST && NMP_OBJECT_GET_TYPE(obj_stack) == NMP_OBJECT_TYPE_IP6_ROUTE
+        && !NM_FLAGS_ANY(flags, NMP_NLM_FLAG_F_EXCL | NMP_NLM_FLAG_F_REPLACE)) {
+        /* Kernel refreshed the lifetime of the existing route, but won't tell us. */
+        cache_op = nmp_cache_update_ip6_route_expires(nm_platform_get_cache(platform),
+                                                      obj_stack,
+                                                      obj_stack->ip6_route.expires,
+                                                      &obj_old,
+                                                      &obj_new);
+        if (cache_op != NMP_CACHE_OPS_UNCHANGED) {
+            cache_on_change(platform, cache_op, obj_old, obj_new);
+            nm_platform_cache_update_emit_signal(platform, cache_op, obj_old, obj_new);
+        }
+    }
+
+    return r;
 }
 
 static gboolean
@@ -10761,6 +11320,9 @@ object_delete(NMPlatform *platform, const NMPObject *obj)
     case NMP_OBJECT_TYPE_TFILTER:
         nlmsg = _nl_msg_new_tfilter(RTM_DELTFILTER, 0, NMP_OBJECT_CAST_TFILTER(obj));
         break;
+    case NMP_OBJECT_TYPE_NEXTHOP:
+        nlmsg = _nl_msg_new_nexthop(RTM_DELNEXTHOP, 0, obj);
+        break;
     case NMP_OBJECT_TYPE_MPTCP_ADDR:
         return (nm_platform_mptcp_addr_update(platform, FALSE, NMP_OBJECT_CAST_MPTCP_ADDR(obj))
                 >= 0);
@@ -10910,6 +11472,52 @@ routing_rule_add(NMPlatform *platform, NMPNlmFlags flags, const NMPlatformRoutin
 
 /*****************************************************************************/
 
+static int
+nexthop_add(NMPlatform *platform, NMPNlmFlags flags, const NMPObject *obj)
+{
+    WaitForNlResponseResult      seq_result;
+    nm_auto_nlmsg struct nl_msg *msg        = NULL;
+    gs_free char                *extack_msg = NULL;
+    char                         s_buf[256];
+    int                          nle;
+    int                          try_count = 0;
+
+    msg = _nl_msg_new_nexthop(RTM_NEWNEXTHOP, flags & NMP_NLM_FLAG_FMASK, obj);
+    if (!msg)
+        g_return_val_if_reached(-NME_BUG);
+
+    event_handler_read_netlink(platform, NMP_NETLINK_ROUTE, FALSE);
+
+    do {
+        seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+        nle        = _netlink_send_nlmsg_rtnl(platform, msg, &seq_result, &extack_msg);
+        if (nle < 0) {
+            _LOGE("do-add-nexthop: failed sending netlink request \"%s\" (%d)",
+                  nm_strerror(nle),
+                  -nle);
+            return -NME_PL_NETLINK;
+        }
+
+        delayed_action_handle_all(platform);
+
+        nm_assert(seq_result != WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN);
+
+    } while (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC
+             && ++try_count < RESYNC_RETRIES);
+
+    _NMLOG(seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK ? LOGL_DEBUG : LOGL_WARN,
+           "do-add-nexthop: %s",
+           wait_for_nl_response_to_string(seq_result, extack_msg, s_buf, sizeof(s_buf)));
+
+    if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK)
+        return 0;
+    if (seq_result < 0)
+        return seq_result;
+    return -NME_UNSPEC;
+}
+
+/*****************************************************************************/
+
 static int
 qdisc_add(NMPlatform *platform, NMPNlmFlags flags, const NMPlatformQdisc *qdisc)
 {
@@ -12189,6 +12797,14 @@ constructed(GObject *_object)
         nm_assert(!nle);
     }
 
+    /* Kernels before 5.3 don't know about nexthop objects and reject the
+     * multicast group. In that case, we don't cache nexthops at all. */
+    nle = nl_socket_add_memberships(priv->sk_rtnl, RTNLGRP_NEXTHOP, 0);
+    if (nle)
+        _LOGD("rtnl: nexthop objects not supported by kernel: %s", nm_strerror(nle));
+    else
+        priv->nexthop_supported = TRUE;
+
     fd = nl_socket_get_fd(priv->sk_rtnl);
 
     _LOGD("rtnl: rtnetlink socket created: port=%u, fd=%d",
@@ -12383,6 +12999,7 @@ nm_linux_platform_class_init(NMLinuxPlatformClass *klass)
     platform_class->link_set_sriov_params_async        = link_set_sriov_params_async;
     platform_class->link_set_sriov_vfs                 = link_set_sriov_vfs;
     platform_class->link_set_bridge_vlans              = link_set_bridge_vlans;
+    platform_class->link_del_bridge_vlans              = link_del_bridge_vlans;
     platform_class->link_get_bridge_vlans              = link_get_bridge_vlans;
     platform_class->link_set_bridge_info               = link_set_bridge_info;
 
@@ -12440,6 +13057,8 @@ nm_linux_platform_class_init(NMLinuxPlatformClass *klass)
 
     platform_class->routing_rule_add = routing_rule_add;
 
+    platform_class->nexthop_add = nexthop_add;
+
     platform_class->qdisc_add      = qdisc_add;
     platform_class->qdisc_delete   = qdisc_delete;
     platform_class->tfilter_add    = tfilter_add;
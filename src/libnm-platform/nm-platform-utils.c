@@ -631,6 +631,167 @@ nmp_utils_bridge_normalized_vlans_equal(const NMPlatformBridgeVlan *vlans_a,
     return TRUE;
 }
 
+#define _BRIDGE_VID_PRESENT  0x1u
+#define _BRIDGE_VID_UNTAGGED 0x2u
+#define _BRIDGE_VID_PVID     0x4u
+
+static void
+_bridge_vlans_to_map(guint8 *map, const NMPlatformBridgeVlan *vlans, guint num_vlans)
+{
+    guint i;
+    guint vid;
+
+    for (i = 0; i < num_vlans; i++) {
+        guint8 flags = _BRIDGE_VID_PRESENT;
+
+        if (vlans[i].untagged)
+            flags |= _BRIDGE_VID_UNTAGGED;
+        if (vlans[i].pvid)
+            flags |= _BRIDGE_VID_PVID;
+
+        for (vid = NM_MAX((guint) vlans[i].vid_start, 1u);
+             vid <= NM_MIN((guint) vlans[i].vid_end, 4094u);
+             vid++)
+            map[vid] = flags;
+    }
+}
+
+static void
+_bridge_vlans_append_vid(GArray *arr, guint vid, guint8 flags)
+{
+    NMPlatformBridgeVlan *last;
+
+    /* The kernel rejects ranges with the PVID flag, a PVID entry is always
+     * a single VID. */
+    if (arr->len > 0 && !NM_FLAGS_HAS(flags, _BRIDGE_VID_PVID)) {
+        last = &nm_g_array_last(arr, NMPlatformBridgeVlan);
+        if (last->vid_end + 1u == vid && !last->pvid
+            && last->untagged == NM_FLAGS_HAS(flags, _BRIDGE_VID_UNTAGGED)) {
+            last->vid_end = vid;
+            return;
+        }
+    }
+
+    g_array_append_val(arr,
+                       ((NMPlatformBridgeVlan){
+                           .vid_start = vid,
+                           .vid_end   = vid,
+                           .untagged  = NM_FLAGS_HAS(flags, _BRIDGE_VID_UNTAGGED),
+                           .pvid      = NM_FLAGS_HAS(flags, _BRIDGE_VID_PVID),
+                       }));
+}
+
+static NMPlatformBridgeVlan *
+_bridge_vlans_steal(GArray *arr, guint *out_len)
+{
+    *out_len = arr->len;
+    return (NMPlatformBridgeVlan *) g_array_free(arr, arr->len == 0);
+}
+
+/**
+ * nmp_utils_bridge_vlans_diff:
+ * @vlans_old: the VLAN ranges currently configured
+ * @num_vlans_old: the number of elements of @vlans_old
+ * @vlans_new: the VLAN ranges that should be configured
+ * @num_vlans_new: the number of elements of @vlans_new
+ * @out_to_add: (out) (transfer full): the VLAN ranges that must be added,
+ *   or whose flags changed. %NULL if there are none.
+ * @out_num_add: (out): the number of elements of @out_to_add
+ * @out_to_del: (out) (transfer full): the VLAN ranges that must be removed
+ *   (their flags are not set). %NULL if there are none.
+ * @out_num_del: (out): the number of elements of @out_to_del
+ *
+ * Compute the minimal set of changes that turns @vlans_old into @vlans_new.
+ * The input arrays don't need to be normalized, but overlapping ranges
+ * within one array must not have different flags.
+ */
+void
+nmp_utils_bridge_vlans_diff(const NMPlatformBridgeVlan *vlans_old,
+                            guint                       num_vlans_old,
+                            const NMPlatformBridgeVlan *vlans_new,
+                            guint                       num_vlans_new,
+                            NMPlatformBridgeVlan      **out_to_add,
+                            guint                      *out_num_add,
+                            NMPlatformBridgeVlan      **out_to_del,
+                            guint                      *out_num_del)
+{
+    guint8  map_old[4095] = {};
+    guint8  map_new[4095] = {};
+    GArray *arr_add;
+    GArray *arr_del;
+    guint   vid;
+
+    nm_assert(out_to_add && out_num_add);
+    nm_assert(out_to_del && out_num_del);
+
+    _bridge_vlans_to_map(map_old, vlans_old, num_vlans_old);
+    _bridge_vlans_to_map(map_new, vlans_new, num_vlans_new);
+
+    arr_add = g_array_new(FALSE, FALSE, sizeof(NMPlatformBridgeVlan));
+    arr_del = g_array_new(FALSE, FALSE, sizeof(NMPlatformBridgeVlan));
+
+    for (vid = 1; vid <= 4094; vid++) {
+        if (map_old[vid] == map_new[vid])
+            continue;
+        if (map_new[vid] != 0)
+            _bridge_vlans_append_vid(arr_add, vid, map_new[vid]);
+        else
+            _bridge_vlans_append_vid(arr_del, vid, 0);
+    }
+
+    *out_to_add = _bridge_vlans_steal(arr_add, out_num_add);
+    *out_to_del = _bridge_vlans_steal(arr_del, out_num_del);
+}
+
+/*****************************************************************************/
+
+/**
+ * nmp_utils_sriov_vf_get_changes:
+ * @vf: the VF configuration that should be applied
+ * @current: (nullable): the state of the VF as reported by the kernel
+ *
+ * Returns: the attributes of @vf that must be sent to the kernel. That is,
+ *   the attributes that @vf sets and which differ from @current. Without
+ *   @current, all attributes that @vf sets.
+ */
+NMPSriovVFChangeFlags
+nmp_utils_sriov_vf_get_changes(const NMPlatformVF *vf, const NMPlatformVF *current)
+{
+    NMPSriovVFChangeFlags changes = NMP_SRIOV_VF_CHANGE_NONE;
+
+    nm_assert(vf);
+    nm_assert(!current || current->index == vf->index);
+
+    if (vf->spoofchk >= 0 && (!current || current->spoofchk != vf->spoofchk))
+        changes |= NMP_SRIOV_VF_CHANGE_SPOOFCHK;
+
+    if (vf->trust >= 0 && (!current || current->trust != vf->trust))
+        changes |= NMP_SRIOV_VF_CHANGE_TRUST;
+
+    /* The kernel reports the MAC address padded with zeros. */
+    if (vf->mac.len > 0
+        && (!current || current->mac.len < vf->mac.len
+            || memcmp(current->mac.data, vf->mac.data, vf->mac.len) != 0))
+        changes |= NMP_SRIOV_VF_CHANGE_MAC;
+
+    if ((vf->min_tx_rate || vf->max_tx_rate)
+        && (!current || current->min_tx_rate != vf->min_tx_rate
+            || current->max_tx_rate != vf->max_tx_rate))
+        changes |= NMP_SRIOV_VF_CHANGE_RATE;
+
+    /* Unlike the other attributes, the VLAN is always set. Without VLANs
+     * in @vf, it gets cleared. */
+    if (!current || current->num_vlans != vf->num_vlans)
+        changes |= NMP_SRIOV_VF_CHANGE_VLAN;
+    else if (vf->num_vlans > 0
+             && (vf->num_vlans > 1 || current->vlans[0].id != vf->vlans[0].id
+                 || current->vlans[0].qos != vf->vlans[0].qos
+                 || current->vlans[0].proto_ad != vf->vlans[0].proto_ad))
+        changes |= NMP_SRIOV_VF_CHANGE_VLAN;
+
+    return changes;
+}
+
 /*****************************************************************************/
 
 static const char *
@@ -55,4 +55,25 @@ gboolean nmp_utils_bridge_normalized_vlans_equal(const NMPlatformBridgeVlan *vla
                                                  const NMPlatformBridgeVlan *vlans_b,
                                                  guint                       num_vlans_b);
 
+void nmp_utils_bridge_vlans_diff(const NMPlatformBridgeVlan *vlans_old,
+                                 guint                       num_vlans_old,
+                                 const NMPlatformBridgeVlan *vlans_new,
+                                 guint                       num_vlans_new,
+                                 NMPlatformBridgeVlan      **out_to_add,
+                                 guint                      *out_num_add,
+                                 NMPlatformBridgeVlan      **out_to_del,
+                                 guint                      *out_num_del);
+
+typedef enum {
+    NMP_SRIOV_VF_CHANGE_NONE     = 0,
+    NMP_SRIOV_VF_CHANGE_SPOOFCHK = (1 << 0),
+    NMP_SRIOV_VF_CHANGE_TRUST    = (1 << 1),
+    NMP_SRIOV_VF_CHANGE_MAC      = (1 << 2),
+    NMP_SRIOV_VF_CHANGE_RATE     = (1 << 3),
+    NMP_SRIOV_VF_CHANGE_VLAN     = (1 << 4),
+} NMPSriovVFChangeFlags;
+
+NMPSriovVFChangeFlags nmp_utils_sriov_vf_get_changes(const NMPlatformVF *vf,
+                                                     const NMPlatformVF *current);
+
 #endif /* __NM_PLATFORM_UTILS_H__ */
@@ -2108,6 +2108,38 @@ nm_platform_link_set_bridge_vlans(NMPlatform                 *self,
     return klass->link_set_bridge_vlans(self, ifindex, on_controller, vlans, num_vlans);
 }
 
+/* Unlike nm_platform_link_set_bridge_vlans() with an empty list, this only
+ * removes the given VLAN ranges (their flags are ignored) and leaves all
+ * other VLANs of the link untouched. */
+gboolean
+nm_platform_link_del_bridge_vlans(NMPlatform                 *self,
+                                  int                         ifindex,
+                                  gboolean                    on_controller,
+                                  const NMPlatformBridgeVlan *vlans,
+                                  guint                       num_vlans)
+{
+    guint i;
+    _CHECK_SELF(self, klass, FALSE);
+
+    g_return_val_if_fail(ifindex > 0, FALSE);
+    g_return_val_if_fail(vlans && num_vlans > 0, FALSE);
+
+    if (!klass->link_del_bridge_vlans)
+        return FALSE;
+
+    if (_LOGD_ENABLED()) {
+        _LOG3D("link: removing bridge VLANs on %s", on_controller ? "controller" : "self");
+        for (i = 0; i < num_vlans; i++) {
+            char sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+
+            _LOG3D("link:   bridge VLAN %s",
+                   nm_platform_bridge_vlan_to_string(&vlans[i], sbuf, sizeof(sbuf)));
+        }
+    }
+
+    return klass->link_del_bridge_vlans(self, ifindex, on_controller, vlans, num_vlans);
+}
+
 gboolean
 nm_platform_link_get_bridge_vlans(NMPlatform            *self,
                                   int                    ifindex,
@@ -4301,6 +4333,25 @@ ip6_address_scope_cmp_descending(gconstpointer p_a, gconstpointer p_b, gpointer
     return ip6_address_scope_cmp_ascending(p_b, p_a, NULL);
 }
 
+static const NMPObject *
+_ip4_address_get_subnet_primary(NMPlatform *self, int ifindex, const NMPlatformIP4Address *addr)
+{
+    NMPLookup        lookup;
+    NMDedupMultiIter iter;
+    const NMPObject *obj;
+
+    nmp_lookup_init_object_by_ifindex(&lookup, NMP_OBJECT_TYPE_IP4_ADDRESS, ifindex);
+    nm_platform_iter_obj_for_each (&iter, self, &lookup, &obj) {
+        const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS(obj);
+
+        if (!NM_FLAGS_HAS(a->n_ifa_flags, IFA_F_SECONDARY) && a->plen == addr->plen
+            && nm_ip4_addr_clear_host_address(a->address, a->plen)
+                   == nm_ip4_addr_clear_host_address(addr->address, addr->plen))
+            return obj;
+    }
+    return NULL;
+}
+
 /**
  * nm_platform_ip_address_sync:
  * @self: platform instance
@@ -4344,7 +4395,6 @@ nm_platform_ip_address_sync(NMPlatform           *self,
     guint                          i_plat;
     guint                          i_know;
     guint                          i;
-    guint                          j;
 
     _CHECK_SELF(self, klass, FALSE);
 
@@ -4466,105 +4516,93 @@ nm_platform_ip_address_sync(NMPlatform           *self,
     if (nm_g_ptr_array_len(plat_addresses) > 0) {
         /* Delete addresses that interfere with our intended order. */
         if (IS_IPv4) {
-            GHashTable   *known_subnets = NULL;
-            GHashTable   *plat_subnets;
-            gs_free bool *plat_handled_to_free = NULL;
-            bool         *plat_handled         = NULL;
+            GHashTable *known_subnets = NULL;
 
             /* For IPv4, we only consider it a conflict for addresses in the same
              * subnet. That's where kernel will assign a primary/secondary flag.
-             * For different subnets, we don't define the order. */
-
-            plat_subnets = ip4_addr_subnets_build_index(plat_addresses, TRUE, TRUE);
+             * For different subnets, we don't define the order.
+             *
+             * Also, only the primary address of a subnet matters. The order of
+             * the secondary addresses is not relevant. So we only need to act
+             * when the primary address should be a secondary one. Delete it
+             * right away. Depending on "promote_secondaries" (kernel honors it if
+             * set either for the device or for "all"), kernel then either deletes
+             * all secondary addresses of the subnet, or promotes the next one.
+             * Don't guess which, look at the cache after each delete. If kernel
+             * promoted an address that we don't want as primary either, delete
+             * it too. Deleted addresses get re-added below in the right order. */
 
             for (i = 0; i < plat_addresses->len; i++) {
-                const NMPObject            *plat_obj = plat_addresses->pdata[i];
-                const NMPObject            *known_obj;
-                const NMPlatformIP4Address *plat_address;
-                const GPtrArray            *addr_list;
-                gboolean                    secondary;
+                const NMPObject                *plat_obj = plat_addresses->pdata[i];
+                nm_auto_nmpobj const NMPObject *del_obj  = NULL;
+                const NMPObject                *known_obj;
+                guint                           n_deleted;
 
-                if (plat_handled && plat_handled[i])
+                if (NM_FLAGS_HAS(NMP_OBJECT_CAST_IP4_ADDRESS(plat_obj)->n_ifa_flags,
+                                 IFA_F_SECONDARY))
                     continue;
 
                 known_obj = nm_g_hash_table_lookup(known_addresses_idx, plat_obj);
-
                 if (!known_obj) {
                     /* this address is added externally. Even if it's presence would mess
                      * with our desired order, we cannot delete it. Skip it. */
-                    if (!plat_handled) {
-                        plat_handled = nm_malloc0_maybe_a(300,
-                                                          sizeof(bool) * plat_addresses->len,
-                                                          &plat_handled_to_free);
-                    }
-                    plat_handled[i] = TRUE;
                     continue;
                 }
 
                 if (!known_subnets)
                     known_subnets = ip4_addr_subnets_build_index(known_addresses, FALSE, FALSE);
 
-                plat_address = NMP_OBJECT_CAST_IP4_ADDRESS(plat_obj);
-
-                secondary =
-                    ip4_addr_subnets_is_secondary(known_obj, known_subnets, known_addresses, NULL);
-                if (secondary == NM_FLAGS_HAS(plat_address->n_ifa_flags, IFA_F_SECONDARY)) {
-                    /* if we have an existing known-address, with matching secondary role,
-                     * do not delete the platform-address. */
+                if (!ip4_addr_subnets_is_secondary(known_obj,
+                                                   known_subnets,
+                                                   known_addresses,
+                                                   NULL)) {
+                    /* The primary address is the one we want. */
                     continue;
                 }
 
-                if (!plat_handled) {
-                    plat_handled = nm_malloc0_maybe_a(300,
-                                                      sizeof(bool) * plat_addresses->len,
-                                                      &plat_handled_to_free);
-                }
-                plat_handled[i] = TRUE;
+                del_obj = nmp_object_ref(plat_obj);
+                for (n_deleted = 0; TRUE; n_deleted++) {
+                    nm_platform_ip_address_delete(self,
+                                                  AF_INET,
+                                                  ifindex,
+                                                  NMP_OBJECT_CAST_IP_ADDRESS(del_obj));
+                    nm_platform_process_events(self);
 
-                g_hash_table_add(_plat_addrs_to_delete_ensure(&plat_addrs_to_delete),
-                                 (gpointer) nmp_object_ref(plat_obj));
+                    if (n_deleted >= plat_addresses->len)
+                        break;
 
-                if (!ip4_addr_subnets_is_secondary(plat_obj,
-                                                   plat_subnets,
-                                                   plat_addresses,
-                                                   &addr_list)
-                    && addr_list) {
-                    /* If we just deleted a primary addresses and there were
-                     * secondary ones the kernel can do two things, depending on
-                     * version and sysctl setting: delete also secondary addresses
-                     * or promote a secondary to primary. Ensure that secondary
-                     * addresses are deleted, so that we can start with a clean
-                     * slate and add addresses in the right order. */
-                    for (j = 1; j < addr_list->len; j++) {
-                        const NMPObject **o = ip4_addr_subnets_addr_list_get(addr_list, j);
-                        guint             o_idx;
-
-                        o_idx = (o - ((const NMPObject **) &plat_addresses->pdata[0]));
-
-                        nm_assert(o_idx < plat_addresses->len);
-                        nm_assert(o == ((const NMPObject **) &plat_addresses->pdata[o_idx]));
-
-                        if (plat_handled[o_idx])
-                            continue;
-
-                        plat_handled[o_idx] = TRUE;
-
-                        if (!nm_g_hash_table_contains(known_addresses_idx, *o)) {
-                            /* Again, this is an external address. We cannot delete
-                             * it to fix the address order. Pass. */
-                            continue;
-                        }
+                    nm_clear_pointer(&del_obj, nmp_object_unref);
+                    del_obj = nmp_object_ref(
+                        _ip4_address_get_subnet_primary(self,
+                                                        ifindex,
+                                                        NMP_OBJECT_CAST_IP4_ADDRESS(plat_obj)));
+                    if (!del_obj) {
+                        /* Kernel deleted the secondary addresses together with
+                         * the primary. */
+                        break;
+                    }
 
-                        g_hash_table_add(_plat_addrs_to_delete_ensure(&plat_addrs_to_delete),
-                                         (gpointer) nmp_object_ref(*o));
+                    known_obj = nm_g_hash_table_lookup(known_addresses_idx, del_obj);
+                    if (!known_obj
+                        || !ip4_addr_subnets_is_secondary(known_obj,
+                                                          known_subnets,
+                                                          known_addresses,
+                                                          NULL)) {
+                        /* Either kernel promoted the address that we want as primary,
+                         * or an external address, which we cannot delete. */
+                        break;
                     }
                 }
             }
-            ip4_addr_subnets_destroy_index(plat_subnets, plat_addresses);
+
             ip4_addr_subnets_destroy_index(known_subnets, known_addresses);
         } else {
-            IP6AddrScope cur_scope;
-            gboolean     delete_remaining_addrs;
+            gs_unref_hashtable GHashTable *plat_idx          = NULL;
+            gs_free bool                  *plat_keep_to_free = NULL;
+            bool                          *plat_keep;
+            IP6AddrScope                   cur_scope;
+            gboolean                       scope_done;
+            guint                          i_plat_last;
 
             /* For IPv6, we only compare addresses per-scope. Addresses in different
              * scopes don't have a defined order. */
@@ -4605,64 +4643,77 @@ nm_platform_ip_address_sync(NMPlatform           *self,
                 }
             }
 
-            /* Next, we must preserve the priority of the routes. That is, source address
+            /* Next, we must preserve the priority of the addresses. That is, source address
              * selection will choose addresses in the order as they are reported by kernel.
              * Note that the order in @plat_addresses of the remaining matches is highest
-             * priority first.
-             * We need to compare this to the order of addresses with same scope in
-             * @known_addresses (which has lowest priority first).
+             * priority first, just like in @known_addresses.
              *
-             * If we find a first discrepancy, we need to delete all remaining addresses
-             * for same scope from that point on, because below we must re-add all the
-             * addresses in the right order to get their priority right. */
-            cur_scope              = IP6_ADDR_SCOPE_LOOPBACK;
-            delete_remaining_addrs = FALSE;
-            i_plat                 = plat_addresses->len;
-            i_know                 = nm_g_ptr_array_len(known_addresses);
-
-            while (i_plat > 0) {
-                const NMPObject            *plat_obj  = plat_addresses->pdata[--i_plat];
-                const NMPlatformIP6Address *plat_addr = NMP_OBJECT_CAST_IP6_ADDRESS(plat_obj);
-                IP6AddrScope                plat_scope;
-
-                if (!plat_addr)
+             * Kernel adds new addresses with the highest priority of their scope. Hence,
+             * the addresses that we keep must be the lowest priority ones of each scope
+             * in @known_addresses and they must already be in the right order. Walk
+             * @known_addresses from the lowest priority and find the longest such tail
+             * that is contained in @plat_addresses in the same order. The matches don't
+             * need to be adjacent, the addresses in between get deleted and re-added
+             * below on top of them. */
+            plat_idx = g_hash_table_new((GHashFunc) nmp_object_id_hash,
+                                        (GEqualFunc) nmp_object_id_equal);
+            for (i_plat = 0; i_plat < plat_addresses->len; i_plat++) {
+                if (plat_addresses->pdata[i_plat]) {
+                    g_hash_table_insert(plat_idx,
+                                        plat_addresses->pdata[i_plat],
+                                        GUINT_TO_POINTER(i_plat));
+                }
+            }
+
+            plat_keep = nm_malloc0_maybe_a(300,
+                                           sizeof(bool) * plat_addresses->len,
+                                           &plat_keep_to_free);
+
+            cur_scope   = IP6_ADDR_SCOPE_LOOPBACK;
+            scope_done  = FALSE;
+            i_plat_last = G_MAXUINT;
+            i_know      = nm_g_ptr_array_len(known_addresses);
+
+            while (i_know > 0) {
+                const NMPObject *know_obj = known_addresses->pdata[--i_know];
+                IP6AddrScope     know_scope;
+                gpointer         p;
+
+                if (!know_obj)
                     continue;
 
-                plat_scope = ip6_address_scope(plat_addr);
-                if (cur_scope != plat_scope) {
-                    nm_assert(cur_scope < plat_scope);
-                    delete_remaining_addrs = FALSE;
-                    cur_scope              = plat_scope;
+                know_scope = ip6_address_scope(NMP_OBJECT_CAST_IP6_ADDRESS(know_obj));
+                if (cur_scope != know_scope) {
+                    nm_assert(cur_scope < know_scope);
+                    cur_scope   = know_scope;
+                    scope_done  = FALSE;
+                    i_plat_last = G_MAXUINT;
                 }
 
-                if (!delete_remaining_addrs) {
-                    while (i_know > 0) {
-                        const NMPlatformIP6Address *know_addr =
-                            NMP_OBJECT_CAST_IP6_ADDRESS(known_addresses->pdata[--i_know]);
-                        IP6AddrScope know_scope;
+                if (scope_done)
+                    continue;
 
-                        if (!know_addr)
-                            continue;
+                if (!g_hash_table_lookup_extended(plat_idx, know_obj, NULL, &p)
+                    || GPOINTER_TO_UINT(p) >= i_plat_last) {
+                    /* This address is not configured, or it is configured with a
+                     * higher priority than an address that we keep. It must be added
+                     * (on top) and so must all the addresses with higher priority. */
+                    scope_done = TRUE;
+                    continue;
+                }
 
-                        know_scope = ip6_address_scope(know_addr);
-                        if (know_scope < plat_scope)
-                            continue;
+                i_plat_last            = GPOINTER_TO_UINT(p);
+                plat_keep[i_plat_last] = TRUE;
+            }
 
-                        if (IN6_ARE_ADDR_EQUAL(&plat_addr->address, &know_addr->address)) {
-                            /* we have a match. Mark address as handled. */
-                            goto next_plat;
-                        }
+            for (i_plat = 0; i_plat < plat_addresses->len; i_plat++) {
+                const NMPObject *plat_obj = plat_addresses->pdata[i_plat];
 
-                        /* "plat_address" has no match. "delete_remaining_addrs" will be set to TRUE and we will
-                         * delete all the remaining addresses with "cur_scope". */
-                        break;
-                    }
-                    delete_remaining_addrs = TRUE;
-                }
+                if (!plat_obj || plat_keep[i_plat])
+                    continue;
 
                 g_hash_table_add(_plat_addrs_to_delete_ensure(&plat_addrs_to_delete),
                                  (gpointer) nmp_object_ref(plat_obj));
-next_plat:;
             }
         }
     }
@@ -5148,6 +5199,44 @@ nm_platform_ip_route_get_prune_list(NMPlatform            *self,
     return routes_prune;
 }
 
+/**
+ * nm_platform_ip6_route_get_expires_remaining:
+ * @expires: the absolute expiry of an IPv6 route, see #NMPlatformIP6Route.expires.
+ * @now_sec: the current time in nm_utils_get_monotonic_timestamp_sec() scale,
+ *   or zero to fetch it.
+ *
+ * Returns: the remaining lifetime in seconds, or zero if the route is permanent.
+ *   An already expired route has a remaining lifetime of one second, because
+ *   zero would mean permanent for RTA_EXPIRES.
+ */
+guint32
+nm_platform_ip6_route_get_expires_remaining(guint32 expires, gint32 now_sec)
+{
+    if (expires == 0)
+        return 0;
+    if (now_sec <= 0)
+        now_sec = nm_utils_get_monotonic_timestamp_sec();
+    if (expires <= (guint32) now_sec)
+        return 1;
+    return expires - (guint32) now_sec;
+}
+
+static gboolean
+_ip6_route_expires_outdated(const NMPlatformIP6Route *conf, const NMPlatformIP6Route *plat)
+{
+    if (conf->expires == plat->expires)
+        return FALSE;
+    if (conf->expires == 0 || plat->expires == 0)
+        return TRUE;
+
+    /* Kernel reports the remaining lifetime in clock ticks and we round it to
+     * seconds. Tolerate a small jitter, otherwise we would needlessly refresh
+     * the route on every sync. */
+    return (conf->expires > plat->expires ? conf->expires - plat->expires
+                                          : plat->expires - conf->expires)
+           > 2;
+}
+
 /**
  * nm_platform_ip_route_sync:
  * @self: the #NMPlatform instance.
@@ -5204,15 +5293,17 @@ nm_platform_ip_route_sync(NMPlatform *self,
                 || nm_platform_ip6_route_get_effective_metric(NMP_OBJECT_CAST_IP6_ROUTE(conf_o))
                        != 0);
 
-#define VTABLE_IS_DEVICE_ROUTE(vt, o)                          \
-    (vt->is_ip4 ? (NMP_OBJECT_CAST_IP4_ROUTE(o)->gateway == 0) \
-                : IN6_IS_ADDR_UNSPECIFIED(&NMP_OBJECT_CAST_IP6_ROUTE(o)->gateway))
+#define VTABLE_IS_DEVICE_ROUTE(vt, o)                              \
+    (NMP_OBJECT_CAST_IP_ROUTE(o)->nhid == 0                        \
+     && (vt->is_ip4 ? (NMP_OBJECT_CAST_IP4_ROUTE(o)->gateway == 0) \
+                    : IN6_IS_ADDR_UNSPECIFIED(&NMP_OBJECT_CAST_IP6_ROUTE(o)->gateway)))
 
             if ((i_type == 0 && !VTABLE_IS_DEVICE_ROUTE(vt, conf_o))
                 || (i_type == 1 && VTABLE_IS_DEVICE_ROUTE(vt, conf_o))) {
                 /* we add routes in two runs over @i_type.
                  *
-                 * First device routes, then gateway routes. */
+                 * First device routes, then gateway routes. Routes with a nhid
+                 * count as gateway routes, as their nexthop might have a gateway. */
                 continue;
             }
 
@@ -5232,19 +5323,35 @@ nm_platform_ip_route_sync(NMPlatform *self,
             plat_entry = nm_platform_lookup_entry(self, NMP_CACHE_ID_TYPE_OBJECT_TYPE, conf_o);
             if (plat_entry) {
                 const NMPObject *plat_o;
+                gboolean         delete_plat = TRUE;
 
                 plat_o = plat_entry->obj;
 
                 if (vt->route_cmp(NMP_OBJECT_CAST_IPX_ROUTE(conf_o),
                                   NMP_OBJECT_CAST_IPX_ROUTE(plat_o),
                                   NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
-                    == 0)
-                    continue;
+                    == 0) {
+                    if (IS_IPv4
+                        || !_ip6_route_expires_outdated(NMP_OBJECT_CAST_IP6_ROUTE(conf_o),
+                                                        NMP_OBJECT_CAST_IP6_ROUTE(plat_o)))
+                        continue;
 
-                /* we need to replace the existing route with a (slightly) different
-                 * one. Delete it first. */
-                if (!nm_platform_object_delete(self, plat_o)) {
-                    /* ignore error. */
+                    /* Only the lifetime changed (e.g. a router advertisement refreshed
+                     * it). If the existing route already expires, kernel updates its
+                     * lifetime when we add it again (and fails with EEXIST). Unlike
+                     * NLM_F_REPLACE, that also works for routes that are part of
+                     * an ECMP route. */
+                    if (NMP_OBJECT_CAST_IP6_ROUTE(conf_o)->expires != 0
+                        && NMP_OBJECT_CAST_IP6_ROUTE(plat_o)->expires != 0)
+                        delete_plat = FALSE;
+                }
+
+                if (delete_plat) {
+                    /* we need to replace the existing route with a (slightly) different
+                     * one. Delete it first. */
+                    if (!nm_platform_object_delete(self, plat_o)) {
+                        /* ignore error. */
+                    }
                 }
             }
 
@@ -5383,12 +5490,24 @@ _ip_route_scope_inv_get_normalized(const NMPlatformIP4Route *route)
         if (route->type_coerced == nm_platform_route_type_coerce(RTN_LOCAL))
             return nm_platform_route_scope_inv(RT_SCOPE_HOST);
         else {
-            return nm_platform_route_scope_inv(!route->gateway ? RT_SCOPE_LINK : RT_SCOPE_UNIVERSE);
+            return nm_platform_route_scope_inv((!route->gateway && route->nhid == 0)
+                                                   ? RT_SCOPE_LINK
+                                                   : RT_SCOPE_UNIVERSE);
         }
     }
     return route->scope_inv;
 }
 
+static int
+_ip_route_ifindex_get_id(const NMPlatformIPRoute *route)
+{
+    /* A route with a nhid takes device and gateway from the nexthop object.
+     * Kernel reports the device of the (first) nexthop in compat mode, and no
+     * device otherwise. The route is identified by its nhid, the ifindex is not
+     * part of its identity. */
+    return route->nhid != 0 ? 0 : route->ifindex;
+}
+
 static guint8
 _route_pref_normalize(guint8 pref)
 {
@@ -5509,6 +5628,398 @@ nm_platform_ip_route_normalize(int addr_family, NMPlatformIPRoute *route)
     }
 }
 
+/*****************************************************************************/
+
+typedef struct {
+    NMIPAddr network;
+    guint    cls;
+    guint    idx;
+    guint8   plen;
+} RouteAggregateEntry;
+
+typedef struct {
+    const NMPlatformVTableRoute *vt;
+    const NMPlatformIPXRoute    *routes;
+} RouteAggregateData;
+
+#define ROUTE_AGGREGATE_CLS_MIXED G_MAXUINT
+
+static int
+_route_aggregate_cmp_attrs(gconstpointer p_a, gconstpointer p_b, gpointer user_data)
+{
+    const RouteAggregateData *data = user_data;
+    NMPlatformIPXRoute        a;
+    NMPlatformIPXRoute        b;
+
+    /* Compare everything but the destination. Routes that compare equal here
+     * only differ in network/plen and may be merged with each other. */
+    memcpy(&a, &data->routes[*((const guint *) p_a)], data->vt->sizeof_route);
+    memcpy(&b, &data->routes[*((const guint *) p_b)], data->vt->sizeof_route);
+    if (data->vt->is_ip4) {
+        a.r4.network = 0;
+        b.r4.network = 0;
+    } else {
+        a.r6.network = in6addr_any;
+        b.r6.network = in6addr_any;
+    }
+    a.rx.plen = 0;
+    b.rx.plen = 0;
+    return data->vt->route_cmp(&a, &b, NM_PLATFORM_IP_ROUTE_CMP_TYPE_FULL);
+}
+
+static int
+_route_aggregate_cmp_entry(gconstpointer p_a, gconstpointer p_b, gpointer user_data)
+{
+    const RouteAggregateEntry *a = p_a;
+    const RouteAggregateEntry *b = p_b;
+
+    NM_CMP_FIELD(a, b, cls);
+    NM_CMP_FIELD_MEMCMP(a, b, network);
+    NM_CMP_FIELD(a, b, plen);
+    return 0;
+}
+
+static int
+_route_aggregate_cmp_idx(gconstpointer p_a, gconstpointer p_b, gpointer user_data)
+{
+    const RouteAggregateEntry *a = p_a;
+    const RouteAggregateEntry *b = p_b;
+
+    NM_CMP_FIELD(a, b, idx);
+    return 0;
+}
+
+static guint
+_route_aggregate_prefix_hash(gconstpointer ptr)
+{
+    const RouteAggregateEntry *e = ptr;
+    NMHashState                h;
+
+    nm_hash_init(&h, 1460301437u);
+    nm_hash_update(&h, &e->network, sizeof(e->network));
+    nm_hash_update_val(&h, e->plen);
+    return nm_hash_complete(&h);
+}
+
+static gboolean
+_route_aggregate_prefix_equal(gconstpointer p_a, gconstpointer p_b)
+{
+    const RouteAggregateEntry *a = p_a;
+    const RouteAggregateEntry *b = p_b;
+
+    return a->plen == b->plen && memcmp(&a->network, &b->network, sizeof(a->network)) == 0;
+}
+
+static gboolean
+_route_aggregate_prefix_conflicts(GHashTable     *prefixes,
+                                  int             addr_family,
+                                  const NMIPAddr *network,
+                                  guint8          plen,
+                                  guint           cls)
+{
+    RouteAggregateEntry needle = {
+        .network = NM_IP_ADDR_INIT,
+        .plen    = plen,
+    };
+    gpointer v;
+
+    nm_ip_addr_clear_host_address(addr_family, &needle.network, network, plen);
+    if (!g_hash_table_lookup_extended(prefixes, &needle, NULL, &v))
+        return FALSE;
+    return GPOINTER_TO_UINT(v) != cls;
+}
+
+static gboolean
+_route_aggregate_contains(int                        addr_family,
+                          const RouteAggregateEntry *outer,
+                          const RouteAggregateEntry *inner)
+{
+    return outer->plen <= inner->plen
+           && nm_ip_addr_same_prefix(addr_family, &outer->network, &inner->network, outer->plen);
+}
+
+static gboolean
+_route_aggregate_others_within(int                        addr_family,
+                               const RouteAggregateEntry *others,
+                               guint                      n_others,
+                               const NMIPAddr            *network,
+                               guint8                     plen)
+{
+    const RouteAggregateEntry needle = {
+        .network = *network,
+        .plen    = plen,
+        .cls     = ROUTE_AGGREGATE_CLS_MIXED,
+    };
+    guint lo = 0;
+    guint hi = n_others;
+
+    /* @others is sorted by network and plen. The first entry that does not
+     * sort before @needle is the only candidate that needs checking: if any
+     * other route lies within the prefix, this one does too. */
+    while (lo < hi) {
+        guint mid = lo + (hi - lo) / 2;
+
+        if (_route_aggregate_cmp_entry(&others[mid], &needle, NULL) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < n_others && _route_aggregate_contains(addr_family, &needle, &others[lo]);
+}
+
+static gboolean
+_route_aggregate_addr_get_bit(const NMIPAddr *addr, guint8 bit)
+{
+    /* Both in_addr_t and struct in6_addr are in network byte order, so
+     * the bits can be addressed the same way for both families. */
+    return !!(addr->addr_ptr[bit / 8] & (0x80 >> (bit % 8)));
+}
+
+/**
+ * nm_platform_ip_route_aggregate:
+ * @addr_family: the address family of @routes
+ * @routes: (inout): the routes to aggregate. On return, the first
+ *   elements of the array contain the aggregated routes.
+ * @len: the number of routes in @routes
+ * @other_routes: (nullable): the #NMPObject routes that are already
+ *   configured in the same table and are not part of @routes.
+ *
+ * Merges routes that only differ in their destination into the minimal
+ * set of prefixes that results in the same forwarding decisions. That is,
+ * routes that are covered by a broader route with identical attributes
+ * are dropped, and pairs of sibling prefixes with identical attributes
+ * are combined into their parent prefix. A merge is skipped whenever
+ * another route in @routes with different attributes would win or lose
+ * a longest-prefix-match against the result, where it did not before.
+ * Sibling prefixes are only combined if no route from @other_routes lies
+ * within the parent prefix, and never into a default route.
+ *
+ * The routes must be single-hop routes (no ECMP). Routes that are not
+ * affected by aggregation keep their relative order.
+ *
+ * Returns: the number of routes remaining in @routes.
+ */
+guint
+nm_platform_ip_route_aggregate(int                 addr_family,
+                               NMPlatformIPXRoute *routes,
+                               guint               len,
+                               const GPtrArray    *other_routes)
+{
+    const int                      IS_IPv4  = NM_IS_IPv4(addr_family);
+    const RouteAggregateData       data     = {
+        .vt     = &nm_platform_vtable_route.vx[IS_IPv4],
+        .routes = routes,
+    };
+    gs_unref_hashtable GHashTable *prefixes = NULL;
+    gs_free guint                 *idxs     = NULL;
+    gs_free RouteAggregateEntry   *entries  = NULL;
+    gs_free RouteAggregateEntry   *kept     = NULL;
+    gs_free RouteAggregateEntry   *stack    = NULL;
+    gs_free RouteAggregateEntry   *others   = NULL;
+    gs_free NMPlatformIPXRoute    *result   = NULL;
+    guint                          n_stack  = 0;
+    guint                          n_kept   = 0;
+    guint                          n_others = 0;
+    guint                          n_result = 0;
+    guint                          cls;
+    guint                          i;
+    guint                          j;
+
+    nm_assert_addr_family(addr_family);
+    nm_assert(routes || len == 0);
+
+    if (len < 2)
+        return len;
+
+    /* Assign each route to the class of routes with identical attributes. */
+    idxs = g_new(guint, len);
+    for (i = 0; i < len; i++) {
+        nm_assert(!IS_IPv4 || nm_platform_ip4_route_get_n_nexthops(&routes[i].r4) <= 1);
+        idxs[i] = i;
+    }
+    g_qsort_with_data(idxs, len, sizeof(guint), _route_aggregate_cmp_attrs, (gpointer) &data);
+
+    entries = g_new0(RouteAggregateEntry, len);
+    for (i = 0, cls = 0; i < len; i++) {
+        const NMPlatformIPXRoute *r = &routes[idxs[i]];
+        RouteAggregateEntry      *e = &entries[i];
+
+        if (i > 0 && _route_aggregate_cmp_attrs(&idxs[i - 1], &idxs[i], (gpointer) &data) != 0)
+            cls++;
+        e->cls  = cls;
+        e->idx  = idxs[i];
+        e->plen = r->rx.plen;
+        if (IS_IPv4)
+            e->network.addr4 = nm_ip4_addr_clear_host_address(r->r4.network, r->r4.plen);
+        else
+            nm_ip6_addr_clear_host_address(&e->network.addr6, &r->r6.network, r->r6.plen);
+    }
+
+    if (cls == len - 1) {
+        /* All routes differ in their attributes. Nothing to merge. */
+        return len;
+    }
+
+    g_qsort_with_data(entries, len, sizeof(RouteAggregateEntry), _route_aggregate_cmp_entry, NULL);
+
+    /* Remember all original prefixes and the class they belong to. A prefix
+     * that exists in more than one class is marked as mixed. */
+    prefixes = g_hash_table_new(_route_aggregate_prefix_hash, _route_aggregate_prefix_equal);
+    for (i = 0; i < len; i++) {
+        gpointer v;
+
+        if (g_hash_table_lookup_extended(prefixes, &entries[i], NULL, &v)) {
+            if (GPOINTER_TO_UINT(v) != entries[i].cls)
+                g_hash_table_insert(prefixes,
+                                    &entries[i],
+                                    GUINT_TO_POINTER(ROUTE_AGGREGATE_CLS_MIXED));
+        } else
+            g_hash_table_insert(prefixes, &entries[i], GUINT_TO_POINTER(entries[i].cls));
+    }
+
+    /* Routes that are not ours conflict with every class. They also take part
+     * in the longest-prefix-match and may tie with a merged parent on the
+     * metric, so sibling prefixes are never combined over one of them. */
+    if (other_routes && other_routes->len > 0) {
+        others = g_new(RouteAggregateEntry, other_routes->len);
+        for (i = 0; i < other_routes->len; i++) {
+            const NMPObject          *obj = other_routes->pdata[i];
+            const NMPlatformIPXRoute *r   = NMP_OBJECT_CAST_IPX_ROUTE(obj);
+            RouteAggregateEntry      *e   = &others[n_others++];
+
+            nm_assert(NMP_OBJECT_GET_TYPE(obj) == NMP_OBJECT_TYPE_IP_ROUTE(IS_IPv4));
+
+            *e = (RouteAggregateEntry) {
+                .cls  = ROUTE_AGGREGATE_CLS_MIXED,
+                .plen = r->rx.plen,
+            };
+            nm_ip_addr_clear_host_address(addr_family, &e->network, r->rx.network_ptr, r->rx.plen);
+        }
+        g_qsort_with_data(others,
+                          n_others,
+                          sizeof(RouteAggregateEntry),
+                          _route_aggregate_cmp_entry,
+                          NULL);
+        for (i = 0; i < n_others; i++)
+            g_hash_table_insert(prefixes, &others[i], GUINT_TO_POINTER(ROUTE_AGGREGATE_CLS_MIXED));
+    }
+
+    kept   = g_new(RouteAggregateEntry, len);
+    stack  = g_new(RouteAggregateEntry, len);
+    result = g_new(NMPlatformIPXRoute, len);
+
+    for (i = 0; i < len;) {
+        guint n_class_start = n_kept;
+
+        /* First, drop routes that are covered by a broader route of the same
+         * class. The entries are sorted by network and plen, so the candidate
+         * containers are tracked on a stack. */
+        n_stack = 0;
+        for (j = i; j < len && entries[j].cls == entries[i].cls; j++) {
+            const RouteAggregateEntry *e = &entries[j];
+            gboolean                   drop;
+            guint8                     plen;
+
+            while (n_stack > 0 && !_route_aggregate_contains(addr_family, &stack[n_stack - 1], e))
+                n_stack--;
+
+            drop = FALSE;
+            if (n_stack > 0) {
+                drop = TRUE;
+                for (plen = stack[n_stack - 1].plen; plen <= e->plen; plen++) {
+                    if (_route_aggregate_prefix_conflicts(prefixes,
+                                                          addr_family,
+                                                          &e->network,
+                                                          plen,
+                                                          e->cls)) {
+                        drop = FALSE;
+                        break;
+                    }
+                }
+            }
+            if (drop)
+                continue;
+
+            stack[n_stack++] = *e;
+            kept[n_kept++]   = *e;
+        }
+        i = j;
+
+        /* Then, combine sibling prefixes into their parent, as long as no other
+         * class has a route for the parent or one of the siblings, and no
+         * other route lies within the parent. Never merge into a default
+         * route, which would be subject to never-default handling. */
+        n_stack = 0;
+        for (j = n_class_start; j < n_kept; j++) {
+            stack[n_stack++] = kept[j];
+
+            while (n_stack >= 2) {
+                RouteAggregateEntry *lo = &stack[n_stack - 2];
+                RouteAggregateEntry *hi = &stack[n_stack - 1];
+                guint8               plen;
+
+                if (lo->plen != hi->plen || lo->plen <= 1)
+                    break;
+                plen = lo->plen - 1;
+                if (_route_aggregate_addr_get_bit(&lo->network, plen)
+                    || !_route_aggregate_addr_get_bit(&hi->network, plen)
+                    || !nm_ip_addr_same_prefix(addr_family, &lo->network, &hi->network, plen))
+                    break;
+                if (_route_aggregate_prefix_conflicts(prefixes,
+                                                      addr_family,
+                                                      &lo->network,
+                                                      lo->plen,
+                                                      lo->cls)
+                    || _route_aggregate_prefix_conflicts(prefixes,
+                                                         addr_family,
+                                                         &hi->network,
+                                                         hi->plen,
+                                                         hi->cls)
+                    || _route_aggregate_prefix_conflicts(prefixes,
+                                                         addr_family,
+                                                         &lo->network,
+                                                         plen,
+                                                         lo->cls)
+                    || _route_aggregate_others_within(addr_family,
+                                                      others,
+                                                      n_others,
+                                                      &lo->network,
+                                                      plen))
+                    break;
+
+                /* The lower sibling has the host bit cleared, so its network
+                 * is already the network of the parent. */
+                lo->plen = plen;
+                lo->idx  = MIN(lo->idx, hi->idx);
+                n_stack--;
+            }
+        }
+
+        memcpy(&kept[n_class_start], stack, n_stack * sizeof(RouteAggregateEntry));
+        n_kept = n_class_start + n_stack;
+    }
+
+    if (n_kept == len)
+        return len;
+
+    /* Keep the order of the original routes. */
+    g_qsort_with_data(kept, n_kept, sizeof(RouteAggregateEntry), _route_aggregate_cmp_idx, NULL);
+
+    for (i = 0; i < n_kept; i++) {
+        NMPlatformIPXRoute *r = &result[n_result++];
+
+        memcpy(r, &routes[kept[i].idx], data.vt->sizeof_route);
+        r->rx.plen = kept[i].plen;
+        if (IS_IPv4)
+            r->r4.network = kept[i].network.addr4;
+        else
+            r->r6.network = kept[i].network.addr6;
+    }
+
+    memcpy(routes, result, n_result * sizeof(NMPlatformIPXRoute));
+    return n_result;
+}
+
 static int
 _ip_route_add(NMPlatform *self, NMPNlmFlags flags, NMPObject *obj_stack, char **out_extack_msg)
 {
@@ -5628,6 +6139,7 @@ nm_platform_object_delete(NMPlatform *self, const NMPObject *obj)
     if (_LOGD_ENABLED()) {
         switch (NMP_OBJECT_GET_TYPE(obj)) {
         case NMP_OBJECT_TYPE_ROUTING_RULE:
+        case NMP_OBJECT_TYPE_NEXTHOP:
         case NMP_OBJECT_TYPE_MPTCP_ADDR:
             _LOGD("%s: delete %s",
                   NMP_OBJECT_GET_CLASS(obj)->obj_type_name,
@@ -5996,6 +6508,36 @@ nm_platform_routing_rule_add(NMPlatform                  *self,
 
 /*****************************************************************************/
 
+/**
+ * nm_platform_nexthop_add:
+ * @self: the #NMPlatform instance
+ * @flags: the netlink flags. Use %NMP_NLM_FLAG_REPLACE to atomically update
+ *   an existing nexthop (for example, to change the gateway of all routes
+ *   that refer to it).
+ * @obj_nexthop: a %NMP_OBJECT_TYPE_NEXTHOP object. For nexthop groups, the
+ *   members are taken from the object.
+ *
+ * Returns: 0 on success or a negative error code.
+ */
+int
+nm_platform_nexthop_add(NMPlatform *self, NMPNlmFlags flags, const NMPObject *obj_nexthop)
+{
+    char sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    _CHECK_SELF(self, klass, -NME_BUG);
+
+    g_return_val_if_fail(NMP_OBJECT_GET_TYPE(obj_nexthop) == NMP_OBJECT_TYPE_NEXTHOP, -NME_BUG);
+    g_return_val_if_fail(obj_nexthop->nexthop.id != 0, -NME_BUG);
+
+    if (!klass->nexthop_add)
+        return -NME_PL_OPNOTSUPP;
+
+    _LOGD("nexthop: adding or updating: %s",
+          nmp_object_to_string(obj_nexthop, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof(sbuf)));
+    return klass->nexthop_add(self, flags, obj_nexthop);
+}
+
+/*****************************************************************************/
+
 int
 nm_platform_qdisc_add(NMPlatform *self, NMPNlmFlags flags, const NMPlatformQdisc *qdisc)
 {
@@ -7224,6 +7766,7 @@ nm_platform_ip4_route_to_string_full(const NMPlatformIP4Route     *route,
     char  str_type[30];
     char  str_metric[30];
     char  weight_str[20];
+    char  str_nhid[30];
     guint n_nexthops;
 
     if (!nm_utils_to_string_buffer_init_null(route, &buf, &len))
@@ -7252,6 +7795,7 @@ nm_platform_ip4_route_to_string_full(const NMPlatformIP4Route     *route,
         "%s%s" /* gateway */
         "%s%s" /* weight */
         "%s"   /* dev/ifindex */
+        "%s"   /* nhid */
         " metric %s"
         "%s"         /* mss */
         " rt-src %s" /* protocol */
@@ -7285,6 +7829,7 @@ nm_platform_ip4_route_to_string_full(const NMPlatformIP4Route     *route,
                              nm_sprintf_buf(weight_str, "%u", route->weight),
                              ""),
         n_nexthops <= 1 ? _to_string_dev(str_dev, route->ifindex) : "",
+        route->nhid ? nm_sprintf_buf(str_nhid, " nhid %u", route->nhid) : "",
         route->metric_any
             ? (route->metric ? nm_sprintf_buf(str_metric, "??+%u", route->metric) : "??")
             : nm_sprintf_buf(str_metric, "%u", route->metric),
@@ -7335,7 +7880,7 @@ nm_platform_ip4_route_to_string_full(const NMPlatformIP4Route     *route,
                                                        route->mtu)
                                       : "");
 
-    if ((n_nexthops == 1 && route->ifindex > 0) || n_nexthops == 0) {
+    if ((n_nexthops == 1 && (route->ifindex > 0 || route->nhid != 0)) || n_nexthops == 0) {
         /* A plain single hop route. Nothing extra to remark. */
     } else {
         nm_strbuf_append(&buf, &len, " n_nexthops %u", n_nexthops);
@@ -7415,6 +7960,8 @@ nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsiz
     char str_mtu[32];
     char str_rtm_flags[_RTM_FLAGS_TO_STRING_MAXLEN];
     char str_metric[30];
+    char str_nhid[30];
+    char str_expires[30];
 
     if (!nm_utils_to_string_buffer_init_null(route, &buf, &len))
         return buf;
@@ -7439,6 +7986,7 @@ nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsiz
         "%s/%d"
         "%s%s" /* gateway */
         "%s"
+        "%s" /* nhid */
         " metric %s"
         "%s"         /* mss */
         " rt-src %s" /* protocol */
@@ -7453,6 +8001,7 @@ nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsiz
         "%s"         /* quickack */
         "%s"         /* mtu */
         "%s"         /* pref */
+        "%s"         /* expires */
         "",
         nm_net_aux_rtnl_rtntype_n2a_maybe_buf(nm_platform_route_type_uncoerce(route->type_coerced),
                                               str_type),
@@ -7468,6 +8017,7 @@ nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsiz
         s_gateway[0] ? " via " : "",
         s_gateway,
         _to_string_dev(str_dev, route->ifindex),
+        route->nhid ? nm_sprintf_buf(str_nhid, " nhid %u", route->nhid) : "",
         route->metric_any
             ? (route->metric ? nm_sprintf_buf(str_metric, "??+%u", route->metric) : "??")
             : nm_sprintf_buf(str_metric, "%u", route->metric),
@@ -7520,6 +8070,11 @@ nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsiz
                   str_pref,
                   " pref %s",
                   nm_icmpv6_router_pref_to_string(route->rt_pref, str_pref2, sizeof(str_pref2)))
+            : "",
+        route->expires
+            ? nm_sprintf_buf(str_expires,
+                             " expires %usec",
+                             nm_platform_ip6_route_get_expires_remaining(route->expires, 0))
             : "");
 
     return buf;
@@ -7746,6 +8301,78 @@ nm_platform_routing_rule_to_string(const NMPlatformRoutingRule *routing_rule, ch
     return buf0;
 }
 
+/**
+ * nm_platform_nexthop_to_string_full:
+ * @nexthop: the #NMPlatformNexthop
+ * @group: (nullable): the members of a nexthop group. If %NULL, the
+ *   members are not printed.
+ * @buf: (nullable): an optional buffer. If %NULL, a static buffer is used.
+ * @len: the size of the @buf. If @buf is %NULL, this argument is ignored.
+ *
+ * Example output: "id 10 via 192.168.1.1 dev 5 proto 3" or "id 20 group 10/11,2".
+ *
+ * Returns: a string representation of the nexthop.
+ */
+const char *
+nm_platform_nexthop_to_string_full(const NMPlatformNexthop           *nexthop,
+                                   const NMPlatformNexthopGroupEntry *group,
+                                   char                              *buf,
+                                   gsize                              len)
+{
+    char *buf0;
+    char  str_dev[30];
+    char  s_gateway[NM_INET_ADDRSTRLEN];
+    guint i;
+
+    if (!nm_utils_to_string_buffer_init_null(nexthop, &buf, &len))
+        return buf;
+
+    buf0 = buf;
+
+    nm_strbuf_append(&buf, &len, "id %u", nexthop->id);
+
+    if (nexthop->group_len > 0) {
+        nm_strbuf_append_str(&buf, &len, " group ");
+        if (!group)
+            nm_strbuf_append(&buf, &len, "[%u]", (guint) nexthop->group_len);
+        else {
+            for (i = 0; i < nexthop->group_len; i++) {
+                nm_strbuf_append(&buf, &len, "%s%u", i > 0 ? "/" : "", group[i].id);
+                if (group[i].weight > 1)
+                    nm_strbuf_append(&buf, &len, ",%u", (guint) group[i].weight);
+            }
+        }
+    }
+
+    if (nexthop->blackhole)
+        nm_strbuf_append_str(&buf, &len, " blackhole");
+
+    if (NM_IN_SET(nexthop->addr_family, AF_INET, AF_INET6)
+        && !nm_ip_addr_is_null(nexthop->addr_family, &nexthop->gateway)) {
+        nm_strbuf_append(&buf,
+                         &len,
+                         " via %s",
+                         nm_inet_ntop(nexthop->addr_family, &nexthop->gateway, s_gateway));
+    }
+
+    nm_strbuf_append(&buf,
+                     &len,
+                     "%s" /* dev */
+                     " proto %u"
+                     "%s" /* family */
+                     "",
+                     _to_string_dev(str_dev, nexthop->ifindex),
+                     (guint) nexthop->protocol,
+                     nexthop->addr_family == AF_INET6 ? " inet6"
+                     : nexthop->addr_family == AF_INET ? " inet"
+                                                       : "");
+
+    if (nexthop->flags != 0)
+        nm_strbuf_append(&buf, &len, " flags 0x%x", nexthop->flags);
+
+    return buf0;
+}
+
 const char *
 nm_platform_qdisc_to_string(const NMPlatformQdisc *qdisc, char *buf, gsize len)
 {
@@ -8980,7 +9607,8 @@ nm_platform_ip4_route_hash_update(const NMPlatformIP4Route *obj,
             if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) {
                 n_nexthops = nm_platform_ip4_route_get_n_nexthops(obj);
                 nm_hash_update_vals(h,
-                                    obj->ifindex,
+                                    _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(obj)),
+                                    obj->nhid,
                                     n_nexthops,
                                     obj->via.addr_family,
                                     obj->via.addr_family == AF_INET6 ? obj->via.addr.addr6
@@ -8996,7 +9624,8 @@ nm_platform_ip4_route_hash_update(const NMPlatformIP4Route *obj,
             h,
             obj->type_coerced,
             nm_platform_ip_route_get_effective_table(NM_PLATFORM_IP_ROUTE_CAST(obj)),
-            obj->ifindex,
+            _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(obj)),
+            obj->nhid,
             nm_ip4_addr_clear_host_address(obj->network, obj->plen),
             obj->plen,
             obj->metric,
@@ -9031,6 +9660,7 @@ nm_platform_ip4_route_hash_update(const NMPlatformIP4Route *obj,
                             obj->type_coerced,
                             obj->table_coerced,
                             obj->ifindex,
+                            obj->nhid,
                             obj->network,
                             obj->plen,
                             obj->metric,
@@ -9133,7 +9763,9 @@ nm_platform_ip4_route_cmp(const NMPlatformIP4Route *a,
             NM_CMP_FIELD_UNSAFE(a, b, lock_mtu);
             NM_CMP_FIELD_UNSAFE(a, b, lock_mss);
             if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) {
-                NM_CMP_FIELD(a, b, ifindex);
+                NM_CMP_DIRECT(_ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(a)),
+                              _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(b)));
+                NM_CMP_FIELD(a, b, nhid);
                 NM_CMP_FIELD(a, b, gateway);
                 NM_CMP_FIELD(a, b, via.addr_family);
                 if (a->via.addr_family == AF_INET6) {
@@ -9155,7 +9787,12 @@ nm_platform_ip4_route_cmp(const NMPlatformIP4Route *a,
                           nm_platform_ip_route_get_effective_table(NM_PLATFORM_IP_ROUTE_CAST(b)));
         } else
             NM_CMP_FIELD(a, b, table_coerced);
-        NM_CMP_FIELD(a, b, ifindex);
+        if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) {
+            NM_CMP_DIRECT(_ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(a)),
+                          _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(b)));
+        } else
+            NM_CMP_FIELD(a, b, ifindex);
+        NM_CMP_FIELD(a, b, nhid);
         if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
             NM_CMP_DIRECT_IP4_ADDR_SAME_PREFIX(a->network, b->network, NM_MIN(a->plen, b->plen));
         else
@@ -9246,7 +9883,8 @@ nm_platform_ip6_route_hash_update(const NMPlatformIP6Route *obj,
             obj->src_plen,
             NM_HASH_COMBINE_BOOLS(guint8, obj->metric_any, obj->table_any),
             /* on top of WEAK_ID: */
-            obj->ifindex,
+            _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(obj)),
+            obj->nhid,
             obj->gateway);
         break;
     case NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY:
@@ -9254,7 +9892,8 @@ nm_platform_ip6_route_hash_update(const NMPlatformIP6Route *obj,
             h,
             obj->type_coerced,
             nm_platform_ip_route_get_effective_table(NM_PLATFORM_IP_ROUTE_CAST(obj)),
-            obj->ifindex,
+            _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(obj)),
+            obj->nhid,
             *nm_ip6_addr_clear_host_address(&a1, &obj->network, obj->plen),
             obj->plen,
             obj->metric,
@@ -9288,6 +9927,7 @@ nm_platform_ip6_route_hash_update(const NMPlatformIP6Route *obj,
                             obj->type_coerced,
                             obj->table_coerced,
                             obj->ifindex,
+                            obj->nhid,
                             obj->network,
                             obj->metric,
                             obj->gateway,
@@ -9313,7 +9953,8 @@ nm_platform_ip6_route_hash_update(const NMPlatformIP6Route *obj,
                             obj->initrwnd,
                             obj->mtu,
                             obj->rto_min,
-                            obj->rt_pref);
+                            obj->rt_pref,
+                            obj->expires);
         break;
     }
 }
@@ -9340,7 +9981,9 @@ nm_platform_ip6_route_cmp(const NMPlatformIP6Route *a,
         NM_CMP_DIRECT_IP6_ADDR_SAME_PREFIX(&a->src, &b->src, NM_MIN(a->src_plen, b->src_plen));
         NM_CMP_FIELD(a, b, src_plen);
         if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) {
-            NM_CMP_FIELD(a, b, ifindex);
+            NM_CMP_DIRECT(_ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(a)),
+                          _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(b)));
+            NM_CMP_FIELD(a, b, nhid);
             NM_CMP_FIELD(a, b, type_coerced);
             NM_CMP_FIELD_IN6ADDR(a, b, gateway);
         }
@@ -9354,7 +9997,12 @@ nm_platform_ip6_route_cmp(const NMPlatformIP6Route *a,
                           nm_platform_ip_route_get_effective_table(NM_PLATFORM_IP_ROUTE_CAST(b)));
         } else
             NM_CMP_FIELD(a, b, table_coerced);
-        NM_CMP_FIELD(a, b, ifindex);
+        if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) {
+            NM_CMP_DIRECT(_ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(a)),
+                          _ip_route_ifindex_get_id(NM_PLATFORM_IP_ROUTE_CAST(b)));
+        } else
+            NM_CMP_FIELD(a, b, ifindex);
+        NM_CMP_FIELD(a, b, nhid);
         if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
             NM_CMP_DIRECT_IP6_ADDR_SAME_PREFIX(&a->network, &b->network, NM_MIN(a->plen, b->plen));
         else
@@ -9394,8 +10042,10 @@ nm_platform_ip6_route_cmp(const NMPlatformIP6Route *a,
         NM_CMP_FIELD(a, b, rto_min);
         if (cmp_type == NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY)
             NM_CMP_DIRECT(_route_pref_normalize(a->rt_pref), _route_pref_normalize(b->rt_pref));
-        else
+        else {
             NM_CMP_FIELD(a, b, rt_pref);
+            NM_CMP_FIELD(a, b, expires);
+        }
         break;
     }
     return 0;
@@ -9491,6 +10141,66 @@ nm_platform_routing_rule_hash_update(const NMPlatformRoutingRule *obj,
     nm_assert_not_reached();
 }
 
+void
+nm_platform_nexthop_hash_update(const NMPlatformNexthop *obj, gboolean for_id, NMHashState *h)
+{
+    nm_assert(obj);
+
+    if (for_id) {
+        /* kernel identifies a nexthop only by its ID. */
+        nm_hash_update_val(h, obj->id);
+        return;
+    }
+
+    nm_hash_update_vals(h,
+                        obj->id,
+                        obj->ifindex,
+                        obj->flags,
+                        obj->group_len,
+                        obj->addr_family,
+                        obj->protocol,
+                        NM_HASH_COMBINE_BOOLS(guint8, obj->blackhole));
+    if (NM_IN_SET(obj->addr_family, AF_INET, AF_INET6))
+        nm_hash_update(h, &obj->gateway, nm_utils_addr_family_to_size(obj->addr_family));
+}
+
+int
+nm_platform_nexthop_cmp(const NMPlatformNexthop *a, const NMPlatformNexthop *b, gboolean for_id)
+{
+    NM_CMP_SELF(a, b);
+
+    NM_CMP_FIELD(a, b, id);
+    if (for_id)
+        return 0;
+
+    NM_CMP_FIELD(a, b, addr_family);
+    NM_CMP_FIELD(a, b, ifindex);
+    if (NM_IN_SET(a->addr_family, AF_INET, AF_INET6))
+        NM_CMP_FIELD_MEMCMP_LEN(a, b, gateway, nm_utils_addr_family_to_size(a->addr_family));
+    NM_CMP_FIELD(a, b, group_len);
+    NM_CMP_FIELD(a, b, protocol);
+    NM_CMP_FIELD(a, b, flags);
+    NM_CMP_FIELD_UNSAFE(a, b, blackhole);
+    return 0;
+}
+
+void
+nm_platform_nexthop_group_entry_hash_update(const NMPlatformNexthopGroupEntry *obj,
+                                            NMHashState                       *h)
+{
+    nm_hash_update_vals(h, obj->id, obj->weight);
+}
+
+int
+nm_platform_nexthop_group_entry_cmp(const NMPlatformNexthopGroupEntry *a,
+                                    const NMPlatformNexthopGroupEntry *b)
+{
+    NM_CMP_SELF(a, b);
+    NM_CMP_FIELD(a, b, id);
+    NM_CMP_FIELD(a, b, weight);
+    return 0;
+}
+
 int
 nm_platform_routing_rule_cmp(const NMPlatformRoutingRule *a,
                              const NMPlatformRoutingRule *b,
@@ -9965,6 +10675,11 @@ nm_platform_cache_update_emit_signal(NMPlatform      *self,
 
     klass = NMP_OBJECT_GET_CLASS(o);
 
+    if (klass->signal_type_id == NM_PLATFORM_SIGNAL_ID_NONE) {
+        /* Nexthops are only tracked in the cache, there is no signal for them. */
+        return;
+    }
+
     if (klass->obj_type == NMP_OBJECT_TYPE_ROUTING_RULE)
         ifindex = 0;
     else
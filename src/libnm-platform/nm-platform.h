@@ -332,6 +332,16 @@ guint _nm_platform_signal_id_get(NMPlatformSignalIdType signal_type);
      * zero (RT_TABLE_UNSPEC) are swapped, so that the default is the main
      * table. Use nm_platform_route_table_coerce()/nm_platform_route_table_uncoerce(). */                                                              \
     guint32 table_coerced;                                                                \
+                                                                                          \
+    /* RTA_NH_ID (iproute2: nhid)
+     * If non-zero, the route refers to a NMPlatformNexthop object and kernel takes
+     * the device and gateway from there. In that case, the gateway of the route
+     * is unset and the ifindex is only used to associate the route with a device.
+     * Kernel reports the device of the (first) nexthop, or none if
+     * "net.ipv4.nexthop_compat_mode" is off. Hence, for such routes the ifindex is
+     * not part of the ID (nor of NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY). */         \
+    guint32 nhid;                                                                         \
+                                                                                          \
     /* The NMIPConfigSource. For routes that we receive from cache this corresponds
      * to the rtm_protocol field (and is one of the NM_IP_CONFIG_SOURCE_RTPROT_* values).
      * When adding a route, the source will be coerced to the protocol using
@@ -531,6 +541,15 @@ struct _NMPlatformIP6Route {
      * The type is guint8 to keep the struct size small. But the values are compatible with
      * the NMIcmpv6RouterPref enum. */
     guint8 rt_pref;
+
+    /* RTA_EXPIRES. Zero means the route is permanent. Otherwise, it is the
+     * absolute time (in nm_utils_get_monotonic_timestamp_sec() scale) when
+     * kernel removes the route.
+     *
+     * Kernel reports the remaining lifetime via RTA_CACHEINFO. Rounding makes
+     * it jitter, so it is only compared with NM_PLATFORM_IP_ROUTE_CMP_TYPE_FULL
+     * and it is not part of the ID. */
+    guint32 expires;
 } _nm_alignas(NMPlatformObject);
 
 typedef union {
@@ -739,6 +758,25 @@ typedef struct {
      * two routes that look different for kernel, get merged by platform cache. */
 } NMPlatformIP4RtNextHop;
 
+typedef struct {
+    guint32 id; /* (struct nexthop_grp).id */
+
+    /* The weight of the group member. The valid range is 1-256 (on
+     * netlink, (struct nexthop_grp).weight is the weight minus one). */
+    guint16 weight;
+} NMPlatformNexthopGroupEntry;
+
+typedef struct {
+    NMIPAddr gateway;     /* NHA_GATEWAY */
+    guint32  id;          /* NHA_ID */
+    int      ifindex;     /* NHA_OIF */
+    guint32  flags;       /* (struct nhmsg).nh_flags */
+    guint16  group_len;   /* number of NHA_GROUP entries */
+    guint8   addr_family; /* (struct nhmsg).nh_family */
+    guint8   protocol;    /* (struct nhmsg).nh_protocol */
+    bool     blackhole : 1; /* NHA_BLACKHOLE */
+} _nm_alignas(NMPlatformObject) NMPlatformNexthop;
+
 typedef struct {
     guint             num_vlans;
     guint32           index;
@@ -1203,6 +1241,11 @@ typedef struct {
                                       gboolean                    on_controller,
                                       const NMPlatformBridgeVlan *vlans,
                                       guint                       num_vlans);
+    gboolean (*link_del_bridge_vlans)(NMPlatform                 *self,
+                                      int                         ifindex,
+                                      gboolean                    on_controller,
+                                      const NMPlatformBridgeVlan *vlans,
+                                      guint                       num_vlans);
     gboolean (*link_get_bridge_vlans)(NMPlatform            *self,
                                       int                    ifindex,
                                       NMPlatformBridgeVlan **out_vlans,
@@ -1343,6 +1386,8 @@ typedef struct {
                             NMPNlmFlags                  flags,
                             const NMPlatformRoutingRule *routing_rule);
 
+    int (*nexthop_add)(NMPlatform *self, NMPNlmFlags flags, const NMPObject *obj);
+
     int (*qdisc_add)(NMPlatform *self, NMPNlmFlags flags, const NMPlatformQdisc *qdisc);
     int (*qdisc_delete)(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
 
@@ -2100,6 +2145,11 @@ gboolean nm_platform_link_set_bridge_vlans(NMPlatform                 *self,
                                            gboolean                    on_controller,
                                            const NMPlatformBridgeVlan *vlans,
                                            guint                       num_vlans);
+gboolean nm_platform_link_del_bridge_vlans(NMPlatform                 *self,
+                                           int                         ifindex,
+                                           gboolean                    on_controller,
+                                           const NMPlatformBridgeVlan *vlans,
+                                           guint                       num_vlans);
 gboolean nm_platform_link_get_bridge_vlans(NMPlatform            *self,
                                            int                    ifindex,
                                            NMPlatformBridgeVlan **out_vlans,
@@ -2355,6 +2405,11 @@ gboolean nm_platform_ip_address_flush(NMPlatform *self, int addr_family, int ifi
 
 void nm_platform_ip_route_normalize(int addr_family, NMPlatformIPRoute *route);
 
+guint nm_platform_ip_route_aggregate(int                 addr_family,
+                                     NMPlatformIPXRoute *routes,
+                                     guint               len,
+                                     const GPtrArray    *other_routes);
+
 static inline guint32
 nm_platform_ip4_route_get_effective_metric(const NMPlatformIP4Route *r)
 {
@@ -2373,10 +2428,10 @@ nm_platform_ip4_route_get_n_nexthops(const NMPlatformIP4Route *r)
      * (for convenience of the user who wants to initialize a
      * single hop route). */
     if (r->n_nexthops >= 1) {
-        nm_assert(r->ifindex > 0);
+        nm_assert(r->ifindex > 0 || r->nhid != 0);
         return r->n_nexthops;
     }
-    if (r->ifindex > 0)
+    if (r->ifindex > 0 || r->nhid != 0)
         return 1;
     return 0;
 }
@@ -2390,6 +2445,8 @@ nm_platform_ip6_route_get_effective_metric(const NMPlatformIP6Route *r)
                          : r->metric;
 }
 
+guint32 nm_platform_ip6_route_get_expires_remaining(guint32 expires, gint32 now_sec);
+
 static inline guint32
 nm_platform_ip_route_get_effective_table(const NMPlatformIPRoute *r)
 {
@@ -2470,6 +2527,8 @@ int nm_platform_routing_rule_add(NMPlatform                  *self,
                                  NMPNlmFlags                  flags,
                                  const NMPlatformRoutingRule *routing_rule);
 
+int nm_platform_nexthop_add(NMPlatform *self, NMPNlmFlags flags, const NMPObject *obj_nexthop);
+
 int nm_platform_qdisc_add(NMPlatform *self, NMPNlmFlags flags, const NMPlatformQdisc *qdisc);
 int nm_platform_qdisc_delete(NMPlatform *self, int ifindex, guint32 parent, gboolean log_error);
 int nm_platform_tfilter_add(NMPlatform *self, NMPNlmFlags flags, const NMPlatformTfilter *tfilter);
@@ -2516,6 +2575,17 @@ nm_platform_ip4_route_to_string(const NMPlatformIP4Route *route, char *buf, gsiz
 const char *nm_platform_ip6_route_to_string(const NMPlatformIP6Route *route, char *buf, gsize len);
 const char *
 nm_platform_routing_rule_to_string(const NMPlatformRoutingRule *routing_rule, char *buf, gsize len);
+const char *nm_platform_nexthop_to_string_full(const NMPlatformNexthop           *nexthop,
+                                               const NMPlatformNexthopGroupEntry *group,
+                                               char                              *buf,
+                                               gsize                              len);
+
+static inline const char *
+nm_platform_nexthop_to_string(const NMPlatformNexthop *nexthop, char *buf, gsize len)
+{
+    return nm_platform_nexthop_to_string_full(nexthop, NULL, buf, len);
+}
+
 const char *nm_platform_qdisc_to_string(const NMPlatformQdisc *qdisc, char *buf, gsize len);
 const char *nm_platform_tfilter_to_string(const NMPlatformTfilter *tfilter, char *buf, gsize len);
 const char *nm_platform_vf_to_string(const NMPlatformVF *vf, char *buf, gsize len);
@@ -2573,6 +2643,12 @@ int nm_platform_routing_rule_cmp(const NMPlatformRoutingRule *a,
                                  const NMPlatformRoutingRule *b,
                                  NMPlatformRoutingRuleCmpType cmp_type);
 
+int nm_platform_nexthop_cmp(const NMPlatformNexthop *a,
+                            const NMPlatformNexthop *b,
+                            gboolean                 for_id);
+int nm_platform_nexthop_group_entry_cmp(const NMPlatformNexthopGroupEntry *a,
+                                        const NMPlatformNexthopGroupEntry *b);
+
 int
 nm_platform_qdisc_cmp(const NMPlatformQdisc *a, const NMPlatformQdisc *b, gboolean compare_handle);
 
@@ -2610,6 +2686,11 @@ void nm_platform_ip6_route_hash_update(const NMPlatformIP6Route *obj,
 void nm_platform_routing_rule_hash_update(const NMPlatformRoutingRule *obj,
                                           NMPlatformRoutingRuleCmpType cmp_type,
                                           NMHashState                 *h);
+void nm_platform_nexthop_hash_update(const NMPlatformNexthop *obj,
+                                     gboolean                 for_id,
+                                     NMHashState             *h);
+void nm_platform_nexthop_group_entry_hash_update(const NMPlatformNexthopGroupEntry *obj,
+                                                 NMHashState                       *h);
 void nm_platform_lnk_bond_hash_update(const NMPlatformLnkBond *obj, NMHashState *h);
 void nm_platform_lnk_bridge_hash_update(const NMPlatformLnkBridge *obj, NMHashState *h);
 void nm_platform_lnk_gre_hash_update(const NMPlatformLnkGre *obj, NMHashState *h);
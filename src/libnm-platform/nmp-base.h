@@ -161,6 +161,8 @@ typedef enum _nm_packed {
 
     NMP_OBJECT_TYPE_ROUTING_RULE,
 
+    NMP_OBJECT_TYPE_NEXTHOP,
+
     NMP_OBJECT_TYPE_QDISC,
 
     NMP_OBJECT_TYPE_TFILTER,
@@ -197,7 +199,12 @@ typedef enum _nm_packed {
 static inline guint32
 nmp_object_type_to_flags(NMPObjectType obj_type)
 {
-    G_STATIC_ASSERT_EXPR(NMP_OBJECT_TYPE_MAX < 32);
+    /* The flags are only used for types that emit platform signals (links,
+     * addresses, routes, routing rules, qdiscs and tfilters). Nexthops and
+     * MPTCP addresses have no signal. NMP_OBJECT_TYPE_MAX (MPTCP address)
+     * itself does not fit into the 32 bit flags, and is never passed here. */
+    G_STATIC_ASSERT_EXPR(NMP_OBJECT_TYPE_MAX <= 32);
+    G_STATIC_ASSERT_EXPR(NMP_OBJECT_TYPE_TFILTER < 32);
 
     nm_assert(_NM_INT_NOT_NEGATIVE(obj_type));
     nm_assert(obj_type < NMP_OBJECT_TYPE_MAX);
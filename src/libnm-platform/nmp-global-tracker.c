@@ -854,7 +854,10 @@ nmp_global_tracker_sync_mptcp_addrs(NMPGlobalTracker *self, gboolean reapply)
         g_array_set_size(entries, j);
     }
 
-    /* Get the list of currently (in kernel) configured MPTCP endpoints. */
+    /* Get the list of currently (in kernel) configured MPTCP endpoints. Kernel
+     * doesn't notify about added or removed endpoints, so we cannot cache this
+     * list. The fresh dump also lets us repair endpoints that were changed
+     * externally. */
     kaddrs_arr = nm_platform_mptcp_addrs_dump(self->platform);
 
     /* First, delete all kaddrs which we no longer want... */
@@ -741,6 +741,12 @@ _vt_cmd_obj_dispose_ip4_route(NMPObject *obj)
     nm_clear_g_free((gpointer *) &obj->_ip4_route.extra_nexthops);
 }
 
+static void
+_vt_cmd_obj_dispose_nexthop(NMPObject *obj)
+{
+    nm_clear_g_free((gpointer *) &obj->_nexthop.group);
+}
+
 static void
 _vt_cmd_obj_dispose_lnk_vlan(NMPObject *obj)
 {
@@ -997,6 +1003,40 @@ _vt_cmd_obj_to_string_link(const NMPObject      *obj,
     }
 }
 
+static const char *
+_vt_cmd_obj_to_string_nexthop(const NMPObject      *obj,
+                              NMPObjectToStringMode to_string_mode,
+                              char                 *buf,
+                              gsize                 buf_size)
+{
+    const NMPClass *klass;
+    char            buf2[NM_UTILS_TO_STRING_BUFFER_SIZE];
+
+    klass = NMP_OBJECT_GET_CLASS(obj);
+
+    switch (to_string_mode) {
+    case NMP_OBJECT_TO_STRING_PUBLIC:
+        nm_platform_nexthop_to_string_full(&obj->nexthop, obj->_nexthop.group, buf, buf_size);
+        return buf;
+    case NMP_OBJECT_TO_STRING_ID:
+        g_snprintf(buf, buf_size, "%u", obj->nexthop.id);
+        return buf;
+    case NMP_OBJECT_TO_STRING_ALL:
+        g_snprintf(buf,
+                   buf_size,
+                   "[%s," NM_HASH_OBFUSCATE_PTR_FMT ",%u,%calive,%cvisible; %s]",
+                   klass->obj_type_name,
+                   NM_HASH_OBFUSCATE_PTR(obj),
+                   obj->parent._ref_count,
+                   nmp_object_is_alive(obj) ? '+' : '-',
+                   nmp_object_is_visible(obj) ? '+' : '-',
+                   nmp_object_to_string(obj, NMP_OBJECT_TO_STRING_PUBLIC, buf2, sizeof(buf2)));
+        return buf;
+    default:
+        g_return_val_if_reached("ERROR");
+    }
+}
+
 static const char *
 _vt_cmd_obj_to_string_ip4_route(const NMPObject      *obj,
                                 NMPObjectToStringMode to_string_mode,
@@ -1252,6 +1292,20 @@ _vt_cmd_obj_hash_update_ip4_route(const NMPObject *obj, gboolean for_id, NMHashS
         nm_platform_ip4_rt_nexthop_hash_update(&obj->_ip4_route.extra_nexthops[i - 1u], for_id, h);
 }
 
+static void
+_vt_cmd_obj_hash_update_nexthop(const NMPObject *obj, gboolean for_id, NMHashState *h)
+{
+    guint i;
+
+    nm_assert(NMP_OBJECT_GET_TYPE(obj) == NMP_OBJECT_TYPE_NEXTHOP);
+
+    nm_platform_nexthop_hash_update(&obj->nexthop, for_id, h);
+    if (for_id)
+        return;
+    for (i = 0; i < obj->nexthop.group_len; i++)
+        nm_platform_nexthop_group_entry_hash_update(&obj->_nexthop.group[i], h);
+}
+
 static void
 _vt_cmd_obj_hash_update_lnk_vlan(const NMPObject *obj, gboolean for_id, NMHashState *h)
 {
@@ -1414,6 +1468,27 @@ _vt_cmd_obj_cmp_ip4_route(const NMPObject *obj1, const NMPObject *obj2, gboolean
     return 0;
 }
 
+static int
+_vt_cmd_obj_cmp_nexthop(const NMPObject *obj1, const NMPObject *obj2, gboolean for_id)
+{
+    int   c;
+    guint i;
+
+    c = nm_platform_nexthop_cmp(&obj1->nexthop, &obj2->nexthop, for_id);
+    NM_CMP_RETURN_DIRECT(c);
+
+    if (for_id)
+        return 0;
+
+    for (i = 0; i < obj1->nexthop.group_len; i++) {
+        c = nm_platform_nexthop_group_entry_cmp(&obj1->_nexthop.group[i],
+                                                &obj2->_nexthop.group[i]);
+        NM_CMP_RETURN_DIRECT(c);
+    }
+
+    return 0;
+}
+
 static int
 _vt_cmd_obj_cmp_lnk_vlan(const NMPObject *obj1, const NMPObject *obj2, gboolean for_id)
 {
@@ -1539,6 +1614,27 @@ _vt_cmd_obj_copy_ip4_route(NMPObject *dst, const NMPObject *src)
     dst->ip4_route = src->ip4_route;
 }
 
+static void
+_vt_cmd_obj_copy_nexthop(NMPObject *dst, const NMPObject *src)
+{
+    nm_assert(dst != src);
+
+    if (src->nexthop.group_len == 0) {
+        nm_clear_g_free((gpointer *) &dst->_nexthop.group);
+    } else if (!nm_memeq_n(src->_nexthop.group,
+                           src->nexthop.group_len,
+                           dst->_nexthop.group,
+                           dst->nexthop.group_len,
+                           sizeof(NMPlatformNexthopGroupEntry))) {
+        nm_clear_g_free((gpointer *) &dst->_nexthop.group);
+        dst->_nexthop.group =
+            nm_memdup(src->_nexthop.group,
+                      sizeof(NMPlatformNexthopGroupEntry) * src->nexthop.group_len);
+    }
+
+    dst->nexthop = src->nexthop;
+}
+
 static void
 _vt_cmd_obj_copy_lnk_vlan(NMPObject *dst, const NMPObject *src)
 {
@@ -1902,6 +1998,12 @@ _vt_cmd_obj_is_alive_routing_rule(const NMPObject *obj)
     return NM_IN_SET(obj->routing_rule.addr_family, AF_INET, AF_INET6);
 }
 
+static gboolean
+_vt_cmd_obj_is_alive_nexthop(const NMPObject *obj)
+{
+    return obj->nexthop.id != 0;
+}
+
 static gboolean
 _vt_cmd_obj_is_alive_qdisc(const NMPObject *obj)
 {
@@ -1978,6 +2080,11 @@ static const guint8 _supported_cache_ids_routing_rules[] = {
     0,
 };
 
+static const guint8 _supported_cache_ids_nexthop[] = {
+    NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+    0,
+};
+
 /*****************************************************************************/
 
 static void
@@ -2264,6 +2371,7 @@ nmp_lookup_init_obj_type(NMPLookup *lookup, NMPObjectType obj_type)
     case NMP_OBJECT_TYPE_IP4_ROUTE:
     case NMP_OBJECT_TYPE_IP6_ROUTE:
     case NMP_OBJECT_TYPE_ROUTING_RULE:
+    case NMP_OBJECT_TYPE_NEXTHOP:
     case NMP_OBJECT_TYPE_QDISC:
     case NMP_OBJECT_TYPE_TFILTER:
     case NMP_OBJECT_TYPE_MPTCP_ADDR:
@@ -3229,6 +3337,49 @@ nmp_cache_update_link_controller_connected(NMPCache         *cache,
     return NMP_CACHE_OPS_UPDATED;
 }
 
+/* Adding an IPv6 route that already exists fails with EEXIST, but kernel
+ * still takes over the lifetime of the new route. It sends no notification
+ * about that, so the cache must be updated by hand. */
+NMPCacheOpsType
+nmp_cache_update_ip6_route_expires(NMPCache         *cache,
+                                   const NMPObject  *obj_needle,
+                                   guint32           expires,
+                                   const NMPObject **out_obj_old,
+                                   const NMPObject **out_obj_new)
+{
+    const NMDedupMultiEntry  *entry_old;
+    const NMDedupMultiEntry  *entry_new = NULL;
+    const NMPObject          *obj_old;
+    nm_auto_nmpobj NMPObject *obj_new = NULL;
+
+    nm_assert(NMP_OBJECT_GET_TYPE(obj_needle) == NMP_OBJECT_TYPE_IP6_ROUTE);
+
+    entry_old = _lookup_entry(cache, obj_needle);
+
+    if (!entry_old) {
+        NM_SET_OUT(out_obj_old, NULL);
+        NM_SET_OUT(out_obj_new, NULL);
+        return NMP_CACHE_OPS_UNCHANGED;
+    }
+
+    obj_old = entry_old->obj;
+
+    if (obj_old->ip6_route.expires == 0 || obj_old->ip6_route.expires == expires) {
+        /* kernel only updates the lifetime of a route that already expires. */
+        NM_SET_OUT(out_obj_old, nmp_object_ref(obj_old));
+        NM_SET_OUT(out_obj_new, nmp_object_ref(obj_old));
+        return NMP_CACHE_OPS_UNCHANGED;
+    }
+
+    obj_new                    = nmp_object_clone(obj_old, FALSE);
+    obj_new->ip6_route.expires = expires;
+
+    NM_SET_OUT(out_obj_old, nmp_object_ref(obj_old));
+    _idxcache_update(cache, entry_old, obj_new, FALSE, &entry_new);
+    NM_SET_OUT(out_obj_new, nmp_object_ref(entry_new->obj));
+    return NMP_CACHE_OPS_UPDATED;
+}
+
 /*****************************************************************************/
 
 void
@@ -3419,6 +3570,22 @@ const NMPClass _nmp_classes[NMP_OBJECT_TYPE_MAX] = {
             .cmd_plobj_hash_update    = _vt_cmd_plobj_hash_update_routing_rule,
             .cmd_plobj_cmp            = _vt_cmd_plobj_cmp_routing_rule,
         },
+    [NMP_OBJECT_TYPE_NEXTHOP - 1] =
+        {
+            .parent              = DEDUP_MULTI_OBJ_CLASS_INIT(),
+            .obj_type            = NMP_OBJECT_TYPE_NEXTHOP,
+            .sizeof_data         = sizeof(NMPObjectNexthop),
+            .sizeof_public       = sizeof(NMPlatformNexthop),
+            .obj_type_name       = "nexthop",
+            .rtm_gettype         = RTM_GETNEXTHOP,
+            .supported_cache_ids = _supported_cache_ids_nexthop,
+            .cmd_obj_is_alive    = _vt_cmd_obj_is_alive_nexthop,
+            .cmd_obj_hash_update = _vt_cmd_obj_hash_update_nexthop,
+            .cmd_obj_cmp         = _vt_cmd_obj_cmp_nexthop,
+            .cmd_obj_copy        = _vt_cmd_obj_copy_nexthop,
+            .cmd_obj_dispose     = _vt_cmd_obj_dispose_nexthop,
+            .cmd_obj_to_string   = _vt_cmd_obj_to_string_nexthop,
+        },
     [NMP_OBJECT_TYPE_QDISC - 1] =
         {
             .parent                   = DEDUP_MULTI_OBJ_CLASS_INIT(),
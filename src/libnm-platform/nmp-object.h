@@ -352,6 +352,14 @@ typedef struct {
     NMPlatformRoutingRule _public;
 } NMPObjectRoutingRule;
 
+typedef struct {
+    NMPlatformNexthop _public;
+
+    /* For nexthop groups, the _public.group_len members
+     * of the group (NHA_GROUP). Otherwise NULL. */
+    const NMPlatformNexthopGroupEntry *group;
+} NMPObjectNexthop;
+
 typedef struct {
     NMPlatformQdisc _public;
 } NMPObjectQdisc;
@@ -448,6 +456,9 @@ struct _NMPObject {
         NMPlatformRoutingRule routing_rule;
         NMPObjectRoutingRule  _routing_rule;
 
+        NMPlatformNexthop nexthop;
+        NMPObjectNexthop  _nexthop;
+
         NMPlatformQdisc   qdisc;
         NMPObjectQdisc    _qdisc;
         NMPlatformTfilter tfilter;
@@ -568,6 +579,7 @@ _NMP_OBJECT_TYPE_IS_OBJ_WITH_IFINDEX(NMPObjectType obj_type)
         return TRUE;
 
     case NMP_OBJECT_TYPE_ROUTING_RULE:
+    case NMP_OBJECT_TYPE_NEXTHOP:
         return FALSE;
 
     case NMP_OBJECT_TYPE_UNKNOWN:
@@ -622,6 +634,7 @@ _NMP_OBJECT_TYPE_IS_OBJ_WITH_IFINDEX(NMPObjectType obj_type)
 #define NMP_OBJECT_CAST_IP6_ROUTE(obj) _NMP_OBJECT_CAST(obj, ip6_route, NMP_OBJECT_TYPE_IP6_ROUTE)
 #define NMP_OBJECT_CAST_ROUTING_RULE(obj) \
     _NMP_OBJECT_CAST(obj, routing_rule, NMP_OBJECT_TYPE_ROUTING_RULE)
+#define NMP_OBJECT_CAST_NEXTHOP(obj) _NMP_OBJECT_CAST(obj, nexthop, NMP_OBJECT_TYPE_NEXTHOP)
 #define NMP_OBJECT_CAST_QDISC(obj)   _NMP_OBJECT_CAST(obj, qdisc, NMP_OBJECT_TYPE_QDISC)
 #define NMP_OBJECT_CAST_TFILTER(obj) _NMP_OBJECT_CAST(obj, tfilter, NMP_OBJECT_TYPE_TFILTER)
 #define NMP_OBJECT_CAST_LNK_WIREGUARD(obj) \
@@ -1006,6 +1019,11 @@ NMPCacheOpsType nmp_cache_update_link_controller_connected(NMPCache         *cac
                                                            int               ifindex,
                                                            const NMPObject **out_obj_old,
                                                            const NMPObject **out_obj_new);
+NMPCacheOpsType nmp_cache_update_ip6_route_expires(NMPCache         *cache,
+                                                   const NMPObject  *obj_needle,
+                                                   guint32           expires,
+                                                   const NMPObject **out_obj_old,
+                                                   const NMPObject **out_obj_new);
 
 static inline const NMDedupMultiEntry *
 nmp_cache_reresolve_main_entry(NMPCache                *cache,
@@ -421,6 +421,171 @@ test_nmp_utils_bridge_normalized_vlans_equal(void)
     g_assert(!nmp_utils_bridge_normalized_vlans_equal(b, 1, a, 1));
 }
 
+static void
+test_nmp_utils_bridge_vlans_diff(void)
+{
+    gs_free NMPlatformBridgeVlan *to_add = NULL;
+    gs_free NMPlatformBridgeVlan *to_del = NULL;
+    guint                         num_add;
+    guint                         num_del;
+    NMPlatformBridgeVlan          old[10];
+    NMPlatformBridgeVlan          new[10];
+    NMPlatformBridgeVlan          expect[10];
+
+    /* No changes */
+    old[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .pvid      = TRUE,
+        .untagged  = TRUE,
+    };
+    old[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 10,
+        .vid_end   = 20,
+    };
+    nmp_utils_bridge_vlans_diff(old, 2, old, 2, &to_add, &num_add, &to_del, &num_del);
+    g_assert_cmpuint(num_add, ==, 0);
+    g_assert_cmpuint(num_del, ==, 0);
+    g_assert(!to_add);
+    g_assert(!to_del);
+
+    /* Extend a range, drop the tail of another and move the PVID */
+    new[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .untagged  = TRUE,
+    };
+    new[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 5,
+        .vid_end   = 5,
+        .pvid      = TRUE,
+    };
+    new[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 10,
+        .vid_end   = 15,
+    };
+    new[3] = (NMPlatformBridgeVlan) {
+        .vid_start = 100,
+        .vid_end   = 110,
+        .untagged  = TRUE,
+    };
+    nmp_utils_bridge_vlans_diff(old, 2, new, 4, &to_add, &num_add, &to_del, &num_del);
+
+    expect[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+        .untagged  = TRUE,
+    };
+    expect[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 5,
+        .vid_end   = 5,
+        .pvid      = TRUE,
+    };
+    expect[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 100,
+        .vid_end   = 110,
+        .untagged  = TRUE,
+    };
+    g_assert_cmpuint(num_add, ==, 3);
+    g_assert(nmp_utils_bridge_normalized_vlans_equal(to_add, num_add, expect, 3));
+
+    expect[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 16,
+        .vid_end   = 20,
+    };
+    g_assert_cmpuint(num_del, ==, 1);
+    g_assert(nmp_utils_bridge_normalized_vlans_equal(to_del, num_del, expect, 1));
+
+    nm_clear_g_free(&to_add);
+    nm_clear_g_free(&to_del);
+
+    /* Removing everything, the flags of removed VLANs are not relevant */
+    nmp_utils_bridge_vlans_diff(new, 4, NULL, 0, &to_add, &num_add, &to_del, &num_del);
+    expect[0] = (NMPlatformBridgeVlan) {
+        .vid_start = 1,
+        .vid_end   = 1,
+    };
+    expect[1] = (NMPlatformBridgeVlan) {
+        .vid_start = 5,
+        .vid_end   = 5,
+    };
+    expect[2] = (NMPlatformBridgeVlan) {
+        .vid_start = 10,
+        .vid_end   = 15,
+    };
+    expect[3] = (NMPlatformBridgeVlan) {
+        .vid_start = 100,
+        .vid_end   = 110,
+    };
+    g_assert_cmpuint(num_add, ==, 0);
+    g_assert_cmpuint(num_del, ==, 4);
+    g_assert(nmp_utils_bridge_normalized_vlans_equal(to_del, num_del, expect, 4));
+}
+
+static void
+test_nmp_utils_sriov_vf_get_changes(void)
+{
+    NMPlatformVFVlan vlan_want;
+    NMPlatformVFVlan vlan_cur;
+    NMPlatformVF     want;
+    NMPlatformVF     cur;
+
+    vlan_want = (NMPlatformVFVlan) {
+        .id  = 100,
+        .qos = 3,
+    };
+    vlan_cur = vlan_want;
+
+    want = (NMPlatformVF) {
+        .index       = 2,
+        .spoofchk    = 1,
+        .trust       = -1,
+        .max_tx_rate = 1000,
+        .mac         = {.data = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55}, .len = 6},
+        .num_vlans   = 1,
+        .vlans       = &vlan_want,
+    };
+
+    /* Without current state, everything that is set is sent. */
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, NULL),
+                    ==,
+                    NMP_SRIOV_VF_CHANGE_SPOOFCHK | NMP_SRIOV_VF_CHANGE_MAC
+                        | NMP_SRIOV_VF_CHANGE_RATE | NMP_SRIOV_VF_CHANGE_VLAN);
+
+    /* The kernel pads the MAC address and reports trust even if we don't set it. */
+    cur = (NMPlatformVF) {
+        .index       = 2,
+        .spoofchk    = 1,
+        .trust       = 0,
+        .max_tx_rate = 1000,
+        .mac         = {.data = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55}, .len = 20},
+        .num_vlans   = 1,
+        .vlans       = &vlan_cur,
+    };
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur), ==, NMP_SRIOV_VF_CHANGE_NONE);
+
+    cur.mac.data[5] = 0x56;
+    cur.spoofchk    = -1;
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur),
+                    ==,
+                    NMP_SRIOV_VF_CHANGE_SPOOFCHK | NMP_SRIOV_VF_CHANGE_MAC);
+    cur.mac.data[5] = 0x55;
+    cur.spoofchk    = 1;
+
+    vlan_cur.proto_ad = TRUE;
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur), ==, NMP_SRIOV_VF_CHANGE_VLAN);
+
+    /* No VLAN wanted, but one is configured. */
+    want.num_vlans = 0;
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur), ==, NMP_SRIOV_VF_CHANGE_VLAN);
+    cur.num_vlans = 0;
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur), ==, NMP_SRIOV_VF_CHANGE_NONE);
+
+    /* A rate of zero is not set and therefore doesn't reset the current one. */
+    want.max_tx_rate = 0;
+    g_assert_cmpint(nmp_utils_sriov_vf_get_changes(&want, &cur), ==, NMP_SRIOV_VF_CHANGE_NONE);
+}
+
 /*****************************************************************************/
 
 static void
@@ -474,6 +639,367 @@ test_nmpclass_consistency(void)
 
 /*****************************************************************************/
 
+static void
+_route_aggregate_add4(GArray *routes, const char *network, guint8 plen, guint class)
+{
+    NMPlatformIPXRoute r = {
+        .r4 =
+            {
+                .network   = nmtst_inet4_from_string(network),
+                .plen      = plen,
+                .gateway   = htonl(0xC0A80001u + class),
+                .metric    = 100 + class,
+                .rt_source = NM_IP_CONFIG_SOURCE_VPN,
+            },
+    };
+
+    g_array_append_val(routes, r);
+}
+
+static void
+_route_aggregate_add6(GArray *routes, const char *network, guint8 plen, guint class)
+{
+    NMPlatformIPXRoute r = {
+        .r6 =
+            {
+                .network   = nmtst_inet6_from_string(network),
+                .plen      = plen,
+                .gateway   = nmtst_inet6_from_string("fd00::1"),
+                .metric    = 100 + class,
+                .rt_source = NM_IP_CONFIG_SOURCE_VPN,
+            },
+    };
+
+    r.r6.gateway.s6_addr[15] += class;
+    g_array_append_val(routes, r);
+}
+
+/* Returns the metric of the route that wins the longest-prefix-match
+ * for @addr, or zero if no route matches. */
+static guint32
+_route_aggregate_lookup4(const NMPlatformIPXRoute *routes, guint len, in_addr_t addr)
+{
+    const NMPlatformIP4Route *best = NULL;
+    guint                     i;
+
+    for (i = 0; i < len; i++) {
+        const NMPlatformIP4Route *r = &routes[i].r4;
+
+        if (!nm_ip_addr_same_prefix(AF_INET, &r->network, &addr, r->plen))
+            continue;
+        if (!best || r->plen > best->plen || (r->plen == best->plen && r->metric < best->metric))
+            best = r;
+    }
+    return best ? best->metric : 0;
+}
+
+static void
+_route_aggregate_check4(GArray *routes, guint expected_len)
+{
+    gs_free NMPlatformIPXRoute *orig = NULL;
+    guint                       len;
+    guint                       i;
+
+    orig = nm_memdup(routes->data, routes->len * sizeof(NMPlatformIPXRoute));
+    len  = nm_platform_ip_route_aggregate(AF_INET,
+                                         (NMPlatformIPXRoute *) routes->data,
+                                         routes->len,
+                                         NULL);
+    if (expected_len != 0)
+        g_assert_cmpint(len, ==, expected_len);
+    g_assert_cmpint(len, <=, routes->len);
+
+    for (i = 0; i < routes->len; i++) {
+        const NMPlatformIP4Route *r = &orig[i].r4;
+        in_addr_t                 addr;
+
+        /* Probe the first, the last and a random address of each original
+         * route. */
+        addr = r->network;
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+        addr = r->network | ~nm_ip4_addr_netmask_from_prefix(r->plen);
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+        addr = r->network | (nmtst_get_rand_uint32() & ~nm_ip4_addr_netmask_from_prefix(r->plen));
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+        addr = r->network ^ htonl(nmtst_get_rand_uint32() & 0xFFFFu);
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+    }
+
+    g_array_set_size(routes, len);
+}
+
+static void
+test_route_aggregate(void)
+{
+    gs_unref_array GArray *routes = g_array_new(FALSE, FALSE, sizeof(NMPlatformIPXRoute));
+    NMPlatformIPXRoute    *r;
+    guint                  len;
+    guint                  i;
+
+    /* siblings are merged into their parent. */
+    _route_aggregate_add4(routes, "10.0.0.0", 25, 0);
+    _route_aggregate_add4(routes, "10.0.0.128", 25, 0);
+    _route_aggregate_add4(routes, "10.0.1.0", 24, 0);
+    _route_aggregate_add4(routes, "10.0.2.0", 23, 0);
+    _route_aggregate_check4(routes, 1);
+    r = &nm_g_array_index(routes, NMPlatformIPXRoute, 0);
+    g_assert_cmpint(r->r4.network, ==, nmtst_inet4_from_string("10.0.0.0"));
+    g_assert_cmpint(r->r4.plen, ==, 22);
+    g_assert_cmpint(r->r4.metric, ==, 100);
+
+    /* covered routes are dropped, duplicates too. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "172.16.5.0", 24, 0);
+    _route_aggregate_add4(routes, "172.16.0.0", 16, 0);
+    _route_aggregate_add4(routes, "172.16.0.0", 16, 0);
+    _route_aggregate_add4(routes, "172.16.7.3", 32, 0);
+    _route_aggregate_check4(routes, 1);
+    r = &nm_g_array_index(routes, NMPlatformIPXRoute, 0);
+    g_assert_cmpint(r->r4.network, ==, nmtst_inet4_from_string("172.16.0.0"));
+    g_assert_cmpint(r->r4.plen, ==, 16);
+
+    /* routes with different attributes are not merged. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "10.0.0.0", 25, 0);
+    _route_aggregate_add4(routes, "10.0.0.128", 25, 1);
+    _route_aggregate_check4(routes, 2);
+
+    /* a route of a different class at the parent prefix blocks the merge. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "10.0.0.0", 25, 0);
+    _route_aggregate_add4(routes, "10.0.0.128", 25, 0);
+    _route_aggregate_add4(routes, "10.0.0.0", 24, 1);
+    _route_aggregate_check4(routes, 3);
+
+    /* a route of a different class between the covering and the covered
+     * route prevents dropping the covered one. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "10.0.0.0", 8, 0);
+    _route_aggregate_add4(routes, "10.1.0.0", 16, 1);
+    _route_aggregate_add4(routes, "10.1.2.0", 24, 0);
+    _route_aggregate_add4(routes, "10.2.0.0", 16, 0);
+    _route_aggregate_check4(routes, 3);
+
+    /* the original order of unaffected routes is preserved. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "192.168.5.0", 24, 1);
+    _route_aggregate_add4(routes, "10.0.0.0", 25, 0);
+    _route_aggregate_add4(routes, "10.0.0.128", 25, 0);
+    _route_aggregate_add4(routes, "172.16.0.0", 12, 2);
+    _route_aggregate_check4(routes, 3);
+    g_assert_cmpint(nm_g_array_index(routes, NMPlatformIPXRoute, 0).r4.metric, ==, 101);
+    g_assert_cmpint(nm_g_array_index(routes, NMPlatformIPXRoute, 1).r4.metric, ==, 100);
+    g_assert_cmpint(nm_g_array_index(routes, NMPlatformIPXRoute, 1).r4.plen, ==, 24);
+    g_assert_cmpint(nm_g_array_index(routes, NMPlatformIPXRoute, 2).r4.metric, ==, 102);
+
+    /* the two halves of the address space are never merged into a default
+     * route. */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add4(routes, "0.0.0.0", 1, 0);
+    _route_aggregate_add4(routes, "128.0.0.0", 1, 0);
+    _route_aggregate_check4(routes, 2);
+
+    /* a route outside of @routes within the parent prefix blocks the merge,
+     * one that is broader than the parent does not. */
+    {
+        gs_unref_ptrarray GPtrArray *other_routes = NULL;
+        NMPlatformIP4Route           other;
+
+        other = (NMPlatformIP4Route) {
+            .ifindex   = 5,
+            .network   = nmtst_inet4_from_string("10.0.0.0"),
+            .plen      = 24,
+            .metric    = 100,
+            .rt_source = NM_IP_CONFIG_SOURCE_USER,
+        };
+
+        other_routes = g_ptr_array_new_with_free_func((GDestroyNotify) nmp_object_unref);
+        g_ptr_array_add(other_routes, nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &other));
+        g_array_set_size(routes, 0);
+        _route_aggregate_add4(routes, "10.0.0.0", 25, 0);
+        _route_aggregate_add4(routes, "10.0.0.128", 25, 0);
+        len = nm_platform_ip_route_aggregate(AF_INET,
+                                             (NMPlatformIPXRoute *) routes->data,
+                                             routes->len,
+                                             other_routes);
+        g_assert_cmpint(len, ==, 2);
+
+        other.network = nmtst_inet4_from_string("10.0.0.64");
+        other.plen    = 26;
+        g_ptr_array_add(other_routes, nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &other));
+        g_ptr_array_remove_index(other_routes, 0);
+        len = nm_platform_ip_route_aggregate(AF_INET,
+                                             (NMPlatformIPXRoute *) routes->data,
+                                             routes->len,
+                                             other_routes);
+        g_assert_cmpint(len, ==, 2);
+
+        other.network = nmtst_inet4_from_string("10.0.0.0");
+        other.plen    = 8;
+        g_ptr_array_add(other_routes, nmp_object_new(NMP_OBJECT_TYPE_IP4_ROUTE, &other));
+        g_ptr_array_remove_index(other_routes, 0);
+        len = nm_platform_ip_route_aggregate(AF_INET,
+                                             (NMPlatformIPXRoute *) routes->data,
+                                             routes->len,
+                                             other_routes);
+        g_assert_cmpint(len, ==, 1);
+        r = &nm_g_array_index(routes, NMPlatformIPXRoute, 0);
+        g_assert_cmpint(r->r4.network, ==, nmtst_inet4_from_string("10.0.0.0"));
+        g_assert_cmpint(r->r4.plen, ==, 24);
+    }
+
+    /* IPv6 */
+    g_array_set_size(routes, 0);
+    _route_aggregate_add6(routes, "2001:db8::", 65, 0);
+    _route_aggregate_add6(routes, "2001:db8::8000:0:0:0", 65, 0);
+    _route_aggregate_add6(routes, "2001:db8:0:1::", 64, 0);
+    _route_aggregate_add6(routes, "2001:db8:0:1::", 64, 1);
+    len = nm_platform_ip_route_aggregate(AF_INET6,
+                                         (NMPlatformIPXRoute *) routes->data,
+                                         routes->len,
+                                         NULL);
+    g_assert_cmpint(len, ==, 3);
+    r = &nm_g_array_index(routes, NMPlatformIPXRoute, 0);
+    nmtst_assert_ip6_address(&r->r6.network, "2001:db8::");
+    g_assert_cmpint(r->r6.plen, ==, 64);
+
+    g_array_set_size(routes, 0);
+    _route_aggregate_add6(routes, "::", 1, 0);
+    _route_aggregate_add6(routes, "8000::", 1, 0);
+    len = nm_platform_ip_route_aggregate(AF_INET6,
+                                         (NMPlatformIPXRoute *) routes->data,
+                                         routes->len,
+                                         NULL);
+    g_assert_cmpint(len, ==, 2);
+
+    /* random route lists, compared by longest-prefix-match. */
+    for (i = 0; i < 200; i++) {
+        guint n = nmtst_get_rand_uint32() % 200;
+        guint j;
+
+        g_array_set_size(routes, 0);
+        for (j = 0; j < n; j++) {
+            NMPlatformIPXRoute rr = {
+                .r4 =
+                    {
+                        .plen      = 16 + (nmtst_get_rand_uint32() % 11),
+                        .rt_source = NM_IP_CONFIG_SOURCE_VPN,
+                    },
+            };
+            guint class = nmtst_get_rand_uint32() % (1 + (i % 3));
+
+            rr.r4.network =
+                nm_ip4_addr_clear_host_address(htonl(0x0A000000u
+                                                     | ((nmtst_get_rand_uint32() & 0x3FFu) << 6)),
+                                               rr.r4.plen);
+            rr.r4.gateway = htonl(0xC0A80001u + class);
+            rr.r4.metric  = 100 + class;
+            g_array_append_val(routes, rr);
+        }
+        _route_aggregate_check4(routes, 0);
+    }
+}
+
+static void
+test_route_aggregate_bench(void)
+{
+    gs_unref_array GArray      *routes = g_array_new(FALSE, FALSE, sizeof(NMPlatformIPXRoute));
+    gs_free NMPlatformIPXRoute *orig   = NULL;
+    guint                       len;
+    double                      elapsed;
+    guint                       i;
+
+    /* A split-tunnel route list with 20k /24 prefixes, most of them
+     * adjacent to each other. */
+    for (i = 0; routes->len < 20000; i++) {
+        char sbuf[NM_INET_ADDRSTRLEN];
+
+        if (nmtst_get_rand_uint32() % 8 == 0)
+            continue;
+        _route_aggregate_add4(routes,
+                              nm_inet4_ntop(htonl(0x0A000000u | (i << 8)), sbuf),
+                              24,
+                              (i / 4096) % 2);
+    }
+    orig = nm_memdup(routes->data, routes->len * sizeof(NMPlatformIPXRoute));
+
+    g_test_timer_start();
+    len     = nm_platform_ip_route_aggregate(AF_INET,
+                                             (NMPlatformIPXRoute *) routes->data,
+                                             routes->len,
+                                             NULL);
+    elapsed = g_test_timer_elapsed();
+
+    g_test_message("aggregated %u routes to %u in %.3f msec", routes->len, len, elapsed * 1000);
+    g_assert_cmpint(len, <, routes->len / 2);
+
+    for (i = 0; i < 500; i++) {
+        const NMPlatformIP4Route *r = &orig[nmtst_get_rand_uint32() % routes->len].r4;
+        in_addr_t                 addr;
+
+        addr = r->network | htonl(nmtst_get_rand_uint32() & 0xFFu);
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+        addr = r->network ^ htonl(0x100u);
+        g_assert_cmpint(_route_aggregate_lookup4(orig, routes->len, addr),
+                        ==,
+                        _route_aggregate_lookup4((NMPlatformIPXRoute *) routes->data, len, addr));
+    }
+}
+
+/*****************************************************************************/
+
+static void
+test_nexthop_object(void)
+{
+    nm_auto_nmpobj NMPObject    *obj1 = NULL;
+    nm_auto_nmpobj NMPObject    *obj2 = NULL;
+    nm_auto_nmpobj NMPObject    *obj3 = NULL;
+    NMPlatformNexthopGroupEntry *group;
+    char                         sbuf[NM_UTILS_TO_STRING_BUFFER_SIZE];
+    const NMPlatformNexthop      nh = {
+             .id        = 20,
+             .group_len = 2,
+             .protocol  = RTPROT_STATIC,
+    };
+
+    obj1                 = nmp_object_new(NMP_OBJECT_TYPE_NEXTHOP, &nh);
+    group                = g_new(NMPlatformNexthopGroupEntry, 2);
+    group[0]             = (NMPlatformNexthopGroupEntry){.id = 10, .weight = 1};
+    group[1]             = (NMPlatformNexthopGroupEntry){.id = 11, .weight = 2};
+    obj1->_nexthop.group = group;
+
+    g_assert(nmp_object_is_alive(obj1));
+    g_assert_cmpstr(nmp_object_to_string(obj1, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof(sbuf)),
+                    ==,
+                    "id 20 group 10/11,2 proto 4");
+
+    obj2 = nmp_object_clone(obj1, FALSE);
+    g_assert(obj2->_nexthop.group != obj1->_nexthop.group);
+    g_assert(nmp_object_equal(obj1, obj2));
+    g_assert_cmpint(nmp_object_id_hash(obj1), ==, nmp_object_id_hash(obj2));
+
+    /* changing the weight of a member is a change of the object, but not of its ID. */
+    group[1].weight = 3;
+    g_assert(!nmp_object_equal(obj1, obj2));
+    g_assert(nmp_object_id_equal(obj1, obj2));
+
+    obj3 = nmp_object_clone(obj1, TRUE);
+    g_assert(nmp_object_id_equal(obj1, obj3));
+    g_assert_cmpint(obj3->nexthop.id, ==, 20);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE();
 
 int
@@ -489,6 +1015,12 @@ main(int argc, char **argv)
                     test_nmp_utils_bridge_vlans_normalize);
     g_test_add_func("/nm-platform/nmp-utils-bridge-vlans-equal",
                     test_nmp_utils_bridge_normalized_vlans_equal);
+    g_test_add_func("/nm-platform/nmp-utils-bridge-vlans-diff", test_nmp_utils_bridge_vlans_diff);
+    g_test_add_func("/nm-platform/nmp-utils-sriov-vf-get-changes",
+                    test_nmp_utils_sriov_vf_get_changes);
+    g_test_add_func("/nm-platform/route-aggregate", test_route_aggregate);
+    g_test_add_func("/nm-platform/route-aggregate-bench", test_route_aggregate_bench);
+    g_test_add_func("/nm-platform/nexthop-object", test_nexthop_object);
 
     return g_test_run();
 }
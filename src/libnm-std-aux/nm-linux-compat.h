@@ -22,5 +22,6 @@
 #include "linux-headers/ethtool.h"
 #include "linux-headers/nl802154.h"
 #include "linux-headers/mptcp.h"
+#include "linux-headers/nexthop.h"
 
 #endif /* __NM_LINUX_COMPAT_H__ */
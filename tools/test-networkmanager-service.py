@@ -2162,6 +2162,10 @@ class NetworkManager(ExportedObj):
         assert len(cons) == 1
         cons[0].SetVisible(vis)
 
+    @dbus.service.method(dbus_interface=IFACE_TEST, in_signature="", out_signature="u")
+    def GetSettingsCallCount(self):
+        return gl.get_settings_calls
+
     @dbus.service.method(dbus_interface=IFACE_TEST, in_signature="", out_signature="")
     def Restart(self):
         gl.bus.release_name("org.freedesktop.NetworkManager")
@@ -2229,12 +2233,15 @@ class Connection(ExportedObj):
             )
 
         self.con_hash = con_hash
+        if self.visible:
+            self.UpdatedSettings(self.con_hash)
         self.Updated()
 
     @dbus.service.method(
         dbus_interface=IFACE_CONNECTION, in_signature="", out_signature="a{sa{sv}}"
     )
     def GetSettings(self):
+        gl.get_settings_calls += 1
         if hasattr(self, "_remove_next_connection_cb"):
             self._remove_next_connection_cb()
             raise BusErr.UnknownConnectionException("Connection not found")
@@ -2285,6 +2292,10 @@ class Connection(ExportedObj):
     def Updated(self):
         pass
 
+    @dbus.service.signal(IFACE_CONNECTION, signature="a{sa{sv}}")
+    def UpdatedSettings(self, con_hash):
+        pass
+
 
 ###############################################################################
 
@@ -3079,6 +3090,7 @@ def main():
     gl.mainloop = GLib.MainLoop()
     gl.bus = dbus.SessionBus()
     gl.force_activation_failure = {}
+    gl.get_settings_calls = 0
 
     gl.object_manager = ObjectManager("/org/freedesktop")
     gl.manager = NetworkManager()